@@ -38,6 +38,7 @@
 #define	OPT_BLD_CATEGORIES	"bldcat"
 #define	OPT_RUN_CATEGORIES	"runcat"
 #define	OPT_MAX_SIZE		"maxsize"
+#define	OPT_BLD_LCORES		"bldlcores"
 #define	OPT_ITER_NUM		"iter"
 #define	OPT_VERBOSE		"verbose"
 #define	OPT_IPV6		"ipv6"
@@ -48,6 +49,8 @@
 
 #define	RULE_NUM		0x10000
 
+#define	BLD_LCORES_MAX		8
+
 enum {
 	DUMP_NONE,
 	DUMP_SEARCH,
@@ -98,6 +101,7 @@ static struct {
 	size_t              max_size;
 	uint32_t            bld_categories;
 	uint32_t            run_categories;
+	uint32_t            bld_lcores;
 	uint32_t            nb_rules;
 	uint32_t            nb_traces;
 	uint32_t            trace_step;
@@ -766,6 +770,9 @@ acx_init(void)
 {
 	int ret;
 	FILE *f;
+	uint32_t n;
+	uint64_t tm;
+	unsigned int lcore, lcores[BLD_LCORES_MAX];
 	struct rte_acl_config cfg;
 
 	memset(&cfg, 0, sizeof(cfg));
@@ -809,12 +816,28 @@ acx_init(void)
 
 	fclose(f);
 
+	/* build on the worker lcores, they don't search yet. */
+	n = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore) {
+		if (n == config.bld_lcores)
+			break;
+		lcores[n++] = lcore;
+	}
+
+	ret = rte_acl_set_ctx_build_lcores(config.acx, lcores, n);
+	if (ret != 0)
+		rte_exit(ret, "failed to setup %u build lcores "
+			"for ACL context\n", n);
+
 	/* perform build. */
+	tm = rte_rdtsc();
 	ret = rte_acl_build(config.acx, &cfg);
+	tm = rte_rdtsc() - tm;
 
 	dump_verbose(DUMP_NONE, stdout,
-		"rte_acl_build(%u) finished with %d\n",
-		config.bld_categories, ret);
+		"rte_acl_build(%u) on %u worker lcores finished with %d, "
+		"%" PRIu64 " cycles\n",
+		config.bld_categories, n, ret, tm);
 
 	rte_acl_dump(config.acx);
 
@@ -963,13 +986,16 @@ print_usage(const char *prgname)
 		"[--" OPT_MAX_SIZE
 			"=<size limit (in bytes) for runtime ACL strucutures> "
 			"leave 0 for default behaviour]\n"
+		"[--" OPT_BLD_LCORES
+			"=<number of worker lcores to build with> "
+			"not greater then %u]\n"
 		"[--" OPT_ITER_NUM "=<number of iterations to perform>]\n"
 		"[--" OPT_VERBOSE "=<verbose level>]\n"
 		"[--" OPT_SEARCH_ALG "=%s]\n"
 		"[--" OPT_IPV6 "=<IPv6 rules and trace files>]\n",
 		prgname, RTE_ACL_RESULTS_MULTIPLIER,
 		(uint32_t)RTE_ACL_MAX_CATEGORIES,
-		buf);
+		(uint32_t)BLD_LCORES_MAX, buf);
 }
 
 static void
@@ -984,6 +1010,7 @@ dump_config(FILE *f)
 	fprintf(f, "%s:%u\n", OPT_BLD_CATEGORIES, config.bld_categories);
 	fprintf(f, "%s:%u\n", OPT_RUN_CATEGORIES, config.run_categories);
 	fprintf(f, "%s:%zu\n", OPT_MAX_SIZE, config.max_size);
+	fprintf(f, "%s:%u\n", OPT_BLD_LCORES, config.bld_lcores);
 	fprintf(f, "%s:%u\n", OPT_ITER_NUM, config.iter_num);
 	fprintf(f, "%s:%u\n", OPT_VERBOSE, config.verbose);
 	fprintf(f, "%s:%u(%s)\n", OPT_SEARCH_ALG, config.alg.alg,
@@ -1011,6 +1038,7 @@ get_input_opts(int argc, char **argv)
 		{OPT_TRACE_NUM, 1, 0, 0},
 		{OPT_RULE_NUM, 1, 0, 0},
 		{OPT_MAX_SIZE, 1, 0, 0},
+		{OPT_BLD_LCORES, 1, 0, 0},
 		{OPT_TRACE_STEP, 1, 0, 0},
 		{OPT_BLD_CATEGORIES, 1, 0, 0},
 		{OPT_RUN_CATEGORIES, 1, 0, 0},
@@ -1040,6 +1068,9 @@ get_input_opts(int argc, char **argv)
 		} else if (strcmp(lgopts[opt_idx].name, OPT_MAX_SIZE) == 0) {
 			config.max_size = get_ulong_opt(optarg,
 				lgopts[opt_idx].name, 0, SIZE_MAX);
+		} else if (strcmp(lgopts[opt_idx].name, OPT_BLD_LCORES) == 0) {
+			config.bld_lcores = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 0, BLD_LCORES_MAX);
 		} else if (strcmp(lgopts[opt_idx].name, OPT_TRACE_NUM) == 0) {
 			config.nb_traces = get_ulong_opt(optarg,
 				lgopts[opt_idx].name, 1, UINT32_MAX);
@@ -115,6 +115,8 @@ struct {
 	{"hash-cuckoo-96", e_APP_PIPELINE_HASH_CUCKOO_KEY96},
 	{"hash-cuckoo-112", e_APP_PIPELINE_HASH_CUCKOO_KEY112},
 	{"hash-cuckoo-128", e_APP_PIPELINE_HASH_CUCKOO_KEY128},
+	{"swx-wm", e_APP_PIPELINE_SWX_WM},
+	{"swx-lpm", e_APP_PIPELINE_SWX_LPM},
 };
 
 int
@@ -151,6 +153,8 @@ app_parse_args(int argc, char **argv)
 		{"hash-cuckoo-96", 0, 0, 0},
 		{"hash-cuckoo-112", 0, 0, 0},
 		{"hash-cuckoo-128", 0, 0, 0},
+		{"swx-wm", 0, 0, 0},
+		{"swx-lpm", 0, 0, 0},
 		{NULL, 0, 0, 0}
 	};
 	uint32_t lcores[3], n_lcores, lcore_id, pipeline_type_provided;
@@ -141,6 +141,11 @@ app_lcore_main_loop(__rte_unused void *arg)
 			app_main_loop_worker_pipeline_lpm_ipv6();
 			return 0;
 
+		case e_APP_PIPELINE_SWX_WM:
+		case e_APP_PIPELINE_SWX_LPM:
+			app_main_loop_worker_pipeline_swx();
+			return 0;
+
 		case e_APP_PIPELINE_NONE:
 		default:
 			app_main_loop_worker();
@@ -97,6 +97,9 @@ enum {
 	e_APP_PIPELINE_HASH_CUCKOO_KEY96,
 	e_APP_PIPELINE_HASH_CUCKOO_KEY112,
 	e_APP_PIPELINE_HASH_CUCKOO_KEY128,
+
+	e_APP_PIPELINE_SWX_WM,
+	e_APP_PIPELINE_SWX_LPM,
 	e_APP_PIPELINES
 };
 
@@ -117,6 +120,7 @@ void app_main_loop_worker_pipeline_hash(void);
 void app_main_loop_worker_pipeline_acl(void);
 void app_main_loop_worker_pipeline_lpm(void);
 void app_main_loop_worker_pipeline_lpm_ipv6(void);
+void app_main_loop_worker_pipeline_swx(void);
 
 void app_main_loop_tx(void);
 
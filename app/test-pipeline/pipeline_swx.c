@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_log.h>
+#include <rte_byteorder.h>
+#include <rte_malloc.h>
+#include <rte_ring.h>
+
+#include <rte_port.h>
+#include <rte_swx_table_wm.h>
+#include <rte_swx_table_lpm.h>
+
+#include "main.h"
+
+#ifndef PIPELINE_SWX_TABLE_N_KEYS_MAX
+#define PIPELINE_SWX_TABLE_N_KEYS_MAX 1024
+#endif
+
+void
+app_main_loop_worker_pipeline_swx(void) {
+	struct rte_swx_table_params table_params = {
+		.key_size = sizeof(uint32_t),
+		.key_offset = 0,
+		.key_mask0 = NULL,
+		.action_data_size = sizeof(uint32_t),
+		.n_keys_max = PIPELINE_SWX_TABLE_N_KEYS_MAX,
+	};
+
+	struct app_mbuf_array *worker_mbuf, *worker_mbuf_out;
+	struct rte_swx_table_ops *ops;
+	void *table, *mailbox;
+	uint64_t mailbox_size;
+	uint32_t i;
+
+	switch (app.pipeline_type) {
+	case e_APP_PIPELINE_SWX_WM:
+		ops = &rte_swx_table_wildcard_match_ops;
+		table_params.match_type = RTE_SWX_TABLE_MATCH_WILDCARD;
+		break;
+
+	case e_APP_PIPELINE_SWX_LPM:
+		ops = &rte_swx_table_lpm_ops;
+		table_params.match_type = RTE_SWX_TABLE_MATCH_LPM;
+		break;
+
+	default:
+		rte_panic("Invalid SWX table type\n");
+	}
+
+	RTE_LOG(INFO, USER1, "Core %u is doing work (SWX %s table)\n",
+		rte_lcore_id(),
+		(app.pipeline_type == e_APP_PIPELINE_SWX_WM) ?
+			"wildcard match" : "LPM");
+
+	worker_mbuf = rte_malloc_socket(NULL, sizeof(struct app_mbuf_array),
+			RTE_CACHE_LINE_SIZE, rte_socket_id());
+	worker_mbuf_out = rte_malloc_socket(NULL,
+			APP_MAX_PORTS * sizeof(struct app_mbuf_array),
+			RTE_CACHE_LINE_SIZE, rte_socket_id());
+	if ((worker_mbuf == NULL) || (worker_mbuf_out == NULL))
+		rte_panic("Worker thread: cannot allocate buffer space\n");
+
+	for (i = 0; i < app.n_ports; i++)
+		worker_mbuf_out[i].n_mbufs = 0;
+
+	/* Table configuration */
+	table = ops->create(&table_params, NULL, NULL, rte_socket_id());
+	if (table == NULL)
+		rte_panic("Unable to configure the SWX table\n");
+
+	mailbox_size = ops->mailbox_size_get ? ops->mailbox_size_get() : 0;
+	mailbox = rte_zmalloc_socket(NULL, mailbox_size ? mailbox_size : 1,
+			RTE_CACHE_LINE_SIZE, rte_socket_id());
+	if (mailbox == NULL)
+		rte_panic("Worker thread: cannot allocate table mailbox\n");
+
+	/* Add entries to tables */
+	for (i = 0; i < app.n_ports; i++) {
+		uint32_t depth = 8 + __builtin_popcount(app.n_ports - 1);
+		uint32_t ip = i << (24 - __builtin_popcount(app.n_ports - 1));
+		uint32_t key = rte_cpu_to_be_32(ip);
+		uint32_t key_mask =
+			rte_cpu_to_be_32(UINT32_MAX << (32 - depth));
+		uint32_t port_out = i;
+
+		struct rte_swx_table_entry entry = {
+			.key = (uint8_t *)&key,
+			.key_mask = (uint8_t *)&key_mask,
+			.key_priority = 0,
+			.action_id = 0,
+			.action_data = (uint8_t *)&port_out,
+		};
+
+		int status;
+
+		printf("Adding rule to SWX table (IPv4 destination = %"
+			PRIu32 ".%" PRIu32 ".%" PRIu32 ".%" PRIu32 "/%" PRIu32
+			" => port out = %" PRIu32 ")\n",
+			(ip & 0xFF000000) >> 24,
+			(ip & 0x00FF0000) >> 16,
+			(ip & 0x0000FF00) >> 8,
+			ip & 0x000000FF,
+			depth,
+			i);
+
+		status = ops->add(table, &entry);
+		if (status < 0)
+			rte_panic("Unable to add entry to SWX table (%d)\n",
+				status);
+	}
+
+	/* Run-time */
+	for (i = 0; ; i = ((i + 1) & (app.n_ports - 1))) {
+		uint32_t j;
+		int ret;
+
+		ret = rte_ring_sc_dequeue_bulk(
+			app.rings_rx[i],
+			(void **) worker_mbuf->array,
+			app.burst_size_worker_read,
+			NULL);
+
+		if (ret == 0)
+			continue;
+
+		for (j = 0; j < app.burst_size_worker_read; j++) {
+			struct rte_mbuf *m = worker_mbuf->array[j];
+			struct app_mbuf_array *out;
+			uint8_t *key, *action_data;
+			uint64_t action_id;
+			uint32_t port_out;
+			int hit;
+
+			key = RTE_MBUF_METADATA_UINT8_PTR(m,
+					APP_METADATA_OFFSET(32));
+
+			while (!ops->lkp(table, mailbox, &key, &action_id,
+					 &action_data, &hit))
+				;
+
+			/* Lookup miss: drop the packet */
+			if (!hit) {
+				rte_pktmbuf_free(m);
+				continue;
+			}
+
+			memcpy(&port_out, action_data, sizeof(port_out));
+			out = &worker_mbuf_out[port_out];
+			out->array[out->n_mbufs++] = m;
+
+			if (out->n_mbufs < app.burst_size_worker_write)
+				continue;
+
+			do {
+				ret = rte_ring_sp_enqueue_bulk(
+					app.rings_tx[port_out],
+					(void **) out->array,
+					out->n_mbufs,
+					NULL);
+			} while (ret == 0);
+
+			out->n_mbufs = 0;
+		}
+	}
+}
@@ -13,8 +13,13 @@
 #include <rte_ip.h>
 #include <rte_acl.h>
 #include <rte_common.h>
+#include <rte_random.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test_acl.h"
+#include "../../lib/librte_acl/acl.h"
 
 #define	BIT_SIZEOF(x) (sizeof(x) * CHAR_BIT)
 
@@ -1716,6 +1721,430 @@ test_u32_range(void)
 	return rc;
 }
 
+#define	TEST_INC_ITER	256
+#define	TEST_INC_DELTA	8
+
+/*
+ * Compare the results of the incremental ACL with the ones of a context
+ * built from scratch with the same set of rules.
+ */
+static int
+test_inc_check(struct rte_acl_inc *inc, struct rte_acl_ctx *acx,
+	const struct acl_ipv4vlan_rule rules[], const uint8_t live[],
+	uint32_t num, const struct rte_acl_config *cfg, const uint8_t *data[],
+	uint32_t dim)
+{
+	uint32_t i, n;
+	int32_t ret;
+	uint32_t results[dim * RTE_ACL_MAX_CATEGORIES];
+	uint32_t expected[dim * RTE_ACL_MAX_CATEGORIES];
+
+	rte_acl_reset_rules(acx);
+	for (i = 0, n = 0; i != num; i++) {
+		if (live[i] == 0)
+			continue;
+		ret = rte_acl_add_rules(acx,
+			(const struct rte_acl_rule *)&rules[i], 1);
+		if (ret != 0)
+			return ret;
+		n++;
+	}
+
+	memset(expected, 0, sizeof(expected));
+	if (n != 0) {
+		ret = rte_acl_build(acx, cfg);
+		if (ret == 0)
+			ret = rte_acl_classify(acx, data, expected, dim,
+				RTE_ACL_MAX_CATEGORIES);
+		if (ret != 0) {
+			printf("Line %i: reference classify failed!\n",
+				__LINE__);
+			return ret;
+		}
+	}
+
+	ret = rte_acl_inc_classify(inc, data, results, dim,
+		RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: incremental classify failed!\n", __LINE__);
+		return ret;
+	}
+
+	for (i = 0; i != RTE_DIM(results); i++) {
+		if (results[i] != expected[i]) {
+			printf("Line %i: Error in results at %u "
+				"(expected %"PRIu32" got %"PRIu32")!\n",
+				__LINE__, i, expected[i], results[i]);
+			return -EINVAL;
+		}
+	}
+	return 0;
+}
+
+static struct rte_acl_inc *inc_reader_acl;
+static struct rte_rcu_qsbr *inc_reader_qsv;
+static uint32_t inc_reader_stop;
+static uint32_t inc_reader_errors;
+
+/* Classify continuously, reporting a quiescent state after each call */
+static int
+test_inc_reader(void *arg)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	const uint8_t *data[RTE_DIM(acl_test_data)];
+	uint32_t results[RTE_DIM(acl_test_data) * RTE_ACL_MAX_CATEGORIES];
+	uint32_t i;
+
+	RTE_SET_USED(arg);
+
+	for (i = 0; i != RTE_DIM(acl_test_data); i++)
+		data[i] = (uint8_t *)&acl_test_data[i];
+
+	rte_rcu_qsbr_thread_register(inc_reader_qsv, lcore_id);
+	rte_rcu_qsbr_thread_online(inc_reader_qsv, lcore_id);
+
+	while (__atomic_load_n(&inc_reader_stop, __ATOMIC_ACQUIRE) == 0) {
+		if (rte_acl_inc_classify(inc_reader_acl, data, results,
+				RTE_DIM(data), RTE_ACL_MAX_CATEGORIES) != 0)
+			inc_reader_errors++;
+		rte_rcu_qsbr_quiescent(inc_reader_qsv, lcore_id);
+	}
+
+	rte_rcu_qsbr_thread_offline(inc_reader_qsv, lcore_id);
+	rte_rcu_qsbr_thread_unregister(inc_reader_qsv, lcore_id);
+	return 0;
+}
+
+/* Add a rule to the incremental ACL, compacting it when full */
+static int
+test_inc_add(struct rte_acl_inc *inc, const struct acl_ipv4vlan_rule *rule)
+{
+	int32_t ret;
+
+	ret = rte_acl_inc_add_rules(inc, (const struct rte_acl_rule *)rule, 1);
+	if (ret == -ENOSPC) {
+		ret = rte_acl_inc_compact(inc);
+		if (ret == 0)
+			ret = rte_acl_inc_add_rules(inc,
+				(const struct rte_acl_rule *)rule, 1);
+	}
+	return ret;
+}
+
+/*
+ * Test incremental ACL updates: add, delete and compact rules
+ * in random order, checking the results after every update.
+ * With use_rcu, another lcore classifies concurrently.
+ */
+static int
+test_incremental(int use_rcu)
+{
+	struct rte_acl_config cfg;
+	struct rte_acl_inc_param param;
+	struct rte_acl_inc *inc;
+	struct rte_acl_ctx *acx;
+	struct rte_rcu_qsbr *v = NULL;
+	unsigned int reader_lcore = RTE_MAX_LCORE;
+	uint32_t i, k;
+	int32_t ret;
+	struct acl_ipv4vlan_rule rules[RTE_DIM(acl_test_rules)];
+	uint8_t live[RTE_DIM(acl_test_rules)];
+	const uint8_t *data[RTE_DIM(acl_test_data)];
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, RTE_ACL_MAX_CATEGORIES);
+
+	memset(&param, 0, sizeof(param));
+	param.name = "acl_inc";
+	param.socket_id = SOCKET_ID_ANY;
+	param.rule_size = RTE_ACL_IPV4VLAN_RULE_SZ;
+	param.max_rule_num = 2 * RTE_DIM(acl_test_rules);
+	param.max_delta_rule_num = TEST_INC_DELTA;
+	param.cfg = &cfg;
+
+	/* check invalid parameters */
+	param.max_delta_rule_num = 0;
+	inc = rte_acl_inc_create(&param);
+	if (inc != NULL || rte_errno != EINVAL) {
+		printf("Line %i: created incremental ACL with no delta!\n",
+			__LINE__);
+		rte_acl_inc_free(inc);
+		return -1;
+	}
+	param.max_delta_rule_num = TEST_INC_DELTA;
+
+	if (use_rcu) {
+		reader_lcore = rte_get_next_lcore(-1, 1, 0);
+		if (reader_lcore >= RTE_MAX_LCORE) {
+			printf("Not enough lcores, skipping RCU test\n");
+			return 0;
+		}
+		v = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+			RTE_CACHE_LINE_SIZE);
+		if (v == NULL || rte_rcu_qsbr_init(v, RTE_MAX_LCORE) != 0) {
+			printf("Line %i: Error creating QSBR variable!\n",
+				__LINE__);
+			rte_free(v);
+			return -1;
+		}
+		param.v = v;
+	}
+
+	inc = rte_acl_inc_create(&param);
+	acx = rte_acl_create(&acl_param);
+	if (inc == NULL || acx == NULL) {
+		printf("Line %i: Error creating ACL contexts!\n", __LINE__);
+		rte_acl_inc_free(inc);
+		rte_acl_free(acx);
+		rte_free(v);
+		return -1;
+	}
+
+	for (i = 0; i != RTE_DIM(acl_test_rules); i++)
+		acl_ipv4vlan_convert_rule(&acl_test_rules[i], &rules[i]);
+	memset(live, 0, sizeof(live));
+
+	bswap_test_data(acl_test_data, RTE_DIM(acl_test_data), 1);
+	for (i = 0; i != RTE_DIM(acl_test_data); i++)
+		data[i] = (uint8_t *)&acl_test_data[i];
+
+	if (use_rcu) {
+		inc_reader_acl = inc;
+		inc_reader_qsv = v;
+		inc_reader_stop = 0;
+		inc_reader_errors = 0;
+		rte_eal_remote_launch(test_inc_reader, NULL, reader_lcore);
+	}
+
+	/* empty ACL matches nothing */
+	ret = test_inc_check(inc, acx, rules, live, RTE_DIM(rules), &cfg,
+		data, RTE_DIM(data));
+
+	/* rules are unique and non zero userdata */
+	if (ret == 0 && (rte_acl_inc_add_rules(inc,
+			(const struct rte_acl_rule *)&rules[0], 1) != 0 ||
+			rte_acl_inc_add_rules(inc,
+			(const struct rte_acl_rule *)&rules[0], 1) != -EEXIST ||
+			rte_acl_inc_del_rules(inc, &rules[0].data.userdata,
+			1) != 0 ||
+			rte_acl_inc_del_rules(inc, &rules[0].data.userdata,
+			1) != -ENOENT)) {
+		printf("Line %i: unexpected rule add/delete result!\n",
+			__LINE__);
+		ret = -1;
+	}
+
+	/* add all rules, compacting when the delta context is full */
+	for (i = 0; i != RTE_DIM(rules) && ret == 0; i++) {
+		ret = test_inc_add(inc, &rules[i]);
+		live[i] = 1;
+		if (ret == 0)
+			ret = test_inc_check(inc, acx, rules, live,
+				RTE_DIM(rules), &cfg, data, RTE_DIM(data));
+	}
+
+	/* random updates, deleting rules from both contexts */
+	for (i = 0; i != TEST_INC_ITER && ret == 0; i++) {
+		k = rte_rand_max(RTE_DIM(rules));
+		if (live[k] != 0)
+			ret = rte_acl_inc_del_rules(inc,
+				&rules[k].data.userdata, 1);
+		else
+			ret = test_inc_add(inc, &rules[k]);
+		live[k] ^= 1;
+
+		if (ret == 0 && (i % TEST_INC_DELTA) == 0)
+			ret = rte_acl_inc_compact(inc);
+		if (ret == 0)
+			ret = test_inc_check(inc, acx, rules, live,
+				RTE_DIM(rules), &cfg, data, RTE_DIM(data));
+		if (ret != 0)
+			printf("Line %i: iter %u failed, error code: %d\n",
+				__LINE__, i, ret);
+	}
+
+	if (use_rcu) {
+		__atomic_store_n(&inc_reader_stop, 1, __ATOMIC_RELEASE);
+		rte_eal_wait_lcore(reader_lcore);
+		if (ret == 0 && inc_reader_errors != 0) {
+			printf("Line %i: concurrent classify failed!\n",
+				__LINE__);
+			ret = -1;
+		}
+	}
+
+	bswap_test_data(acl_test_data, RTE_DIM(acl_test_data), 0);
+	rte_acl_inc_free(inc);
+	rte_acl_free(acx);
+	rte_free(v);
+	return ret;
+}
+
+#define	TEST_BLD_RULES	2048
+#define	TEST_BLD_DATA	4096
+#define	TEST_BLD_LCORES	8
+
+/*
+ * Random rules with a rather large number of nodes,
+ * so that the build splits them into several tries.
+ */
+static void
+test_bld_lcores_rule(struct rte_acl_ipv4vlan_rule *rule, uint32_t i)
+{
+	uint16_t p;
+
+	memset(rule, 0, sizeof(*rule));
+	rule->data.userdata = i + 1;
+	rule->data.priority = rte_rand_max(RTE_ACL_MAX_PRIORITY) + 1;
+	rule->data.category_mask = RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES,
+		uint32_t);
+
+	rule->src_mask_len = rte_rand_max(BIT_SIZEOF(rule->src_addr) + 1);
+	rule->dst_mask_len = rte_rand_max(BIT_SIZEOF(rule->dst_addr) + 1);
+	rule->src_addr = rte_rand();
+	rule->dst_addr = rte_rand();
+
+	p = rte_rand();
+	rule->src_port_low = p;
+	rule->src_port_high = p + rte_rand_max(UINT16_MAX - p + 1);
+	p = rte_rand();
+	rule->dst_port_low = p;
+	rule->dst_port_high = p + rte_rand_max(UINT16_MAX - p + 1);
+}
+
+/*
+ * Check that a context built on the worker lcores
+ * classifies the same way as the one built on the calling thread.
+ */
+static int
+test_build_lcores(void)
+{
+	static const unsigned int bad_lcore[] = {RTE_MAX_LCORE};
+	const unsigned int main_lcore[] = {rte_get_main_lcore()};
+
+	int32_t ret;
+	uint32_t i, k, n;
+	unsigned int lcore, lcores[TEST_BLD_LCORES + 1];
+	struct rte_acl_ctx *acx[2];
+	struct rte_acl_config cfg;
+	struct rte_acl_ipv4vlan_rule *rules;
+	struct ipv4_7tuple *test_data;
+	const uint8_t **data;
+	uint32_t *results[RTE_DIM(acx)];
+
+	n = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore) {
+		if (n == TEST_BLD_LCORES)
+			break;
+		lcores[n++] = lcore;
+	}
+
+	rules = rte_malloc(NULL, TEST_BLD_RULES * sizeof(rules[0]), 0);
+	test_data = rte_malloc(NULL, TEST_BLD_DATA * sizeof(test_data[0]), 0);
+	data = rte_malloc(NULL, TEST_BLD_DATA * sizeof(data[0]), 0);
+	results[0] = rte_malloc(NULL, TEST_BLD_DATA * sizeof(results[0][0]),
+		0);
+	results[1] = rte_malloc(NULL, TEST_BLD_DATA * sizeof(results[1][0]),
+		0);
+	acx[0] = rte_acl_create(&acl_param);
+	acl_param.name = "acl_ctx_lcores";
+	acx[1] = rte_acl_create(&acl_param);
+	acl_param.name = "acl_ctx";
+
+	ret = -1;
+	if (rules == NULL || test_data == NULL || data == NULL ||
+			results[0] == NULL || results[1] == NULL ||
+			acx[0] == NULL || acx[1] == NULL) {
+		printf("Line %i: Error allocating test data!\n", __LINE__);
+		goto err;
+	}
+
+	if (rte_acl_set_ctx_build_lcores(acx[1], bad_lcore,
+			RTE_DIM(bad_lcore)) != -EINVAL ||
+			rte_acl_set_ctx_build_lcores(acx[1], main_lcore,
+			RTE_DIM(main_lcore)) != -EINVAL ||
+			rte_acl_set_ctx_build_lcores(acx[1], lcores,
+			RTE_DIM(lcores)) != -EINVAL) {
+		printf("Line %i: Invalid build lcores accepted!\n", __LINE__);
+		goto err;
+	}
+
+	ret = rte_acl_set_ctx_build_lcores(acx[1], lcores, n);
+	if (ret != 0) {
+		printf("Line %i: Error setting %u build lcores!\n",
+			__LINE__, n);
+		goto err;
+	}
+
+	for (i = 0; i != TEST_BLD_RULES; i++)
+		test_bld_lcores_rule(rules + i, i);
+
+	/* half of the input hits some rule, the other half is random */
+	for (i = 0; i != TEST_BLD_DATA; i++) {
+		k = rte_rand_max(TEST_BLD_RULES);
+		memset(test_data + i, 0, sizeof(test_data[i]));
+		test_data[i].ip_src = (i & 1) ? rte_rand() : rules[k].src_addr;
+		test_data[i].ip_dst = (i & 1) ? rte_rand() : rules[k].dst_addr;
+		test_data[i].port_src = (i & 1) ? rte_rand() :
+			rules[k].src_port_low;
+		test_data[i].port_dst = (i & 1) ? rte_rand() :
+			rules[k].dst_port_high;
+		data[i] = (uint8_t *)&test_data[i];
+	}
+	bswap_test_data(test_data, TEST_BLD_DATA, 1);
+
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, 1);
+
+	for (k = 0; k != RTE_DIM(acx); k++) {
+		ret = rte_acl_ipv4vlan_add_rules(acx[k], rules,
+			TEST_BLD_RULES);
+		if (ret == 0)
+			ret = rte_acl_build(acx[k], &cfg);
+		if (ret == 0)
+			ret = rte_acl_classify(acx[k], data, results[k],
+				TEST_BLD_DATA, 1);
+		if (ret != 0) {
+			printf("Line %i: Error building context %u, "
+				"error code: %d\n", __LINE__, k, ret);
+			goto err;
+		}
+	}
+
+	/* the parallel build has to be used, on more than one trie */
+	if (acx[1]->num_tries < 2 || acx[1]->num_tries != acx[0]->num_tries) {
+		printf("Line %i: Error, built %u tries, expected %u (> 1)!\n",
+			__LINE__, acx[1]->num_tries, acx[0]->num_tries);
+		ret = -EINVAL;
+		goto err;
+	}
+	if (n != 0 && acx[1]->num_bld_jobs == 0) {
+		printf("Line %i: Error, no job ran on the %u build lcores!\n",
+			__LINE__, n);
+		ret = -EINVAL;
+		goto err;
+	}
+
+	for (i = 0; i != TEST_BLD_DATA; i++) {
+		if (results[0][i] != results[1][i]) {
+			printf("Line %i: Error in results at %u "
+				"(expected %"PRIu32" got %"PRIu32")!\n",
+				__LINE__, i, results[0][i], results[1][i]);
+			ret = -EINVAL;
+			break;
+		}
+	}
+
+err:
+	rte_acl_free(acx[0]);
+	rte_acl_free(acx[1]);
+	rte_free(results[0]);
+	rte_free(results[1]);
+	rte_free(data);
+	rte_free(test_data);
+	rte_free(rules);
+	return ret;
+}
+
 static int
 test_acl(void)
 {
@@ -1737,6 +2166,12 @@ test_acl(void)
 		return -1;
 	if (test_u32_range() < 0)
 		return -1;
+	if (test_incremental(0) < 0)
+		return -1;
+	if (test_incremental(1) < 0)
+		return -1;
+	if (test_build_lcores() < 0)
+		return -1;
 
 	return 0;
 }
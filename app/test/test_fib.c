@@ -10,6 +10,9 @@
 #include <rte_ip.h>
 #include <rte_log.h>
 #include <rte_fib.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test.h"
 
@@ -21,6 +24,7 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_update_bulk(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
@@ -371,6 +375,140 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+#define BULK_ROUTES	4096
+#define BULK_BATCH	256
+
+static int
+check_same_lookup(struct rte_fib *fib1, struct rte_fib *fib2,
+	struct rte_fib_route_update *upd, uint32_t n)
+{
+	uint32_t ips[BULK_BATCH];
+	uint64_t nh1[BULK_BATCH], nh2[BULK_BATCH];
+	uint32_t i, j, k, mask;
+
+	for (i = 0; i < n; i += BULK_BATCH / 4) {
+		for (j = 0, k = 0; (j < BULK_BATCH / 4) && (i + j < n); j++) {
+			mask = (upd[i + j].depth == 0) ? 0 :
+				UINT32_MAX << (32 - upd[i + j].depth);
+			ips[k++] = upd[i + j].ip & mask;
+			ips[k++] = upd[i + j].ip | ~mask;
+			ips[k++] = upd[i + j].ip ^ 0x80;
+			ips[k++] = (uint32_t)rte_rand();
+		}
+		rte_fib_lookup_bulk(fib1, ips, nh1, k);
+		rte_fib_lookup_bulk(fib2, ips, nh2, k);
+		for (j = 0; j < k; j++)
+			RTE_TEST_ASSERT(nh1[j] == nh2[j],
+				"Different nexthop for ip %x\n", ips[j]);
+	}
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Apply random route updates, with duplicates and deletes, in batches
+ * to FIBs with RCU in both reclaim modes and one by one to a FIB without
+ * RCU, and check that all of them return the same nexthops.
+ * Delete all the routes in batches and check the lookups again.
+ */
+int32_t
+test_update_bulk(void)
+{
+	static struct rte_fib_route_update upd[BULK_ROUTES];
+	struct rte_fib *fib[3] = {NULL};
+	struct rte_fib_conf config;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint32_t i, j, r;
+	int ret;
+
+	qsv = rte_zmalloc(NULL, rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE),
+		RTE_CACHE_LINE_SIZE);
+	RTE_TEST_ASSERT(qsv != NULL, "Failed to allocate QSBR variable\n");
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 100;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+
+	for (i = 0; i < RTE_DIM(fib); i++) {
+		char name[64];
+
+		snprintf(name, sizeof(name), "%s_%u", __func__, i);
+		fib[i] = rte_fib_create(name, SOCKET_ID_ANY, &config);
+		RTE_TEST_ASSERT(fib[i] != NULL, "Failed to create FIB\n");
+	}
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_SYNC;
+	ret = rte_fib_rcu_qsbr_add(fib[1], &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add RCU\n");
+	ret = rte_fib_rcu_qsbr_add(fib[1], &rcu_cfg);
+	RTE_TEST_ASSERT(ret == -EEXIST, "RCU added twice\n");
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+	ret = rte_fib_rcu_qsbr_add(fib[2], &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add RCU\n");
+
+	/* most prefixes are reused from earlier updates to get merges */
+	for (i = 0; i < BULK_ROUTES; i++) {
+		r = rte_rand() % 4;
+		if ((i > 0) && (r != 0))
+			upd[i] = upd[rte_rand() % i];
+		else {
+			upd[i].ip = (uint32_t)rte_rand();
+			upd[i].depth = 8 + rte_rand() % (RTE_FIB_MAXDEPTH - 7);
+		}
+		upd[i].op = (r == 1) ? RTE_FIB_DEL : RTE_FIB_ADD;
+		upd[i].next_hop = rte_rand() % 1000;
+	}
+
+	for (i = 0; i < BULK_ROUTES; i++) {
+		if (upd[i].op == RTE_FIB_ADD)
+			ret = rte_fib_add(fib[0], upd[i].ip, upd[i].depth,
+				upd[i].next_hop);
+		else {
+			ret = rte_fib_delete(fib[0], upd[i].ip, upd[i].depth);
+			ret = (ret == -ENOENT) ? 0 : ret;
+		}
+		RTE_TEST_ASSERT(ret == 0, "Failed to update a route\n");
+	}
+	for (i = 1; i < RTE_DIM(fib); i++) {
+		for (j = 0; j < BULK_ROUTES; j += BULK_BATCH) {
+			ret = rte_fib_update_bulk(fib[i], &upd[j], BULK_BATCH);
+			RTE_TEST_ASSERT(ret == 0, "Failed to update routes\n");
+		}
+		ret = check_same_lookup(fib[0], fib[i], upd, BULK_ROUTES);
+		RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+	}
+
+	for (i = 0; i < BULK_ROUTES; i++)
+		upd[i].op = RTE_FIB_DEL;
+	for (i = 0; i < RTE_DIM(fib); i++) {
+		ret = rte_fib_update_bulk(fib[i], upd, BULK_ROUTES);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete routes\n");
+	}
+	for (i = 0; i < BULK_ROUTES; i++) {
+		upd[i].ip = (uint32_t)rte_rand();
+		upd[i].depth = RTE_FIB_MAXDEPTH;
+	}
+	ret = check_same_lookup(fib[0], fib[1], upd, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+	ret = check_same_lookup(fib[0], fib[2], upd, BULK_ROUTES);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	upd[0].op = RTE_FIB_DEL + 1;
+	ret = rte_fib_update_bulk(fib[0], upd, 1);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Invalid update accepted\n");
+
+	for (i = 0; i < RTE_DIM(fib); i++)
+		rte_fib_free(fib[i]);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib_fast_tests = {
 	.suite_name = "fib autotest",
 	.setup = NULL,
@@ -381,6 +519,7 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_update_bulk),
 	TEST_CASES_END()
 	}
 };
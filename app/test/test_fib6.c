@@ -6,8 +6,10 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <rte_memory.h>
+#include <rte_random.h>
 #include <rte_log.h>
 #include <rte_rib6.h>
 #include <rte_fib6.h>
@@ -22,10 +24,13 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_poptrie_random(void);
 
 #define MAX_ROUTES	(1 << 16)
 /** Maximum number of tbl8 for 2-byte entries */
 #define MAX_TBL8	(1 << 15)
+#define POPTRIE_NODES	(1 << 16)
+#define POPTRIE_LEAVES	(1 << 20)
 
 /*
  * Check that rte_fib6_create fails gracefully for incorrect user input
@@ -63,7 +68,7 @@ test_create_invalid(void)
 		"Call succeeded with invalid parameters\n");
 	config.max_routes = MAX_ROUTES;
 
-	config.type = RTE_FIB6_TRIE + 1;
+	config.type = RTE_FIB6_POPTRIE + 1;
 	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
@@ -82,6 +87,26 @@ test_create_invalid(void)
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
 
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.num_nodes = 0;
+	config.poptrie.num_leaves = POPTRIE_LEAVES;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+	config.poptrie.num_nodes = POPTRIE_NODES;
+
+	config.poptrie.num_leaves = 0;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+	config.poptrie.num_leaves = POPTRIE_LEAVES;
+
+	/* next hops are limited to 31 bits */
+	config.default_nh = UINT32_MAX;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
 	return TEST_SUCCESS;
 }
 
@@ -377,6 +402,122 @@ test_lookup(void)
 		"Check_fib fails for TRIE_8B type\n");
 	rte_fib6_free(fib);
 
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.num_nodes = POPTRIE_NODES;
+	config.poptrie.num_leaves = POPTRIE_LEAVES;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for POPTRIE type\n");
+	rte_fib6_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+#define RAND_ROUTES	2048
+#define RAND_LOOKUPS	4096
+
+static int
+compare_fibs(struct rte_fib6 *ref, struct rte_fib6 *fib,
+	uint8_t ips[RAND_LOOKUPS][RTE_FIB6_IPV6_ADDR_SIZE])
+{
+	static const enum rte_fib6_lookup_type types[] = {
+		RTE_FIB6_LOOKUP_POPTRIE_SCALAR,
+		RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512,
+	};
+	uint64_t ref_nh[RAND_LOOKUPS], nh[RAND_LOOKUPS];
+	unsigned int i, j;
+
+	rte_fib6_lookup_bulk(ref, ips, ref_nh, RAND_LOOKUPS);
+	for (i = 0; i < RTE_DIM(types); i++) {
+		/* vector lookup is not available on every platform */
+		if (rte_fib6_select_lookup(fib, types[i]) != 0)
+			continue;
+		/* odd number of addresses to exercise the scalar tail */
+		rte_fib6_lookup_bulk(fib, ips, nh, RAND_LOOKUPS - 3);
+		for (j = 0; j < RAND_LOOKUPS - 3; j++)
+			RTE_TEST_ASSERT(nh[j] == ref_nh[j],
+				"Lookup mismatch for address %u\n", j);
+	}
+	return TEST_SUCCESS;
+}
+
+/*
+ * Add and delete random routes clustered under a few prefixes, so that
+ * every level of the poptrie is used, and check the lookups against
+ * the TRIE type on every step
+ */
+int32_t
+test_poptrie_random(void)
+{
+	struct rte_fib6 *ref, *fib;
+	struct rte_fib6_conf config;
+	static uint8_t ips[RAND_LOOKUPS][RTE_FIB6_IPV6_ADDR_SIZE];
+	static uint8_t routes[RAND_ROUTES][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint8_t depths[RAND_ROUTES];
+	unsigned int i, j;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = 7;
+	config.type = RTE_FIB6_TRIE;
+	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config.trie.num_tbl8 = MAX_TBL8;
+	ref = rte_fib6_create("ref", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(ref != NULL, "Failed to create FIB\n");
+
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.num_nodes = POPTRIE_NODES;
+	config.poptrie.num_leaves = POPTRIE_LEAVES;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	for (i = 0; i < RAND_ROUTES; i++) {
+		for (j = 0; j < RTE_FIB6_IPV6_ADDR_SIZE; j++)
+			routes[i][j] = rte_rand();
+		/* share the first bytes between routes */
+		routes[i][0] = 0x20;
+		routes[i][1] &= 0x3;
+		depths[i] = rte_rand_max(RTE_FIB6_MAXDEPTH) + 1;
+	}
+	for (i = 0; i < RAND_LOOKUPS; i++) {
+		/* look up addresses close to the routes */
+		memcpy(ips[i], routes[rte_rand_max(RAND_ROUTES)],
+			RTE_FIB6_IPV6_ADDR_SIZE);
+		ips[i][rte_rand_max(RTE_FIB6_IPV6_ADDR_SIZE)] ^=
+			1 << rte_rand_max(8);
+	}
+
+	for (i = 0; i < RAND_ROUTES; i++) {
+		ret = rte_fib6_add(ref, routes[i], depths[i], i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = rte_fib6_add(fib, routes[i], depths[i], i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		if ((i % 64) == 0) {
+			ret = compare_fibs(ref, fib, ips);
+			RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+				"Poptrie differs from trie\n");
+		}
+	}
+	ret = compare_fibs(ref, fib, ips);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Poptrie differs from trie\n");
+
+	for (i = 0; i < RAND_ROUTES; i++) {
+		ret = rte_fib6_delete(ref, routes[i], depths[i]);
+		rte_fib6_delete(fib, routes[i], depths[i]);
+		if ((i % 64) == 0) {
+			ret = compare_fibs(ref, fib, ips);
+			RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+				"Poptrie differs from trie\n");
+		}
+	}
+	ret = compare_fibs(ref, fib, ips);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Poptrie differs from trie\n");
+
+	rte_fib6_free(fib);
+	rte_fib6_free(ref);
+
 	return TEST_SUCCESS;
 }
 
@@ -390,6 +531,7 @@ static struct unit_test_suite fib6_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_poptrie_random),
 	TEST_CASES_END()
 	}
 };
@@ -10,6 +10,7 @@
 #include <rte_cycles.h>
 #include <rte_random.h>
 #include <rte_memory.h>
+#include <rte_malloc.h>
 #include <rte_fib6.h>
 
 #include "test.h"
@@ -25,6 +26,8 @@
 #define ITERATIONS (1 << 10)
 #define BATCH_SIZE 100000
 #define NUMBER_TBL8S                                           (1 << 16)
+#define NUMBER_POPTRIE_NODES	(1 << 16)
+#define NUMBER_POPTRIE_LEAVES	(1 << 20)
 
 static void
 print_route_distribution(const struct rules_tbl_entry *table, uint32_t n)
@@ -62,40 +65,44 @@ get_max_nh(uint8_t nh_sz)
 	return ((1ULL << (bits_in_nh(nh_sz) - 1)) - 1);
 }
 
+static size_t
+get_heap_used(void)
+{
+	struct rte_malloc_socket_stats stats;
+	size_t used = 0;
+	int socket;
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (rte_malloc_get_socket_stats(socket, &stats) == 0)
+			used += stats.heap_allocsz_bytes;
+	}
+	return used;
+}
+
 static int
-test_fib6_perf(void)
+run_fib6_perf(const char *name, struct rte_fib6_conf *conf,
+	enum rte_fib6_lookup_type type, uint8_t ip_batch[][16],
+	uint64_t *next_hops)
 {
 	struct rte_fib6 *fib = NULL;
-	struct rte_fib6_conf conf;
 	uint64_t begin, total_time;
 	unsigned int i, j;
 	uint64_t next_hop_add;
 	int status = 0;
 	int64_t count = 0;
-	uint8_t ip_batch[NUM_IPS_ENTRIES][16];
-	uint64_t next_hops[NUM_IPS_ENTRIES];
-
-	conf.type = RTE_FIB6_TRIE;
-	conf.default_nh = 0;
-	conf.max_routes = 1000000;
-	conf.trie.nh_sz = RTE_FIB6_TRIE_4B;
-	conf.trie.num_tbl8 = RTE_MIN(get_max_nh(conf.trie.nh_sz), 1000000U);
-
-	rte_srand(rte_rdtsc());
+	size_t mem_used;
 
-	printf("No. routes = %u\n", (unsigned int) NUM_ROUTE_ENTRIES);
-
-	print_route_distribution(large_route_table,
-		(uint32_t)NUM_ROUTE_ENTRIES);
-
-	/* Only generate IPv6 address of each item in large IPS table,
-	 * here next_hop is not needed.
-	 */
-	generate_large_ips_table(0);
-
-	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &conf);
+	mem_used = get_heap_used();
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, conf);
 	TEST_FIB_ASSERT(fib != NULL);
 
+	if (rte_fib6_select_lookup(fib, type) != 0) {
+		printf("%s lookup is not supported, skipping\n", name);
+		rte_fib6_free(fib);
+		return 0;
+	}
+	printf("\n%s:\n", name);
+
 	/* Measure add. */
 	begin = rte_rdtsc();
 
@@ -111,14 +118,13 @@ test_fib6_perf(void)
 	printf("Unique added entries = %d\n", status);
 	printf("Average FIB Add: %g cycles\n",
 			(double)total_time / NUM_ROUTE_ENTRIES);
+	/* includes the RIB and the preallocated dataplane tables */
+	printf("Memory used: %zu KB\n", (get_heap_used() - mem_used) >> 10);
 
 	/* Measure bulk Lookup */
 	total_time = 0;
 	count = 0;
 
-	for (i = 0; i < NUM_IPS_ENTRIES; i++)
-		memcpy(ip_batch[i], large_ips_table[i].ip, 16);
-
 	for (i = 0; i < ITERATIONS; i++) {
 
 		/* Lookup per batch */
@@ -154,4 +160,51 @@ test_fib6_perf(void)
 	return 0;
 }
 
+static int
+test_fib6_perf(void)
+{
+	struct rte_fib6_conf conf;
+	unsigned int i;
+	static uint8_t ip_batch[NUM_IPS_ENTRIES][16];
+	static uint64_t next_hops[NUM_IPS_ENTRIES];
+
+	rte_srand(rte_rdtsc());
+
+	printf("No. routes = %u\n", (unsigned int) NUM_ROUTE_ENTRIES);
+
+	print_route_distribution(large_route_table,
+		(uint32_t)NUM_ROUTE_ENTRIES);
+
+	/* Only generate IPv6 address of each item in large IPS table,
+	 * here next_hop is not needed.
+	 */
+	generate_large_ips_table(0);
+
+	for (i = 0; i < NUM_IPS_ENTRIES; i++)
+		memcpy(ip_batch[i], large_ips_table[i].ip, 16);
+
+	conf.type = RTE_FIB6_TRIE;
+	conf.default_nh = 0;
+	conf.max_routes = 1000000;
+	conf.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	conf.trie.num_tbl8 = RTE_MIN(get_max_nh(conf.trie.nh_sz), 1000000U);
+
+	TEST_FIB_ASSERT(run_fib6_perf("TRIE scalar", &conf,
+		RTE_FIB6_LOOKUP_TRIE_SCALAR, ip_batch, next_hops) == 0);
+	TEST_FIB_ASSERT(run_fib6_perf("TRIE AVX512", &conf,
+		RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512, ip_batch, next_hops) == 0);
+
+	conf.type = RTE_FIB6_POPTRIE;
+	conf.poptrie.num_nodes = NUMBER_POPTRIE_NODES;
+	conf.poptrie.num_leaves = NUMBER_POPTRIE_LEAVES;
+
+	TEST_FIB_ASSERT(run_fib6_perf("POPTRIE scalar", &conf,
+		RTE_FIB6_LOOKUP_POPTRIE_SCALAR, ip_batch, next_hops) == 0);
+	TEST_FIB_ASSERT(run_fib6_perf("POPTRIE AVX512", &conf,
+		RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512, ip_batch,
+		next_hops) == 0);
+
+	return 0;
+}
+
 REGISTER_TEST_COMMAND(fib6_perf_autotest, test_fib6_perf);
@@ -11,6 +11,8 @@
 #include <rte_errno.h>
 #include <rte_graph.h>
 #include <rte_graph_worker.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_mbuf.h>
 #include <rte_mbuf_dyn.h>
 #include <rte_random.h>
@@ -771,6 +773,380 @@ test_print_stats(void)
 	return 0;
 }
 
+#define DEFER_MIN_OBJS	8
+#define DEFER_BUDGET_US	1000
+
+static void *defer_objs[RTE_GRAPH_BURST_SIZE];
+static uint16_t defer_burst;
+static uint64_t defer_calls;
+static uint64_t defer_objs_last;
+
+static uint16_t
+test_defer_src_worker(struct rte_graph *graph, struct rte_node *node,
+		      void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	if (defer_burst)
+		rte_node_enqueue(graph, node, 0, defer_objs, defer_burst);
+	return defer_burst;
+}
+
+static uint16_t
+test_defer_sink_worker(struct rte_graph *graph, struct rte_node *node,
+		       void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+	RTE_SET_USED(objs);
+
+	defer_calls++;
+	defer_objs_last = nb_objs;
+	return nb_objs;
+}
+
+static struct rte_node_register test_defer_src = {
+	.name = "test_defer_src",
+	.process = test_defer_src_worker,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_defer_sink"},
+};
+RTE_NODE_REGISTER(test_defer_src);
+
+static struct rte_node_register test_defer_sink = {
+	.name = "test_defer_sink",
+	.process = test_defer_sink_worker,
+};
+RTE_NODE_REGISTER(test_defer_sink);
+
+static int
+test_graph_sched_deferred(void)
+{
+	static const char *defer_patterns[] = {
+		"test_defer_src", "test_defer_sink",
+	};
+	struct rte_graph_param gconf = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_node_patterns = 2,
+		.node_patterns = defer_patterns,
+		.sched_mode = RTE_GRAPH_SCHED_DEFERRED,
+		.sched_min_objs = 0,
+		.sched_budget_us = DEFER_BUDGET_US,
+	};
+	struct rte_graph *graph;
+	struct rte_node *sink;
+	uint64_t calls;
+	rte_graph_t id;
+	int i, rc = -1;
+
+	/* Invalid fill levels */
+	id = rte_graph_create("worker_defer", &gconf);
+	if (id != RTE_GRAPH_ID_INVALID) {
+		printf("Graph created with no fill level\n");
+		rte_graph_destroy(id);
+		return -1;
+	}
+	gconf.sched_min_objs = RTE_GRAPH_BURST_SIZE + 1;
+	id = rte_graph_create("worker_defer", &gconf);
+	if (id != RTE_GRAPH_ID_INVALID) {
+		printf("Graph created with a fill level above burst size\n");
+		rte_graph_destroy(id);
+		return -1;
+	}
+
+	gconf.sched_min_objs = DEFER_MIN_OBJS;
+	id = rte_graph_create("worker_defer", &gconf);
+	if (id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph creation failed with error = %d\n", rte_errno);
+		return -1;
+	}
+	graph = rte_graph_lookup("worker_defer");
+	sink = rte_graph_node_get_by_name("worker_defer", "test_defer_sink");
+	if (graph == NULL || sink == NULL) {
+		printf("Graph or node lookup failed\n");
+		goto destroy;
+	}
+
+	/* The sink runs once it has accumulated the fill level */
+	defer_calls = 0;
+	defer_burst = DEFER_MIN_OBJS / 4;
+	for (i = 0; i < 3; i++)
+		rte_graph_walk(graph);
+	if (defer_calls != 0) {
+		printf("Node run below its fill level\n");
+		goto destroy;
+	}
+	rte_graph_walk(graph);
+	if (defer_calls != 1 || defer_objs_last != DEFER_MIN_OBJS) {
+		printf("Node not run at its fill level, calls = %" PRIu64
+		       " objs = %" PRIu64 "\n", defer_calls, defer_objs_last);
+		goto destroy;
+	}
+
+	/* The sink runs below its fill level after the latency budget */
+	defer_burst = 1;
+	rte_graph_walk(graph);
+	defer_burst = 0;
+	rte_delay_us(2 * DEFER_BUDGET_US);
+	rte_graph_walk(graph);
+	if (defer_calls != 2 || defer_objs_last != 1) {
+		printf("Node not run after its latency budget, calls = %"
+		       PRIu64 " objs = %" PRIu64 "\n", defer_calls,
+		       defer_objs_last);
+		goto destroy;
+	}
+
+	/* Fill histogram: one call with 1 object, one with the fill level */
+	if (rte_graph_has_stats_feature() &&
+	    (sink->fill_hist[rte_fls_u32(1)] != 1 ||
+	     sink->fill_hist[rte_fls_u32(DEFER_MIN_OBJS)] != 1)) {
+		printf("Fill histogram mismatch\n");
+		goto destroy;
+	}
+
+	/* Cycles histogram: the two calls */
+	calls = 0;
+	for (i = 0; i < RTE_GRAPH_CYCLES_HIST_SZ; i++)
+		calls += sink->cycles_hist[i];
+	if (rte_graph_has_stats_feature() && calls != 2) {
+		printf("Cycles histogram mismatch, %" PRIu64 " calls\n", calls);
+		goto destroy;
+	}
+
+	rc = 0;
+destroy:
+	rte_graph_destroy(id);
+	return rc;
+}
+
+/* More objs than the ring between two lcores holds */
+#define DSP_NB_OBJS	(32 * RTE_GRAPH_BURST_SIZE)
+#define DSP_TIMEOUT_S	5
+
+static void *dsp_objs[RTE_GRAPH_BURST_SIZE];
+static unsigned int dsp_work_lcore;
+static uint32_t dsp_sent;
+static uint32_t dsp_recv;
+static uint32_t dsp_foreign;
+static uint32_t dsp_stop;
+
+static uint16_t
+test_dsp_src_worker(struct rte_graph *graph, struct rte_node *node,
+		    void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	if (dsp_sent == DSP_NB_OBJS)
+		return 0;
+
+	rte_node_enqueue(graph, node, 0, dsp_objs, RTE_GRAPH_BURST_SIZE);
+	dsp_sent += RTE_GRAPH_BURST_SIZE;
+	return RTE_GRAPH_BURST_SIZE;
+}
+
+static uint16_t
+test_dsp_work_worker(struct rte_graph *graph, struct rte_node *node,
+		     void **objs, uint16_t nb_objs)
+{
+	if (rte_lcore_id() != dsp_work_lcore)
+		__atomic_fetch_add(&dsp_foreign, 1, __ATOMIC_RELAXED);
+
+	rte_node_enqueue(graph, node, 0, objs, nb_objs);
+	return nb_objs;
+}
+
+static uint16_t
+test_dsp_sink_worker(struct rte_graph *graph, struct rte_node *node,
+		     void **objs, uint16_t nb_objs)
+{
+	RTE_SET_USED(graph);
+	RTE_SET_USED(node);
+	RTE_SET_USED(objs);
+
+	if (rte_lcore_id() != rte_get_main_lcore())
+		__atomic_fetch_add(&dsp_foreign, 1, __ATOMIC_RELAXED);
+
+	__atomic_fetch_add(&dsp_recv, nb_objs, __ATOMIC_RELAXED);
+	return nb_objs;
+}
+
+static struct rte_node_register test_dsp_src = {
+	.name = "test_dsp_src",
+	.process = test_dsp_src_worker,
+	.flags = RTE_NODE_SOURCE_F,
+	.nb_edges = 1,
+	.next_nodes = {"test_dsp_work"},
+};
+RTE_NODE_REGISTER(test_dsp_src);
+
+static struct rte_node_register test_dsp_work = {
+	.name = "test_dsp_work",
+	.process = test_dsp_work_worker,
+	.nb_edges = 1,
+	.next_nodes = {"test_dsp_sink"},
+};
+RTE_NODE_REGISTER(test_dsp_work);
+
+static struct rte_node_register test_dsp_sink = {
+	.name = "test_dsp_sink",
+	.process = test_dsp_sink_worker,
+};
+RTE_NODE_REGISTER(test_dsp_sink);
+
+static int
+test_dsp_walk(void *arg)
+{
+	struct rte_graph *graph = arg;
+
+	while (!__atomic_load_n(&dsp_stop, __ATOMIC_ACQUIRE))
+		rte_graph_walk(graph);
+
+	return 0;
+}
+
+static int
+test_graph_sched_dispatch(void)
+{
+	static const char *dsp_patterns[] = {
+		"test_dsp_src", "test_dsp_work", "test_dsp_sink",
+	};
+	struct rte_graph_param gconf = {
+		.socket_id = SOCKET_ID_ANY,
+		.nb_node_patterns = 3,
+		.node_patterns = dsp_patterns,
+		.sched_mode = RTE_GRAPH_SCHED_DISPATCH,
+		.lcore_id = RTE_MAX_LCORE,
+	};
+	unsigned int main_lcore = rte_get_main_lcore();
+	struct rte_graph *main_graph, *work_graph;
+	struct rte_node *work, *sink;
+	rte_graph_t main_id, work_id;
+	uint64_t deadline;
+	int rc = -1;
+
+	dsp_work_lcore = rte_get_next_lcore(-1, 1, 0);
+	if (dsp_work_lcore >= RTE_MAX_LCORE) {
+		printf("At least 2 lcores needed, skipping\n");
+		return 0;
+	}
+
+	if (rte_node_lcore_affinity_set(rte_node_from_name("test_dsp_work"),
+					RTE_MAX_LCORE + 1) != -EINVAL) {
+		printf("Node affinity set to an invalid lcore\n");
+		return -1;
+	}
+	if (rte_node_lcore_affinity_set(rte_node_from_name("test_dsp_src"),
+					main_lcore) ||
+	    rte_node_lcore_affinity_set(rte_node_from_name("test_dsp_work"),
+					dsp_work_lcore) ||
+	    rte_node_lcore_affinity_set(rte_node_from_name("test_dsp_sink"),
+					main_lcore)) {
+		printf("Node affinity set failed\n");
+		return -1;
+	}
+
+	/* Invalid lcore */
+	main_id = rte_graph_create("main_dsp", &gconf);
+	if (main_id != RTE_GRAPH_ID_INVALID) {
+		printf("Graph created on an invalid lcore\n");
+		rte_graph_destroy(main_id);
+		return -1;
+	}
+
+	gconf.lcore_id = main_lcore;
+	main_id = rte_graph_create("main_dsp", &gconf);
+	if (main_id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph creation failed with error = %d\n", rte_errno);
+		return -1;
+	}
+
+	/* One graph per lcore */
+	work_id = rte_graph_create("work_dsp", &gconf);
+	if (work_id != RTE_GRAPH_ID_INVALID) {
+		printf("Two graphs created on lcore %u\n", main_lcore);
+		goto destroy_work;
+	}
+
+	gconf.lcore_id = dsp_work_lcore;
+	work_id = rte_graph_create("work_dsp", &gconf);
+	if (work_id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph creation failed with error = %d\n", rte_errno);
+		goto destroy_main;
+	}
+
+	main_graph = rte_graph_lookup("main_dsp");
+	work_graph = rte_graph_lookup("work_dsp");
+	work = rte_graph_node_get_by_name("main_dsp", "test_dsp_work");
+	sink = rte_graph_node_get_by_name("work_dsp", "test_dsp_sink");
+	if (main_graph == NULL || work_graph == NULL || work == NULL ||
+	    sink == NULL) {
+		printf("Graph or node lookup failed\n");
+		goto destroy_work;
+	}
+	if (work->dispatch_peer == NULL || sink->dispatch_peer == NULL) {
+		printf("Nodes not handed over to their lcore\n");
+		goto destroy_work;
+	}
+
+	/* main -> test_dsp_work on the worker -> test_dsp_sink on main */
+	dsp_sent = 0;
+	dsp_recv = 0;
+	dsp_foreign = 0;
+	dsp_stop = 0;
+
+	/* The stream waits on main for the ring to the stopped worker */
+	while (dsp_sent != DSP_NB_OBJS)
+		rte_graph_walk(main_graph);
+	if (dsp_foreign != 0 || work->idx == 0 ||
+	    (rte_graph_has_stats_feature() && work->dispatch_stalls == 0)) {
+		printf("Stream not kept pending on a full ring\n");
+		goto destroy_work;
+	}
+
+	rte_eal_remote_launch(test_dsp_walk, work_graph, dsp_work_lcore);
+	deadline = rte_get_timer_cycles() + DSP_TIMEOUT_S * rte_get_timer_hz();
+	while (__atomic_load_n(&dsp_recv, __ATOMIC_RELAXED) != DSP_NB_OBJS &&
+	       rte_get_timer_cycles() < deadline)
+		rte_graph_walk(main_graph);
+	__atomic_store_n(&dsp_stop, 1, __ATOMIC_RELEASE);
+	rte_eal_wait_lcore(dsp_work_lcore);
+
+	if (dsp_recv != DSP_NB_OBJS || dsp_foreign != 0) {
+		printf("Dispatch failed, %u/%u objs, %u foreign calls\n",
+		       dsp_recv, DSP_NB_OBJS, dsp_foreign);
+		goto destroy_work;
+	}
+	if (rte_graph_has_stats_feature() &&
+	    (work->dispatch_objs != DSP_NB_OBJS ||
+	     sink->dispatch_objs != DSP_NB_OBJS)) {
+		printf("Dispatch stats mismatch\n");
+		goto destroy_work;
+	}
+
+	/* The streams in flight go to the owner graph on destroy */
+	dsp_sent = 0;
+	dsp_recv = 0;
+	rte_graph_walk(main_graph);
+	work = rte_graph_node_get_by_name("work_dsp", "test_dsp_work");
+	rte_graph_destroy(main_id);
+	if (work == NULL || work->idx != RTE_GRAPH_BURST_SIZE) {
+		printf("Stream in flight lost on graph destroy\n");
+		rte_graph_destroy(work_id);
+		return -1;
+	}
+	rte_graph_destroy(work_id);
+	return 0;
+
+destroy_work:
+	rte_graph_destroy(work_id);
+destroy_main:
+	rte_graph_destroy(main_id);
+	return rc;
+}
+
 static int
 graph_setup(void)
 {
@@ -822,6 +1198,8 @@ static struct unit_test_suite graph_testsuite = {
 		TEST_CASE(test_graph_lookup_functions),
 		TEST_CASE(test_graph_walk),
 		TEST_CASE(test_print_stats),
+		TEST_CASE(test_graph_sched_deferred),
+		TEST_CASE(test_graph_sched_dispatch),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
 };
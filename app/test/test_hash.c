@@ -18,6 +18,7 @@
 #include <rte_eal.h>
 #include <rte_ip.h>
 #include <rte_string_fns.h>
+#include <rte_vect.h>
 
 #include "test.h"
 
@@ -777,6 +778,200 @@ static int test_five_keys(void)
 	return 0;
 }
 
+#define BULK_SIMD_KEYS		200
+#define BULK_SIMD_BURST		63
+
+/*
+ * Bulk lookups with the widest vector path allowed.
+ *	- create hash with the max SIMD bitwidth raised to 512 bits, with and
+ *	  without lock free concurrency
+ *	- add keys
+ *	- bulk lookup the added keys mixed with missing keys, in odd sized
+ *	  bursts: hits at the positions of the adds, misses elsewhere
+ */
+static int test_bulk_lookup_max_simd(void)
+{
+	struct rte_hash *handle = NULL;
+	struct rte_hash_parameters params = ut_params;
+	static struct flow_key bulk_keys[BULK_SIMD_KEYS * 2];
+	const void *key_array[BULK_SIMD_BURST];
+	int32_t pos[BULK_SIMD_BURST];
+	int32_t expected_pos[BULK_SIMD_KEYS];
+	void *data[BULK_SIMD_BURST];
+	const uint16_t max_simd = rte_vect_get_max_simd_bitwidth();
+	uint64_t hit_mask;
+	unsigned int lf, i, j, k, n;
+	int32_t expected;
+
+	for (i = 0; i < RTE_DIM(bulk_keys); i++) {
+		bulk_keys[i].ip_src = rte_rand();
+		bulk_keys[i].ip_dst = i;
+		bulk_keys[i].port_src = i;
+		bulk_keys[i].port_dst = ~i;
+		bulk_keys[i].proto = i;
+	}
+
+	params.name = "test_bulk_simd";
+	params.entries = 256;
+
+	for (lf = 0; lf < 2; lf++) {
+		params.extra_flag = lf ? RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF : 0;
+
+		/* The lookup path is selected at creation */
+		rte_vect_set_max_simd_bitwidth(RTE_VECT_SIMD_512);
+		handle = rte_hash_create(&params);
+		rte_vect_set_max_simd_bitwidth(max_simd);
+		RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+		for (i = 0; i < BULK_SIMD_KEYS; i++) {
+			RETURN_IF_ERROR(rte_hash_add_key_data(handle,
+				&bulk_keys[i], (void *)(uintptr_t)(i + 1)) != 0,
+				"failed to add key %u", i);
+			expected_pos[i] = rte_hash_lookup(handle,
+						&bulk_keys[i]);
+			RETURN_IF_ERROR(expected_pos[i] < 0,
+				"failed to find key (pos[%u]=%d)", i,
+				expected_pos[i]);
+		}
+
+		/* Interleave hits and misses */
+		for (i = 0; i < RTE_DIM(bulk_keys); i += n) {
+			n = RTE_MIN(RTE_DIM(bulk_keys) - i,
+					(unsigned int)BULK_SIMD_BURST);
+			for (j = 0; j < n; j++)
+				key_array[j] = &bulk_keys[(i + j) * 7 %
+							RTE_DIM(bulk_keys)];
+
+			RETURN_IF_ERROR(rte_hash_lookup_bulk(handle,
+				key_array, n, pos) != 0, "bulk lookup failed");
+			rte_hash_lookup_bulk_data(handle, key_array, n,
+				&hit_mask, data);
+
+			for (j = 0; j < n; j++) {
+				k = (i + j) * 7 % RTE_DIM(bulk_keys);
+				expected = k < BULK_SIMD_KEYS ?
+					expected_pos[k] : -ENOENT;
+				RETURN_IF_ERROR(pos[j] != expected,
+					"wrong lookup of key %u (pos=%d)",
+					k, pos[j]);
+				RETURN_IF_ERROR(!!(hit_mask & (1ULL << j)) !=
+					(k < BULK_SIMD_KEYS) ||
+					(k < BULK_SIMD_KEYS &&
+					(uintptr_t)data[j] != k + 1),
+					"wrong data lookup of key %u", k);
+			}
+		}
+
+		rte_hash_free(handle);
+		handle = NULL;
+	}
+
+	return 0;
+}
+
+#define STAGED_KEYS		256
+#define STAGED_BURST		32
+
+/*
+ * Staged bulk lookups with precomputed hash values.
+ *	- create hash with different concurrency and ext table flags
+ *	- add half of the keys with random hash values
+ *	- look up all the keys in two batches whose stages are interleaved:
+ *	  hits at the positions of the adds, misses for the other keys
+ */
+static int test_staged_lookup(void)
+{
+	static const uint8_t flags[] = {
+		0,
+		RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY,
+		RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF,
+		RTE_HASH_EXTRA_FLAGS_EXT_TABLE,
+	};
+	struct rte_hash *handle = NULL;
+	struct rte_hash_parameters params = ut_params;
+	static struct flow_key staged_keys[STAGED_KEYS];
+	static hash_sig_t staged_sig[STAGED_KEYS];
+	static int32_t expected_pos[STAGED_KEYS];
+	static struct rte_hash_lookup_staged state[2];
+	const void *key_array[2][STAGED_BURST];
+	int32_t pos[2][STAGED_BURST];
+	void *data[2][STAGED_BURST];
+	uint64_t hit_mask;
+	unsigned int f, i, j, b, k;
+	int ret;
+
+	for (i = 0; i < STAGED_KEYS; i++) {
+		staged_keys[i].ip_src = rte_rand();
+		staged_keys[i].ip_dst = i;
+		staged_keys[i].port_src = i;
+		staged_keys[i].port_dst = ~i;
+		staged_keys[i].proto = i;
+		staged_sig[i] = (hash_sig_t)rte_rand();
+	}
+
+	params.name = "test_staged";
+	params.entries = STAGED_KEYS;
+
+	for (f = 0; f < RTE_DIM(flags); f++) {
+		params.extra_flag = flags[f];
+		handle = rte_hash_create(&params);
+		RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+		for (i = 0; i < STAGED_KEYS; i += 2) {
+			RETURN_IF_ERROR(rte_hash_add_key_with_hash_data(handle,
+				&staged_keys[i], staged_sig[i],
+				(void *)(uintptr_t)(i + 1)) != 0,
+				"failed to add key %u", i);
+			expected_pos[i] = rte_hash_lookup_with_hash(handle,
+				&staged_keys[i], staged_sig[i]);
+			RETURN_IF_ERROR(expected_pos[i] < 0,
+				"failed to find key (pos[%u]=%d)", i,
+				expected_pos[i]);
+			expected_pos[i + 1] = -ENOENT;
+		}
+
+		for (i = 0; i < STAGED_KEYS; i += 2 * STAGED_BURST) {
+			for (b = 0; b < 2; b++) {
+				k = i + b * STAGED_BURST;
+				for (j = 0; j < STAGED_BURST; j++)
+					key_array[b][j] = &staged_keys[k + j];
+				ret = rte_hash_lookup_staged_prefetch(handle,
+					&staged_sig[k], STAGED_BURST,
+					&state[b]);
+				RETURN_IF_ERROR(ret != 0, "prefetch failed");
+			}
+			for (b = 0; b < 2; b++) {
+				ret = rte_hash_lookup_staged_match(handle,
+					&state[b]);
+				RETURN_IF_ERROR(ret != 0, "match failed");
+			}
+			for (b = 0; b < 2; b++) {
+				ret = rte_hash_lookup_staged_compare(handle,
+					key_array[b], &state[b], pos[b],
+					&hit_mask, data[b]);
+				RETURN_IF_ERROR(ret != STAGED_BURST / 2,
+					"wrong number of hits %d", ret);
+
+				for (j = 0; j < STAGED_BURST; j++) {
+					k = i + b * STAGED_BURST + j;
+					RETURN_IF_ERROR(pos[b][j] !=
+						expected_pos[k],
+						"wrong lookup of key %u "
+						"(pos=%d)", k, pos[b][j]);
+					RETURN_IF_ERROR(pos[b][j] >= 0 &&
+						(uintptr_t)data[b][j] != k + 1,
+						"wrong data for key %u", k);
+				}
+			}
+		}
+
+		rte_hash_free(handle);
+		handle = NULL;
+	}
+
+	return 0;
+}
+
 /*
  * Add keys to the same bucket until bucket full.
  *	- add 5 keys to the same bucket (hash created with 4 keys per bucket):
@@ -2174,6 +2369,241 @@ test_hash_rcu_qsbr_sync_mode(uint8_t ext_bkt)
 
 }
 
+#define RESIZE_INIT_ENTRIES	64
+#define RESIZE_TOTAL_KEYS	8192
+#define RESIZE_STABLE_KEYS	32
+
+static volatile uint32_t resize_reader_errors;
+
+/*
+ * Reader thread looking up keys that stay in the table while it resizes.
+ */
+static int
+test_hash_rcu_qsbr_resize_reader(void *arg)
+{
+	uint32_t key;
+	void *data;
+	int i;
+
+	RTE_SET_USED(arg);
+	/* Register this thread to report quiescent state */
+	(void)rte_rcu_qsbr_thread_register(g_qsv, 0);
+	rte_rcu_qsbr_thread_online(g_qsv, 0);
+
+	do {
+		for (i = 0; i < QSBR_REPORTING_INTERVAL; i++) {
+			key = i % RESIZE_STABLE_KEYS;
+			if (rte_hash_lookup_data(g_handle, &key, &data) < 0 ||
+					(uintptr_t)data != key + 1)
+				resize_reader_errors++;
+		}
+
+		/* Update quiescent state */
+		rte_rcu_qsbr_quiescent(g_qsv, 0);
+	} while (!writer_done);
+
+	rte_rcu_qsbr_thread_offline(g_qsv, 0);
+	(void)rte_rcu_qsbr_thread_unregister(g_qsv, 0);
+
+	return 0;
+}
+
+/*
+ * Resizable hash table functional test.
+ * 1 Reader and 1 writer. They cannot be in the same thread in this test.
+ *  - Check that the resizable flag requires lock free concurrency
+ *  - Create a small resizable hash and add RCU QSBR variable to it
+ *  - Add a few keys and launch a reader looking them up
+ *  - Add many more keys, making the table grow, and look them all up
+ *    with single and bulk lookups
+ *  - Delete most keys, making the bucket array shrink, and check that
+ *    the remaining keys are still found
+ *  - Check that the reader never missed a key
+ */
+static int
+test_hash_rcu_qsbr_resize(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_hash_rcu_qsbr_resize",
+		.entries = RESIZE_INIT_ENTRIES,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.hash_func_init_val = 0,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	uint32_t keys[RTE_HASH_LOOKUP_BULK_MAX];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	uint64_t hit_mask;
+	uint32_t i, j, key;
+	int32_t pos, ret = -1;
+	int reader_launched = 0;
+	size_t sz;
+
+	printf("\n# Running RCU QSBR resizable hash functional test\n");
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for resizable hash test, expecting at least 2\n");
+		return TEST_SKIPPED;
+	}
+
+	g_qsv = NULL;
+	writer_done = 0;
+	resize_reader_errors = 0;
+
+	g_handle = rte_hash_create(&params);
+	if (g_handle != NULL) {
+		printf("Resizable hash without lock free concurrency created\n");
+		rte_hash_free(g_handle);
+		return -1;
+	}
+
+	params.extra_flag |= RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	g_handle = rte_hash_create(&params);
+	if (g_handle == NULL) {
+		printf("Hash creation failed\n");
+		return -1;
+	}
+
+	/* Resizing needs RCU to free the old bucket arrays */
+	if (rte_hash_resize(g_handle, RESIZE_TOTAL_KEYS) != -EINVAL) {
+		printf("Resize without RCU QSBR variable did not fail\n");
+		goto end;
+	}
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	g_qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	if (g_qsv == NULL || rte_rcu_qsbr_init(g_qsv, RTE_MAX_LCORE) != 0) {
+		printf("RCU QSBR variable creation failed\n");
+		goto end;
+	}
+
+	rcu_cfg.v = g_qsv;
+	rcu_cfg.mode = RTE_HASH_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to hash table */
+	if (rte_hash_rcu_qsbr_add(g_handle, &rcu_cfg) != 0) {
+		printf("Attach RCU QSBR to hash table failed\n");
+		goto end;
+	}
+
+	for (key = 0; key < RESIZE_STABLE_KEYS; key++) {
+		pos = rte_hash_add_key_data(g_handle, &key,
+				(void *)((uintptr_t)key + 1));
+		if (pos < 0) {
+			printf("Failed to add key %u (pos=%d)\n", key, pos);
+			goto end;
+		}
+	}
+
+	/* Launch reader thread */
+	rte_eal_remote_launch(test_hash_rcu_qsbr_resize_reader, NULL,
+				rte_get_next_lcore(-1, 1, 0));
+	reader_launched = 1;
+
+	/* Grow well beyond the initial size */
+	for (key = RESIZE_STABLE_KEYS; key < RESIZE_TOTAL_KEYS; key++) {
+		pos = rte_hash_add_key_data(g_handle, &key,
+				(void *)((uintptr_t)key + 1));
+		if (pos < 0) {
+			printf("Failed to add key %u (pos=%d)\n", key, pos);
+			goto end;
+		}
+	}
+
+	if (rte_hash_count(g_handle) != RESIZE_TOTAL_KEYS) {
+		printf("Wrong key count %d after grow\n",
+			rte_hash_count(g_handle));
+		goto end;
+	}
+
+	for (i = 0; i < RESIZE_TOTAL_KEYS; i += RTE_HASH_LOOKUP_BULK_MAX) {
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++) {
+			keys[j] = i + j;
+			key_ptrs[j] = &keys[j];
+		}
+		if (rte_hash_lookup_bulk_data(g_handle, key_ptrs,
+				RTE_HASH_LOOKUP_BULK_MAX, &hit_mask, data) !=
+				RTE_HASH_LOOKUP_BULK_MAX) {
+			printf("Bulk lookup missed keys from %u\n", i);
+			goto end;
+		}
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++) {
+			if ((uintptr_t)data[j] != keys[j] + 1) {
+				printf("Wrong data for key %u\n", keys[j]);
+				goto end;
+			}
+		}
+	}
+
+	/* Complete the resize in progress, if any */
+	while (rte_hash_resize_step(g_handle, UINT32_MAX) > 0)
+		;
+
+	for (key = 0; key < RESIZE_TOTAL_KEYS; key++) {
+		if (rte_hash_lookup_data(g_handle, &key, &data[0]) < 0 ||
+				(uintptr_t)data[0] != key + 1) {
+			printf("Lookup of key %u failed after resize\n", key);
+			goto end;
+		}
+	}
+
+	if (rte_hash_resize(g_handle, RESIZE_INIT_ENTRIES) != -ENOSPC) {
+		printf("Resize below the number of keys did not fail\n");
+		goto end;
+	}
+
+	/* Delete all but the stable keys, the bucket array shrinks */
+	for (key = RESIZE_STABLE_KEYS; key < RESIZE_TOTAL_KEYS; key++) {
+		pos = rte_hash_del_key(g_handle, &key);
+		if (pos < 0) {
+			printf("Failed to delete key %u (pos=%d)\n", key, pos);
+			goto end;
+		}
+	}
+
+	while (rte_hash_resize_step(g_handle, UINT32_MAX) > 0)
+		;
+
+	for (key = 0; key < RESIZE_TOTAL_KEYS; key++) {
+		pos = rte_hash_lookup(g_handle, &key);
+		if ((key < RESIZE_STABLE_KEYS) != (pos >= 0)) {
+			printf("Wrong lookup result %d for key %u after "
+				"shrink\n", pos, key);
+			goto end;
+		}
+	}
+
+	/* Explicit resize */
+	if (rte_hash_resize(g_handle, RESIZE_TOTAL_KEYS * 2) != 0 ||
+			rte_hash_resize_step(g_handle, UINT32_MAX) != 0) {
+		printf("Explicit resize failed\n");
+		goto end;
+	}
+
+	ret = 0;
+
+end:
+	writer_done = 1;
+	/* Wait until reader exited. */
+	if (reader_launched)
+		rte_eal_mp_wait_lcore();
+
+	if (ret == 0 && resize_reader_errors != 0) {
+		printf("Reader missed keys %u times during resize\n",
+			resize_reader_errors);
+		ret = -1;
+	}
+
+	rte_hash_free(g_handle);
+	rte_free(g_qsv);
+
+	return ret;
+}
+
 /*
  * Do all unit and performance tests.
  */
@@ -2204,6 +2634,10 @@ test_hash(void)
 		return -1;
 	if (test_five_keys() < 0)
 		return -1;
+	if (test_bulk_lookup_max_simd() < 0)
+		return -1;
+	if (test_staged_lookup() < 0)
+		return -1;
 	if (test_full_bucket() < 0)
 		return -1;
 	if (test_extendable_bucket() < 0)
@@ -2250,6 +2684,9 @@ test_hash(void)
 	if (test_hash_rcu_qsbr_sync_mode(1) < 0)
 		return -1;
 
+	if (test_hash_rcu_qsbr_resize() < 0)
+		return -1;
+
 	return 0;
 }
 
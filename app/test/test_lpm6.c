@@ -9,6 +9,7 @@
 
 #include <rte_memory.h>
 #include <rte_lpm6.h>
+#include <rte_vect.h>
 
 #include "test.h"
 #include "test_lpm6_data.h"
@@ -51,6 +52,7 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -83,6 +85,7 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
 };
 
 #define MAX_DEPTH                                                    128
@@ -1770,6 +1773,70 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * Add the large route table and look up the large ips table with
+ * rte_lpm6_lookup_bulk_func, with the scalar interleaved path and with
+ * the vector path if available. The number of ips is not a multiple of the
+ * vector width to also exercise the remainder.
+ * Check that every result is equal to the one of rte_lpm6_lookup.
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	static uint8_t ip_batch[NUM_IPS_ENTRIES][16];
+	static int32_t next_hops[NUM_IPS_ENTRIES];
+	const uint16_t max_simd = rte_vect_get_max_simd_bitwidth();
+	const unsigned int n = NUM_IPS_ENTRIES - 13;
+	uint32_t next_hop_return;
+	unsigned int i, j;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	generate_large_ips_table(0);
+	for (i = 0; i < NUM_IPS_ENTRIES; i++)
+		memcpy(ip_batch[i], large_ips_table[i].ip, 16);
+
+	for (j = 0; j < 2; j++) {
+		if (j == 1)
+			rte_vect_set_max_simd_bitwidth(RTE_VECT_SIMD_512);
+
+		lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+		rte_vect_set_max_simd_bitwidth(max_simd);
+		TEST_LPM_ASSERT(lpm != NULL);
+
+		for (i = 0; i < NUM_ROUTE_ENTRIES; i++) {
+			status = rte_lpm6_add(lpm, large_route_table[i].ip,
+					large_route_table[i].depth,
+					large_route_table[i].next_hop);
+			TEST_LPM_ASSERT(status == 0);
+		}
+
+		memset(next_hops, 0, sizeof(next_hops));
+		status = rte_lpm6_lookup_bulk_func(lpm, ip_batch, next_hops, n);
+		TEST_LPM_ASSERT(status == 0);
+
+		for (i = 0; i < n; i++) {
+			status = rte_lpm6_lookup(lpm, ip_batch[i],
+					&next_hop_return);
+			if (status == 0)
+				TEST_LPM_ASSERT(next_hops[i] ==
+						(int32_t)next_hop_return);
+			else
+				TEST_LPM_ASSERT(next_hops[i] == -1);
+		}
+		TEST_LPM_ASSERT(next_hops[n] == 0);
+
+		rte_lpm6_free(lpm);
+	}
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
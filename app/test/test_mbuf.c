@@ -10,6 +10,11 @@
 #include <inttypes.h>
 #include <errno.h>
 #include <sys/queue.h>
+#ifdef RTE_EXEC_ENV_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 #include <rte_common.h>
 #include <rte_errno.h>
@@ -886,6 +891,38 @@ test_pktmbuf_pool_bulk(void)
 		goto err;
 	}
 
+	printf("Test bulk free of interleaved mbufs from multiple pools.\n");
+
+	/* Allocate single segment mbufs, alternating between the pools. */
+	for (i = 0; i < NB_MBUF; i++) {
+		mbufs[i] = rte_pktmbuf_alloc((i & 1) ? pool2 : pool);
+		if (mbufs[i] == NULL) {
+			printf("rte_pktmbuf_alloc() failed (%u)\n", i);
+			goto err;
+		}
+	}
+	/* Hold an extra reference on the first mbuf. */
+	rte_mbuf_refcnt_update(mbufs[0], 1);
+	m = mbufs[0];
+	/* Free all mbufs in one go. */
+	rte_pktmbuf_free_bulk(mbufs, NB_MBUF);
+	/* Test that all but the referenced mbuf have been returned. */
+	if (!(rte_mempool_avail_count(pool) == NB_MBUF - 1 &&
+			rte_mempool_full(pool2))) {
+		printf("interleaved mbufs have not been returned\n");
+		goto err;
+	}
+	if (rte_mbuf_refcnt_read(m) != 1) {
+		printf("referenced mbuf has bad refcnt\n");
+		goto err;
+	}
+	/* Release the last reference. */
+	rte_pktmbuf_free_bulk(&m, 1);
+	if (!(rte_mempool_full(pool) && rte_mempool_full(pool2))) {
+		printf("mempools not full\n");
+		goto err;
+	}
+
 	ret = 0;
 	goto done;
 
@@ -899,6 +936,81 @@ test_pktmbuf_pool_bulk(void)
 	return ret;
 }
 
+/*
+ * Test the mbuf pool with data buffers in a memfd: the data written in a
+ * mbuf must be visible through a separate mapping of the memfd, at the
+ * offset given by rte_pktmbuf_memfd_offset().
+ */
+static int
+test_pktmbuf_pool_memfd(void)
+{
+#if defined(RTE_EXEC_ENV_LINUX) && defined(F_ADD_SEALS)
+	struct rte_pktmbuf_memfd mfd;
+	struct rte_mempool *pool;
+	struct rte_mbuf *m = NULL;
+	size_t page_sz = (size_t)sysconf(_SC_PAGESIZE);
+	void *map = MAP_FAILED;
+	char *data;
+	unsigned int i;
+	int seals;
+
+	pool = rte_pktmbuf_pool_create_memfd("test_pktmbuf_memfd", NB_MBUF,
+			MEMPOOL_CACHE_SIZE, 0, MBUF_DATA_SIZE, SOCKET_ID_ANY,
+			page_sz, &mfd);
+	if (pool == NULL && rte_errno == ENOTSUP) {
+		printf("memfd not supported, skipping\n");
+		return 0;
+	}
+	if (pool == NULL)
+		GOTO_FAIL("%s: cannot create memfd pool", __func__);
+	if (mfd.len < (size_t)NB_MBUF * MBUF_DATA_SIZE)
+		GOTO_FAIL("%s: memfd too small", __func__);
+
+	seals = fcntl(mfd.fd, F_GET_SEALS);
+	if (seals < 0 || (seals & (F_SEAL_SHRINK | F_SEAL_GROW)) !=
+			(F_SEAL_SHRINK | F_SEAL_GROW))
+		GOTO_FAIL("%s: memfd not sealed", __func__);
+
+	/* map the memfd as a consumer process would do */
+	map = mmap(NULL, mfd.len, PROT_READ, MAP_SHARED, mfd.fd, 0);
+	if (map == MAP_FAILED)
+		GOTO_FAIL("%s: cannot map memfd", __func__);
+
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL)
+		GOTO_FAIL("%s: cannot allocate mbuf", __func__);
+	if (!RTE_MBUF_HAS_PINNED_EXTBUF(m))
+		GOTO_FAIL("%s: mbuf has no pinned external buffer", __func__);
+	data = rte_pktmbuf_append(m, MBUF_TEST_DATA_LEN);
+	if (data == NULL)
+		GOTO_FAIL("%s: cannot append data", __func__);
+	for (i = 0; i < MBUF_TEST_DATA_LEN; i++)
+		data[i] = (char)i;
+
+	if (rte_pktmbuf_memfd_offset(&mfd, m) + MBUF_TEST_DATA_LEN > mfd.len)
+		GOTO_FAIL("%s: data offset out of the memfd", __func__);
+	if (memcmp(RTE_PTR_ADD(map, rte_pktmbuf_memfd_offset(&mfd, m)),
+			data, MBUF_TEST_DATA_LEN) != 0)
+		GOTO_FAIL("%s: data differs in the memfd mapping", __func__);
+
+	rte_pktmbuf_free(m);
+	munmap(map, mfd.len);
+	rte_pktmbuf_pool_free_memfd(pool, &mfd);
+	return 0;
+
+fail:
+	rte_pktmbuf_free(m);
+	if (map != MAP_FAILED)
+		munmap(map, mfd.len);
+	if (pool != NULL)
+		rte_pktmbuf_pool_free_memfd(pool, &mfd);
+	return -1;
+#else
+	printf("memfd not supported, skipping\n");
+	return 0;
+#endif
+}
+
 /*
  * test that the pointer to the data on a packet mbuf is set properly
  */
@@ -2732,6 +2844,12 @@ test_mbuf(void)
 		goto err;
 	}
 
+	/* test mbuf pool with data buffers in a memfd */
+	if (test_pktmbuf_pool_memfd() < 0) {
+		printf("test_pktmbuf_pool_memfd() failed\n");
+		goto err;
+	}
+
 	/* test that the pointer to the data on a packet mbuf is set properly */
 	if (test_pktmbuf_pool_ptr(pktmbuf_pool) < 0) {
 		printf("test_pktmbuf_pool_ptr() failed\n");
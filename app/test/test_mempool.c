@@ -27,6 +27,9 @@
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
 #include <rte_mbuf.h>
+#ifdef RTE_MEMPOOL_NUMA
+#include <rte_mempool_numa.h>
+#endif
 
 #include "test.h"
 
@@ -474,6 +477,163 @@ test_mp_mem_init(struct rte_mempool *mp,
 	data->ret = 0;
 }
 
+/*
+ * Check that an adaptive cache grows when its lcore only gets objects,
+ * then only puts them back, or when its gets bypass it, and stays within
+ * its bounds.
+ */
+static int
+test_mempool_cache_adaptive(struct rte_mempool *mp_nocache)
+{
+	struct rte_mempool_cache *cache;
+	struct rte_mempool *mp;
+	unsigned int i, max;
+	void **objs;
+	int ret = -1;
+
+	max = MEMPOOL_SIZE / 2;
+	objs = rte_malloc(NULL, max * sizeof(objs[0]), 0);
+	mp = rte_mempool_create("test_cache_adaptive", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, 32, 0, NULL, NULL, my_obj_init, NULL,
+		SOCKET_ID_ANY, 0);
+	if (objs == NULL || mp == NULL)
+		GOTO_ERR(ret, err);
+
+	if (rte_mempool_cache_set_adaptive(mp_nocache, 8, 64) != -EINVAL ||
+			rte_mempool_cache_set_adaptive(mp, 0, 64) != -EINVAL ||
+			rte_mempool_cache_set_adaptive(mp, 64, 128) != -EINVAL ||
+			rte_mempool_cache_set_adaptive(mp, 8, 16) != -EINVAL ||
+			rte_mempool_cache_set_adaptive(mp, 8,
+				RTE_MEMPOOL_CACHE_MAX_SIZE + 1) != -EINVAL)
+		GOTO_ERR(ret, err);
+
+	if (rte_mempool_cache_set_adaptive(mp, 8, 128) != 0)
+		GOTO_ERR(ret, err);
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache == NULL)
+		GOTO_ERR(ret, err);
+
+	/* get heavy, then put heavy */
+	for (i = 0; i + 4 <= max; i += 4) {
+		if (rte_mempool_get_bulk(mp, objs + i, 4) < 0)
+			GOTO_ERR(ret, err);
+	}
+	for (i = 0; i + 4 <= max; i += 4)
+		rte_mempool_put_bulk(mp, objs + i, 4);
+
+	rte_mempool_dump(stdout, mp);
+	if (cache->nb_grow == 0 || cache->size <= 32 || cache->size > 128)
+		GOTO_ERR(ret, err);
+
+	/*
+	 * a cache shrunk below the bulk size is bypassed by the gets,
+	 * which still have to grow it back
+	 */
+	cache->size = 8;
+	cache->flushthresh = RTE_MEMPOOL_CACHE_FLUSHTHRESH(cache->size);
+	for (i = 0; i < 4 * RTE_MEMPOOL_CACHE_ADAPT_WINDOW; i++) {
+		if (rte_mempool_get_bulk(mp, objs, 32) < 0)
+			GOTO_ERR(ret, err);
+		rte_mempool_generic_put(mp, objs, 32, NULL);
+	}
+	if (cache->size <= 32)
+		GOTO_ERR(ret, err);
+
+	/* disabling the adaptive mode restores the size */
+	if (rte_mempool_cache_set_adaptive(mp, 0, 0) != 0 ||
+			cache->size != 32)
+		GOTO_ERR(ret, err);
+
+	if (rte_mempool_avail_count(mp) != mp->size)
+		GOTO_ERR(ret, err);
+
+	ret = 0;
+err:
+	rte_mempool_free(mp);
+	rte_free(objs);
+	return ret;
+}
+
+#ifdef RTE_MEMPOOL_NUMA
+/*
+ * Check that the objects of the NUMA sharded handlers are accounted
+ * to the sub-pool of their socket.
+ */
+static int
+test_mempool_numa(const char *ops_name)
+{
+	struct rte_mempool_numa_stats stats;
+	struct rte_mempool *mp;
+	unsigned int i, n;
+	void **objs;
+	int socket_id;
+	int ret = -1;
+
+	printf("Testing %s mempool handler\n", ops_name);
+
+	objs = rte_malloc(NULL, MEMPOOL_SIZE * sizeof(objs[0]), 0);
+	mp = rte_mempool_create_empty("test_numa", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, 0, 0, SOCKET_ID_ANY, 0);
+	if (objs == NULL || mp == NULL)
+		GOTO_ERR(ret, err);
+
+	if (rte_mempool_numa_stats_get(mp, 0, &stats) != -EINVAL)
+		GOTO_ERR(ret, err);
+
+	if (rte_mempool_set_ops_byname(mp, ops_name, NULL) < 0 ||
+			rte_mempool_populate_default(mp) < 0)
+		GOTO_ERR(ret, err);
+	rte_mempool_obj_iter(mp, my_obj_init, NULL);
+
+	if (test_mempool_basic(mp, 0) < 0)
+		GOTO_ERR(ret, err);
+
+	if (rte_mempool_numa_stats_reset(mp) != 0 ||
+			rte_mempool_numa_stats_get(mp, -1, &stats) != -ENOENT)
+		GOTO_ERR(ret, err);
+
+	/* all the objects are in the sub-pools of their sockets */
+	n = 0;
+	for (i = 0; i != rte_socket_count(); i++) {
+		socket_id = rte_socket_id_by_idx(i);
+		if (rte_mempool_numa_stats_get(mp, socket_id, &stats) != 0)
+			GOTO_ERR(ret, err);
+		n += stats.count;
+	}
+	if (n != mp->size)
+		GOTO_ERR(ret, err);
+
+	/* get them all, then put them back */
+	if (rte_mempool_get_bulk(mp, objs, mp->size) < 0)
+		GOTO_ERR(ret, err);
+	if (rte_mempool_get(mp, objs) == 0)
+		GOTO_ERR(ret, err);
+	rte_mempool_put_bulk(mp, objs, mp->size);
+
+	for (i = 0; i != rte_socket_count(); i++) {
+		socket_id = rte_socket_id_by_idx(i);
+		if (rte_mempool_numa_stats_get(mp, socket_id, &stats) != 0)
+			GOTO_ERR(ret, err);
+		if (stats.local_get + stats.remote_get !=
+				stats.local_put + stats.remote_put)
+			GOTO_ERR(ret, err);
+		if (socket_id == (int)rte_socket_id() &&
+				stats.remote_get + stats.remote_put != 0)
+			GOTO_ERR(ret, err);
+		n -= stats.local_get + stats.remote_get;
+	}
+	if (n != 0 || rte_mempool_avail_count(mp) != mp->size)
+		GOTO_ERR(ret, err);
+
+	ret = 0;
+err:
+	rte_mempool_free(mp);
+	rte_free(objs);
+	return ret;
+}
+#endif
+
 static int
 test_mempool(void)
 {
@@ -643,6 +803,9 @@ test_mempool(void)
 	if (test_mempool_same_name_twice_creation() < 0)
 		GOTO_ERR(ret, err);
 
+	if (test_mempool_cache_adaptive(mp_nocache) < 0)
+		GOTO_ERR(ret, err);
+
 	/* test the stack handler */
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		GOTO_ERR(ret, err);
@@ -650,6 +813,15 @@ test_mempool(void)
 	if (test_mempool_basic(default_pool, 1) < 0)
 		GOTO_ERR(ret, err);
 
+#ifdef RTE_MEMPOOL_NUMA
+	/* test the NUMA sharded handlers */
+	if (test_mempool_numa("numa_stack") < 0)
+		GOTO_ERR(ret, err);
+
+	if (test_mempool_numa("numa_lf_stack") < 0)
+		GOTO_ERR(ret, err);
+#endif
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -7,7 +7,11 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <rte_errno.h>
 #include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
 #include <rte_rib.h>
 
 #include "test.h"
@@ -21,6 +25,9 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_rcu_qsbr_add(void);
+static int32_t test_rcu_qsbr_reclaim(void);
+static int32_t test_rcu_qsbr_concurrent(void);
 
 #define MAX_DEPTH 32
 #define MAX_RULES (1 << 22)
@@ -323,6 +330,287 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * rte_rib_rcu_qsbr_add positive and negative tests
+ */
+int32_t
+test_rcu_qsbr_add(void)
+{
+	struct rte_rib *rib = NULL;
+	struct rte_rib_conf config;
+	struct rte_rib_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	size_t sz;
+	int ret;
+
+	config.max_nodes = MAX_RULES;
+	config.ext_sz = 0;
+
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Failed to allocate QSBR variable\n");
+	ret = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(ret == 0, "Failed to init QSBR variable\n");
+
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret != 0, "Call succeeded with invalid parameters\n");
+
+	rcu_cfg.v = qsv;
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret != 0, "Call succeeded with invalid parameters\n");
+
+	rcu_cfg.mode = RTE_RIB_QSBR_MODE_DQ;
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add QSBR variable\n");
+
+	rcu_cfg.mode = RTE_RIB_QSBR_MODE_SYNC;
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT((ret != 0) && (rte_errno == EEXIST),
+		"QSBR variable added twice\n");
+
+	rte_rib_free(rib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * RCU defer queue mode with the reader and the writer in the same thread.
+ * A removed node stays readable and is not reused until the reader
+ * reports a quiescent state.
+ */
+int32_t
+test_rcu_qsbr_reclaim(void)
+{
+	struct rte_rib *rib = NULL;
+	struct rte_rib_node *node, *node2;
+	struct rte_rib_conf config;
+	struct rte_rib_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint32_t ip = RTE_IPV4(192, 0, 2, 0);
+	uint32_t ip2 = RTE_IPV4(198, 51, 100, 0);
+	uint64_t nh;
+	uint8_t depth = 24, depth_ret;
+	size_t sz;
+	int ret;
+
+	/* only one node, so that it can not be reused before reclaim */
+	config.max_nodes = 1;
+	config.ext_sz = 0;
+
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Failed to allocate QSBR variable\n");
+	ret = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to init QSBR variable\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_RIB_QSBR_MODE_DQ;
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add QSBR variable\n");
+
+	node = rte_rib_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node != NULL, "Failed to insert rule\n");
+	rte_rib_set_nh(node, 10);
+
+	/* Register pseudo reader */
+	ret = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(ret == 0, "Failed to register reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	node = rte_rib_lookup(rib, ip);
+	RTE_TEST_ASSERT(node != NULL, "Failed to lookup\n");
+
+	/* Writer update */
+	rte_rib_remove(rib, ip, depth);
+	RTE_TEST_ASSERT(rte_rib_lookup(rib, ip) == NULL,
+		"Lookup returns removed rule\n");
+
+	node2 = rte_rib_insert(rib, ip2, depth);
+	RTE_TEST_ASSERT(node2 == NULL,
+		"Node reused before the reader quiescent state\n");
+
+	ret = rte_rib_get_nh(node, &nh);
+	RTE_TEST_ASSERT((ret == 0) && (nh == 10),
+		"Removed node is not readable\n");
+	ret = rte_rib_get_depth(node, &depth_ret);
+	RTE_TEST_ASSERT((ret == 0) && (depth_ret == depth),
+		"Removed node is not readable\n");
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	node2 = rte_rib_insert(rib, ip2, depth);
+	RTE_TEST_ASSERT(node2 != NULL, "Failed to insert rule\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	ret = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(ret == 0, "Failed to unregister reader\n");
+
+	rte_rib_free(rib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+#define RCU_PREFIX		RTE_IPV4(10, 0, 0, 0)
+#define RCU_PREFIX_DEPTH	8
+#define RCU_ROUTES		32
+#define RCU_WRITER_ITERATIONS	(1 << 14)
+#define RCU_READER_LOOKUPS	64
+
+static struct rte_rib *g_rib;
+static struct rte_rcu_qsbr *g_v;
+static volatile uint8_t writer_done;
+static uint32_t reader_errors;
+
+/* Check that a node got from the reader was not reused for another route */
+static int
+check_node(struct rte_rib_node *node, uint32_t ip, uint8_t depth)
+{
+	uint32_t node_ip;
+	uint8_t node_depth;
+	uint64_t nh;
+
+	rte_rib_get_ip(node, &node_ip);
+	rte_rib_get_depth(node, &node_depth);
+	rte_rib_get_nh(node, &nh);
+	if ((node_depth < depth) ||
+			(((ip ^ node_ip) & rte_rib_depth_to_mask(depth)) != 0))
+		return -1;
+	/* next hop is set by the writer after the insertion */
+	if ((nh != 0) && (nh != ((uint64_t)node_ip << 8 | node_depth)))
+		return -1;
+	return 0;
+}
+
+static int
+test_rcu_reader(void *arg)
+{
+	struct rte_rib_node *node;
+	unsigned int lcore_id = rte_lcore_id();
+	uint32_t ip;
+	int i;
+
+	RTE_SET_USED(arg);
+
+	rte_rcu_qsbr_thread_register(g_v, lcore_id);
+	rte_rcu_qsbr_thread_online(g_v, lcore_id);
+
+	do {
+		for (i = 0; i < RCU_READER_LOOKUPS; i++) {
+			ip = RCU_PREFIX | (rte_rand() &
+				~rte_rib_depth_to_mask(RCU_PREFIX_DEPTH));
+			node = rte_rib_lookup(g_rib, ip);
+			if ((node != NULL) && (check_node(node, ip, 0) != 0 ||
+					check_node(node, RCU_PREFIX,
+					RCU_PREFIX_DEPTH) != 0))
+				reader_errors++;
+		}
+		/* walk the routes, as a diagnostic dump would do */
+		node = NULL;
+		while ((node = rte_rib_get_nxt(g_rib, RCU_PREFIX,
+				RCU_PREFIX_DEPTH, node,
+				RTE_RIB_GET_NXT_ALL)) != NULL) {
+			if (check_node(node, RCU_PREFIX,
+					RCU_PREFIX_DEPTH) != 0)
+				reader_errors++;
+		}
+		rte_rcu_qsbr_quiescent(g_v, lcore_id);
+	} while (!writer_done);
+
+	rte_rcu_qsbr_thread_offline(g_v, lcore_id);
+	rte_rcu_qsbr_thread_unregister(g_v, lcore_id);
+
+	return 0;
+}
+
+/*
+ * A reader thread looks up and walks the RIB while the writer keeps
+ * inserting and removing routes, with a node pool small enough to have
+ * nodes reused all the time.
+ */
+int32_t
+test_rcu_qsbr_concurrent(void)
+{
+	struct rte_rib_conf config;
+	struct rte_rib_rcu_config rcu_cfg = {0};
+	struct rte_rib_node *node;
+	uint32_t ips[RCU_ROUTES] = {0};
+	uint8_t depths[RCU_ROUTES] = {0};
+	unsigned int reader_lcore, i, r;
+	size_t sz;
+	int ret;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for %s, expecting at least 2\n",
+			__func__);
+		return TEST_SKIPPED;
+	}
+
+	config.max_nodes = 2 * RCU_ROUTES;
+	config.ext_sz = 0;
+	g_rib = rte_rib_create("rcu_rib", SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(g_rib != NULL, "Failed to create RIB\n");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	g_v = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(g_v != NULL, "Failed to allocate QSBR variable\n");
+	rte_rcu_qsbr_init(g_v, RTE_MAX_LCORE);
+
+	rcu_cfg.v = g_v;
+	rcu_cfg.mode = RTE_RIB_QSBR_MODE_DQ;
+	ret = rte_rib_rcu_qsbr_add(g_rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add QSBR variable\n");
+
+	writer_done = 0;
+	reader_errors = 0;
+	reader_lcore = rte_get_next_lcore(-1, 1, 0);
+	rte_eal_remote_launch(test_rcu_reader, NULL, reader_lcore);
+
+	for (i = 0; i < RCU_WRITER_ITERATIONS; i++) {
+		r = rte_rand_max(RCU_ROUTES);
+		if (depths[r] != 0) {
+			rte_rib_remove(g_rib, ips[r], depths[r]);
+			depths[r] = 0;
+			continue;
+		}
+		depths[r] = RCU_PREFIX_DEPTH + 1 +
+			rte_rand_max(MAX_DEPTH - RCU_PREFIX_DEPTH);
+		ips[r] = (RCU_PREFIX | (rte_rand() &
+			~rte_rib_depth_to_mask(RCU_PREFIX_DEPTH))) &
+			rte_rib_depth_to_mask(depths[r]);
+		node = rte_rib_insert(g_rib, ips[r], depths[r]);
+		if (node == NULL) {
+			/* duplicated route or no node reclaimed yet */
+			depths[r] = 0;
+			continue;
+		}
+		rte_rib_set_nh(node, (uint64_t)ips[r] << 8 | depths[r]);
+	}
+	writer_done = 1;
+	rte_eal_wait_lcore(reader_lcore);
+
+	rte_rib_free(g_rib);
+	rte_free(g_v);
+
+	RTE_TEST_ASSERT(reader_errors == 0,
+		"Reader got %u reused nodes\n", reader_errors);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib_tests = {
 	.suite_name = "rib autotest",
 	.setup = NULL,
@@ -334,6 +622,9 @@ static struct unit_test_suite rib_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_rcu_qsbr_add),
+		TEST_CASE(test_rcu_qsbr_reclaim),
+		TEST_CASE(test_rcu_qsbr_concurrent),
 		TEST_CASES_END()
 	}
 };
@@ -7,7 +7,9 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <rte_errno.h>
 #include <rte_ip.h>
+#include <rte_malloc.h>
 #include <rte_rib6.h>
 
 #include "test.h"
@@ -21,6 +23,8 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_rcu_qsbr_add(void);
+static int32_t test_rcu_qsbr_reclaim(void);
 
 #define MAX_DEPTH 128
 #define MAX_RULES (1 << 22)
@@ -328,6 +332,141 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * rte_rib6_rcu_qsbr_add positive and negative tests
+ */
+int32_t
+test_rcu_qsbr_add(void)
+{
+	struct rte_rib6 *rib = NULL;
+	struct rte_rib6_conf config;
+	struct rte_rib6_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	size_t sz;
+	int ret;
+
+	config.max_nodes = MAX_RULES;
+	config.ext_sz = 0;
+
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Failed to allocate QSBR variable\n");
+	ret = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(ret == 0, "Failed to init QSBR variable\n");
+
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret != 0, "Call succeeded with invalid parameters\n");
+
+	rcu_cfg.v = qsv;
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret != 0, "Call succeeded with invalid parameters\n");
+
+	rcu_cfg.mode = RTE_RIB6_QSBR_MODE_DQ;
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add QSBR variable\n");
+
+	rcu_cfg.mode = RTE_RIB6_QSBR_MODE_SYNC;
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT((ret != 0) && (rte_errno == EEXIST),
+		"QSBR variable added twice\n");
+
+	rte_rib6_free(rib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * RCU defer queue mode with the reader and the writer in the same thread.
+ * A removed node stays readable and is not reused until the reader
+ * reports a quiescent state.
+ */
+int32_t
+test_rcu_qsbr_reclaim(void)
+{
+	struct rte_rib6 *rib = NULL;
+	struct rte_rib6_node *node, *node2;
+	struct rte_rib6_conf config;
+	struct rte_rib6_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE] = {0x20, 0x01, 0x0d, 0xb8, 0, 0,
+						0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t ip2[RTE_RIB6_IPV6_ADDR_SIZE] = {0x20, 0x01, 0x0d, 0xb9, 0, 0,
+						0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	uint64_t nh;
+	uint8_t depth = 32, depth_ret;
+	size_t sz;
+	int ret;
+
+	/* only one node, so that it can not be reused before reclaim */
+	config.max_nodes = 1;
+	config.ext_sz = 0;
+
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Failed to allocate QSBR variable\n");
+	ret = rte_rcu_qsbr_init(qsv, 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to init QSBR variable\n");
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_RIB6_QSBR_MODE_DQ;
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add QSBR variable\n");
+
+	node = rte_rib6_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node != NULL, "Failed to insert rule\n");
+	rte_rib6_set_nh(node, 10);
+
+	/* Register pseudo reader */
+	ret = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(ret == 0, "Failed to register reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	node = rte_rib6_lookup(rib, ip);
+	RTE_TEST_ASSERT(node != NULL, "Failed to lookup\n");
+
+	/* Writer update */
+	rte_rib6_remove(rib, ip, depth);
+	RTE_TEST_ASSERT(rte_rib6_lookup(rib, ip) == NULL,
+		"Lookup returns removed rule\n");
+
+	node2 = rte_rib6_insert(rib, ip2, depth);
+	RTE_TEST_ASSERT(node2 == NULL,
+		"Node reused before the reader quiescent state\n");
+
+	ret = rte_rib6_get_nh(node, &nh);
+	RTE_TEST_ASSERT((ret == 0) && (nh == 10),
+		"Removed node is not readable\n");
+	ret = rte_rib6_get_depth(node, &depth_ret);
+	RTE_TEST_ASSERT((ret == 0) && (depth_ret == depth),
+		"Removed node is not readable\n");
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	node2 = rte_rib6_insert(rib, ip2, depth);
+	RTE_TEST_ASSERT(node2 != NULL, "Failed to insert rule\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	ret = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	RTE_TEST_ASSERT(ret == 0, "Failed to unregister reader\n");
+
+	rte_rib6_free(rib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib6_tests = {
 	.suite_name = "rib6 autotest",
 	.setup = NULL,
@@ -339,6 +478,8 @@ static struct unit_test_suite rib6_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_rcu_qsbr_add),
+		TEST_CASE(test_rcu_qsbr_reclaim),
 		TEST_CASES_END()
 	}
 };
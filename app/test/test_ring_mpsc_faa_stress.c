@@ -0,0 +1,47 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+/* MPSC FAA ring memory is sized by rte_ring_create() */
+#define RING_STRESS_CREATE_FLAGS	RING_F_MPSC_FAA
+
+#include "test_ring_stress_impl.h"
+
+/*
+ * All workers enqueue concurrently through the generic ring API, while
+ * the dequeues are serialized, as the ring has a single consumer.
+ * A producer preempted between its slot reservation and its publication
+ * holds back the consumer, while the other producers keep going: wait for
+ * the reserved objects to be published.
+ */
+static inline uint32_t
+_st_ring_dequeue_bulk(struct rte_ring *r, void **obj, uint32_t n,
+	uint32_t *avail)
+{
+	uint32_t m;
+
+	static rte_spinlock_t lck = RTE_SPINLOCK_INITIALIZER;
+
+	rte_spinlock_lock(&lck);
+	for (;;) {
+		m = rte_ring_dequeue_bulk(r, obj, n, avail);
+		if (m != 0 || rte_ring_count(r) < n)
+			break;
+		rte_pause();
+	}
+	rte_spinlock_unlock(&lck);
+	return m;
+}
+
+static inline uint32_t
+_st_ring_enqueue_bulk(struct rte_ring *r, void * const *obj, uint32_t n,
+	uint32_t *free)
+{
+	return rte_ring_enqueue_bulk(r, obj, n, free);
+}
+
+const struct test test_ring_mpsc_faa_stress = {
+	.name = "MPSC_FAA",
+	.nb_case = RTE_DIM(tests),
+	.cases = tests,
+};
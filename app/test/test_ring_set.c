@@ -0,0 +1,302 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+#include <rte_ring_set.h>
+
+#include "test.h"
+
+#define RING_SET_NB_RINGS	200
+#define RING_SIZE		256
+#define RING_SET_BURST		8
+
+#define RING_SET_MT_NB_OBJS	(1 << 16)
+#define RING_SET_MT_TIMEOUT_S	30
+
+static struct rte_ring *rings[RING_SET_NB_RINGS];
+
+/* encode the ring index and a sequence number in an object pointer */
+#define OBJ(ring, seq)	((void *)(uintptr_t)(((ring) << 24) | (seq) | 1))
+#define OBJ_RING(obj)	((uint32_t)((uintptr_t)(obj) >> 24))
+#define OBJ_SEQ(obj)	((uint32_t)((uintptr_t)(obj) & 0xfffffe))
+
+static int
+ring_set_rings_create(unsigned int nb, unsigned int flags)
+{
+	char name[RTE_RING_NAMESIZE];
+	unsigned int i;
+
+	for (i = 0; i != nb; i++) {
+		snprintf(name, sizeof(name), "test_ring_set_%u", i);
+		rings[i] = rte_ring_create(name, RING_SIZE, SOCKET_ID_ANY,
+				flags);
+		if (rings[i] == NULL) {
+			printf("%s: cannot create ring %u: %s\n", __func__, i,
+				rte_strerror(rte_errno));
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void
+ring_set_rings_free(void)
+{
+	unsigned int i;
+
+	for (i = 0; i != RTE_DIM(rings); i++) {
+		rte_ring_free(rings[i]);
+		rings[i] = NULL;
+	}
+}
+
+static int
+ring_set_bmp_empty(const struct rte_ring_set *s)
+{
+	uint32_t i;
+
+	for (i = 0; i != s->nb_slabs; i++)
+		if (s->bmp[i] != 0)
+			return 0;
+	return 1;
+}
+
+/* only the signalled rings are visited, and drained rings are cleared */
+static int
+test_ring_set_signal(void)
+{
+	static const uint32_t idx[] = {3, 70, 199};
+	struct rte_ring_set *s;
+	struct rte_ring *mc;
+	int ret;
+	void *objs[RING_SET_BURST];
+	unsigned int i, n;
+
+	s = rte_ring_set_create("test_ring_set", RING_SET_NB_RINGS,
+			SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(s, "cannot create ring set");
+
+	TEST_ASSERT_SUCCESS(ring_set_rings_create(RING_SET_NB_RINGS,
+			RING_F_SP_ENQ | RING_F_SC_DEQ), "cannot create rings");
+	for (i = 0; i != RING_SET_NB_RINGS; i++)
+		TEST_ASSERT_EQUAL(rte_ring_set_add(s, rings[i], 1), (int)i,
+			"cannot add ring %u", i);
+	TEST_ASSERT_EQUAL(rte_ring_set_add(s, rings[0], 1), -ENOSPC,
+			"ring added to a full set");
+	TEST_ASSERT_SUCCESS(rte_ring_set_del(s, 0), "cannot remove ring");
+
+	/* multi-consumer rings are rejected */
+	mc = rte_ring_create("test_ring_set_mc", RING_SIZE, SOCKET_ID_ANY, 0);
+	TEST_ASSERT_NOT_NULL(mc, "cannot create ring");
+	ret = rte_ring_set_add(s, mc, 1);
+	rte_ring_free(mc);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "multi-consumer ring added");
+	TEST_ASSERT_EQUAL(rte_ring_set_add(s, rings[0], 1), 0,
+			"cannot add ring again");
+
+	TEST_ASSERT_EQUAL(rte_ring_set_dequeue_burst(s, objs, RING_SET_BURST),
+			0, "dequeued from an empty set");
+
+	for (i = 0; i != RTE_DIM(idx); i++) {
+		objs[0] = OBJ(idx[i], 0);
+		TEST_ASSERT_EQUAL(rte_ring_set_enqueue_burst(s, idx[i], objs,
+				1, NULL), 1, "cannot enqueue to ring %u",
+				idx[i]);
+	}
+	TEST_ASSERT(!ring_set_bmp_empty(s), "rings not signalled");
+
+	n = rte_ring_set_dequeue_burst(s, objs, RING_SET_BURST);
+	TEST_ASSERT_EQUAL(n, RTE_DIM(idx), "dequeued %u objects", n);
+	for (i = 0; i != n; i++)
+		TEST_ASSERT_EQUAL(OBJ_RING(objs[i]), idx[i],
+			"object %u from ring %u", i, OBJ_RING(objs[i]));
+	TEST_ASSERT(ring_set_bmp_empty(s), "drained rings still signalled");
+
+	/* a ring filled outside of the set is signalled when added */
+	TEST_ASSERT_SUCCESS(rte_ring_set_del(s, 10), "cannot remove ring");
+	objs[0] = OBJ(10, 0);
+	TEST_ASSERT_EQUAL(rte_ring_enqueue(rings[10], objs[0]), 0,
+			"cannot enqueue");
+	TEST_ASSERT(ring_set_bmp_empty(s), "removed ring signalled");
+	TEST_ASSERT_EQUAL(rte_ring_set_add(s, rings[10], 1), 10,
+			"cannot add ring again");
+	TEST_ASSERT_EQUAL(rte_ring_set_dequeue_burst(s, objs, RING_SET_BURST),
+			1, "added ring not signalled");
+
+	rte_ring_set_free(s);
+	ring_set_rings_free();
+	return 0;
+}
+
+/* the signalled rings are served according to their weight */
+static int
+test_ring_set_weight(void)
+{
+	static const uint32_t weight[] = {1, 2, 4};
+	uint32_t count[RTE_DIM(weight)] = {0};
+	struct rte_ring_set *s;
+	void *objs[RING_SET_BURST];
+	unsigned int i, j, n, nb_round;
+
+	s = rte_ring_set_create("test_ring_set", RTE_DIM(weight),
+			SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(s, "cannot create ring set");
+
+	TEST_ASSERT_SUCCESS(ring_set_rings_create(RTE_DIM(weight),
+			RING_F_SP_ENQ | RING_F_SC_DEQ), "cannot create rings");
+
+	TEST_ASSERT_EQUAL(rte_ring_set_add(s, rings[0], 0), -EINVAL,
+			"ring added with no weight");
+
+	for (i = 0; i != RTE_DIM(weight); i++) {
+		TEST_ASSERT_EQUAL(rte_ring_set_add(s, rings[i], weight[i]),
+			(int)i, "cannot add ring %u", i);
+		for (j = 0; j != RING_SIZE / 2; j++) {
+			objs[0] = OBJ(i, j << 1);
+			TEST_ASSERT_EQUAL(rte_ring_set_enqueue_burst(s, i,
+				objs, 1, NULL), 1, "cannot enqueue");
+		}
+	}
+
+	/* each round of 7 objects takes 1, 2 and 4 objects */
+	nb_round = RING_SIZE / 2 / 4;
+	for (i = 0; i != nb_round; i++) {
+		n = rte_ring_set_dequeue_burst(s, objs, 7);
+		TEST_ASSERT_EQUAL(n, 7, "round %u dequeued %u objects", i, n);
+		for (j = 0; j != n; j++) {
+			TEST_ASSERT_EQUAL(OBJ_SEQ(objs[j]),
+				count[OBJ_RING(objs[j])] << 1,
+				"objects out of order");
+			count[OBJ_RING(objs[j])]++;
+		}
+	}
+	for (i = 0; i != RTE_DIM(weight); i++)
+		TEST_ASSERT_EQUAL(count[i], nb_round * weight[i],
+			"ring %u served %u times", i, count[i]);
+
+	rte_ring_set_free(s);
+	ring_set_rings_free();
+	return 0;
+}
+
+static struct rte_ring_set *mt_set;
+static volatile uint32_t mt_start;
+
+static int
+ring_set_producer(void *arg)
+{
+	uint32_t idx = (uintptr_t)arg;
+	uint32_t seq;
+	void *obj;
+
+	while (mt_start == 0)
+		rte_pause();
+
+	for (seq = 0; seq != RING_SET_MT_NB_OBJS; seq++) {
+		obj = OBJ(idx, seq << 1);
+		while (rte_ring_set_enqueue_burst(mt_set, idx, &obj, 1,
+				NULL) == 0)
+			rte_pause();
+	}
+	return 0;
+}
+
+/* no signal is lost with concurrent producers and consumer */
+static int
+test_ring_set_mt(void)
+{
+	uint32_t next[RTE_MAX_LCORE] = {0};
+	void *objs[RING_SET_BURST];
+	uint64_t deadline, total, expected;
+	unsigned int i, n, lcore, nb_prod;
+	int ret = 0;
+
+	nb_prod = rte_lcore_count() - 1;
+	if (nb_prod == 0) {
+		printf("%s: at least 2 lcores needed, skipping\n", __func__);
+		return 0;
+	}
+
+	mt_set = rte_ring_set_create("test_ring_set", nb_prod, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(mt_set, "cannot create ring set");
+	TEST_ASSERT_SUCCESS(ring_set_rings_create(nb_prod,
+			RING_F_SP_ENQ | RING_F_SC_DEQ), "cannot create rings");
+	for (i = 0; i != nb_prod; i++)
+		TEST_ASSERT_EQUAL(rte_ring_set_add(mt_set, rings[i], 4),
+			(int)i, "cannot add ring %u", i);
+
+	mt_start = 0;
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore)
+		rte_eal_remote_launch(ring_set_producer,
+			(void *)(uintptr_t)i++, lcore);
+	mt_start = 1;
+
+	expected = (uint64_t)nb_prod * RING_SET_MT_NB_OBJS;
+	deadline = rte_get_timer_cycles() +
+		RING_SET_MT_TIMEOUT_S * rte_get_timer_hz();
+	for (total = 0; total != expected && ret == 0; ) {
+		n = rte_ring_set_dequeue_burst(mt_set, objs, RING_SET_BURST);
+		for (i = 0; i != n; i++) {
+			uint32_t r = OBJ_RING(objs[i]);
+
+			if (OBJ_SEQ(objs[i]) != next[r] << 1) {
+				printf("%s: ring %u object out of order\n",
+					__func__, r);
+				ret = -1;
+			}
+			next[r]++;
+		}
+		total += n;
+		if (n == 0 && rte_get_timer_cycles() > deadline) {
+			printf("%s: %" PRIu64 "/%" PRIu64 " objects received\n",
+				__func__, total, expected);
+			ret = -1;
+		}
+	}
+
+	/* on failure, drain the rings until the producers are done */
+	if (ret != 0)
+		RTE_LCORE_FOREACH_WORKER(lcore)
+			while (rte_eal_get_lcore_state(lcore) == RUNNING)
+				for (i = 0; i != nb_prod; i++)
+					while (rte_ring_sc_dequeue(rings[i],
+							&objs[0]) == 0)
+						;
+	rte_eal_mp_wait_lcore();
+
+	rte_ring_set_free(mt_set);
+	ring_set_rings_free();
+	return ret;
+}
+
+static struct unit_test_suite ring_set_testsuite = {
+	.suite_name = "ring set autotest",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_ring_set_signal),
+		TEST_CASE(test_ring_set_weight),
+		TEST_CASE(test_ring_set_mt),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_ring_set(void)
+{
+	return unit_test_suite_runner(&ring_set_testsuite);
+}
+
+REGISTER_TEST_COMMAND(ring_set_autotest, test_ring_set);
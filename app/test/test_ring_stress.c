@@ -46,12 +46,18 @@ test_ring_stress(void)
 	n += test_ring_hts_stress.nb_case;
 	k += run_test(&test_ring_hts_stress);
 
+	n += test_ring_mpsc_faa_stress.nb_case;
+	k += run_test(&test_ring_mpsc_faa_stress);
+
 	n += test_ring_mt_peek_stress.nb_case;
 	k += run_test(&test_ring_mt_peek_stress);
 
 	n += test_ring_mt_peek_stress_zc.nb_case;
 	k += run_test(&test_ring_mt_peek_stress_zc);
 
+	n += test_ring_rts_peek_stress_zc.nb_case;
+	k += run_test(&test_ring_rts_peek_stress_zc);
+
 	n += test_ring_st_peek_stress.nb_case;
 	k += run_test(&test_ring_st_peek_stress);
 
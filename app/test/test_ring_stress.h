@@ -12,6 +12,7 @@
 
 #include <rte_ring.h>
 #include <rte_cycles.h>
+#include <rte_errno.h>
 #include <rte_launch.h>
 #include <rte_pause.h>
 #include <rte_random.h>
@@ -35,7 +36,9 @@ struct test {
 extern const struct test test_ring_mpmc_stress;
 extern const struct test test_ring_rts_stress;
 extern const struct test test_ring_hts_stress;
+extern const struct test test_ring_mpsc_faa_stress;
 extern const struct test test_ring_mt_peek_stress;
 extern const struct test test_ring_mt_peek_stress_zc;
+extern const struct test test_ring_rts_peek_stress_zc;
 extern const struct test test_ring_st_peek_stress;
 extern const struct test test_ring_st_peek_stress_zc;
@@ -59,8 +59,10 @@ static uint32_t
 _st_ring_enqueue_bulk(struct rte_ring *r, void * const *obj, uint32_t n,
 	uint32_t *free);
 
+#ifndef RING_STRESS_CREATE_FLAGS
 static int
 _st_ring_init(struct rte_ring *r, const char *name, uint32_t num);
+#endif
 
 
 static void
@@ -265,7 +267,11 @@ test_worker_avg(void *arg)
 static void
 mt1_fini(struct rte_ring *rng, void *data)
 {
+#ifdef RING_STRESS_CREATE_FLAGS
+	rte_ring_free(rng);
+#else
 	rte_free(rng);
+#endif
 	rte_free(data);
 }
 
@@ -294,6 +300,19 @@ mt1_init(struct rte_ring **rng, void **data, uint32_t num)
 
 	/* alloc ring */
 	nr = 2 * num;
+#ifdef RING_STRESS_CREATE_FLAGS
+	/* ring modes which cannot be set by rte_ring_init() */
+	r = rte_ring_create(RING_NAME, nr, SOCKET_ID_ANY,
+		RING_STRESS_CREATE_FLAGS);
+	if (r == NULL) {
+		rc = -rte_errno;
+		printf("%s: rte_ring_create(%u) failed, error: %d(%s)\n",
+			__func__, nr, rc, strerror(-rc));
+		return rc;
+	}
+
+	*rng = r;
+#else
 	sz = rte_ring_get_memsize(nr);
 	r = rte_zmalloc(NULL, sz, __alignof__(*r));
 	if (r == NULL) {
@@ -310,6 +329,7 @@ mt1_init(struct rte_ring **rng, void **data, uint32_t num)
 			__func__, r, nr, rc, strerror(-rc));
 		return rc;
 	}
+#endif
 
 	for (i = 0; i != num; i++) {
 		fill_ring_elm(elm + i, UINT32_MAX);
@@ -0,0 +1,268 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+/*
+ * Test of the tagged index lock-free lists, used by default on the platforms
+ * without a 128-bit compare-and-swap, or with the stack_lf_idx build option.
+ */
+
+#include <string.h>
+
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+#include <rte_stack.h>
+
+#include "test.h"
+
+#define STACK_SIZE 4096
+#define MAX_BULK 32
+#define NUM_ITERS_PER_THREAD 100000
+
+#ifdef RTE_STACK_LF_IDX
+
+static struct rte_stack *
+stack_lf_idx_create(const char *name, unsigned int count)
+{
+	struct rte_stack *s;
+
+	s = rte_stack_create(name, count, rte_socket_id(), RTE_STACK_F_LF);
+	if (s == NULL)
+		return NULL;
+
+	/* the elements of both lists are indexed in the element array */
+	if (s->stack_lf.used.idx_elems != s->stack_lf.elems ||
+	    s->stack_lf.free.idx_elems != s->stack_lf.elems) {
+		printf("[%s():%u] lists not in tagged index mode\n",
+		       __func__, __LINE__);
+		rte_stack_free(s);
+		return NULL;
+	}
+
+	return s;
+}
+
+static int
+test_stack_lf_idx_push_pop(struct rte_stack *s, void **obj_table,
+			   void **popped_objs, unsigned int bulk_sz)
+{
+	unsigned int i;
+
+	for (i = 0; i < STACK_SIZE; i += bulk_sz) {
+		if (rte_stack_push(s, &obj_table[i], bulk_sz) != bulk_sz) {
+			printf("[%s():%u] push of %u objects failed\n",
+			       __func__, __LINE__, bulk_sz);
+			return -1;
+		}
+	}
+
+	if (rte_stack_count(s) != STACK_SIZE ||
+	    rte_stack_free_count(s) != 0) {
+		printf("[%s():%u] stack count: %u (expected %u)\n",
+		       __func__, __LINE__, rte_stack_count(s), STACK_SIZE);
+		return -1;
+	}
+
+	for (i = 0; i < STACK_SIZE; i += bulk_sz) {
+		if (rte_stack_pop(s, &popped_objs[i], bulk_sz) != bulk_sz) {
+			printf("[%s():%u] pop of %u objects failed\n",
+			       __func__, __LINE__, bulk_sz);
+			return -1;
+		}
+	}
+
+	if (rte_stack_count(s) != 0 ||
+	    rte_stack_free_count(s) != STACK_SIZE) {
+		printf("[%s():%u] stack count: %u (expected 0)\n",
+		       __func__, __LINE__, rte_stack_count(s));
+		return -1;
+	}
+
+	for (i = 0; i < STACK_SIZE; i++) {
+		if (obj_table[i] != popped_objs[STACK_SIZE - i - 1]) {
+			printf("[%s():%u] Incorrect value %p at index 0x%x\n",
+			       __func__, __LINE__,
+			       popped_objs[STACK_SIZE - i - 1], i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+test_stack_lf_idx_basic(void)
+{
+	void **obj_table, **popped_objs;
+	struct rte_stack *s;
+	int i, ret = -1;
+
+	obj_table = rte_calloc(NULL, STACK_SIZE, sizeof(void *), 0);
+	popped_objs = rte_calloc(NULL, STACK_SIZE, sizeof(void *), 0);
+	s = stack_lf_idx_create("idx_basic", STACK_SIZE);
+	if (obj_table == NULL || popped_objs == NULL || s == NULL) {
+		printf("[%s():%u] failed to allocate the test stack\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	for (i = 0; i < STACK_SIZE; i++)
+		obj_table[i] = (void *)(uintptr_t)i;
+
+	if (test_stack_lf_idx_push_pop(s, obj_table, popped_objs, 1) ||
+	    test_stack_lf_idx_push_pop(s, obj_table, popped_objs, MAX_BULK))
+		goto fail_test;
+
+	if (rte_stack_push(s, obj_table, 2 * STACK_SIZE) != 0) {
+		printf("[%s():%u] Excess objects push succeeded\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	if (rte_stack_pop(s, obj_table, 1) != 0) {
+		printf("[%s():%u] Empty stack pop succeeded\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	ret = 0;
+
+fail_test:
+	rte_stack_free(s);
+	rte_free(popped_objs);
+	rte_free(obj_table);
+
+	return ret;
+}
+
+static struct rte_stack *thread_stack;
+
+/* Pop objects and push them back, so that no object is lost or duplicated */
+static int
+stack_lf_idx_thread_pop_push(__rte_unused void *args)
+{
+	void *obj_table[MAX_BULK];
+	int i;
+
+	for (i = 0; i < NUM_ITERS_PER_THREAD; i++) {
+		unsigned int num;
+
+		num = rte_rand_max(MAX_BULK) + 1;
+
+		if (rte_stack_pop(thread_stack, obj_table, num) != num) {
+			printf("[%s():%u] Failed to pop %u pointers\n",
+			       __func__, __LINE__, num);
+			return -1;
+		}
+
+		if (rte_stack_push(thread_stack, obj_table, num) != num) {
+			printf("[%s():%u] Failed to push %u pointers\n",
+			       __func__, __LINE__, num);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+test_stack_lf_idx_multithreaded(void)
+{
+	unsigned int lcore_id, n, i;
+	void **obj_table = NULL;
+	uint8_t *seen = NULL;
+	struct rte_stack *s;
+	int ret = -1;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough cores for test_stack_lf_idx_multithreaded, expecting at least 2\n");
+		return TEST_SKIPPED;
+	}
+
+	printf("[%s():%u] Running with %u lcores\n",
+	       __func__, __LINE__, rte_lcore_count());
+
+	/* Every lcore can pop its largest bulk at any time */
+	n = MAX_BULK * rte_lcore_count();
+	s = stack_lf_idx_create("idx_mt", n);
+	obj_table = rte_calloc(NULL, n, sizeof(void *), 0);
+	seen = rte_zmalloc(NULL, n, 0);
+	if (s == NULL || obj_table == NULL || seen == NULL) {
+		printf("[%s():%u] failed to allocate the test stack\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	for (i = 0; i < n; i++)
+		obj_table[i] = (void *)(uintptr_t)i;
+	if (rte_stack_push(s, obj_table, n) != n) {
+		printf("[%s():%u] Failed to fill the stack\n",
+		       __func__, __LINE__);
+		goto fail_test;
+	}
+
+	thread_stack = s;
+	if (rte_eal_mp_remote_launch(stack_lf_idx_thread_pop_push, NULL,
+				     CALL_MAIN))
+		rte_panic("Failed to launch tests\n");
+
+	ret = 0;
+	RTE_LCORE_FOREACH(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+	}
+	if (ret != 0)
+		goto fail_test;
+
+	/* All the objects are back, once each */
+	ret = -1;
+	if (rte_stack_pop(s, obj_table, n) != n) {
+		printf("[%s():%u] Objects lost, stack count: %u (expected %u)\n",
+		       __func__, __LINE__, rte_stack_count(s), n);
+		goto fail_test;
+	}
+	for (i = 0; i < n; i++) {
+		uintptr_t obj = (uintptr_t)obj_table[i];
+
+		if (obj >= n || seen[obj]++ != 0) {
+			printf("[%s():%u] Unexpected object %p\n",
+			       __func__, __LINE__, obj_table[i]);
+			goto fail_test;
+		}
+	}
+
+	ret = 0;
+
+fail_test:
+	rte_stack_free(s);
+	rte_free(seen);
+	rte_free(obj_table);
+
+	return ret;
+}
+
+static int
+test_stack_lf_idx(void)
+{
+	if (test_stack_lf_idx_basic() < 0)
+		return -1;
+
+	if (test_stack_lf_idx_multithreaded() < 0)
+		return -1;
+
+	return 0;
+}
+
+#else /* !RTE_STACK_LF_IDX */
+
+static int
+test_stack_lf_idx(void)
+{
+	printf("Stack built without the tagged index lists, skipping test\n");
+	return TEST_SKIPPED;
+}
+
+#endif /* RTE_STACK_LF_IDX */
+
+REGISTER_TEST_COMMAND(stack_lf_idx_autotest, test_stack_lf_idx);
@@ -0,0 +1,284 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+#include <rte_timer.h>
+#include <rte_timer_pool.h>
+
+#include "test.h"
+
+/* more timers than an internal bulk */
+#define BULK_NB_TIMERS		200
+#define BULK_POOL_SIZE		256
+#define BULK_TIMEOUT_S		5
+
+static struct rte_timer_pool *pool;
+static rte_timer_handle_t handles[BULK_NB_TIMERS];
+static struct rte_timer *tims[BULK_NB_TIMERS];
+static uint32_t runs[BULK_POOL_SIZE];	/* indexed by handle */
+static void *args[BULK_NB_TIMERS];
+static uint32_t data_id;
+static uint32_t nb_expired;
+
+static void
+bulk_timer_cb(struct rte_timer *tim, void *arg)
+{
+	uint32_t *run = arg;
+
+	if (run != &runs[rte_timer_pool_get_handle(pool, tim)])
+		printf("%s: wrong timer argument\n", __func__);
+	else
+		(*run)++;
+	nb_expired++;
+}
+
+static void
+bulk_manage_cb(struct rte_timer *tim)
+{
+	tim->f(tim, tim->arg);
+}
+
+static int
+bulk_setup(void)
+{
+	unsigned int i;
+
+	pool = rte_timer_pool_create("test_timer_bulk", BULK_POOL_SIZE,
+			SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(pool, "cannot create timer pool: %s",
+			rte_strerror(rte_errno));
+	TEST_ASSERT_SUCCESS(rte_timer_pool_alloc_bulk(pool, handles,
+			BULK_NB_TIMERS), "cannot allocate timers");
+
+	for (i = 0; i != BULK_NB_TIMERS; i++) {
+		tims[i] = rte_timer_pool_get_timer(pool, handles[i]);
+		args[i] = &runs[handles[i]];
+	}
+	memset(runs, 0, sizeof(runs));
+	nb_expired = 0;
+	return 0;
+}
+
+static void
+bulk_teardown(void)
+{
+	rte_timer_pool_free_bulk(pool, handles, BULK_NB_TIMERS);
+	rte_timer_pool_free(pool);
+	pool = NULL;
+}
+
+/* the handles of a pool map to distinct timers, and the pool runs dry */
+static int
+test_timer_pool(void)
+{
+	rte_timer_handle_t more[BULK_POOL_SIZE];
+	unsigned int i;
+
+	TEST_ASSERT_NULL(rte_timer_pool_create("test_timer_bulk", 0,
+			SOCKET_ID_ANY), "timer pool created with no timer");
+	TEST_ASSERT_SUCCESS(bulk_setup(), "cannot setup");
+	TEST_ASSERT_NULL(rte_timer_pool_create("test_timer_bulk",
+			BULK_POOL_SIZE, SOCKET_ID_ANY),
+			"timer pool created twice");
+
+	for (i = 0; i != BULK_NB_TIMERS; i++) {
+		TEST_ASSERT(handles[i] < BULK_POOL_SIZE, "invalid handle");
+		TEST_ASSERT_EQUAL(rte_timer_pool_get_handle(pool, tims[i]),
+			handles[i], "handle of timer %u", i);
+		TEST_ASSERT(!rte_timer_pending(tims[i]), "timer pending");
+	}
+
+	TEST_ASSERT_EQUAL(rte_timer_pool_alloc_bulk(pool, more,
+			BULK_POOL_SIZE - BULK_NB_TIMERS + 1), -ENOENT,
+			"allocated more timers than the pool size");
+	TEST_ASSERT_SUCCESS(rte_timer_pool_alloc_bulk(pool, more,
+			BULK_POOL_SIZE - BULK_NB_TIMERS),
+			"cannot allocate the remaining timers");
+	rte_timer_pool_free_bulk(pool, more, BULK_POOL_SIZE - BULK_NB_TIMERS);
+
+	bulk_teardown();
+	return 0;
+}
+
+/* the timers armed in bulk expire once with their own argument */
+static int
+bulk_expiry(void)
+{
+	unsigned int lcore = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t deadline;
+	unsigned int i;
+
+	TEST_ASSERT_SUCCESS(bulk_setup(), "cannot setup");
+
+	/* re-arming pending timers moves them */
+	TEST_ASSERT_EQUAL(rte_timer_alt_reset_bulk(data_id, tims,
+			BULK_NB_TIMERS, hz * 100, SINGLE, lcore,
+			bulk_timer_cb, args), BULK_NB_TIMERS,
+			"cannot arm timers");
+	TEST_ASSERT_EQUAL(rte_timer_alt_reset_bulk(data_id, tims,
+			BULK_NB_TIMERS, hz / 100, SINGLE, lcore,
+			bulk_timer_cb, args), BULK_NB_TIMERS,
+			"cannot re-arm timers");
+	for (i = 0; i != BULK_NB_TIMERS; i++)
+		TEST_ASSERT(rte_timer_pending(tims[i]), "timer %u not pending",
+			i);
+
+	deadline = rte_get_timer_cycles() + BULK_TIMEOUT_S * hz;
+	while (nb_expired != BULK_NB_TIMERS &&
+	       rte_get_timer_cycles() < deadline)
+		rte_timer_alt_manage(data_id, NULL, 0, bulk_manage_cb);
+
+	TEST_ASSERT_EQUAL(nb_expired, BULK_NB_TIMERS, "%u/%u timers expired",
+			nb_expired, BULK_NB_TIMERS);
+	for (i = 0; i != BULK_NB_TIMERS; i++)
+		TEST_ASSERT_EQUAL(runs[handles[i]], 1,
+			"timer %u expired %u times", i, runs[handles[i]]);
+
+	bulk_teardown();
+	return 0;
+}
+
+/* the timers pending on several lcores are stopped at once */
+static int
+bulk_stop(void)
+{
+	uint64_t hz = rte_get_timer_hz();
+	unsigned int i, lcore;
+
+	TEST_ASSERT_SUCCESS(bulk_setup(), "cannot setup");
+
+	/* spread the timers over the lcores */
+	lcore = rte_get_next_lcore(-1, 0, 1);
+	for (i = 0; i != BULK_NB_TIMERS; i += 10) {
+		TEST_ASSERT_EQUAL(rte_timer_alt_reset_bulk(data_id, &tims[i],
+			10, hz * 100, PERIODICAL, lcore, bulk_timer_cb,
+			&args[i]), 10, "cannot arm timers");
+		lcore = rte_get_next_lcore(lcore, 0, 1);
+	}
+
+	TEST_ASSERT_EQUAL(rte_timer_alt_stop_bulk(data_id, tims,
+			BULK_NB_TIMERS), BULK_NB_TIMERS, "cannot stop timers");
+	for (i = 0; i != BULK_NB_TIMERS; i++)
+		TEST_ASSERT(!rte_timer_pending(tims[i]), "timer %u pending", i);
+
+	/* stopping stopped timers succeeds */
+	TEST_ASSERT_EQUAL(rte_timer_alt_stop_bulk(data_id, tims,
+			BULK_NB_TIMERS), BULK_NB_TIMERS,
+			"cannot stop stopped timers");
+
+	bulk_teardown();
+	return 0;
+}
+
+static uint32_t running;
+static uint32_t release;
+
+static void
+bulk_busy_cb(struct rte_timer *tim __rte_unused, void *arg __rte_unused)
+{
+	__atomic_store_n(&running, 1, __ATOMIC_RELEASE);
+	while (__atomic_load_n(&release, __ATOMIC_ACQUIRE) == 0)
+		rte_pause();
+}
+
+static int
+bulk_busy_manage(void *arg __rte_unused)
+{
+	while (__atomic_load_n(&running, __ATOMIC_ACQUIRE) == 0)
+		rte_timer_alt_manage(data_id, NULL, 0, bulk_manage_cb);
+	return 0;
+}
+
+/* the bulk functions stop at a timer running on another lcore */
+static int
+bulk_busy(void)
+{
+	unsigned int lcore = rte_get_next_lcore(-1, 1, 0);
+	uint64_t hz = rte_get_timer_hz();
+	int ret;
+
+	if (lcore >= RTE_MAX_LCORE) {
+		printf("%s: at least 2 lcores needed, skipping\n", __func__);
+		return 0;
+	}
+
+	TEST_ASSERT_SUCCESS(bulk_setup(), "cannot setup");
+	running = 0;
+	release = 0;
+
+	TEST_ASSERT_EQUAL(rte_timer_alt_reset_bulk(data_id, tims, 4,
+			hz * 100, SINGLE, rte_lcore_id(), bulk_timer_cb, args),
+			4, "cannot arm timers");
+	TEST_ASSERT_SUCCESS(rte_timer_alt_reset(data_id, tims[2], 0, SINGLE,
+			lcore, bulk_busy_cb, NULL), "cannot arm busy timer");
+
+	rte_eal_remote_launch(bulk_busy_manage, NULL, lcore);
+	while (__atomic_load_n(&running, __ATOMIC_ACQUIRE) == 0)
+		rte_pause();
+
+	ret = rte_timer_alt_stop_bulk(data_id, tims, 4);
+	__atomic_store_n(&release, 1, __ATOMIC_RELEASE);
+	rte_eal_wait_lcore(lcore);
+
+	TEST_ASSERT_EQUAL(ret, 2, "%d timers stopped", ret);
+	TEST_ASSERT(rte_timer_pending(tims[3]), "timer after busy one stopped");
+	TEST_ASSERT_EQUAL(rte_timer_alt_stop_bulk(data_id, &tims[2], 2), 2,
+			"cannot stop timers");
+
+	bulk_teardown();
+	return 0;
+}
+
+static int
+bulk_skiplist_setup(void)
+{
+	return rte_timer_data_alloc(&data_id);
+}
+
+static int
+bulk_wheel_setup(void)
+{
+	return rte_timer_data_alloc_wheel(&data_id, 1);
+}
+
+static void
+bulk_data_teardown(void)
+{
+	rte_timer_data_dealloc(data_id);
+}
+
+#define BULK_TEST_CASES(setup) \
+	TEST_CASE_ST(setup, bulk_data_teardown, bulk_expiry), \
+	TEST_CASE_ST(setup, bulk_data_teardown, bulk_stop), \
+	TEST_CASE_ST(setup, bulk_data_teardown, bulk_busy)
+
+static struct unit_test_suite timer_bulk_testsuite = {
+	.suite_name = "timer bulk autotest",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_timer_pool),
+		BULK_TEST_CASES(bulk_skiplist_setup),
+		BULK_TEST_CASES(bulk_wheel_setup),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_timer_bulk(void)
+{
+	return unit_test_suite_runner(&timer_bulk_testsuite);
+}
+
+REGISTER_TEST_COMMAND(timer_bulk_autotest, test_timer_bulk);
@@ -0,0 +1,292 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+#include <rte_random.h>
+#include <rte_timer.h>
+
+#include "test.h"
+
+#define WHEEL_NB_TIMERS		1024
+#define WHEEL_NB_PERIODS	5
+#define WHEEL_TIMEOUT_S		10
+
+struct wheel_timer {
+	struct rte_timer tim;
+	unsigned int lcore;	/* lcore expected to run the timer */
+	uint32_t nb_runs;
+	int stopped;
+};
+
+static struct wheel_timer timers[WHEEL_NB_TIMERS];
+static struct wheel_timer periodic;
+static uint32_t wheel_id;
+static uint32_t nb_expired;
+static uint32_t nb_errors;
+static uint32_t wheel_quit;
+
+static void
+wheel_timer_cb(struct rte_timer *tim, void *arg)
+{
+	struct wheel_timer *wt = arg;
+
+	if (rte_get_timer_cycles() < tim->expire) {
+		printf("%s: timer expired early\n", __func__);
+		__atomic_fetch_add(&nb_errors, 1, __ATOMIC_RELAXED);
+	}
+	if (rte_lcore_id() != wt->lcore) {
+		printf("%s: timer of lcore %u run on lcore %u\n", __func__,
+			wt->lcore, rte_lcore_id());
+		__atomic_fetch_add(&nb_errors, 1, __ATOMIC_RELAXED);
+	}
+	if (wt->stopped) {
+		printf("%s: stopped timer expired\n", __func__);
+		__atomic_fetch_add(&nb_errors, 1, __ATOMIC_RELAXED);
+	}
+
+	wt->nb_runs++;
+	if (tim->period != 0 && wt->nb_runs == WHEEL_NB_PERIODS)
+		rte_timer_alt_stop(wheel_id, tim);
+	__atomic_fetch_add(&nb_expired, 1, __ATOMIC_RELAXED);
+}
+
+static void
+wheel_manage_cb(struct rte_timer *tim)
+{
+	tim->f(tim, tim->arg);
+}
+
+static void
+wheel_timers_init(void)
+{
+	unsigned int i;
+
+	memset(timers, 0, sizeof(timers));
+	memset(&periodic, 0, sizeof(periodic));
+	for (i = 0; i != WHEEL_NB_TIMERS; i++)
+		rte_timer_init(&timers[i].tim);
+	rte_timer_init(&periodic.tim);
+	nb_expired = 0;
+	nb_errors = 0;
+}
+
+static int
+wheel_timer_arm(struct wheel_timer *wt, uint64_t ticks, unsigned int lcore)
+{
+	wt->lcore = lcore;
+	return rte_timer_alt_reset(wheel_id, &wt->tim, ticks, SINGLE, lcore,
+			wheel_timer_cb, wt);
+}
+
+/* timers of all the wheel levels expire once, never early */
+static int
+test_timer_wheel_expiry(void)
+{
+	unsigned int lcore = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t deadline, ticks;
+	uint32_t i, expected = 0;
+
+	TEST_ASSERT_EQUAL(rte_timer_data_alloc_wheel(&wheel_id, 0), -EINVAL,
+			"wheel allocated with no resolution");
+	TEST_ASSERT_SUCCESS(rte_timer_data_alloc_wheel(&wheel_id, 1),
+			"cannot allocate timer wheel");
+	wheel_timers_init();
+
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		ticks = (i % 16 == 0) ? 0 : rte_rand() % (hz / 4);
+		TEST_ASSERT_SUCCESS(wheel_timer_arm(&timers[i], ticks, lcore),
+			"cannot arm timer %u", i);
+	}
+
+	/* cancel and re-arm some of the timers */
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		if (i % 4 == 1) {
+			TEST_ASSERT_SUCCESS(rte_timer_alt_stop(wheel_id,
+				&timers[i].tim), "cannot stop timer %u", i);
+			timers[i].stopped = 1;
+			continue;
+		}
+		if (i % 4 == 2)
+			TEST_ASSERT_SUCCESS(wheel_timer_arm(&timers[i],
+				rte_rand() % (hz / 8), lcore),
+				"cannot re-arm timer %u", i);
+		expected++;
+	}
+
+	/* beyond the wheel span, the timer is cascaded again */
+	if ((UINT64_C(1) << 32) < 2 * hz)
+		TEST_ASSERT_SUCCESS(wheel_timer_arm(&timers[0],
+			(UINT64_C(1) << 32) + hz / 10, lcore),
+			"cannot arm timer far away");
+
+	periodic.lcore = lcore;
+	TEST_ASSERT_SUCCESS(rte_timer_alt_reset(wheel_id, &periodic.tim,
+		hz / 1000, PERIODICAL, lcore, wheel_timer_cb, &periodic),
+		"cannot arm periodic timer");
+	expected += WHEEL_NB_PERIODS;
+
+	deadline = rte_get_timer_cycles() + WHEEL_TIMEOUT_S * hz;
+	while (__atomic_load_n(&nb_expired, __ATOMIC_RELAXED) != expected &&
+	       rte_get_timer_cycles() < deadline)
+		rte_timer_alt_manage(wheel_id, NULL, 0, wheel_manage_cb);
+
+	TEST_ASSERT_EQUAL(nb_expired, expected, "%u/%u timers expired",
+			nb_expired, expected);
+	TEST_ASSERT_EQUAL(nb_errors, 0, "timers expired wrongly");
+	for (i = 0; i != WHEEL_NB_TIMERS; i++) {
+		TEST_ASSERT(timers[i].nb_runs == (timers[i].stopped ? 0U : 1U),
+			"timer %u expired %u times", i, timers[i].nb_runs);
+		TEST_ASSERT(!rte_timer_pending(&timers[i].tim),
+			"timer %u still pending", i);
+	}
+	TEST_ASSERT(!rte_timer_pending(&periodic.tim),
+			"periodic timer still pending");
+
+	TEST_ASSERT_SUCCESS(rte_timer_data_dealloc(wheel_id),
+			"cannot free timer wheel");
+	return 0;
+}
+
+static void
+wheel_stop_cb(struct rte_timer *tim __rte_unused, void *arg)
+{
+	(*(uint32_t *)arg)++;
+}
+
+/* stopping all the timers of an lcore walks all the levels */
+static int
+test_timer_wheel_stop_all(void)
+{
+	unsigned int lcore = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	uint32_t i, count = 0;
+
+	TEST_ASSERT_SUCCESS(rte_timer_data_alloc_wheel(&wheel_id, 1),
+			"cannot allocate timer wheel");
+	wheel_timers_init();
+
+	for (i = 0; i != WHEEL_NB_TIMERS; i++)
+		TEST_ASSERT_SUCCESS(wheel_timer_arm(&timers[i],
+			hz + (UINT64_C(1) << (i % 40)), lcore),
+			"cannot arm timer %u", i);
+
+	TEST_ASSERT_SUCCESS(rte_timer_stop_all(wheel_id, &lcore, 1,
+			wheel_stop_cb, &count), "cannot stop timers");
+	TEST_ASSERT_EQUAL(count, WHEEL_NB_TIMERS, "%u/%u timers stopped",
+			count, WHEEL_NB_TIMERS);
+	for (i = 0; i != WHEEL_NB_TIMERS; i++)
+		TEST_ASSERT(!rte_timer_pending(&timers[i].tim),
+			"timer %u still pending", i);
+
+	TEST_ASSERT_SUCCESS(rte_timer_data_dealloc(wheel_id),
+			"cannot free timer wheel");
+	return 0;
+}
+
+static int
+wheel_manage_loop(void *arg __rte_unused)
+{
+	while (__atomic_load_n(&wheel_quit, __ATOMIC_RELAXED) == 0)
+		rte_timer_alt_manage(wheel_id, NULL, 0, wheel_manage_cb);
+	return 0;
+}
+
+/* timers armed, moved and stopped from another lcore run on their owner */
+static int
+test_timer_wheel_mt(void)
+{
+	unsigned int lcores[RTE_MAX_LCORE];
+	uint64_t hz = rte_get_timer_hz();
+	unsigned int lcore, nb_lcores = 0;
+	uint32_t i, expected = 0;
+	uint64_t deadline;
+	int ret = 0;
+
+	RTE_LCORE_FOREACH_WORKER(lcore)
+		lcores[nb_lcores++] = lcore;
+	if (nb_lcores < 2) {
+		printf("%s: at least 3 lcores needed, skipping\n", __func__);
+		return 0;
+	}
+
+	TEST_ASSERT_SUCCESS(rte_timer_data_alloc_wheel(&wheel_id, 16),
+			"cannot allocate timer wheel");
+	wheel_timers_init();
+
+	wheel_quit = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore)
+		rte_eal_remote_launch(wheel_manage_loop, NULL, lcore);
+
+	for (i = 0; i != WHEEL_NB_TIMERS && ret == 0; i++) {
+		lcore = lcores[i % nb_lcores];
+		/* the timers to stop cannot expire before */
+		if (i % 3 == 0) {
+			ret = wheel_timer_arm(&timers[i], WHEEL_TIMEOUT_S * hz,
+					lcore);
+			if (ret == 0)
+				ret = rte_timer_alt_stop(wheel_id,
+						&timers[i].tim);
+			timers[i].stopped = 1;
+			continue;
+		}
+
+		/* move the timer to the next lcore before it expires */
+		if (i % 3 == 1) {
+			ret = wheel_timer_arm(&timers[i], WHEEL_TIMEOUT_S * hz,
+					lcore);
+			lcore = lcores[(i + 1) % nb_lcores];
+		}
+		if (ret == 0)
+			ret = wheel_timer_arm(&timers[i],
+					rte_rand() % (hz / 10), lcore);
+		expected++;
+	}
+
+	deadline = rte_get_timer_cycles() + WHEEL_TIMEOUT_S * hz;
+	while (ret == 0 &&
+	       __atomic_load_n(&nb_expired, __ATOMIC_RELAXED) != expected &&
+	       rte_get_timer_cycles() < deadline)
+		rte_delay_ms(1);
+
+	__atomic_store_n(&wheel_quit, 1, __ATOMIC_RELAXED);
+	rte_eal_mp_wait_lcore();
+
+	TEST_ASSERT_SUCCESS(ret, "cannot arm or stop timer %u", i - 1);
+	TEST_ASSERT_EQUAL(nb_expired, expected, "%u/%u timers expired",
+			nb_expired, expected);
+	TEST_ASSERT_EQUAL(nb_errors, 0, "timers expired wrongly");
+
+	TEST_ASSERT_SUCCESS(rte_timer_data_dealloc(wheel_id),
+			"cannot free timer wheel");
+	return 0;
+}
+
+static struct unit_test_suite timer_wheel_testsuite = {
+	.suite_name = "timer wheel autotest",
+	.setup = NULL,
+	.teardown = NULL,
+	.unit_test_cases = {
+		TEST_CASE(test_timer_wheel_expiry),
+		TEST_CASE(test_timer_wheel_stop_all),
+		TEST_CASE(test_timer_wheel_mt),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_timer_wheel(void)
+{
+	return unit_test_suite_runner(&timer_wheel_testsuite);
+}
+
+REGISTER_TEST_COMMAND(timer_wheel_autotest, test_timer_wheel);
@@ -0,0 +1,475 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+#include <rte_stack.h>
+
+#include "rte_mempool_numa.h"
+
+/*
+ * The objects are kept in one stack per socket (shard). The socket of
+ * an object is the one of the memory chunk it was populated from, so
+ * the pool remembers the address ranges of its chunks. Adjacent chunks
+ * on the same socket are merged, so a few ranges are usually enough.
+ */
+
+/* maximum number of address ranges remembered per pool */
+#define NUMA_RANGES_MAX	64
+
+/* lcore_shard entry of the lcores whose socket is looked up on each call */
+#define NUMA_SHARD_LOOKUP	UINT8_MAX
+
+#define NUMA_OPS_NAME		"numa_stack"
+#define NUMA_LF_OPS_NAME	"numa_lf_stack"
+
+struct numa_range {
+	uintptr_t start;
+	uintptr_t end;
+	uint32_t shard;
+};
+
+/* counters of one lcore for one shard */
+struct numa_stats {
+	uint64_t local_get;
+	uint64_t remote_get;
+	uint64_t local_put;
+	uint64_t remote_put;
+};
+
+struct numa_pool {
+	uint32_t nb_shards;
+	/* shard of the objects out of the known ranges */
+	uint32_t def_shard;
+	uint32_t nb_ranges;
+	/* stride between the statistics of two lcores */
+	uint32_t stats_stride;
+	int socket_id[RTE_MAX_NUMA_NODES];
+	struct rte_stack *shard[RTE_MAX_NUMA_NODES];
+	struct numa_range range[NUMA_RANGES_MAX];
+	/*
+	 * shard of each EAL lcore, nb_shards for unknown sockets,
+	 * NUMA_SHARD_LOOKUP for the lcores of non-EAL threads
+	 */
+	uint8_t lcore_shard[RTE_MAX_LCORE];
+	/* statistics of each lcore, the last row is for non-EAL threads */
+	struct numa_stats *stats;
+};
+
+static uint32_t
+numa_socket_shard(const struct numa_pool *np, int socket_id)
+{
+	uint32_t i;
+
+	for (i = 0; i != np->nb_shards; i++) {
+		if (np->socket_id[i] == socket_id)
+			break;
+	}
+	return i;
+}
+
+static inline uint32_t
+numa_obj_shard(const struct numa_pool *np, const void *obj, uint32_t *hint)
+{
+	const struct numa_range *r;
+	uintptr_t addr;
+	uint32_t i;
+
+	if (np->nb_shards == 1)
+		return 0;
+
+	addr = (uintptr_t)obj;
+	r = &np->range[*hint];
+	if (addr - r->start < r->end - r->start)
+		return r->shard;
+
+	for (i = 0; i != np->nb_ranges; i++) {
+		r = &np->range[i];
+		if (addr - r->start < r->end - r->start) {
+			*hint = i;
+			return r->shard;
+		}
+	}
+	return np->def_shard;
+}
+
+/* shard of the calling thread, nb_shards if its socket is unknown */
+static inline uint32_t
+numa_lcore_shard(const struct numa_pool *np, unsigned int lcore_id)
+{
+	if (lcore_id < RTE_MAX_LCORE &&
+			np->lcore_shard[lcore_id] != NUMA_SHARD_LOOKUP)
+		return np->lcore_shard[lcore_id];
+	return numa_socket_shard(np, rte_socket_id());
+}
+
+static inline struct numa_stats *
+numa_lcore_stats(const struct numa_pool *np, unsigned int lcore_id)
+{
+	lcore_id = RTE_MIN(lcore_id, (unsigned int)RTE_MAX_LCORE);
+	return np->stats + (size_t)lcore_id * np->stats_stride;
+}
+
+static inline void
+numa_stats_add(uint64_t *cnt, uint64_t n, unsigned int lcore_id)
+{
+	if (lcore_id < RTE_MAX_LCORE)
+		*cnt += n;
+	else
+		__atomic_fetch_add(cnt, n, __ATOMIC_RELAXED);
+}
+
+/*
+ * Return the objects to the stacks of their sockets,
+ * pushing the runs of objects from the same socket at once.
+ */
+static int
+numa_push(struct numa_pool *np, void * const *obj_table, unsigned int n,
+	unsigned int lcore_id)
+{
+	struct numa_stats *st;
+	uint32_t hint, i, j, s, home;
+
+	st = numa_lcore_stats(np, lcore_id);
+	home = numa_lcore_shard(np, lcore_id);
+	hint = 0;
+
+	for (i = 0; i != n; i = j) {
+		s = numa_obj_shard(np, obj_table[i], &hint);
+		for (j = i + 1; j != n &&
+				numa_obj_shard(np, obj_table[j], &hint) == s;
+				j++)
+			;
+
+		if (rte_stack_push(np->shard[s], obj_table + i, j - i) == 0)
+			return -ENOBUFS;
+
+		if (s == home)
+			numa_stats_add(&st[s].local_put, j - i, lcore_id);
+		else
+			numa_stats_add(&st[s].remote_put, j - i, lcore_id);
+	}
+	return 0;
+}
+
+static int
+numa_enqueue(struct rte_mempool *mp, void * const *obj_table,
+	unsigned int n)
+{
+	return numa_push(mp->pool_data, obj_table, n, rte_lcore_id());
+}
+
+/*
+ * Steal the objects from the other sockets: first from the one that has
+ * them all, then gathering them from all the sockets.
+ */
+static int
+numa_steal(struct numa_pool *np, void **obj_table, unsigned int n,
+	uint32_t home, unsigned int lcore_id)
+{
+	struct numa_stats *st;
+	uint32_t i, k, m, s;
+	uint32_t num[RTE_MAX_NUMA_NODES];
+
+	st = numa_lcore_stats(np, lcore_id);
+
+	for (i = 1; i <= np->nb_shards; i++) {
+		s = (home + i) % np->nb_shards;
+		if (s != home &&
+				rte_stack_pop(np->shard[s], obj_table, n) != 0) {
+			numa_stats_add(&st[s].remote_get, n, lcore_id);
+			return 0;
+		}
+	}
+
+	k = 0;
+	for (i = 0; i != np->nb_shards; i++) {
+		s = (home + i) % np->nb_shards;
+		m = RTE_MIN(n - k, rte_stack_count(np->shard[s]));
+		num[s] = rte_stack_pop(np->shard[s], obj_table + k, m);
+		k += num[s];
+	}
+
+	/* not enough objects, give back the ones we got */
+	if (k != n) {
+		for (i = 0, k = 0; i != np->nb_shards; i++) {
+			s = (home + i) % np->nb_shards;
+			rte_stack_push(np->shard[s], obj_table + k, num[s]);
+			k += num[s];
+		}
+		return -ENOBUFS;
+	}
+
+	for (s = 0; s != np->nb_shards; s++) {
+		if (s == home)
+			numa_stats_add(&st[s].local_get, num[s], lcore_id);
+		else
+			numa_stats_add(&st[s].remote_get, num[s], lcore_id);
+	}
+	return 0;
+}
+
+static int
+numa_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct numa_pool *np = mp->pool_data;
+	unsigned int lcore_id;
+	uint32_t home;
+
+	lcore_id = rte_lcore_id();
+	home = numa_lcore_shard(np, lcore_id);
+
+	if (home != np->nb_shards &&
+			rte_stack_pop(np->shard[home], obj_table, n) != 0) {
+		numa_stats_add(&numa_lcore_stats(np, lcore_id)[home].local_get,
+			n, lcore_id);
+		return 0;
+	}
+
+	return numa_steal(np, obj_table, n, home, lcore_id);
+}
+
+static unsigned int
+numa_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_pool *np = mp->pool_data;
+	unsigned int count;
+	uint32_t i;
+
+	count = 0;
+	for (i = 0; i != np->nb_shards; i++)
+		count += rte_stack_count(np->shard[i]);
+	return count;
+}
+
+/*
+ * Remember the socket of the memory chunk, before its objects
+ * get enqueued by the default populate routine.
+ */
+static int
+numa_populate(struct rte_mempool *mp, unsigned int max_objs, void *vaddr,
+	rte_iova_t iova, size_t len, rte_mempool_populate_obj_cb_t *obj_cb,
+	void *obj_cb_arg)
+{
+	struct numa_pool *np = mp->pool_data;
+	const struct rte_memseg_list *msl;
+	struct numa_range *r;
+	uint32_t s;
+
+	msl = rte_mem_virt2memseg_list(vaddr);
+	s = (msl == NULL) ? np->nb_shards :
+		numa_socket_shard(np, msl->socket_id);
+	if (s == np->nb_shards)
+		s = np->def_shard;
+
+	/* merge with the previous chunk if possible */
+	r = (np->nb_ranges != 0) ? &np->range[np->nb_ranges - 1] : NULL;
+	if (r != NULL && r->shard == s && r->end == (uintptr_t)vaddr)
+		r->end += len;
+	else if (np->nb_ranges != RTE_DIM(np->range)) {
+		r = &np->range[np->nb_ranges++];
+		r->start = (uintptr_t)vaddr;
+		r->end = (uintptr_t)vaddr + len;
+		r->shard = s;
+	} else if (s != np->def_shard)
+		RTE_LOG(WARNING, MEMPOOL,
+			"%s: too many memory chunks, objects of %s at %p "
+			"go to socket %d\n", __func__, mp->name, vaddr,
+			np->socket_id[np->def_shard]);
+
+	return rte_mempool_op_populate_default(mp, max_objs, vaddr, iova,
+		len, obj_cb, obj_cb_arg);
+}
+
+static void
+numa_free(struct rte_mempool *mp)
+{
+	struct numa_pool *np = mp->pool_data;
+	uint32_t i;
+
+	if (np == NULL)
+		return;
+
+	for (i = 0; i != np->nb_shards; i++)
+		rte_stack_free(np->shard[i]);
+	rte_free(np->stats);
+	rte_free(np);
+}
+
+static int
+__numa_alloc(struct rte_mempool *mp, uint32_t flags)
+{
+	char name[RTE_STACK_NAMESIZE];
+	struct numa_pool *np;
+	unsigned int lcore_id;
+	uint32_t i, s;
+	size_t sz;
+	int ret;
+
+	np = rte_zmalloc_socket(mp->name, sizeof(*np), RTE_CACHE_LINE_SIZE,
+		mp->socket_id);
+	if (np == NULL)
+		return -ENOMEM;
+
+	mp->pool_data = np;
+	np->nb_shards = RTE_MIN(rte_socket_count(),
+		(unsigned int)RTE_MAX_NUMA_NODES);
+	for (i = 0; i != np->nb_shards; i++)
+		np->socket_id[i] = rte_socket_id_by_idx(i);
+
+	np->stats_stride = RTE_ALIGN(np->nb_shards * sizeof(np->stats[0]),
+		RTE_CACHE_LINE_SIZE) / sizeof(np->stats[0]);
+	sz = (RTE_MAX_LCORE + 1) * np->stats_stride * sizeof(np->stats[0]);
+	np->stats = rte_zmalloc_socket(mp->name, sz, RTE_CACHE_LINE_SIZE,
+		mp->socket_id);
+	if (np->stats == NULL) {
+		ret = -ENOMEM;
+		goto error;
+	}
+
+	/*
+	 * The lcore ids of the non-EAL threads are given at registration,
+	 * maybe after the pool creation, so their socket can't be cached.
+	 */
+	for (lcore_id = 0; lcore_id != RTE_MAX_LCORE; lcore_id++) {
+		enum rte_lcore_role_t role = rte_eal_lcore_role(lcore_id);
+
+		if (role == ROLE_RTE || role == ROLE_SERVICE)
+			np->lcore_shard[lcore_id] = numa_socket_shard(np,
+				rte_lcore_to_socket_id(lcore_id));
+		else
+			np->lcore_shard[lcore_id] = NUMA_SHARD_LOOKUP;
+	}
+
+	s = numa_socket_shard(np, mp->socket_id);
+	if (s == np->nb_shards)
+		s = numa_socket_shard(np, rte_socket_id());
+	np->def_shard = (s == np->nb_shards) ? 0 : s;
+
+	for (i = 0; i != np->nb_shards; i++) {
+		ret = snprintf(name, sizeof(name), RTE_MEMPOOL_MZ_FORMAT "_%u",
+			mp->name, i);
+		if (ret < 0 || ret >= (int)sizeof(name)) {
+			ret = -ENAMETOOLONG;
+			goto error;
+		}
+
+		/* every stack can hold all the objects of the pool */
+		np->shard[i] = rte_stack_create(name, mp->size,
+			np->socket_id[i], flags);
+		if (np->shard[i] == NULL) {
+			ret = -rte_errno;
+			goto error;
+		}
+	}
+
+	return 0;
+
+error:
+	numa_free(mp);
+	mp->pool_data = NULL;
+	rte_errno = -ret;
+	return ret;
+}
+
+static int
+numa_alloc(struct rte_mempool *mp)
+{
+	return __numa_alloc(mp, 0);
+}
+
+static int
+numa_lf_alloc(struct rte_mempool *mp)
+{
+	return __numa_alloc(mp, RTE_STACK_F_LF);
+}
+
+static const struct numa_pool *
+numa_pool_get(const struct rte_mempool *mp)
+{
+	const struct rte_mempool_ops *ops;
+
+	if (mp == NULL || mp->pool_data == NULL)
+		return NULL;
+
+	ops = rte_mempool_get_ops(mp->ops_index);
+	if (strcmp(ops->name, NUMA_OPS_NAME) != 0 &&
+			strcmp(ops->name, NUMA_LF_OPS_NAME) != 0)
+		return NULL;
+
+	return mp->pool_data;
+}
+
+int
+rte_mempool_numa_stats_get(const struct rte_mempool *mp, int socket_id,
+	struct rte_mempool_numa_stats *stats)
+{
+	const struct numa_pool *np;
+	const struct numa_stats *st;
+	unsigned int lcore_id;
+	uint32_t s;
+
+	np = numa_pool_get(mp);
+	if (np == NULL || stats == NULL)
+		return -EINVAL;
+
+	s = numa_socket_shard(np, socket_id);
+	if (s == np->nb_shards)
+		return -ENOENT;
+
+	memset(stats, 0, sizeof(*stats));
+	for (lcore_id = 0; lcore_id <= RTE_MAX_LCORE; lcore_id++) {
+		st = numa_lcore_stats(np, lcore_id) + s;
+		stats->local_get += st->local_get;
+		stats->remote_get += st->remote_get;
+		stats->local_put += st->local_put;
+		stats->remote_put += st->remote_put;
+	}
+	stats->count = rte_stack_count(np->shard[s]);
+	return 0;
+}
+
+int
+rte_mempool_numa_stats_reset(struct rte_mempool *mp)
+{
+	const struct numa_pool *np;
+
+	np = numa_pool_get(mp);
+	if (np == NULL)
+		return -EINVAL;
+
+	memset(np->stats, 0, (RTE_MAX_LCORE + 1) * np->stats_stride *
+		sizeof(np->stats[0]));
+	return 0;
+}
+
+static struct rte_mempool_ops ops_numa_stack = {
+	.name = NUMA_OPS_NAME,
+	.alloc = numa_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+};
+
+static struct rte_mempool_ops ops_numa_lf_stack = {
+	.name = NUMA_LF_OPS_NAME,
+	.alloc = numa_lf_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+};
+
+MEMPOOL_REGISTER_OPS(ops_numa_stack);
+MEMPOOL_REGISTER_OPS(ops_numa_lf_stack);
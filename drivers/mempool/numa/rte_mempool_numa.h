@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_MEMPOOL_NUMA_H_
+#define _RTE_MEMPOOL_NUMA_H_
+
+/**
+ * @file
+ *
+ * NUMA sharded mempool handler.
+ *
+ * The "numa_stack" and "numa_lf_stack" handlers keep one sub-pool per
+ * NUMA socket, each one being a stack allocated on its socket. The
+ * objects always go back to the sub-pool of the socket their memory is
+ * on, whichever lcore frees them, and the lcores allocate from the
+ * sub-pool of their own socket. When it runs short, they steal the
+ * objects of the other sockets.
+ *
+ * The handlers are selected with rte_mempool_set_ops_byname().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_mempool.h>
+
+/**
+ * Statistics of the sub-pool of one socket.
+ */
+struct rte_mempool_numa_stats {
+	uint64_t local_get;  /**< Objects allocated by lcores of the socket. */
+	uint64_t remote_get; /**< Objects stolen by lcores of other sockets. */
+	uint64_t local_put;  /**< Objects freed by lcores of the socket. */
+	uint64_t remote_put; /**< Objects freed by lcores of other sockets. */
+	unsigned int count;  /**< Objects currently in the sub-pool. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the statistics of the sub-pool of a socket.
+ * A non-EAL thread uses the sub-pool of the socket returned by
+ * rte_socket_id(). The objects allocated and freed by the non-EAL threads
+ * without a socket, e.g. not registered with rte_thread_register(), count
+ * as remote.
+ *
+ * @param mp
+ *   Mempool using one of the NUMA sharded handlers.
+ * @param socket_id
+ *   Socket of the sub-pool.
+ * @param stats
+ *   Statistics of the sub-pool.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool doesn't use a NUMA sharded handler.
+ *   - -ENOENT: The mempool has no sub-pool for that socket.
+ */
+__rte_experimental
+int
+rte_mempool_numa_stats_get(const struct rte_mempool *mp, int socket_id,
+	struct rte_mempool_numa_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset the statistics of all the sub-pools.
+ * This function is not thread safe with the mempool operations.
+ *
+ * @param mp
+ *   Mempool using one of the NUMA sharded handlers.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool doesn't use a NUMA sharded handler.
+ */
+__rte_experimental
+int
+rte_mempool_numa_stats_reset(struct rte_mempool *mp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMPOOL_NUMA_H_ */
@@ -613,7 +613,7 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	}
 
 	while (n_tx_pkts < nb_pkts && n_free) {
-		mbuf_head = *bufs++;
+		mbuf_head = bufs[n_tx_pkts];
 		mbuf = mbuf_head;
 
 		saved_slot = slot;
@@ -665,7 +665,6 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		n_tx_pkts++;
 		slot++;
 		n_free--;
-		rte_pktmbuf_free(mbuf_head);
 	}
 
 no_free_slots:
@@ -683,6 +682,9 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		}
 	}
 
+	/* free the transmitted mbufs in one go */
+	rte_pktmbuf_free_bulk(bufs, n_tx_pkts);
+
 	mq->n_pkts += n_tx_pkts;
 	return n_tx_pkts;
 }
@@ -141,18 +141,16 @@ eth_null_no_rx(void *q __rte_unused, struct rte_mbuf **bufs __rte_unused,
 static uint16_t
 eth_null_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 {
-	int i;
 	struct null_queue *h = q;
 
 	if ((q == NULL) || (bufs == NULL))
 		return 0;
 
-	for (i = 0; i < nb_bufs; i++)
-		rte_pktmbuf_free(bufs[i]);
+	rte_pktmbuf_free_bulk(bufs, nb_bufs);
 
-	rte_atomic64_add(&(h->tx_pkts), i);
+	rte_atomic64_add(&(h->tx_pkts), nb_bufs);
 
-	return i;
+	return nb_bufs;
 }
 
 static uint16_t
@@ -166,11 +164,10 @@ eth_null_copy_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 		return 0;
 
 	packet_size = h->internals->packet_size;
-	for (i = 0; i < nb_bufs; i++) {
+	for (i = 0; i < nb_bufs; i++)
 		rte_memcpy(h->dummy_packet, rte_pktmbuf_mtod(bufs[i], void *),
 					packet_size);
-		rte_pktmbuf_free(bufs[i]);
-	}
+	rte_pktmbuf_free_bulk(bufs, nb_bufs);
 
 	rte_atomic64_add(&(h->tx_pkts), i);
 
@@ -11,6 +11,8 @@
 #include <rte_swx_port_ethdev.h>
 #include <rte_swx_port_source_sink.h>
 #include <rte_swx_table_em.h>
+#include <rte_swx_table_wm.h>
+#include <rte_swx_table_lpm.h>
 #include <rte_swx_pipeline.h>
 #include <rte_swx_ctl.h>
 
@@ -415,6 +417,31 @@ pipeline_create(struct obj *obj, const char *name, int numa_node)
 	if (status)
 		goto error;
 
+	status = rte_swx_pipeline_table_type_register(p,
+		"wildcard",
+		RTE_SWX_TABLE_MATCH_WILDCARD,
+		&rte_swx_table_wildcard_match_ops);
+	if (status)
+		goto error;
+
+	/* The first LPM table type is the default one, the "lpm" type only
+	 * handles the IPv4 tables, with a 4-byte key in network byte order, and
+	 * is selected by the "instanceof lpm" table statement.
+	 */
+	status = rte_swx_pipeline_table_type_register(p,
+		"lpm_wildcard",
+		RTE_SWX_TABLE_MATCH_LPM,
+		&rte_swx_table_wildcard_match_ops);
+	if (status)
+		goto error;
+
+	status = rte_swx_pipeline_table_type_register(p,
+		"lpm",
+		RTE_SWX_TABLE_MATCH_LPM,
+		&rte_swx_table_lpm_ops);
+	if (status)
+		goto error;
+
 	/* Node allocation */
 	pipeline = calloc(1, sizeof(struct pipeline));
 	if (pipeline == NULL)
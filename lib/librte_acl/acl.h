@@ -169,6 +169,9 @@ struct rte_acl_ctx {
 	int32_t             socket_id;
 	/** Socket ID to allocate memory from. */
 	enum rte_acl_classify_alg alg;
+	uint32_t            num_bld_lcores;
+	uint32_t            bld_lcores[RTE_ACL_MAX_TRIES];
+	/** Worker lcores used by rte_acl_build(). */
 	uint32_t           first_load_sz;
 	void               *rules;
 	uint32_t            max_rules;
@@ -176,6 +179,8 @@ struct rte_acl_ctx {
 	uint32_t            num_rules;
 	uint32_t            num_categories;
 	uint32_t            num_tries;
+	uint32_t            num_bld_jobs;
+	/** Jobs run on the worker lcores by the last build. */
 	uint32_t            match_index;
 	uint64_t            no_match;
 	uint64_t            idle;
@@ -191,6 +196,27 @@ int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
 	uint32_t num_categories, uint32_t data_index_sz, size_t max_size);
 
+int acl_check_rule(const struct rte_acl_rule_data *rd);
+
+/*
+ * Jobs of a build spread over the worker lcores of the context,
+ * see rte_acl_set_ctx_build_lcores().
+ */
+struct acl_workers {
+	const struct rte_acl_ctx *ctx;
+	uint32_t next;	/* next worker to use when all are busy */
+	uint32_t busy;	/* bitmask of the workers running a job */
+	uint32_t jobs;	/* number of jobs launched on the workers */
+	int32_t rc;	/* first error returned by a job */
+};
+
+void acl_workers_init(struct acl_workers *wrk, const struct rte_acl_ctx *ctx);
+
+void acl_workers_launch(struct acl_workers *wrk, int (*fn)(void *),
+	void *arg);
+
+int acl_workers_wait(struct acl_workers *wrk);
+
 typedef int (*rte_acl_classify_t)
 (const struct rte_acl_ctx *, const uint8_t **, uint32_t *, uint32_t, uint32_t);
 
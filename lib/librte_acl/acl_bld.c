@@ -62,6 +62,8 @@ struct rte_acl_build_rule {
 	uint32_t                    *wildness;
 };
 
+struct acl_bld_job;
+
 /* Context for build phase */
 struct acl_build_context {
 	const struct rte_acl_ctx *acx;
@@ -85,6 +87,17 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* tries rebuilt on the worker lcores */
+	struct acl_workers        wrk;
+	struct acl_bld_job        *jobs[RTE_ACL_MAX_TRIES];
+};
+
+/* Rebuild of a trie on a worker lcore, with its own build context */
+struct acl_bld_job {
+	struct acl_build_context  bcx;
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+	uint32_t                  n;
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -1335,6 +1348,98 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+/*
+ * Worker lcore routine: rebuild the trie for the reduced rule-set.
+ */
+static int
+acl_rebuild_trie(void *arg)
+{
+	int32_t rc;
+	struct acl_bld_job *job;
+	struct rte_acl_build_rule *last;
+
+	job = arg;
+
+	rc = sigsetjmp(job->bcx.pool.fail, 0);
+	if (rc != 0)
+		return rc;
+
+	last = build_one_trie(&job->bcx, job->rule_sets, job->n, INT32_MAX);
+	if (job->bcx.bld_tries[job->n].trie == NULL || last != NULL) {
+		RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", job->n);
+		return -ENOMEM;
+	}
+	return 0;
+}
+
+/*
+ * Rebuild the trie on a worker lcore, while the calling thread goes on
+ * with the remaining rules. The job gets its own build context, as
+ * the memory pool and the free lists are not thread safe.
+ */
+static void
+acl_rebuild_trie_launch(struct acl_build_context *context,
+	struct rte_acl_build_rule *rule_set, uint32_t n)
+{
+	struct acl_bld_job *job;
+
+	job = tb_alloc(&context->pool, sizeof(*job));
+	memset(job, 0, sizeof(*job));
+
+	job->bcx.acx = context->acx;
+	job->bcx.cfg = context->cfg;
+	job->bcx.node_max = context->node_max;
+	job->bcx.category_mask = context->category_mask;
+	job->bcx.pool.alignment = ACL_POOL_ALIGN;
+	job->bcx.pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	job->rule_sets[n] = rule_set;
+	job->n = n;
+
+	context->jobs[n] = job;
+	acl_workers_launch(&context->wrk, acl_rebuild_trie, job);
+}
+
+/*
+ * Wait for the rebuilds running on the worker lcores,
+ * then collect the tries they built.
+ */
+static int
+acl_rebuild_trie_wait(struct acl_build_context *context)
+{
+	int32_t rc;
+	uint32_t n;
+	struct acl_bld_job *job;
+
+	rc = acl_workers_wait(&context->wrk);
+	if (rc != 0)
+		return rc;
+
+	for (n = 0; n != RTE_DIM(context->jobs); n++) {
+		job = context->jobs[n];
+		if (job == NULL)
+			continue;
+
+		context->tries[n] = job->bcx.tries[n];
+		context->bld_tries[n] = job->bcx.bld_tries[n];
+		memcpy(context->data_indexes[n], job->bcx.data_indexes[n],
+			sizeof(context->data_indexes[n]));
+		context->tries[n].data_index = context->data_indexes[n];
+		context->num_nodes += job->bcx.num_nodes;
+	}
+	return 0;
+}
+
+static void
+acl_rebuild_trie_free(struct acl_build_context *context)
+{
+	uint32_t n;
+
+	for (n = 0; n != RTE_DIM(context->jobs); n++) {
+		if (context->jobs[n] != NULL)
+			tb_free_pool(&context->jobs[n]->bcx.pool);
+	}
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
@@ -1398,6 +1503,11 @@ acl_build_tries(struct acl_build_context *context,
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
 		 */
+		if (context->acx->num_bld_lcores != 0) {
+			acl_rebuild_trie_launch(context, rule_sets[n], n);
+			continue;
+		}
+
 		last = build_one_trie(context, rule_sets, n, INT32_MAX);
 		if (context->bld_tries[n].trie == NULL || last != NULL) {
 			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
@@ -1407,7 +1517,7 @@ acl_build_tries(struct acl_build_context *context,
 	}
 
 	context->num_tries = num_tries;
-	return 0;
+	return acl_rebuild_trie_wait(context);
 }
 
 static void
@@ -1512,6 +1622,7 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
 		typeof(bcx->category_mask));
 	bcx->node_max = node_max;
+	acl_workers_init(&bcx->wrk, ctx);
 
 	rc = sigsetjmp(bcx->pool.fail, 0);
 
@@ -1520,6 +1631,8 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 		RTE_LOG(ERR, ACL,
 			"ACL context: %s, %s() failed with error code: %d\n",
 			bcx->acx->name, __func__, rc);
+		/* the rebuilds in progress still use the rules */
+		acl_workers_wait(&bcx->wrk);
 		return rc;
 	}
 
@@ -1534,6 +1647,8 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	} else {
 		/* build internal trie representation. */
 		rc = acl_build_tries(bcx, bcx->build_rules);
+		if (rc != 0)
+			acl_workers_wait(&bcx->wrk);
 	}
 	return rc;
 }
@@ -1638,6 +1753,7 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 
 		/* perform build phase. */
 		rc = acl_bld(&bcx, ctx, cfg, n);
+		ctx->num_bld_jobs += bcx.wrk.jobs;
 
 		if (rc == 0) {
 			/* allocate and fill run-time  structures. */
@@ -1660,6 +1776,7 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		acl_build_log(&bcx);
 
 		/* cleanup after build. */
+		acl_rebuild_trie_free(&bcx);
 		tb_free_pool(&bcx.pool);
 	}
 
@@ -30,6 +30,16 @@ struct rte_acl_indices {
 	int32_t match_start;
 };
 
+/* per trie state of the gen phase, see acl_gen_tries() */
+struct acl_gen_job {
+	struct rte_acl_node *root;
+	uint64_t *node_array;
+	uint64_t no_match;
+	int num_categories;
+	struct acl_node_counters counts;
+	struct rte_acl_indices indices;
+};
+
 static void
 acl_gen_log_stats(const struct rte_acl_ctx *ctx,
 	const struct acl_node_counters *counts,
@@ -414,11 +424,46 @@ acl_gen_node(struct rte_acl_node *node, uint64_t *node_array,
 	}
 }
 
+static int
+acl_gen_count_job(void *arg)
+{
+	struct acl_gen_job *job = arg;
+
+	acl_count_trie_types(&job->counts, job->root, job->no_match, 1);
+	return 0;
+}
+
+static int
+acl_gen_node_job(void *arg)
+{
+	struct acl_gen_job *job = arg;
+
+	acl_gen_node(job->root, job->node_array, job->no_match,
+		&job->indices, job->num_categories);
+	return 0;
+}
+
+/*
+ * Run the job for each trie: the first trie on the calling thread,
+ * the others on the worker lcores of the context, if any.
+ * The tries don't share any node, so the jobs are independent.
+ */
+static void
+acl_gen_tries(struct acl_workers *wrk, struct acl_gen_job *job,
+	uint32_t num_tries, int (*fn)(void *))
+{
+	uint32_t n;
+
+	for (n = 1; n < num_tries; n++)
+		acl_workers_launch(wrk, fn, job + n);
+	fn(job);
+	acl_workers_wait(wrk);
+}
+
 static void
 acl_calc_counts_indices(struct acl_node_counters *counts,
-	struct rte_acl_indices *indices,
-	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
-	uint64_t no_match)
+	struct rte_acl_indices *indices, struct acl_workers *wrk,
+	struct acl_gen_job *job, uint32_t num_tries)
 {
 	uint32_t n;
 
@@ -426,9 +471,15 @@ acl_calc_counts_indices(struct acl_node_counters *counts,
 	memset(counts, 0, sizeof(*counts));
 
 	/* Get stats on nodes */
+	acl_gen_tries(wrk, job, num_tries, acl_gen_count_job);
+
 	for (n = 0; n < num_tries; n++) {
-		acl_count_trie_types(counts, node_bld_trie[n].trie,
-			no_match, 1);
+		counts->match += job[n].counts.match;
+		counts->single += job[n].counts.single;
+		counts->quad += job[n].counts.quad;
+		counts->quad_vectors += job[n].counts.quad_vectors;
+		counts->dfa += job[n].counts.dfa;
+		counts->dfa_gr64 += job[n].counts.dfa_gr64;
 	}
 
 	indices->dfa_index = RTE_ACL_DFA_SIZE + 1;
@@ -439,6 +490,20 @@ acl_calc_counts_indices(struct acl_node_counters *counts,
 	indices->match_start = RTE_ALIGN(indices->match_start,
 		(XMM_SIZE / sizeof(uint64_t)));
 	indices->match_index = 1;
+
+	/*
+	 * Each trie gets its own part of every region, in the same order
+	 * as if the tries were generated one after another.
+	 */
+	job[0].indices = *indices;
+	for (n = 1; n < num_tries; n++) {
+		job[n].indices = job[n - 1].indices;
+		job[n].indices.dfa_index += job[n - 1].counts.dfa_gr64 *
+			RTE_ACL_DFA_GR64_SIZE;
+		job[n].indices.quad_index += job[n - 1].counts.quad_vectors;
+		job[n].indices.single_index += job[n - 1].counts.single;
+		job[n].indices.match_index += job[n - 1].counts.match;
+	}
 }
 
 /*
@@ -456,12 +521,21 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_match_results *match;
 	struct acl_node_counters counts;
 	struct rte_acl_indices indices;
+	struct acl_gen_job job[RTE_ACL_MAX_TRIES];
+	struct acl_workers wrk;
 
 	no_match = RTE_ACL_NODE_MATCH;
 
+	memset(job, 0, sizeof(job));
+	for (n = 0; n < num_tries; n++) {
+		job[n].root = node_bld_trie[n].trie;
+		job[n].no_match = no_match;
+		job[n].num_categories = num_categories;
+	}
+	acl_workers_init(&wrk, ctx);
+
 	/* Fill counts and indices arrays from the nodes. */
-	acl_calc_counts_indices(&counts, &indices,
-		node_bld_trie, num_tries, no_match);
+	acl_calc_counts_indices(&counts, &indices, &wrk, job, num_tries);
 
 	/* Allocate runtime memory (align to cache boundary) */
 	total_size = RTE_ALIGN(data_index_sz, RTE_CACHE_LINE_SIZE) +
@@ -505,11 +579,16 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	match = ((struct rte_acl_match_results *)(node_array + match_index));
 	memset(match, 0, sizeof(*match));
 
-	for (n = 0; n < num_tries; n++) {
+	for (n = 0; n < num_tries; n++)
+		job[n].node_array = node_array;
 
-		acl_gen_node(node_bld_trie[n].trie, node_array, no_match,
-			&indices, num_categories);
+	acl_gen_tries(&wrk, job, num_tries, acl_gen_node_job);
+	ctx->num_bld_jobs += wrk.jobs;
 
+	/* the last trie ends every region */
+	indices = job[num_tries - 1].indices;
+
+	for (n = 0; n < num_tries; n++) {
 		if (node_bld_trie[n].trie->node_index == no_match)
 			trie[n].root_index = 0;
 		else
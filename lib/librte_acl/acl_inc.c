@@ -0,0 +1,900 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_acl.h>
+#include <rte_pause.h>
+#include <rte_rcu_qsbr.h>
+#include <rte_spinlock.h>
+
+#include "acl.h"
+
+/*
+ * Incremental ACL: the rules live in a table of slots, every slot being
+ * part of the main context, of the delta context, or of both while a
+ * compaction is in progress. The contexts are built with the slot index
+ * plus one as userdata, so that classify can find the rule behind each
+ * match, check that it is not deleted and compare the priorities of the
+ * main and delta matches.
+ * A rule deleted from the main context is still returned by its tries
+ * until the next compaction, hiding the lower priority rules matching the
+ * same input. These rules are copied to the delta context, which then
+ * gives the result of the input buffers matching the deleted rule.
+ * Every context is doubled: the updates build the spare one and switch
+ * classify to it. The next update waits for the readers to leave the
+ * previous one before reusing it, without holding the update lock.
+ */
+
+/* rule is visible to classify */
+#define ACL_INC_LIVE	0x1
+/* rule is being added to the delta context */
+#define ACL_INC_NEW	0x2
+/* rule is part of the delta context */
+#define ACL_INC_DELTA	0x4
+/* rule is part of the main context */
+#define ACL_INC_MAIN	0x8
+/* rule is part of the main context being built by a compaction */
+#define ACL_INC_SNAP	0x10
+/* rule is out of the published contexts, slot free after a grace period */
+#define ACL_INC_DEAD	0x20
+/* main rule copied to the delta context, as a deleted rule may hide it */
+#define ACL_INC_SHADOW	0x40
+/* rule is being deleted */
+#define ACL_INC_DEL	0x80
+
+/* number of input buffers classified at once */
+#define ACL_INC_BURST	64
+
+/* contexts used by classify, switched at once */
+struct acl_inc_view {
+	struct rte_acl_ctx *main;
+	struct rte_acl_ctx *delta;
+	uint64_t gen;		/**< publish generation */
+};
+
+struct rte_acl_inc {
+	char name[RTE_ACL_NAMESIZE];
+	struct rte_acl_config cfg;	/**< build config of the contexts */
+	struct rte_rcu_qsbr *v;	/**< QSBR variable of the readers */
+	uint64_t token;		/**< QSBR token of the last publish */
+	uint64_t gen;		/**< generation of the last publish */
+	uint32_t rule_sz;
+	uint32_t max_rules;
+	uint32_t max_delta;
+	uint32_t num_delta;	/**< number of live delta rules */
+	uint32_t compacting;	/**< a compaction is in progress */
+	rte_spinlock_t lock;	/**< serializes the updates */
+	struct acl_inc_view *view;	/**< contexts used by classify */
+	struct acl_inc_view views[2];
+	struct rte_acl_ctx *main[2];
+	struct rte_acl_ctx *delta[2];
+	uint8_t *flags;		/**< ACL_INC_* state of each slot */
+	/**
+	 * For each deleted main rule, generation of the first view whose
+	 * delta context holds the rules it hides, zero if none.
+	 */
+	uint64_t *tomb;
+	uint8_t *rules;		/**< rule of each slot */
+	struct rte_acl_rule *tmp;	/**< rule buffer */
+};
+
+static inline const struct rte_acl_rule *
+inc_rule(const struct rte_acl_inc *inc, uint32_t idx)
+{
+	return (const struct rte_acl_rule *)(inc->rules +
+		(size_t)idx * inc->rule_sz);
+}
+
+static inline uint64_t
+inc_field_value(const union rte_acl_field_types *fv, uint32_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return fv->u8;
+	case sizeof(uint16_t):
+		return fv->u16;
+	case sizeof(uint32_t):
+		return fv->u32;
+	default:
+		return fv->u64;
+	}
+}
+
+static inline uint64_t
+inc_input_value(const uint8_t *p, uint32_t size)
+{
+	uint16_t v16;
+	uint32_t v32;
+	uint64_t v64;
+
+	switch (size) {
+	case sizeof(uint8_t):
+		return p[0];
+	case sizeof(uint16_t):
+		memcpy(&v16, p, sizeof(v16));
+		return rte_be_to_cpu_16(v16);
+	case sizeof(uint32_t):
+		memcpy(&v32, p, sizeof(v32));
+		return rte_be_to_cpu_32(v32);
+	default:
+		memcpy(&v64, p, sizeof(v64));
+		return rte_be_to_cpu_64(v64);
+	}
+}
+
+/*
+ * Check the input data buffer against a single rule,
+ * with the same semantics as the tries built by rte_acl_build().
+ */
+static int
+inc_rule_match(const struct rte_acl_inc *inc, const struct rte_acl_rule *rule,
+	const uint8_t *data)
+{
+	const struct rte_acl_field_def *def;
+	const struct rte_acl_field *fld;
+	uint64_t in, val, msk;
+	uint32_t n;
+
+	for (n = 0; n != inc->cfg.num_fields; n++) {
+		def = inc->cfg.defs + n;
+		fld = rule->field + def->field_index;
+		in = inc_input_value(data + def->offset, def->size);
+		val = inc_field_value(&fld->value, def->size);
+
+		switch (def->type) {
+		case RTE_ACL_FIELD_TYPE_MASK:
+			msk = RTE_ACL_MASKLEN_TO_BITMASK(
+				(uint64_t)fld->mask_range.u32, def->size);
+			if (((in ^ val) & msk) != 0)
+				return 0;
+			break;
+		case RTE_ACL_FIELD_TYPE_RANGE:
+			if (in < val || in > inc_field_value(&fld->mask_range,
+					def->size))
+				return 0;
+			break;
+		default:
+			msk = inc_field_value(&fld->mask_range, def->size);
+			if (((in ^ val) & msk) != 0)
+				return 0;
+			break;
+		}
+	}
+	return 1;
+}
+
+/*
+ * Check whether some input data buffer can match both rules.
+ */
+static int
+inc_rule_overlap(const struct rte_acl_inc *inc, const struct rte_acl_rule *r1,
+	const struct rte_acl_rule *r2)
+{
+	const struct rte_acl_field_def *def;
+	const struct rte_acl_field *f1, *f2;
+	uint64_t m1, m2;
+	uint32_t n;
+
+	for (n = 0; n != inc->cfg.num_fields; n++) {
+		def = inc->cfg.defs + n;
+		f1 = r1->field + def->field_index;
+		f2 = r2->field + def->field_index;
+
+		switch (def->type) {
+		case RTE_ACL_FIELD_TYPE_MASK:
+			m1 = RTE_ACL_MASKLEN_TO_BITMASK(
+				(uint64_t)f1->mask_range.u32, def->size);
+			m2 = RTE_ACL_MASKLEN_TO_BITMASK(
+				(uint64_t)f2->mask_range.u32, def->size);
+			break;
+		case RTE_ACL_FIELD_TYPE_RANGE:
+			if (inc_field_value(&f1->value, def->size) >
+					inc_field_value(&f2->mask_range,
+					def->size) ||
+					inc_field_value(&f2->value,
+					def->size) >
+					inc_field_value(&f1->mask_range,
+					def->size))
+				return 0;
+			continue;
+		default:
+			m1 = inc_field_value(&f1->mask_range, def->size);
+			m2 = inc_field_value(&f2->mask_range, def->size);
+			break;
+		}
+		if (((inc_field_value(&f1->value, def->size) ^
+				inc_field_value(&f2->value, def->size)) &
+				m1 & m2) != 0)
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Slow path for the input buffers matching a deleted rule when the delta
+ * context of the view does not hold the rules it hides yet, which only
+ * happens to the calls started before the update publishing them, or
+ * after a failed build: check all the live rules.
+ */
+static void
+inc_scan(const struct rte_acl_inc *inc, const uint8_t *data,
+	uint32_t *results, uint32_t categories)
+{
+	const struct rte_acl_rule *rule;
+	int32_t prio[RTE_ACL_MAX_CATEGORIES];
+	uint32_t c, i;
+
+	for (c = 0; c != categories; c++) {
+		results[c] = 0;
+		prio[c] = 0;
+	}
+
+	for (i = 0; i != inc->max_rules; i++) {
+		if ((__atomic_load_n(&inc->flags[i], __ATOMIC_ACQUIRE) &
+				ACL_INC_LIVE) == 0)
+			continue;
+		rule = inc_rule(inc, i);
+		if (inc_rule_match(inc, rule, data) == 0)
+			continue;
+		for (c = 0; c != categories; c++) {
+			if ((rule->data.category_mask & (1U << c)) != 0 &&
+					rule->data.priority > prio[c]) {
+				prio[c] = rule->data.priority;
+				results[c] = rule->data.userdata;
+			}
+		}
+	}
+}
+
+/*
+ * Merge the results of the main and delta contexts for one input buffer.
+ * A deleted main rule is skipped when the delta context of the view
+ * holds the rules it hides.
+ */
+static void
+inc_merge(const struct rte_acl_inc *inc, const struct acl_inc_view *view,
+	const uint8_t *data, const uint32_t *mres, const uint32_t *dres,
+	uint32_t *results, uint32_t categories)
+{
+	uint64_t tomb;
+	const struct rte_acl_rule *rule;
+	uint32_t c, i, k, res[2];
+	int32_t prio;
+
+	for (c = 0; c != categories; c++) {
+		res[0] = mres[c];
+		res[1] = dres[c];
+		results[c] = 0;
+		prio = 0;
+		for (k = 0; k != RTE_DIM(res); k++) {
+			if (res[k] == 0)
+				continue;
+			i = res[k] - 1;
+			if ((__atomic_load_n(&inc->flags[i], __ATOMIC_ACQUIRE) &
+					ACL_INC_LIVE) == 0) {
+				tomb = __atomic_load_n(&inc->tomb[i],
+					__ATOMIC_RELAXED);
+				if (k == 0 && tomb != 0 && view->gen >= tomb)
+					continue;
+				inc_scan(inc, data, results, categories);
+				return;
+			}
+			rule = inc_rule(inc, i);
+			if (rule->data.priority > prio) {
+				prio = rule->data.priority;
+				results[c] = rule->data.userdata;
+			}
+		}
+	}
+}
+
+int
+rte_acl_inc_classify(const struct rte_acl_inc *inc, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories)
+{
+	const struct acl_inc_view *view;
+	uint32_t mres[ACL_INC_BURST * RTE_ACL_MAX_CATEGORIES];
+	uint32_t dres[ACL_INC_BURST * RTE_ACL_MAX_CATEGORIES];
+	uint32_t i, j, n;
+	int32_t rc;
+
+	if (inc == NULL || data == NULL || results == NULL ||
+			categories == 0 ||
+			categories > RTE_ACL_MAX_CATEGORIES ||
+			(categories != 1 &&
+			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0))
+		return -EINVAL;
+
+	view = __atomic_load_n(&inc->view, __ATOMIC_ACQUIRE);
+
+	for (i = 0; i < num; i += n) {
+		n = RTE_MIN(num - i, (uint32_t)ACL_INC_BURST);
+
+		if (view->main != NULL) {
+			rc = rte_acl_classify(view->main, data + i, mres, n,
+				categories);
+			if (rc != 0)
+				return rc;
+		} else
+			memset(mres, 0, n * categories * sizeof(mres[0]));
+
+		if (view->delta != NULL) {
+			rc = rte_acl_classify(view->delta, data + i, dres, n,
+				categories);
+			if (rc != 0)
+				return rc;
+		} else
+			memset(dres, 0, n * categories * sizeof(dres[0]));
+
+		for (j = 0; j != n; j++)
+			inc_merge(inc, view, data[i + j],
+				mres + j * categories,
+				dres + j * categories,
+				results + (i + j) * categories, categories);
+	}
+
+	return 0;
+}
+
+/*
+ * Switch classify to the given contexts. The previous ones are reused
+ * once the grace period started here is over.
+ */
+static void
+inc_publish(struct rte_acl_inc *inc, struct rte_acl_ctx *mctx,
+	struct rte_acl_ctx *dctx)
+{
+	struct acl_inc_view *view;
+
+	view = &inc->views[inc->view == &inc->views[0]];
+	view->main = mctx;
+	view->delta = dctx;
+	view->gen = ++inc->gen;
+	__atomic_store_n(&inc->view, view, __ATOMIC_RELEASE);
+
+	if (inc->v != NULL)
+		inc->token = rte_rcu_qsbr_start(inc->v);
+}
+
+/*
+ * Retire the slots of the rules deleted from the delta context,
+ * once the delta context without them was published.
+ */
+static void
+inc_sweep(struct rte_acl_inc *inc)
+{
+	uint32_t i;
+
+	for (i = 0; i != inc->max_rules; i++) {
+		if (inc->flags[i] == ACL_INC_DELTA)
+			inc->flags[i] = ACL_INC_DEAD;
+	}
+}
+
+/*
+ * Wait until no reader uses the contexts replaced by the last publish,
+ * then release the retired slots. Called with the update lock held,
+ * which is released while waiting, so it has to come before any use
+ * of the state protected by the lock.
+ */
+static void
+inc_reclaim(struct rte_acl_inc *inc)
+{
+	uint32_t i;
+
+	while (inc->v != NULL &&
+			rte_rcu_qsbr_check(inc->v, inc->token, false) == 0) {
+		rte_spinlock_unlock(&inc->lock);
+		rte_pause();
+		rte_spinlock_lock(&inc->lock);
+	}
+
+	for (i = 0; i != inc->max_rules; i++) {
+		if (inc->flags[i] == ACL_INC_DEAD)
+			__atomic_store_n(&inc->flags[i], 0, __ATOMIC_RELAXED);
+	}
+}
+
+/*
+ * Fill the context with the rules of the slots having all the flags
+ * from *all*, at least one from *any* and none from *none*, or all the
+ * flags from *extra* if not zero, as long as they are not being deleted.
+ */
+static int
+inc_fill(struct rte_acl_inc *inc, struct rte_acl_ctx *ctx, uint8_t all,
+	uint8_t any, uint8_t none, uint8_t extra)
+{
+	uint32_t i;
+	uint8_t f;
+	int32_t rc;
+
+	rte_acl_reset_rules(ctx);
+	for (i = 0; i != inc->max_rules; i++) {
+		f = inc->flags[i];
+		if (((f & all) != all || (f & any) == 0 || (f & none) != 0) &&
+				(extra == 0 ||
+				(f & (extra | ACL_INC_DEL)) != extra))
+			continue;
+		memcpy(inc->tmp, inc_rule(inc, i), inc->rule_sz);
+		inc->tmp->data.userdata = i + 1;
+		rc = rte_acl_add_rules(ctx, inc->tmp, 1);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+/*
+ * Build the spare delta context, without the rules being deleted, and
+ * without the rules being compacted if *none* is ACL_INC_SNAP. The copies
+ * of the main rules hidden by deleted rules are part of it unless
+ * *copies* is zero.
+ * Returns the context to publish, NULL if there are no delta rules.
+ */
+static int
+inc_build_delta(struct rte_acl_inc *inc, uint8_t none, uint32_t copies,
+	struct rte_acl_ctx **delta)
+{
+	struct rte_acl_ctx *ctx;
+	int32_t rc;
+
+	ctx = inc->delta[inc->view->delta == inc->delta[0]];
+	rc = inc_fill(inc, ctx, ACL_INC_DELTA, ACL_INC_LIVE | ACL_INC_NEW,
+		none | ACL_INC_DEL,
+		(copies != 0) ? ACL_INC_SHADOW | ACL_INC_LIVE : 0);
+	if (rc == 0 && ctx->num_rules != 0)
+		rc = rte_acl_build(ctx, &inc->cfg);
+	if (rc != 0)
+		return rc;
+
+	*delta = (ctx->num_rules != 0) ? ctx : NULL;
+	return 0;
+}
+
+/* Find the slot of the live rule with the given userdata. */
+static int32_t
+inc_find(const struct rte_acl_inc *inc, uint32_t userdata)
+{
+	uint32_t i;
+
+	for (i = 0; i != inc->max_rules; i++) {
+		if ((inc->flags[i] & ACL_INC_LIVE) != 0 &&
+				inc_rule(inc, i)->data.userdata == userdata)
+			return i;
+	}
+	return -ENOENT;
+}
+
+/* Number of slots of the delta context used by live rules and copies. */
+static uint32_t
+inc_delta_size(const struct rte_acl_inc *inc)
+{
+	uint32_t i, n;
+
+	for (i = 0, n = inc->num_delta; i != inc->max_rules; i++)
+		n += ((inc->flags[i] & (ACL_INC_SHADOW | ACL_INC_LIVE |
+			ACL_INC_DEL)) == (ACL_INC_SHADOW | ACL_INC_LIVE));
+	return n;
+}
+
+/*
+ * Mark as copies, with ACL_INC_NEW until the delta context holding them is
+ * built, the live main rules which the main rules being deleted may hide:
+ * the rules that may match the same input, in a common category, with a
+ * lower or equal priority. Returns their number.
+ */
+static uint32_t
+inc_shadow(struct rte_acl_inc *inc)
+{
+	const uint8_t in = ACL_INC_MAIN | ACL_INC_SNAP;
+	const struct rte_acl_rule *rd, *rule;
+	uint32_t i, j, n;
+
+	n = 0;
+	for (i = 0; i != inc->max_rules; i++) {
+		if ((inc->flags[i] & ACL_INC_DEL) == 0 ||
+				(inc->flags[i] & in) == 0)
+			continue;
+		rd = inc_rule(inc, i);
+		for (j = 0; j != inc->max_rules; j++) {
+			if ((inc->flags[j] & (ACL_INC_LIVE | ACL_INC_DEL |
+					ACL_INC_SHADOW | ACL_INC_NEW)) !=
+					ACL_INC_LIVE ||
+					(inc->flags[j] & in) == 0)
+				continue;
+			rule = inc_rule(inc, j);
+			if (rule->data.priority > rd->data.priority ||
+					(rule->data.category_mask &
+					rd->data.category_mask) == 0 ||
+					inc_rule_overlap(inc, rule, rd) == 0)
+				continue;
+			inc->flags[j] |= ACL_INC_SHADOW | ACL_INC_NEW;
+			n++;
+		}
+	}
+	return n;
+}
+
+static int
+inc_check_rules(struct rte_acl_inc *inc, const struct rte_acl_rule *rules,
+	uint32_t num)
+{
+	const struct rte_acl_rule *rv, *rp;
+	uint32_t i, j;
+
+	for (i = 0; i != num; i++) {
+		rv = (const struct rte_acl_rule *)
+			((uintptr_t)rules + i * inc->rule_sz);
+		if (rv->data.userdata == 0 || acl_check_rule(&rv->data) != 0 ||
+				(rv->data.category_mask & RTE_LEN2MASK(
+				inc->cfg.num_categories, uint32_t)) == 0) {
+			RTE_LOG(ERR, ACL, "%s(%s): rule #%u is invalid\n",
+				__func__, inc->name, i + 1);
+			return -EINVAL;
+		}
+		if (inc_find(inc, rv->data.userdata) >= 0)
+			return -EEXIST;
+		for (j = 0; j != i; j++) {
+			rp = (const struct rte_acl_rule *)
+				((uintptr_t)rules + j * inc->rule_sz);
+			if (rp->data.userdata == rv->data.userdata)
+				return -EEXIST;
+		}
+	}
+	return 0;
+}
+
+int
+rte_acl_inc_add_rules(struct rte_acl_inc *inc,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	struct rte_acl_ctx *delta;
+	uint32_t i, k;
+	int32_t rc;
+
+	if (inc == NULL || rules == NULL)
+		return -EINVAL;
+	if (num == 0)
+		return 0;
+
+	rte_spinlock_lock(&inc->lock);
+	inc_reclaim(inc);
+
+	if (inc_delta_size(inc) + num > inc->max_delta) {
+		rc = -ENOSPC;
+		goto exit;
+	}
+
+	rc = inc_check_rules(inc, rules, num);
+	if (rc != 0)
+		goto exit;
+
+	for (i = 0, k = 0; i != inc->max_rules && k != num; i++)
+		k += (inc->flags[i] == 0);
+	if (k != num) {
+		rc = -ENOSPC;
+		goto exit;
+	}
+
+	for (i = 0, k = 0; k != num; i++) {
+		if (inc->flags[i] != 0)
+			continue;
+		memcpy((void *)(uintptr_t)inc_rule(inc, i),
+			(const uint8_t *)rules + k * inc->rule_sz,
+			inc->rule_sz);
+		inc->tomb[i] = 0;
+		inc->flags[i] = ACL_INC_DELTA | ACL_INC_NEW;
+		k++;
+	}
+
+	rc = inc_build_delta(inc, 0, 1, &delta);
+
+	/* make the new rules live, or leave them to the next sweep */
+	for (i = 0; i != inc->max_rules; i++) {
+		if ((inc->flags[i] & ACL_INC_NEW) != 0)
+			__atomic_store_n(&inc->flags[i], (rc == 0) ?
+				ACL_INC_DELTA | ACL_INC_LIVE : ACL_INC_DELTA,
+				__ATOMIC_RELEASE);
+	}
+
+	if (rc == 0) {
+		inc->num_delta += num;
+		inc_publish(inc, inc->view->main, delta);
+		inc_sweep(inc);
+	}
+
+exit:
+	rte_spinlock_unlock(&inc->lock);
+	return rc;
+}
+
+int
+rte_acl_inc_del_rules(struct rte_acl_inc *inc, const uint32_t *userdata,
+	uint32_t num)
+{
+	struct rte_acl_ctx *delta;
+	uint64_t token;
+	uint32_t covered, i, k, m, n;
+	int32_t idx, rc;
+	uint8_t f;
+
+	if (inc == NULL || userdata == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&inc->lock);
+	inc_reclaim(inc);
+
+	for (i = 0; i != num; i++) {
+		if (inc_find(inc, userdata[i]) < 0) {
+			rte_spinlock_unlock(&inc->lock);
+			return -ENOENT;
+		}
+	}
+
+	for (i = 0, n = 0, m = 0; i != num; i++) {
+		idx = inc_find(inc, userdata[i]);
+		if (idx < 0 || (inc->flags[idx] & ACL_INC_DEL) != 0)
+			continue;
+		f = inc->flags[idx];
+		inc->flags[idx] = f | ACL_INC_DEL;
+		n += ((f & ACL_INC_DELTA) != 0);
+		m += ((f & (ACL_INC_DELTA | ACL_INC_SHADOW)) != 0);
+	}
+
+	/*
+	 * The main rules hidden by the deleted ones go to the delta context.
+	 * Without room for them, the deleted rules are left to the slow path
+	 * until the next compaction.
+	 */
+	k = inc_shadow(inc);
+	covered = 1;
+	if (k != 0 && inc_delta_size(inc) - n > inc->max_delta) {
+		for (i = 0; i != inc->max_rules; i++) {
+			if ((inc->flags[i] & ACL_INC_NEW) != 0)
+				inc->flags[i] &= ~(ACL_INC_SHADOW |
+					ACL_INC_NEW);
+		}
+		k = 0;
+		covered = 0;
+	}
+
+	/*
+	 * Rebuild the delta context without the deleted rules and with the
+	 * copies, publish it, then hide the deleted rules. If the build
+	 * fails, the deleted rules stay in the delta context until the next
+	 * update, and classify falls back to the slow path for the input
+	 * buffers matching them.
+	 */
+	inc->num_delta -= n;
+	rc = (m != 0 || k != 0) ? inc_build_delta(inc, 0, 1, &delta) :
+		-ENOENT;
+	if (rc == 0)
+		inc_publish(inc, inc->view->main, delta);
+	else if (inc->v != NULL)
+		inc->token = rte_rcu_qsbr_start(inc->v);
+
+	/* the published delta context holds all the copies */
+	covered &= (rc == 0 || k == 0);
+
+	for (i = 0; i != inc->max_rules; i++) {
+		f = inc->flags[i];
+		if ((f & ACL_INC_NEW) != 0)
+			inc->flags[i] = f & ~(ACL_INC_NEW |
+				((rc == 0) ? 0 : ACL_INC_SHADOW));
+		if ((f & ACL_INC_DEL) == 0)
+			continue;
+		if (covered != 0)
+			__atomic_store_n(&inc->tomb[i], inc->view->gen,
+				__ATOMIC_RELAXED);
+		__atomic_store_n(&inc->flags[i], f & ~(ACL_INC_LIVE |
+			ACL_INC_DEL | ACL_INC_SHADOW), __ATOMIC_RELEASE);
+	}
+	if (rc == 0)
+		inc_sweep(inc);
+	token = inc->token;
+
+	rte_spinlock_unlock(&inc->lock);
+
+	/* wait for the readers which may still return the deleted rules */
+	if (inc->v != NULL)
+		rte_rcu_qsbr_check(inc->v, token, true);
+	return 0;
+}
+
+int
+rte_acl_inc_compact(struct rte_acl_inc *inc)
+{
+	struct rte_acl_ctx *mctx, *delta;
+	uint32_t i, k, n;
+	int32_t rc;
+	uint8_t f;
+
+	if (inc == NULL)
+		return -EINVAL;
+
+	rte_spinlock_lock(&inc->lock);
+
+	if (inc->compacting != 0) {
+		rte_spinlock_unlock(&inc->lock);
+		return -EBUSY;
+	}
+	inc->compacting = 1;
+	inc_reclaim(inc);
+
+	/* snapshot the live rules into the spare main context */
+	mctx = inc->main[inc->view->main == inc->main[0]];
+	rc = inc_fill(inc, mctx, ACL_INC_LIVE, ACL_INC_LIVE, 0, 0);
+	for (i = 0; i != inc->max_rules && rc == 0; i++) {
+		if ((inc->flags[i] & ACL_INC_LIVE) != 0)
+			inc->flags[i] |= ACL_INC_SNAP;
+	}
+
+	rte_spinlock_unlock(&inc->lock);
+
+	/* the long part, updates and classify go on meanwhile */
+	if (rc == 0 && mctx->num_rules != 0)
+		rc = rte_acl_build(mctx, &inc->cfg);
+
+	rte_spinlock_lock(&inc->lock);
+	inc_reclaim(inc);
+
+	/*
+	 * The rules added meanwhile stay in the delta context, the copies
+	 * too if some rules were deleted meanwhile from the new main context.
+	 */
+	for (i = 0, k = 0; i != inc->max_rules; i++)
+		k += ((inc->flags[i] & (ACL_INC_SNAP | ACL_INC_LIVE)) ==
+			ACL_INC_SNAP);
+	if (rc == 0)
+		rc = inc_build_delta(inc, ACL_INC_SNAP, k, &delta);
+
+	if (rc == 0)
+		inc_publish(inc, (mctx->num_rules != 0) ? mctx : NULL, delta);
+
+	for (i = 0, n = 0; i != inc->max_rules; i++) {
+		f = inc->flags[i];
+		/* copies left out of the new delta context */
+		if (rc == 0 && k == 0)
+			f &= ~ACL_INC_SHADOW;
+		if (rc != 0)
+			f &= ~ACL_INC_SNAP;
+		else if ((f & ACL_INC_SNAP) != 0)
+			f = (f & (ACL_INC_LIVE | ACL_INC_SHADOW)) | ACL_INC_MAIN;
+		/* deleted rules of the previous main context */
+		else if ((f & ACL_INC_MAIN) != 0)
+			f = ACL_INC_DEAD;
+		else if (f == ACL_INC_DELTA)
+			f = ACL_INC_DEAD;
+		__atomic_store_n(&inc->flags[i], f, __ATOMIC_RELAXED);
+		n += ((f & (ACL_INC_DELTA | ACL_INC_LIVE)) ==
+			(ACL_INC_DELTA | ACL_INC_LIVE));
+	}
+	inc->num_delta = n;
+
+	inc->compacting = 0;
+	rte_spinlock_unlock(&inc->lock);
+	return rc;
+}
+
+static int
+inc_check_param(const struct rte_acl_inc_param *param)
+{
+	const struct rte_acl_config *cfg;
+	uint32_t i;
+
+	if (param == NULL || param->name == NULL || param->cfg == NULL ||
+			param->max_rule_num == 0 ||
+			param->max_delta_rule_num == 0)
+		return -EINVAL;
+
+	cfg = param->cfg;
+	if (cfg->num_categories == 0 ||
+			cfg->num_categories > RTE_ACL_MAX_CATEGORIES ||
+			cfg->num_fields == 0 ||
+			cfg->num_fields > RTE_ACL_MAX_FIELDS ||
+			param->rule_size < RTE_ACL_RULE_SZ(cfg->num_fields))
+		return -EINVAL;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		if (cfg->defs[i].type > RTE_ACL_FIELD_TYPE_BITMASK ||
+				cfg->defs[i].field_index >= cfg->num_fields ||
+				!rte_is_power_of_2(cfg->defs[i].size) ||
+				cfg->defs[i].size > sizeof(uint64_t))
+			return -EINVAL;
+	}
+	return 0;
+}
+
+void
+rte_acl_inc_free(struct rte_acl_inc *inc)
+{
+	uint32_t i;
+
+	if (inc == NULL)
+		return;
+
+	for (i = 0; i != RTE_DIM(inc->main); i++) {
+		rte_acl_free(inc->main[i]);
+		rte_acl_free(inc->delta[i]);
+	}
+	rte_free(inc);
+}
+
+struct rte_acl_inc *
+rte_acl_inc_create(const struct rte_acl_inc_param *param)
+{
+	struct rte_acl_inc *inc;
+	struct rte_acl_ctx *ctx;
+	struct rte_acl_param prm;
+	char name[RTE_ACL_NAMESIZE];
+	uint32_t i, k;
+	size_t sz;
+
+	if (inc_check_param(param) != 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	sz = sizeof(*inc) + param->max_rule_num +
+		(size_t)param->max_rule_num * sizeof(inc->tomb[0]) +
+		(size_t)(param->max_rule_num + 1) * param->rule_size;
+	inc = rte_zmalloc_socket("ACL_INC", sz, RTE_CACHE_LINE_SIZE,
+		param->socket_id);
+	if (inc == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			sz, param->socket_id, param->name);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	strlcpy(inc->name, param->name, sizeof(inc->name));
+	inc->cfg = *param->cfg;
+	inc->v = param->v;
+	inc->rule_sz = param->rule_size;
+	inc->max_rules = param->max_rule_num;
+	inc->max_delta = param->max_delta_rule_num;
+	rte_spinlock_init(&inc->lock);
+	inc->view = &inc->views[0];
+	inc->tomb = (uint64_t *)(inc + 1);
+	inc->tmp = (struct rte_acl_rule *)(inc->tomb + param->max_rule_num);
+	inc->rules = (uint8_t *)inc->tmp + param->rule_size;
+	inc->flags = inc->rules + (size_t)param->max_rule_num *
+		param->rule_size;
+
+	prm.socket_id = param->socket_id;
+	prm.rule_size = param->rule_size;
+	prm.name = name;
+
+	/* two main and two delta contexts, named <name>_m0 ... <name>_d1 */
+	for (i = 0; i != 2 * RTE_DIM(inc->main); i++) {
+		k = i % RTE_DIM(inc->main);
+		prm.max_rule_num = (i < RTE_DIM(inc->main)) ?
+			param->max_rule_num : param->max_delta_rule_num;
+		if (snprintf(name, sizeof(name), "%s_%c%u", param->name,
+				(i < RTE_DIM(inc->main)) ? 'm' : 'd', k) >=
+				(int)sizeof(name)) {
+			rte_errno = EINVAL;
+			goto error;
+		}
+		if (rte_acl_find_existing(name) != NULL) {
+			rte_errno = EEXIST;
+			goto error;
+		}
+		ctx = rte_acl_create(&prm);
+		if (ctx == NULL) {
+			rte_errno = ENOMEM;
+			goto error;
+		}
+		if (i < RTE_DIM(inc->main))
+			inc->main[k] = ctx;
+		else
+			inc->delta[k] = ctx;
+	}
+
+	return inc;
+
+error:
+	rte_acl_inc_free(inc);
+	return NULL;
+}
@@ -3,6 +3,8 @@
  */
 
 #include <rte_eal_memconfig.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include <rte_string_fns.h>
 #include <rte_acl.h>
 #include <rte_tailq.h>
@@ -287,6 +289,111 @@ rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx, enum rte_acl_classify_alg alg)
 	return 0;
 }
 
+int
+rte_acl_set_ctx_build_lcores(struct rte_acl_ctx *ctx,
+	const unsigned int *lcores, uint32_t num)
+{
+	uint32_t i;
+
+	if (ctx == NULL || (lcores == NULL && num != 0) ||
+			num > RTE_DIM(ctx->bld_lcores))
+		return -EINVAL;
+
+	for (i = 0; i != num; i++) {
+		if (lcores[i] >= RTE_MAX_LCORE ||
+				lcores[i] == rte_get_main_lcore() ||
+				!rte_lcore_is_enabled(lcores[i]))
+			return -EINVAL;
+	}
+
+	for (i = 0; i != num; i++)
+		ctx->bld_lcores[i] = lcores[i];
+	ctx->num_bld_lcores = num;
+	return 0;
+}
+
+void
+acl_workers_init(struct acl_workers *wrk, const struct rte_acl_ctx *ctx)
+{
+	wrk->ctx = ctx;
+	wrk->next = 0;
+	wrk->busy = 0;
+	wrk->jobs = 0;
+	wrk->rc = 0;
+}
+
+static void
+acl_workers_join(struct acl_workers *wrk, uint32_t i)
+{
+	int32_t rc;
+
+	rc = rte_eal_wait_lcore(wrk->ctx->bld_lcores[i]);
+	if (wrk->rc == 0)
+		wrk->rc = rc;
+	wrk->busy &= ~(1U << i);
+}
+
+/*
+ * Run the job on a free worker lcore, waiting for one if they are all
+ * busy. As lcores are launched from the main lcore only, the job runs
+ * on the calling thread if it is not the main lcore, if the context has
+ * no worker lcores, or if the worker is not available.
+ */
+void
+acl_workers_launch(struct acl_workers *wrk, int (*fn)(void *), void *arg)
+{
+	const struct rte_acl_ctx *ctx;
+	uint32_t i, lcore;
+	int32_t rc;
+
+	ctx = wrk->ctx;
+	if (rte_lcore_id() != rte_get_main_lcore()) {
+		rc = fn(arg);
+		if (wrk->rc == 0)
+			wrk->rc = rc;
+		return;
+	}
+
+	for (i = 0; i != ctx->num_bld_lcores &&
+			(wrk->busy & (1U << i)) != 0; i++)
+		;
+
+	if (i == ctx->num_bld_lcores && i != 0) {
+		i = wrk->next;
+		wrk->next = (wrk->next + 1) % ctx->num_bld_lcores;
+		acl_workers_join(wrk, i);
+	}
+
+	if (i != ctx->num_bld_lcores) {
+		lcore = ctx->bld_lcores[i];
+		if (rte_eal_get_lcore_state(lcore) == WAIT &&
+				rte_eal_remote_launch(fn, arg, lcore) == 0) {
+			wrk->busy |= 1U << i;
+			wrk->jobs++;
+			return;
+		}
+	}
+
+	rc = fn(arg);
+	if (wrk->rc == 0)
+		wrk->rc = rc;
+}
+
+/*
+ * Wait for all the jobs, returns the first error they reported.
+ */
+int
+acl_workers_wait(struct acl_workers *wrk)
+{
+	uint32_t i;
+
+	for (i = 0; i != wrk->ctx->num_bld_lcores; i++) {
+		if ((wrk->busy & (1U << i)) != 0)
+			acl_workers_join(wrk, i);
+	}
+	return wrk->rc;
+}
+
 int
 rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories,
@@ -448,7 +555,7 @@ acl_add_rules(struct rte_acl_ctx *ctx, const void *rules, uint32_t num)
 	return 0;
 }
 
-static int
+int
 acl_check_rule(const struct rte_acl_rule_data *rd)
 {
 	if ((RTE_LEN2MASK(RTE_ACL_MAX_CATEGORIES, typeof(rd->category_mask)) &
@@ -518,12 +625,14 @@ rte_acl_dump(const struct rte_acl_ctx *ctx)
 	printf("acl context <%s>@%p\n", ctx->name, ctx);
 	printf("  socket_id=%"PRId32"\n", ctx->socket_id);
 	printf("  alg=%"PRId32"\n", ctx->alg);
+	printf("  num_bld_lcores=%"PRIu32"\n", ctx->num_bld_lcores);
 	printf("  first_load_sz=%"PRIu32"\n", ctx->first_load_sz);
 	printf("  max_rules=%"PRIu32"\n", ctx->max_rules);
 	printf("  rule_size=%"PRIu32"\n", ctx->rule_sz);
 	printf("  num_rules=%"PRIu32"\n", ctx->num_rules);
 	printf("  num_categories=%"PRIu32"\n", ctx->num_categories);
 	printf("  num_tries=%"PRIu32"\n", ctx->num_tries);
+	printf("  num_bld_jobs=%"PRIu32"\n", ctx->num_bld_jobs);
 }
 
 /*
@@ -11,6 +11,7 @@
  * RTE Classifier.
  */
 
+#include <rte_compat.h>
 #include <rte_acl_osdep.h>
 
 #ifdef __cplusplus
@@ -339,6 +340,37 @@ extern int
 rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx,
 	enum rte_acl_classify_alg alg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the worker lcores used to build the given ACL context.
+ * rte_acl_build() then rebuilds the tries of the context and generates
+ * their run-time structures in parallel on these lcores, while the
+ * calling thread splits the rule set into tries.
+ * As lcores are launched from the main lcore only, the workers are used
+ * when rte_acl_build() is called on the main lcore, the build runs on the
+ * calling thread otherwise. The application must not launch anything on
+ * the worker lcores during the build: the lcores have to be in WAIT state
+ * when rte_acl_build() is called, the jobs of busy lcores run on the
+ * calling thread instead.
+ *
+ * @param ctx
+ *   ACL context to change the build workers for.
+ * @param lcores
+ *   Array of worker lcore ids, not including the main lcore.
+ * @param num
+ *   Number of worker lcores, up to 8 (the maximum number of tries),
+ *   zero to build on the calling thread only.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_set_ctx_build_lcores(struct rte_acl_ctx *ctx,
+	const unsigned int *lcores, uint32_t num);
+
 /**
  * Dump an ACL context structure to the console.
  *
@@ -354,6 +386,178 @@ rte_acl_dump(const struct rte_acl_ctx *ctx);
 void
 rte_acl_list_dump(void);
 
+struct rte_rcu_qsbr;
+struct rte_acl_inc;
+
+/**
+ * Parameters used when creating an incrementally updated ACL.
+ */
+struct rte_acl_inc_param {
+	const char *name;         /**< Name of the incremental ACL. */
+	int         socket_id;    /**< Socket ID to allocate memory for. */
+	uint32_t    rule_size;    /**< Size of each rule. */
+	uint32_t    max_rule_num;
+	/**< Maximum number of rules, including deleted not compacted ones. */
+	uint32_t    max_delta_rule_num;
+	/**<
+	 * Maximum number of rules of the delta context: the rules added
+	 * since the last compaction, and the copies of the main rules hidden
+	 * by deleted ones.
+	 */
+	const struct rte_acl_config *cfg; /**< Build configuration. */
+	struct rte_rcu_qsbr *v;
+	/**<
+	 * RCU QSBR variable of the threads calling rte_acl_inc_classify(),
+	 * NULL if classify is never called concurrently with the updates.
+	 */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new incrementally updated ACL.
+ *
+ * The rules are split between a main ACL context, rebuilt only by
+ * rte_acl_inc_compact(), and a small delta context holding the rules
+ * added since, which is rebuilt on every update. Classify searches both
+ * contexts, so the updates are visible as soon as the small delta
+ * context is built. Deleted rules which are still part of the main
+ * context may hide lower priority rules until the next compaction: these
+ * are copied to the delta context, which gives the result of the input
+ * buffers matching a deleted rule.
+ *
+ * @param param
+ *   Parameters used to create and initialise the incremental ACL.
+ * @return
+ *   Pointer to the incremental ACL, or NULL on error, with error code
+ *   set in rte_errno. Possible rte_errno errors include:
+ *   - EINVAL - invalid parameter passed to function
+ *   - EEXIST - an ACL context with the same name already exists
+ *   - ENOMEM - unable to allocate memory
+ */
+__rte_experimental
+struct rte_acl_inc *
+rte_acl_inc_create(const struct rte_acl_inc_param *param);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * De-allocate all memory used by an incremental ACL.
+ *
+ * @param inc
+ *   Incremental ACL to free
+ */
+__rte_experimental
+void
+rte_acl_inc_free(struct rte_acl_inc *inc);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add rules to an incremental ACL and make them visible to classify.
+ * The userdata of each rule identifies it and has to be unique and
+ * non zero. This function is multi-thread safe.
+ *
+ * @param inc
+ *   Incremental ACL to add rules to.
+ * @param rules
+ *   Array of rules to add, in the same format as for rte_acl_add_rules().
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOSPC if the delta context or the rule table is full,
+ *     rte_acl_inc_compact() has to be called to make room.
+ *   - -EEXIST if a rule with the same userdata already exists.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if the build of the delta context failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_inc_add_rules(struct rte_acl_inc *inc,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete rules from an incremental ACL. The deleted rules are no longer
+ * returned by classify once this function returns.
+ * If the delta context has no room for the copies of the main rules hidden
+ * by the deleted ones, the input buffers matching the deleted rules are
+ * matched rule by rule until the next rte_acl_inc_compact().
+ * This function is multi-thread safe.
+ *
+ * @param inc
+ *   Incremental ACL to delete rules from.
+ * @param userdata
+ *   Array of userdata of the rules to delete.
+ * @param num
+ *   Number of elements in the userdata array.
+ * @return
+ *   - -ENOENT if one of the rules is not found, no rule is deleted then.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_inc_del_rules(struct rte_acl_inc *inc, const uint32_t *userdata,
+	uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Rebuild the main context with all the current rules, then switch
+ * classify to it, leaving the delta context empty.
+ * The build runs without blocking the updates and classify, so this
+ * function is meant to be called from a control thread.
+ *
+ * @param inc
+ *   Incremental ACL to compact.
+ * @return
+ *   - -EBUSY if a compaction is already in progress.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if the build failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_inc_compact(struct rte_acl_inc *inc);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Perform search for a matching rule of an incremental ACL for each input
+ * data buffer, with the same semantics as rte_acl_classify().
+ * If the incremental ACL was created with an RCU QSBR variable, the
+ * calling thread has to be registered to it and report its quiescent
+ * states outside of the calls to this function.
+ *
+ * @param inc
+ *   Incremental ACL to search with.
+ * @param data
+ *   Array of pointers to input data buffers to perform search.
+ * @param results
+ *   Array of search results, *categories* results per each input data buffer.
+ * @param num
+ *   Number of elements in the input data buffers array.
+ * @param categories
+ *   Number of maximum possible matches for each input buffer, one possible
+ *   match per category.
+ * @return
+ *   zero on successful completion.
+ *   -EINVAL for incorrect arguments.
+ */
+__rte_experimental
+int
+rte_acl_inc_classify(const struct rte_acl_inc *inc, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,6 +14,8 @@
 #include <rte_errno.h>
 #include <rte_memory.h>
 #include <rte_vect.h>
+#include <rte_log.h>
+#include <rte_rcu_qsbr.h>
 
 #include <rte_rib.h>
 #include <rte_fib.h>
@@ -150,7 +152,7 @@ write_to_fib(void *ptr, uint64_t val, enum rte_fib_dir24_8_nh_sz size, int n)
 }
 
 static int
-tbl8_get_idx(struct dir24_8_tbl *dp)
+__tbl8_get_idx(struct dir24_8_tbl *dp)
 {
 	uint32_t i;
 	int bit_idx;
@@ -173,6 +175,84 @@ tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
 		~(1ULL << (idx & BITMAP_SLAB_BITMASK));
 }
 
+static void
+tbl8_cleanup(struct dir24_8_tbl *dp, uint32_t tbl8_idx)
+{
+	memset((uint8_t *)dp->tbl8 +
+		((tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT) << dp->nh_sz), 0,
+		DIR24_8_TBL8_GRP_NUM_ENT << dp->nh_sz);
+	tbl8_free_idx(dp, tbl8_idx);
+	dp->cur_tbl8s--;
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	RTE_SET_USED(n);
+	tbl8_cleanup((struct dir24_8_tbl *)p, *(uint32_t *)data);
+}
+
+/* Reclaim the tbl8s released by a batch after one grace period */
+static void
+tbl8_reclaim_pending(struct dir24_8_tbl *dp)
+{
+	uint32_t i;
+
+	if (dp->num_pending == 0)
+		return;
+
+	rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+	for (i = 0; i < dp->num_pending; i++)
+		tbl8_cleanup(dp, dp->tbl8_pending[i]);
+	dp->num_pending = 0;
+}
+
+static int
+tbl8_get_idx(struct dir24_8_tbl *dp)
+{
+	int tbl8_idx;
+
+	tbl8_idx = __tbl8_get_idx(dp);
+	if (tbl8_idx != -ENOSPC || dp->v == NULL)
+		return tbl8_idx;
+
+	/* If there are no tbl8s left try to reclaim released ones. */
+	if (dp->num_pending != 0)
+		tbl8_reclaim_pending(dp);
+	else if (dp->dq == NULL || rte_rcu_qsbr_dq_reclaim(dp->dq, 1,
+			NULL, NULL, NULL) != 0)
+		return tbl8_idx;
+
+	return __tbl8_get_idx(dp);
+}
+
+/*
+ * Release a tbl8 no longer referenced from tbl24. With RCU, it is cleaned
+ * and reused only once the readers can not hold a reference to it anymore.
+ */
+static void
+tbl8_free(struct dir24_8_tbl *dp, uint32_t tbl8_idx)
+{
+	if (dp->v == NULL) {
+		tbl8_cleanup(dp, tbl8_idx);
+		return;
+	}
+
+	if (dp->rcu_mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(dp->dq, &tbl8_idx) == 0)
+			return;
+		RTE_LOG(DEBUG, LPM, "Failed to push QSBR FIFO\n");
+	} else if (dp->in_batch) {
+		dp->tbl8_pending[dp->num_pending++] = tbl8_idx;
+		return;
+	}
+
+	/* Wait for quiescent state change. */
+	rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+	tbl8_cleanup(dp, tbl8_idx);
+}
+
 static int
 tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 {
@@ -190,6 +270,8 @@ tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 		DIR24_8_EXT_ENT, dp->nh_sz,
 		DIR24_8_TBL8_GRP_NUM_ENT);
 	dp->cur_tbl8s++;
+	/* tbl8 must be filled in before it is published in tbl24 */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
 	return tbl8_idx;
 }
 
@@ -214,8 +296,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint8_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr8[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_2B:
 		ptr16 = &((uint16_t *)dp->tbl8)[tbl8_idx *
@@ -227,8 +307,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint16_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr16[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_4B:
 		ptr32 = &((uint32_t *)dp->tbl8)[tbl8_idx *
@@ -240,8 +318,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint32_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr32[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_8B:
 		ptr64 = &((uint64_t *)dp->tbl8)[tbl8_idx *
@@ -253,12 +329,9 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint64_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr64[i] = 0;
 		break;
 	}
-	tbl8_free_idx(dp, tbl8_idx);
-	dp->cur_tbl8s--;
+	tbl8_free(dp, tbl8_idx);
 }
 
 static int
@@ -562,11 +635,78 @@ dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
 	return dp;
 }
 
+void
+dir24_8_batch_start(void *p)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+
+	dp->in_batch = 1;
+}
+
+void
+dir24_8_batch_finish(void *p)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+
+	tbl8_reclaim_pending(dp);
+	dp->in_batch = 0;
+}
+
+int
+dir24_8_rcu_qsbr_add(void *p, struct rte_fib_rcu_config *cfg,
+	const char *name)
+{
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (dp->v != NULL)
+		return -EEXIST;
+
+	if (cfg->mode == RTE_FIB_QSBR_MODE_SYNC) {
+		/* tbl8s released by a batch wait for the end of it */
+		dp->tbl8_pending = rte_zmalloc(NULL,
+			sizeof(uint32_t) * dp->number_tbl8s, 0);
+		if (dp->tbl8_pending == NULL)
+			return -ENOMEM;
+	} else if (cfg->mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"FIB_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = dp->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 group index */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			RTE_LOG(ERR, LPM, "FIB defer queue creation failed\n");
+			return -rte_errno;
+		}
+	} else
+		return -EINVAL;
+
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
+
 void
 dir24_8_free(void *p)
 {
 	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
 
+	if (dp->dq != NULL)
+		rte_rcu_qsbr_dq_delete(dp->dq);
+	rte_free(dp->tbl8_pending);
 	rte_free(dp->tbl8_idxes);
 	rte_free(dp->tbl8);
 	rte_free(dp);
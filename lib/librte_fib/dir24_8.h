@@ -35,6 +35,13 @@ struct dir24_8_tbl {
 	uint64_t	def_nh;		/**< Default next hop */
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint64_t	*tbl8_idxes;	/**< bitmap containing free tbl8 idxes*/
+	/* RCU config. */
+	struct rte_rcu_qsbr	*v;		/* RCU QSBR variable. */
+	enum rte_fib_qsbr_mode	rcu_mode;	/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq	*dq;		/* RCU QSBR defer queue. */
+	uint32_t	*tbl8_pending;	/**< tbl8s released by the batch */
+	uint32_t	num_pending;	/**< Number of released tbl8s */
+	int		in_batch;	/**< Batch update in progress */
 	/* tbl24 table. */
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
@@ -252,6 +259,16 @@ int
 dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	uint64_t next_hop, int op);
 
+void
+dir24_8_batch_start(void *p);
+
+void
+dir24_8_batch_finish(void *p);
+
+int
+dir24_8_rcu_qsbr_add(void *p, struct rte_fib_rcu_config *cfg,
+	const char *name);
+
 #ifdef __cplusplus
 }
 #endif
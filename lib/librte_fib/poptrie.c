@@ -0,0 +1,728 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_debug.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_memory.h>
+#include <rte_vect.h>
+
+#include <rte_rib6.h>
+#include <rte_fib6.h>
+#include "poptrie.h"
+
+#ifdef CC_POPTRIE_AVX512_SUPPORT
+
+#include "poptrie_avx512.h"
+
+#endif /* CC_POPTRIE_AVX512_SUPPORT */
+
+#define POPTRIE_NAMESIZE	64
+#define POPTRIE_POOL_END	UINT32_MAX
+
+/* Next hops and more specific routes of the entries of a node */
+struct poptrie_ents {
+	uint64_t	nh[POPTRIE_NODE_NUM_ENT];
+	uint8_t		depth[POPTRIE_NODE_NUM_ENT];
+	uint64_t	sub;	/**< bitmap of the entries with subroutes */
+};
+
+static inline rte_fib6_lookup_fn_t
+get_vector_fn(void)
+{
+#ifdef CC_POPTRIE_AVX512_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0) ||
+			(rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) <= 0) ||
+			(rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_512))
+		return NULL;
+	return rte_poptrie_vec_lookup_bulk;
+#else
+	return NULL;
+#endif
+}
+
+rte_fib6_lookup_fn_t
+poptrie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
+{
+	rte_fib6_lookup_fn_t ret_fn;
+
+	if (p == NULL)
+		return NULL;
+
+	switch (type) {
+	case RTE_FIB6_LOOKUP_POPTRIE_SCALAR:
+		return rte_poptrie_lookup_bulk;
+	case RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512:
+		return get_vector_fn();
+	case RTE_FIB6_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn();
+		return (ret_fn != NULL) ? ret_fn : rte_poptrie_lookup_bulk;
+	default:
+		return NULL;
+	}
+}
+
+static void
+pool_init(struct poptrie_pool *pool, void *base, uint32_t esize,
+	uint32_t size)
+{
+	uint32_t i;
+
+	pool->base = base;
+	pool->esize = esize;
+	pool->size = size;
+	pool->top = 0;
+	pool->used = 0;
+	for (i = 0; i < POPTRIE_NUM_ORDERS; i++)
+		pool->free_head[i] = POPTRIE_POOL_END;
+}
+
+/* Free blocks are linked through their first 4 bytes */
+static inline uint32_t *
+pool_link(struct poptrie_pool *pool, uint32_t idx)
+{
+	return (uint32_t *)((uint8_t *)pool->base + (size_t)idx * pool->esize);
+}
+
+static inline uint32_t
+get_order(uint32_t n)
+{
+	return (n <= 1) ? 0 : 32 - __builtin_clz(n - 1);
+}
+
+static inline uint32_t
+pool_pop(struct poptrie_pool *pool, uint32_t order)
+{
+	uint32_t idx = pool->free_head[order];
+
+	pool->free_head[order] = *pool_link(pool, idx);
+	return idx;
+}
+
+static inline void
+pool_push(struct poptrie_pool *pool, uint32_t order, uint32_t idx)
+{
+	*pool_link(pool, idx) = pool->free_head[order];
+	pool->free_head[order] = idx;
+}
+
+/*
+ * Allocate a block of n consecutive elements, from the free list of its
+ * size, then from the never used elements, then splitting a larger block.
+ */
+static int
+pool_alloc(struct poptrie_pool *pool, uint32_t n, uint32_t *idx)
+{
+	uint32_t order, o;
+
+	*idx = 0;
+	if (n == 0)
+		return 0;
+
+	order = get_order(n);
+	if (pool->free_head[order] != POPTRIE_POOL_END) {
+		*idx = pool_pop(pool, order);
+	} else if (pool->size - pool->top >= (1U << order)) {
+		*idx = pool->top;
+		pool->top += 1U << order;
+	} else {
+		for (o = order + 1; (o < POPTRIE_NUM_ORDERS) &&
+				(pool->free_head[o] == POPTRIE_POOL_END); o++)
+			;
+		if (o == POPTRIE_NUM_ORDERS)
+			return -ENOSPC;
+		*idx = pool_pop(pool, o);
+		while (o-- != order)
+			pool_push(pool, o, *idx + (1U << o));
+	}
+	pool->used += 1U << order;
+	return 0;
+}
+
+static void
+pool_free(struct poptrie_pool *pool, uint32_t idx, uint32_t n)
+{
+	uint32_t order;
+
+	if (n == 0)
+		return;
+
+	order = get_order(n);
+	pool_push(pool, order, idx);
+	pool->used -= 1U << order;
+}
+
+static void
+put_ip_parts(uint8_t *ip, uint64_t hi, uint64_t lo)
+{
+	uint64_t tmp[2];
+
+	tmp[0] = rte_cpu_to_be_64(hi);
+	tmp[1] = rte_cpu_to_be_64(lo);
+	memcpy(ip, tmp, sizeof(tmp));
+}
+
+/* Set the bits of a node entry index in an address masked at off */
+static void
+set_slot(uint8_t *ip, uint32_t off, uint32_t slot)
+{
+	uint64_t hi, lo;
+
+	get_ip_parts(ip, &hi, &lo);
+	if (off < 64)
+		hi |= (uint64_t)slot << (64 - POPTRIE_STRIDE - off);
+	else if (off + POPTRIE_STRIDE <= 128)
+		lo |= (uint64_t)slot << (128 - POPTRIE_STRIDE - off);
+	else
+		lo |= (uint64_t)slot >> (off + POPTRIE_STRIDE - 128);
+	put_ip_parts(ip, hi, lo);
+}
+
+static inline uint32_t
+get_ip_slot(const uint8_t *ip, uint32_t off)
+{
+	uint64_t hi, lo;
+
+	get_ip_parts(ip, &hi, &lo);
+	return get_slot(hi, lo, off);
+}
+
+static inline uint32_t
+get_tbl16_idx(const uint8_t *ip)
+{
+	return (ip[0] << 8) | ip[1];
+}
+
+/* Get the next hop of the most specific route covering ip/depth */
+static uint64_t
+get_cover_nh(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	const uint8_t *ip, uint8_t depth)
+{
+	struct rte_rib6_node *node;
+	uint64_t nh;
+	uint8_t node_depth;
+
+	node = rte_rib6_lookup(rib, ip);
+	while (node != NULL) {
+		rte_rib6_get_depth(node, &node_depth);
+		if (node_depth <= depth) {
+			rte_rib6_get_nh(node, &nh);
+			return nh;
+		}
+		node = rte_rib6_lookup_parent(node);
+	}
+	return dp->def_nh;
+}
+
+/*
+ * Compute the next hop of every entry of the node for ip/off, by expanding
+ * the routes ending in the node, and the entries having more specific
+ * routes which need a child node.
+ */
+static void
+get_node_ents(struct rte_rib6 *rib, const uint8_t *ip, uint32_t off,
+	uint64_t def_nh, struct poptrie_ents *ents)
+{
+	struct rte_rib6_node *node = NULL;
+	uint8_t node_ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint32_t i, first, num;
+	uint64_t nh;
+	uint8_t depth;
+
+	for (i = 0; i < POPTRIE_NODE_NUM_ENT; i++) {
+		ents->nh[i] = def_nh;
+		ents->depth[i] = 0;
+	}
+	ents->sub = 0;
+
+	while ((node = rte_rib6_get_nxt(rib, ip, off, node,
+			RTE_RIB6_GET_NXT_ALL)) != NULL) {
+		rte_rib6_get_ip(node, node_ip);
+		rte_rib6_get_depth(node, &depth);
+		first = get_ip_slot(node_ip, off);
+		if (depth > off + POPTRIE_STRIDE) {
+			ents->sub |= 1ULL << first;
+			continue;
+		}
+		rte_rib6_get_nh(node, &nh);
+		num = RTE_MIN(1U << (off + POPTRIE_STRIDE - depth),
+			POPTRIE_NODE_NUM_ENT - first);
+		for (i = first; i < first + num; i++) {
+			if (depth > ents->depth[i]) {
+				ents->depth[i] = depth;
+				ents->nh[i] = nh;
+			}
+		}
+	}
+}
+
+/* Number of leaf runs, consecutive leaves with the same next hop merged */
+static uint32_t
+get_leaf_num(const struct poptrie_ents *ents, uint64_t *leafvec)
+{
+	uint64_t prev_nh = 0;
+	uint32_t i, num = 0;
+
+	*leafvec = 0;
+	for (i = 0; i < POPTRIE_NODE_NUM_ENT; i++) {
+		if ((ents->sub >> i) & 1)
+			continue;
+		if ((num == 0) || (ents->nh[i] != prev_nh)) {
+			*leafvec |= 1ULL << i;
+			num++;
+		}
+		prev_nh = ents->nh[i];
+	}
+	return num;
+}
+
+static void
+write_leaves(struct rte_poptrie_tbl *dp, const struct poptrie_ents *ents,
+	uint64_t leafvec, uint32_t base0)
+{
+	uint32_t i;
+
+	for (i = 0; i < POPTRIE_NODE_NUM_ENT; i++) {
+		if ((leafvec >> i) & 1)
+			dp->leaves[base0++] = ents->nh[i];
+	}
+}
+
+static void
+free_node(struct rte_poptrie_tbl *dp, const struct poptrie_node *node)
+{
+	uint32_t i, num_nodes;
+
+	num_nodes = __builtin_popcountll(node->vector);
+	for (i = 0; i < num_nodes; i++)
+		free_node(dp, &dp->nodes[node->base1 + i]);
+	pool_free(&dp->node_pool, node->base1, num_nodes);
+	pool_free(&dp->leaf_pool, node->base0,
+		__builtin_popcountll(node->leafvec));
+}
+
+/* Build the node for ip/off and all its children from the RIB */
+static int
+build_node(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	const uint8_t *ip, uint32_t off, uint64_t def_nh,
+	struct poptrie_node *dst)
+{
+	struct poptrie_ents ents;
+	uint8_t child_ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t leafvec, sub;
+	uint32_t base0, base1, num_leaves, num_nodes, slot, i;
+	int ret;
+
+	get_node_ents(rib, ip, off, def_nh, &ents);
+	num_leaves = get_leaf_num(&ents, &leafvec);
+	num_nodes = __builtin_popcountll(ents.sub);
+
+	ret = pool_alloc(&dp->node_pool, num_nodes, &base1);
+	if (ret != 0)
+		return ret;
+	ret = pool_alloc(&dp->leaf_pool, num_leaves, &base0);
+	if (ret != 0) {
+		pool_free(&dp->node_pool, base1, num_nodes);
+		return ret;
+	}
+
+	for (i = 0, sub = ents.sub; sub != 0; i++, sub &= sub - 1) {
+		slot = __builtin_ctzll(sub);
+		memcpy(child_ip, ip, sizeof(child_ip));
+		set_slot(child_ip, off, slot);
+		ret = build_node(dp, rib, child_ip, off + POPTRIE_STRIDE,
+			ents.nh[slot], &dp->nodes[base1 + i]);
+		if (ret != 0) {
+			while (i-- != 0)
+				free_node(dp, &dp->nodes[base1 + i]);
+			pool_free(&dp->leaf_pool, base0, num_leaves);
+			pool_free(&dp->node_pool, base1, num_nodes);
+			return ret;
+		}
+	}
+	write_leaves(dp, &ents, leafvec, base0);
+
+	dst->vector = ents.sub;
+	dst->leafvec = leafvec;
+	dst->base0 = base0;
+	dst->base1 = base1;
+	return 0;
+}
+
+/*
+ * Rebuild a tbl16 entry and the nodes below it from the RIB. The old nodes
+ * are freed right after the new entry is stored, lookups must not run
+ * concurrently.
+ */
+static int
+build_tbl16_ent(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	uint32_t tbl16_idx)
+{
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	uint32_t old_ent, new_ent, node_idx;
+	uint64_t def_nh;
+	int ret;
+
+	ip[0] = tbl16_idx >> 8;
+	ip[1] = tbl16_idx & UINT8_MAX;
+	def_nh = get_cover_nh(dp, rib, ip, POPTRIE_TBL16_BITS);
+	old_ent = dp->tbl16[tbl16_idx];
+
+	if (rte_rib6_get_nxt(rib, ip, POPTRIE_TBL16_BITS, NULL,
+			RTE_RIB6_GET_NXT_ALL) == NULL)
+		new_ent = def_nh;
+	else {
+		ret = pool_alloc(&dp->node_pool, 1, &node_idx);
+		if (ret != 0)
+			return ret;
+		ret = build_node(dp, rib, ip, POPTRIE_TBL16_BITS, def_nh,
+			&dp->nodes[node_idx]);
+		if (ret != 0) {
+			pool_free(&dp->node_pool, node_idx, 1);
+			return ret;
+		}
+		new_ent = node_idx | POPTRIE_NODE_ENT;
+	}
+
+	__atomic_store_n(&dp->tbl16[tbl16_idx], new_ent, __ATOMIC_RELEASE);
+
+	if (old_ent & POPTRIE_NODE_ENT) {
+		node_idx = old_ent & POPTRIE_MAX_NH;
+		free_node(dp, &dp->nodes[node_idx]);
+		pool_free(&dp->node_pool, node_idx, 1);
+	}
+	return 0;
+}
+
+/*
+ * Free the child nodes of a node, except those in the keep bitmap
+ * which are shared with another node, and its leaves and children arrays.
+ */
+static void
+release_node(struct rte_poptrie_tbl *dp, const struct poptrie_node *node,
+	uint64_t keep)
+{
+	uint64_t sub;
+	uint32_t i;
+
+	for (i = 0, sub = node->vector; sub != 0; i++, sub &= sub - 1) {
+		if (((keep >> __builtin_ctzll(sub)) & 1) == 0)
+			free_node(dp, &dp->nodes[node->base1 + i]);
+	}
+	pool_free(&dp->node_pool, node->base1,
+		__builtin_popcountll(node->vector));
+	pool_free(&dp->leaf_pool, node->base0,
+		__builtin_popcountll(node->leafvec));
+}
+
+/*
+ * Build a new version of a node from the RIB. The child nodes of the
+ * entries not in the changed bitmap are shared with the old version,
+ * the others are rebuilt. The old version is left untouched.
+ */
+static int
+rebuild_node(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	const struct poptrie_node *old, const uint8_t *ip, uint32_t off,
+	uint64_t changed, struct poptrie_node *dst, uint64_t *keep)
+{
+	struct poptrie_ents ents;
+	uint8_t child_ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t leafvec, sub;
+	uint32_t num_leaves, num_nodes, slot, i, old_idx;
+	int ret;
+
+	get_node_ents(rib, ip, off, get_cover_nh(dp, rib, ip, off), &ents);
+	num_leaves = get_leaf_num(&ents, &leafvec);
+	num_nodes = __builtin_popcountll(ents.sub);
+	*keep = old->vector & ents.sub & ~changed;
+
+	ret = pool_alloc(&dp->node_pool, num_nodes, &dst->base1);
+	if (ret != 0)
+		return ret;
+	ret = pool_alloc(&dp->leaf_pool, num_leaves, &dst->base0);
+	if (ret != 0) {
+		pool_free(&dp->node_pool, dst->base1, num_nodes);
+		return ret;
+	}
+	dst->vector = ents.sub;
+	dst->leafvec = leafvec;
+
+	for (i = 0, sub = ents.sub; sub != 0; i++, sub &= sub - 1) {
+		slot = __builtin_ctzll(sub);
+		if ((*keep >> slot) & 1) {
+			old_idx = old->base1 + __builtin_popcountll(
+				old->vector & ((1ULL << slot) - 1));
+			dp->nodes[dst->base1 + i] = dp->nodes[old_idx];
+			continue;
+		}
+		memcpy(child_ip, ip, sizeof(child_ip));
+		set_slot(child_ip, off, slot);
+		ret = build_node(dp, rib, child_ip, off + POPTRIE_STRIDE,
+			ents.nh[slot], &dp->nodes[dst->base1 + i]);
+		if (ret != 0) {
+			/* free the children built so far */
+			for (old_idx = 0, sub = ents.sub; old_idx < i;
+					old_idx++, sub &= sub - 1) {
+				if (((*keep >> __builtin_ctzll(sub)) & 1) == 0)
+					free_node(dp,
+						&dp->nodes[dst->base1 + old_idx]);
+			}
+			pool_free(&dp->leaf_pool, dst->base0, num_leaves);
+			pool_free(&dp->node_pool, dst->base1, num_nodes);
+			return ret;
+		}
+	}
+	write_leaves(dp, &ents, leafvec, dst->base0);
+	return 0;
+}
+
+/*
+ * Update the dataplane after a change of the route ip/depth in the RIB.
+ * Only the deepest existing node covering the route is rebuilt. The path
+ * from the tbl16 entry to it is copied, and the new path is published
+ * with a single atomic store of the tbl16 entry. The old path is freed and
+ * may be reused right away, so as with the TRIE type, lookups must not run
+ * concurrently with an update.
+ */
+static int
+update_dp(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	const uint8_t *ip, uint8_t depth)
+{
+	uint8_t node_ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	const struct poptrie_node *path[RTE_FIB6_MAXDEPTH / POPTRIE_STRIDE];
+	uint32_t slots[RTE_FIB6_MAXDEPTH / POPTRIE_STRIDE];
+	uint32_t blocks[RTE_FIB6_MAXDEPTH / POPTRIE_STRIDE];
+	const struct poptrie_node *node;
+	struct poptrie_node new_node;
+	uint32_t i, ent, off, slot, first, num, level, lvl, root_idx;
+	uint32_t tbl16_idx;
+	uint64_t changed, keep;
+	int ret;
+
+	first = get_tbl16_idx(ip);
+	if (depth <= POPTRIE_TBL16_BITS) {
+		num = 1U << (POPTRIE_TBL16_BITS - depth);
+		for (i = first; i < first + num; i++) {
+			ret = build_tbl16_ent(dp, rib, i);
+			if (ret != 0)
+				return ret;
+		}
+		return 0;
+	}
+
+	tbl16_idx = first;
+	ent = dp->tbl16[tbl16_idx];
+	if ((ent & POPTRIE_NODE_ENT) == 0)
+		return build_tbl16_ent(dp, rib, tbl16_idx);
+
+	node = &dp->nodes[ent & POPTRIE_MAX_NH];
+	node_ip[0] = ip[0];
+	node_ip[1] = ip[1];
+	off = POPTRIE_TBL16_BITS;
+	level = 0;
+	changed = 0;
+	while (depth > off + POPTRIE_STRIDE) {
+		slot = get_ip_slot(ip, off);
+		if (((node->vector >> slot) & 1) == 0) {
+			changed = 1ULL << slot;
+			break;
+		}
+		path[level] = node;
+		slots[level++] = slot;
+		node = &dp->nodes[node->base1 +
+			__builtin_popcountll(node->vector &
+			((1ULL << slot) - 1))];
+		set_slot(node_ip, off, slot);
+		off += POPTRIE_STRIDE;
+	}
+	if (changed == 0) {
+		first = get_ip_slot(ip, off);
+		num = 1U << (off + POPTRIE_STRIDE - depth);
+		changed = (num == POPTRIE_NODE_NUM_ENT) ? UINT64_MAX :
+			((1ULL << num) - 1) << first;
+	}
+
+	ret = rebuild_node(dp, rib, node, node_ip, off, changed, &new_node,
+		&keep);
+	if (ret != 0)
+		return ret;
+
+	/* copy the children arrays of the nodes on the path */
+	ret = pool_alloc(&dp->node_pool, 1, &root_idx);
+	if (ret != 0) {
+		release_node(dp, &new_node, keep);
+		return ret;
+	}
+	for (lvl = 0; lvl < level; lvl++) {
+		ret = pool_alloc(&dp->node_pool,
+			__builtin_popcountll(path[lvl]->vector), &blocks[lvl]);
+		if (ret != 0) {
+			while (lvl-- != 0)
+				pool_free(&dp->node_pool, blocks[lvl],
+					__builtin_popcountll(path[lvl]->vector));
+			pool_free(&dp->node_pool, root_idx, 1);
+			release_node(dp, &new_node, keep);
+			return ret;
+		}
+	}
+	for (lvl = level; lvl-- != 0; ) {
+		num = __builtin_popcountll(path[lvl]->vector);
+		memcpy(&dp->nodes[blocks[lvl]], &dp->nodes[path[lvl]->base1],
+			num * sizeof(struct poptrie_node));
+		dp->nodes[blocks[lvl] + __builtin_popcountll(path[lvl]->vector &
+			((1ULL << slots[lvl]) - 1))] = new_node;
+		new_node = *path[lvl];
+		new_node.base1 = blocks[lvl];
+	}
+	dp->nodes[root_idx] = new_node;
+	__atomic_store_n(&dp->tbl16[tbl16_idx], root_idx | POPTRIE_NODE_ENT,
+		__ATOMIC_RELEASE);
+
+	/* free the old path, from the deepest node up */
+	release_node(dp, node, keep);
+	for (lvl = level; lvl-- != 0; )
+		pool_free(&dp->node_pool, path[lvl]->base1,
+			__builtin_popcountll(path[lvl]->vector));
+	pool_free(&dp->node_pool, ent & POPTRIE_MAX_NH, 1);
+	return 0;
+}
+
+int
+poptrie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t next_hop, int op)
+{
+	struct rte_poptrie_tbl *dp;
+	struct rte_rib6 *rib;
+	struct rte_rib6_node *node;
+	uint8_t ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t old_nh;
+	int i, ret;
+
+	if ((fib == NULL) || (ip == NULL) || (depth > RTE_FIB6_MAXDEPTH))
+		return -EINVAL;
+
+	dp = rte_fib6_get_dp(fib);
+	RTE_ASSERT(dp);
+	rib = rte_fib6_get_rib(fib);
+	RTE_ASSERT(rib);
+
+	if (next_hop > POPTRIE_MAX_NH)
+		return -EINVAL;
+
+	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++) {
+		int part_depth = RTE_MAX(0, RTE_MIN(8, depth - i * 8));
+
+		ip_masked[i] = ip[i] & (uint8_t)(UINT8_MAX << (8 - part_depth));
+	}
+
+	node = rte_rib6_lookup_exact(rib, ip_masked, depth);
+	switch (op) {
+	case RTE_FIB6_ADD:
+		if (node != NULL) {
+			rte_rib6_get_nh(node, &old_nh);
+			if (old_nh == next_hop)
+				return 0;
+			rte_rib6_set_nh(node, next_hop);
+			ret = update_dp(dp, rib, ip_masked, depth);
+			if (ret != 0) {
+				rte_rib6_set_nh(node, old_nh);
+				update_dp(dp, rib, ip_masked, depth);
+			}
+			return ret;
+		}
+		node = rte_rib6_insert(rib, ip_masked, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib6_set_nh(node, next_hop);
+		ret = update_dp(dp, rib, ip_masked, depth);
+		if (ret != 0) {
+			rte_rib6_remove(rib, ip_masked, depth);
+			update_dp(dp, rib, ip_masked, depth);
+		}
+		return ret;
+	case RTE_FIB6_DEL:
+		if (node == NULL)
+			return -ENOENT;
+		rte_rib6_get_nh(node, &old_nh);
+		rte_rib6_remove(rib, ip_masked, depth);
+		ret = update_dp(dp, rib, ip_masked, depth);
+		if (ret != 0) {
+			node = rte_rib6_insert(rib, ip_masked, depth);
+			if (node != NULL)
+				rte_rib6_set_nh(node, old_nh);
+			update_dp(dp, rib, ip_masked, depth);
+		}
+		return ret;
+	default:
+		break;
+	}
+	return -EINVAL;
+}
+
+void *
+poptrie_create(const char *name, int socket_id, struct rte_fib6_conf *conf)
+{
+	char mem_name[POPTRIE_NAMESIZE];
+	struct rte_poptrie_tbl *dp = NULL;
+	uint32_t i;
+
+	if ((name == NULL) || (conf == NULL) ||
+			(conf->poptrie.num_nodes == 0) ||
+			(conf->poptrie.num_nodes > POPTRIE_MAX_NH) ||
+			(conf->poptrie.num_leaves == 0) ||
+			(conf->default_nh > POPTRIE_MAX_NH)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
+	dp = rte_zmalloc_socket(mem_name, sizeof(struct rte_poptrie_tbl),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	dp->def_nh = conf->default_nh;
+	for (i = 0; i < POPTRIE_TBL16_NUM_ENT; i++)
+		dp->tbl16[i] = dp->def_nh;
+
+	snprintf(mem_name, sizeof(mem_name), "NODES_%p", dp);
+	dp->nodes = rte_zmalloc_socket(mem_name,
+		sizeof(struct poptrie_node) * conf->poptrie.num_nodes,
+		RTE_CACHE_LINE_SIZE, socket_id);
+	snprintf(mem_name, sizeof(mem_name), "LEAVES_%p", dp);
+	dp->leaves = rte_zmalloc_socket(mem_name,
+		sizeof(uint32_t) * conf->poptrie.num_leaves,
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if ((dp->nodes == NULL) || (dp->leaves == NULL)) {
+		rte_errno = ENOMEM;
+		rte_free(dp->leaves);
+		rte_free(dp->nodes);
+		rte_free(dp);
+		return NULL;
+	}
+
+	pool_init(&dp->node_pool, dp->nodes, sizeof(struct poptrie_node),
+		conf->poptrie.num_nodes);
+	pool_init(&dp->leaf_pool, dp->leaves, sizeof(uint32_t),
+		conf->poptrie.num_leaves);
+
+	return dp;
+}
+
+void
+poptrie_free(void *p)
+{
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;
+
+	rte_free(dp->leaves);
+	rte_free(dp->nodes);
+	rte_free(dp);
+}
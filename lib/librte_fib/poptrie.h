@@ -0,0 +1,212 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _POPTRIE_H_
+#define _POPTRIE_H_
+
+/**
+ * @file
+ * Poptrie based IPv6 FIB
+ *
+ * Multibit trie with 6 bit strides below a 16 bit direct table. Every node
+ * keeps bitmaps of its child nodes and of the starts of leaf runs, so that
+ * children and leaves are stored in contiguous arrays indexed with popcount.
+ */
+#include <string.h>
+
+#include <rte_prefetch.h>
+#include <rte_branch_prediction.h>
+#include <rte_byteorder.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* @internal Total number of tbl16 entries. */
+#define POPTRIE_TBL16_NUM_ENT	(1 << 16)
+/* @internal Number of bits of the address looked up in tbl16. */
+#define POPTRIE_TBL16_BITS	16
+/* @internal Number of bits of the address looked up in a node. */
+#define POPTRIE_STRIDE		6
+/* @internal Number of entries in a node. */
+#define POPTRIE_NODE_NUM_ENT	(1 << POPTRIE_STRIDE)
+/* @internal tbl16 entry pointing to a node instead of holding a next hop */
+#define POPTRIE_NODE_ENT	(1U << 31)
+/* @internal Maximum next hop and node index value */
+#define POPTRIE_MAX_NH		(POPTRIE_NODE_ENT - 1)
+/* @internal Number of block sizes, from 1 to POPTRIE_NODE_NUM_ENT */
+#define POPTRIE_NUM_ORDERS	(POPTRIE_STRIDE + 1)
+
+struct poptrie_node {
+	uint64_t	vector;	/**< bitmap of the entries being nodes */
+	uint64_t	leafvec; /**< bitmap of the leaf runs starts */
+	uint32_t	base0;	/**< index of the first leaf */
+	uint32_t	base1;	/**< index of the first child node */
+};
+
+/* Allocator of blocks of up to POPTRIE_NODE_NUM_ENT consecutive elements */
+struct poptrie_pool {
+	void		*base;	/**< array of elements */
+	uint32_t	esize;	/**< element size */
+	uint32_t	size;	/**< total number of elements */
+	uint32_t	top;	/**< first element never allocated */
+	uint32_t	used;	/**< number of allocated elements */
+	/** heads of the lists of free blocks for every block size */
+	uint32_t	free_head[POPTRIE_NUM_ORDERS];
+};
+
+struct rte_poptrie_tbl {
+	uint64_t	def_nh;		/**< Default next hop */
+	struct poptrie_node	*nodes;	/**< nodes table */
+	uint32_t	*leaves;	/**< leaves table */
+	struct poptrie_pool	node_pool; /**< nodes allocator */
+	struct poptrie_pool	leaf_pool; /**< leaves allocator */
+	/* tbl16 table. */
+	uint32_t	tbl16[POPTRIE_TBL16_NUM_ENT] __rte_cache_aligned;
+};
+
+static inline void
+get_ip_parts(const uint8_t *ip, uint64_t *hi, uint64_t *lo)
+{
+	uint64_t tmp[2];
+
+	memcpy(tmp, ip, sizeof(tmp));
+	*hi = rte_be_to_cpu_64(tmp[0]);
+	*lo = rte_be_to_cpu_64(tmp[1]);
+}
+
+/*
+ * Get the node entry index for the bits of the address starting at off.
+ * The last node only uses the 4 remaining bits of the address,
+ * followed by 2 zero bits.
+ */
+static inline uint32_t
+get_slot(uint64_t hi, uint64_t lo, uint32_t off)
+{
+	if (off < 64)
+		return (hi >> (64 - POPTRIE_STRIDE - off)) &
+			(POPTRIE_NODE_NUM_ENT - 1);
+	if (off + POPTRIE_STRIDE <= 128)
+		return (lo >> (128 - POPTRIE_STRIDE - off)) &
+			(POPTRIE_NODE_NUM_ENT - 1);
+	return (lo << (off + POPTRIE_STRIDE - 128)) &
+		(POPTRIE_NODE_NUM_ENT - 1);
+}
+
+static inline uint64_t
+poptrie_lookup(const struct rte_poptrie_tbl *dp, const uint8_t *ip)
+{
+	const struct poptrie_node *node;
+	uint64_t hi, lo, bit, msk;
+	uint32_t ent, off;
+
+	get_ip_parts(ip, &hi, &lo);
+	ent = dp->tbl16[hi >> (64 - POPTRIE_TBL16_BITS)];
+	if (likely((ent & POPTRIE_NODE_ENT) == 0))
+		return ent;
+
+	node = &dp->nodes[ent & POPTRIE_MAX_NH];
+	for (off = POPTRIE_TBL16_BITS; ; off += POPTRIE_STRIDE) {
+		bit = 1ULL << get_slot(hi, lo, off);
+		/* bitmask of the entries up to and including this one */
+		msk = (bit << 1) - 1;
+		if ((node->vector & bit) == 0)
+			return dp->leaves[node->base0 +
+				__builtin_popcountll(node->leafvec & msk) - 1];
+		node = &dp->nodes[node->base1 +
+			__builtin_popcountll(node->vector & msk) - 1];
+	}
+}
+
+/* @internal Number of lookups walking the trie at the same time */
+#define POPTRIE_LOOKUP_INTERLEAVE	8
+
+/*
+ * Walk the trie for several addresses at once, so that the memory
+ * accesses of independent lookups overlap.
+ */
+static inline void
+poptrie_lookup_interleaved(const struct rte_poptrie_tbl *dp,
+	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE], uint64_t *next_hops)
+{
+	const struct poptrie_node *node[POPTRIE_LOOKUP_INTERLEAVE];
+	uint64_t hi[POPTRIE_LOOKUP_INTERLEAVE], lo[POPTRIE_LOOKUP_INTERLEAVE];
+	uint64_t bit, msk;
+	uint32_t i, ent, off, active = 0;
+
+	for (i = 0; i < POPTRIE_LOOKUP_INTERLEAVE; i++) {
+		get_ip_parts(ips[i], &hi[i], &lo[i]);
+		ent = dp->tbl16[hi[i] >> (64 - POPTRIE_TBL16_BITS)];
+		if (likely((ent & POPTRIE_NODE_ENT) == 0)) {
+			next_hops[i] = ent;
+			continue;
+		}
+		node[i] = &dp->nodes[ent & POPTRIE_MAX_NH];
+		rte_prefetch0(node[i]);
+		active |= 1U << i;
+	}
+
+	for (off = POPTRIE_TBL16_BITS; active != 0; off += POPTRIE_STRIDE) {
+		for (i = 0; i < POPTRIE_LOOKUP_INTERLEAVE; i++) {
+			if (((active >> i) & 1) == 0)
+				continue;
+			bit = 1ULL << get_slot(hi[i], lo[i], off);
+			msk = (bit << 1) - 1;
+			if ((node[i]->vector & bit) == 0) {
+				next_hops[i] = dp->leaves[node[i]->base0 +
+					__builtin_popcountll(node[i]->leafvec &
+					msk) - 1];
+				active &= ~(1U << i);
+				continue;
+			}
+			node[i] = &dp->nodes[node[i]->base1 +
+				__builtin_popcountll(node[i]->vector &
+				msk) - 1];
+			rte_prefetch0(node[i]);
+		}
+	}
+}
+
+static inline void
+rte_poptrie_lookup_bulk(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;
+	uint32_t i;
+
+	for (i = 0; i + POPTRIE_LOOKUP_INTERLEAVE <= n;
+			i += POPTRIE_LOOKUP_INTERLEAVE) {
+		if (i + 2 * POPTRIE_LOOKUP_INTERLEAVE <= n) {
+			uint32_t j;
+
+			for (j = i + POPTRIE_LOOKUP_INTERLEAVE;
+					j < i + 2 * POPTRIE_LOOKUP_INTERLEAVE;
+					j++)
+				rte_prefetch0(&dp->tbl16[(ips[j][0] << 8) |
+					ips[j][1]]);
+		}
+		poptrie_lookup_interleaved(dp, &ips[i], &next_hops[i]);
+	}
+	for (; i < n; i++)
+		next_hops[i] = poptrie_lookup(dp, ips[i]);
+}
+
+void *
+poptrie_create(const char *name, int socket_id, struct rte_fib6_conf *conf);
+
+void
+poptrie_free(void *p);
+
+rte_fib6_lookup_fn_t
+poptrie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type);
+
+int
+poptrie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t next_hop, int op);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _POPTRIE_H_ */
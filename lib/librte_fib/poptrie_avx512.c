@@ -0,0 +1,148 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_vect.h>
+#include <rte_fib6.h>
+
+#include "poptrie.h"
+#include "poptrie_avx512.h"
+
+static __rte_always_inline void
+transpose_x8(uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	__m512i *first, __m512i *second)
+{
+	__m512i tmp1, tmp2, tmp3, tmp4;
+	const __rte_x86_zmm_t perm_idxes = {
+		.u64 = { 0, 2, 4, 6, 1, 3, 5, 7
+		},
+	};
+
+	tmp1 = _mm512_loadu_si512(&ips[0][0]);
+	tmp2 = _mm512_loadu_si512(&ips[4][0]);
+
+	tmp3 = _mm512_unpacklo_epi64(tmp1, tmp2);
+	*first = _mm512_permutexvar_epi64(perm_idxes.z, tmp3);
+	tmp4 = _mm512_unpackhi_epi64(tmp1, tmp2);
+	*second = _mm512_permutexvar_epi64(perm_idxes.z, tmp4);
+}
+
+/*
+ * Population count of every 64 bit lane using a nibble lookup table,
+ * so that AVX512 VPOPCNTDQ is not required.
+ */
+static __rte_always_inline __m512i
+popcnt_epi64(__m512i x)
+{
+	const __m512i lut = _mm512_broadcast_i32x4(_mm_setr_epi8(
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+	const __m512i nibble = _mm512_set1_epi8(0x0f);
+	__m512i lo, hi;
+
+	lo = _mm512_shuffle_epi8(lut, _mm512_and_si512(x, nibble));
+	hi = _mm512_shuffle_epi8(lut,
+		_mm512_and_si512(_mm512_srli_epi64(x, 4), nibble));
+	return _mm512_sad_epu8(_mm512_add_epi8(lo, hi), _mm512_setzero_si512());
+}
+
+static __rte_always_inline __m512i
+get_slots(__m512i hi, __m512i lo, uint32_t off)
+{
+	const __m512i msk = _mm512_set1_epi64(POPTRIE_NODE_NUM_ENT - 1);
+
+	if (off < 64)
+		return _mm512_and_si512(_mm512_srlv_epi64(hi,
+			_mm512_set1_epi64(64 - POPTRIE_STRIDE - off)), msk);
+	if (off + POPTRIE_STRIDE <= 128)
+		return _mm512_and_si512(_mm512_srlv_epi64(lo,
+			_mm512_set1_epi64(128 - POPTRIE_STRIDE - off)), msk);
+	return _mm512_and_si512(_mm512_sllv_epi64(lo,
+		_mm512_set1_epi64(off + POPTRIE_STRIDE - 128)), msk);
+}
+
+static __rte_always_inline void
+poptrie_vec_lookup_x8(void *p, uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops)
+{
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;
+	const __m512i one = _mm512_set1_epi64(1);
+	const __m512i node_flag = _mm512_set1_epi64(POPTRIE_NODE_ENT);
+	const __m512i idx_msk = _mm512_set1_epi64(POPTRIE_MAX_NH);
+	const __m512i lsw_msk = _mm512_set1_epi64(UINT32_MAX);
+	const __rte_x86_zmm_t bswap = {
+		.u8 = { 7, 6, 5, 4, 3, 2, 1, 0,
+			15, 14, 13, 12, 11, 10, 9, 8,
+			7, 6, 5, 4, 3, 2, 1, 0,
+			15, 14, 13, 12, 11, 10, 9, 8,
+			7, 6, 5, 4, 3, 2, 1, 0,
+			15, 14, 13, 12, 11, 10, 9, 8,
+			7, 6, 5, 4, 3, 2, 1, 0,
+			15, 14, 13, 12, 11, 10, 9, 8
+			},
+	};
+	const uint8_t *nodes = (const uint8_t *)dp->nodes;
+	__m512i hi, lo, res, idxes, offs, slots, bits, msk;
+	__m512i vector, leafvec, bases, cnt;
+	__mmask8 node_msk, leaf_msk;
+	uint32_t off;
+
+	transpose_x8(ips, &hi, &lo);
+	hi = _mm512_shuffle_epi8(hi, bswap.z);
+	lo = _mm512_shuffle_epi8(lo, bswap.z);
+
+	/* lookup in tbl16, node entries are resolved below */
+	idxes = _mm512_srli_epi64(hi, 64 - POPTRIE_TBL16_BITS);
+	res = _mm512_cvtepu32_epi64(_mm512_i64gather_epi32(idxes,
+		(const int *)dp->tbl16, 4));
+	node_msk = _mm512_test_epi64_mask(res, node_flag);
+	idxes = _mm512_and_si512(res, idx_msk);
+
+	for (off = POPTRIE_TBL16_BITS; node_msk != 0; off += POPTRIE_STRIDE) {
+		/* nodes are 24 bytes long */
+		offs = _mm512_add_epi64(_mm512_slli_epi64(idxes, 4),
+			_mm512_slli_epi64(idxes, 3));
+		vector = _mm512_mask_i64gather_epi64(offs, node_msk, offs,
+			nodes + offsetof(struct poptrie_node, vector), 1);
+		leafvec = _mm512_mask_i64gather_epi64(offs, node_msk, offs,
+			nodes + offsetof(struct poptrie_node, leafvec), 1);
+		/* base0 in the low and base1 in the high 32 bits */
+		bases = _mm512_mask_i64gather_epi64(offs, node_msk, offs,
+			nodes + offsetof(struct poptrie_node, base0), 1);
+
+		slots = get_slots(hi, lo, off);
+		bits = _mm512_sllv_epi64(one, slots);
+		msk = _mm512_sub_epi64(_mm512_slli_epi64(bits, 1), one);
+		leaf_msk = _mm512_mask_testn_epi64_mask(node_msk, vector, bits);
+
+		/* leaves[base0 + popcnt(leafvec & msk) - 1] */
+		cnt = popcnt_epi64(_mm512_and_si512(leafvec, msk));
+		idxes = _mm512_sub_epi64(_mm512_add_epi64(
+			_mm512_and_si512(bases, lsw_msk), cnt), one);
+		res = _mm512_mask_mov_epi64(res, leaf_msk,
+			_mm512_cvtepu32_epi64(_mm512_mask_i64gather_epi32(
+			_mm512_castsi512_si256(res), leaf_msk, idxes,
+			(const int *)dp->leaves, 4)));
+
+		/* nodes[base1 + popcnt(vector & msk) - 1] */
+		node_msk &= ~leaf_msk;
+		cnt = popcnt_epi64(_mm512_and_si512(vector, msk));
+		idxes = _mm512_sub_epi64(_mm512_add_epi64(
+			_mm512_srli_epi64(bases, 32), cnt), one);
+	}
+
+	_mm512_storeu_si512((void *)next_hops, res);
+}
+
+void
+rte_poptrie_vec_lookup_bulk(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+
+	for (i = 0; i < (n / 8); i++) {
+		poptrie_vec_lookup_x8(p, (uint8_t (*)[16])&ips[i * 8][0],
+			next_hops + i * 8);
+	}
+	rte_poptrie_lookup_bulk(p, (uint8_t (*)[16])&ips[i * 8][0],
+		next_hops + i * 8, n - i * 8);
+}
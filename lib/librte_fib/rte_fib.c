@@ -4,6 +4,7 @@
  */
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <rte_eal.h>
@@ -135,6 +136,98 @@ rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth)
 	return fib->modify(fib, ip, depth, 0, RTE_FIB_DEL);
 }
 
+/* Route update with its position in the batch, used to merge updates */
+struct fib_bulk_ent {
+	struct rte_fib_route_update	upd;
+	uint32_t			seq;
+};
+
+static int
+bulk_ent_cmp(const void *a, const void *b)
+{
+	const struct fib_bulk_ent *e1 = a;
+	const struct fib_bulk_ent *e2 = b;
+
+	if (e1->upd.depth != e2->upd.depth)
+		return (e1->upd.depth < e2->upd.depth) ? -1 : 1;
+	if (e1->upd.ip != e2->upd.ip)
+		return (e1->upd.ip < e2->upd.ip) ? -1 : 1;
+	return (e1->seq < e2->seq) ? -1 : (e1->seq > e2->seq);
+}
+
+static int
+apply_bulk_ent(struct rte_fib *fib, const struct fib_bulk_ent *ent)
+{
+	int ret;
+
+	ret = fib->modify(fib, ent->upd.ip, ent->upd.depth,
+		ent->upd.next_hop, ent->upd.op);
+	if ((ret == -ENOENT) && (ent->upd.op == RTE_FIB_DEL))
+		return 0;
+	return ret;
+}
+
+int
+rte_fib_update_bulk(struct rte_fib *fib,
+	const struct rte_fib_route_update *upd, unsigned int n)
+{
+	struct fib_bulk_ent *ents;
+	unsigned int i, k;
+	int ret = 0;
+
+	if ((fib == NULL) || (fib->modify == NULL) ||
+			((upd == NULL) && (n != 0)))
+		return -EINVAL;
+
+	for (i = 0; i < n; i++) {
+		if ((upd[i].depth > RTE_FIB_MAXDEPTH) ||
+				((upd[i].op != RTE_FIB_ADD) &&
+				(upd[i].op != RTE_FIB_DEL)))
+			return -EINVAL;
+	}
+	if (n == 0)
+		return 0;
+
+	ents = rte_malloc(NULL, sizeof(*ents) * n, 0);
+	if (ents == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i < n; i++) {
+		ents[i].upd = upd[i];
+		ents[i].upd.ip &= rte_rib_depth_to_mask(upd[i].depth);
+		ents[i].seq = i;
+	}
+
+	/* keep only the last update of every prefix */
+	qsort(ents, n, sizeof(*ents), bulk_ent_cmp);
+	for (i = 1, k = 0; i < n; i++) {
+		if ((ents[i].upd.ip != ents[k].upd.ip) ||
+				(ents[i].upd.depth != ents[k].upd.depth))
+			k++;
+		ents[k] = ents[i];
+	}
+	n = k + 1;
+
+	if (fib->type == RTE_FIB_DIR24_8)
+		dir24_8_batch_start(fib->dp);
+
+	/* adds from the most specific prefix, then deletes */
+	for (i = n; (i-- != 0) && (ret == 0); ) {
+		if (ents[i].upd.op == RTE_FIB_ADD)
+			ret = apply_bulk_ent(fib, &ents[i]);
+	}
+	for (i = 0; (i < n) && (ret == 0); i++) {
+		if (ents[i].upd.op == RTE_FIB_DEL)
+			ret = apply_bulk_ent(fib, &ents[i]);
+	}
+
+	if (fib->type == RTE_FIB_DIR24_8)
+		dir24_8_batch_finish(fib->dp);
+
+	rte_free(ents);
+	return ret;
+}
+
 int
 rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
 	uint64_t *next_hops, int n)
@@ -319,6 +412,20 @@ rte_fib_get_rib(struct rte_fib *fib)
 	return (fib == NULL) ? NULL : fib->rib;
 }
 
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg)
+{
+	if ((fib == NULL) || (cfg == NULL) || (cfg->v == NULL))
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	default:
+		return -EINVAL;
+	}
+}
+
 int
 rte_fib_select_lookup(struct rte_fib *fib,
 	enum rte_fib_lookup_type type)
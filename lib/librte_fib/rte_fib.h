@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,6 +52,17 @@ enum rte_fib_op {
 	RTE_FIB_DEL,
 };
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_FIB_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_fib_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_FIB_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_FIB_QSBR_MODE_SYNC
+};
+
 /** Size of nexthop (1 << nh_sz) bits for DIR24_8 based FIB */
 enum rte_fib_dir24_8_nh_sz {
 	RTE_FIB_DIR24_8_1B,
@@ -92,6 +104,30 @@ struct rte_fib_conf {
 	};
 };
 
+/** FIB RCU QSBR configuration structure. */
+struct rte_fib_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_FIB_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_fib_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: number of tbl8s.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_FIB_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
+/** Route update for rte_fib_update_bulk() */
+struct rte_fib_route_update {
+	uint32_t	ip;	/**< IPv4 prefix address */
+	uint8_t		depth;	/**< Prefix length */
+	uint8_t		op;	/**< RTE_FIB_ADD or RTE_FIB_DEL */
+	uint64_t	next_hop; /**< Next hop, unused for RTE_FIB_DEL */
+};
+
 /**
  * Create FIB
  *
@@ -169,6 +205,33 @@ __rte_experimental
 int
 rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth);
 
+/**
+ * Add and delete a batch of routes.
+ *
+ * Updates to the same prefix are merged, so that only the last one takes
+ * effect. Adds are then applied from the most to the least specific
+ * prefix, so that a less specific route only rewrites the ranges not
+ * covered by the more specific ones, and deletes are applied afterwards.
+ * If RCU is enabled with RTE_FIB_QSBR_MODE_SYNC, the tbl8s released by the
+ * batch are reclaimed after a single grace period at the end of the batch.
+ *
+ * Deleting a prefix not present in the FIB is not an error.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param upd
+ *   Array of route updates
+ * @param n
+ *   Number of elements in upd array
+ * @return
+ *   0 on success, negative value otherwise.
+ *   On failure of one update, the updates applied before it stay in the FIB.
+ */
+__rte_experimental
+int
+rte_fib_update_bulk(struct rte_fib *fib,
+	const struct rte_fib_route_update *upd, unsigned int n);
+
 /**
  * Lookup multiple IP addresses in the FIB.
  *
@@ -232,6 +295,27 @@ __rte_experimental
 int
 rte_fib_select_lookup(struct rte_fib *fib, enum rte_fib_lookup_type type);
 
+/**
+ * Associate RCU QSBR variable with a FIB object.
+ *
+ * Once associated, tbl8s released by route updates are only reused after
+ * the readers registered with the QSBR variable went through a quiescent
+ * state.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -EINVAL - invalid pointer or FIB type not supporting RCU
+ *   -EEXIST - already added QSBR
+ *   -ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,7 @@
 #include <rte_fib6.h>
 
 #include "trie.h"
+#include "poptrie.h"
 
 TAILQ_HEAD(rte_fib6_list, rte_tailq_entry);
 static struct rte_tailq_elem rte_fib6_tailq = {
@@ -110,6 +111,14 @@ init_dataplane(struct rte_fib6 *fib, __rte_unused int socket_id,
 		fib->lookup = trie_get_lookup_fn(fib->dp, RTE_FIB6_LOOKUP_DEFAULT);
 		fib->modify = trie_modify;
 		return 0;
+	case RTE_FIB6_POPTRIE:
+		fib->dp = poptrie_create(dp_name, socket_id, conf);
+		if (fib->dp == NULL)
+			return -rte_errno;
+		fib->lookup = poptrie_get_lookup_fn(fib->dp,
+			RTE_FIB6_LOOKUP_DEFAULT);
+		fib->modify = poptrie_modify;
+		return 0;
 	default:
 		return -EINVAL;
 	}
@@ -160,7 +169,7 @@ rte_fib6_create(const char *name, int socket_id, struct rte_fib6_conf *conf)
 
 	/* Check user arguments. */
 	if ((name == NULL) || (conf == NULL) || (conf->max_routes < 0) ||
-			(conf->type > RTE_FIB6_TRIE)) {
+			(conf->type > RTE_FIB6_POPTRIE)) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
@@ -274,6 +283,10 @@ free_dataplane(struct rte_fib6 *fib)
 		return;
 	case RTE_FIB6_TRIE:
 		trie_free(fib->dp);
+		return;
+	case RTE_FIB6_POPTRIE:
+		poptrie_free(fib->dp);
+		return;
 	default:
 		return;
 	}
@@ -333,6 +346,12 @@ rte_fib6_select_lookup(struct rte_fib6 *fib,
 			return -EINVAL;
 		fib->lookup = fn;
 		return 0;
+	case RTE_FIB6_POPTRIE:
+		fn = poptrie_get_lookup_fn(fib->dp, type);
+		if (fn == NULL)
+			return -EINVAL;
+		fib->lookup = fn;
+		return 0;
 	default:
 		return -EINVAL;
 	}
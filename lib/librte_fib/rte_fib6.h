@@ -37,7 +37,8 @@ struct rte_rib6;
 /** Type of FIB struct */
 enum rte_fib6_type {
 	RTE_FIB6_DUMMY,		/**< RIB6 tree based FIB */
-	RTE_FIB6_TRIE		/**< TRIE based fib  */
+	RTE_FIB6_TRIE,		/**< TRIE based fib  */
+	RTE_FIB6_POPTRIE	/**< Poptrie based fib */
 };
 
 /** Modify FIB function */
@@ -66,7 +67,11 @@ enum rte_fib6_lookup_type {
 	RTE_FIB6_LOOKUP_DEFAULT,
 	/**< Selects the best implementation based on the max simd bitwidth */
 	RTE_FIB6_LOOKUP_TRIE_SCALAR, /**< Scalar lookup function implementation*/
-	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512 /**< Vector implementation using AVX512 */
+	RTE_FIB6_LOOKUP_TRIE_VECTOR_AVX512, /**< Vector implementation using AVX512 */
+	/** Scalar lookup function implementation for POPTRIE */
+	RTE_FIB6_LOOKUP_POPTRIE_SCALAR,
+	/** Vector implementation using AVX512 for POPTRIE */
+	RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512
 };
 
 /** FIB configuration structure */
@@ -80,6 +85,11 @@ struct rte_fib6_conf {
 			enum rte_fib_trie_nh_sz nh_sz;
 			uint32_t	num_tbl8;
 		} trie;
+		/** Next hops are limited to 31 bits for POPTRIE */
+		struct {
+			uint32_t	num_nodes; /**< Number of trie nodes */
+			uint32_t	num_leaves; /**< Number of leaves */
+		} poptrie;
 	};
 };
 
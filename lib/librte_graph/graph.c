@@ -257,6 +257,62 @@ rte_graph_lookup(const char *name)
 	return graph_mem_fixup_secondary(rc);
 }
 
+static int
+graph_sched_param_check(const struct rte_graph_param *prm)
+{
+	struct graph *graph;
+
+	switch (prm->sched_mode) {
+	case RTE_GRAPH_SCHED_DEFAULT:
+		break;
+	case RTE_GRAPH_SCHED_DEFERRED:
+		if (prm->sched_min_objs == 0 ||
+		    prm->sched_min_objs > RTE_GRAPH_BURST_SIZE)
+			SET_ERR_JMP(EINVAL, fail, "Invalid fill level %u",
+				    prm->sched_min_objs);
+		if (prm->sched_budget_us == 0)
+			SET_ERR_JMP(EINVAL, fail, "Invalid latency budget");
+		break;
+	case RTE_GRAPH_SCHED_DISPATCH:
+		if (prm->lcore_id >= RTE_MAX_LCORE)
+			SET_ERR_JMP(EINVAL, fail, "Invalid lcore %u",
+				    prm->lcore_id);
+		/* One graph walked by an lcore */
+		STAILQ_FOREACH(graph, &graph_list, next)
+			if (graph->lcore_id == prm->lcore_id)
+				SET_ERR_JMP(EEXIST, fail,
+					    "Found graph %s on lcore %u",
+					    graph->name, prm->lcore_id);
+		break;
+	default:
+		SET_ERR_JMP(EINVAL, fail, "Invalid scheduling mode %d",
+			    prm->sched_mode);
+	}
+
+	return 0;
+fail:
+	return -rte_errno;
+}
+
+static void
+graph_sched_param_set(struct graph *graph, const struct rte_graph_param *prm)
+{
+	graph->lcore_id = RTE_MAX_LCORE;
+
+	switch (prm->sched_mode) {
+	case RTE_GRAPH_SCHED_DEFERRED:
+		graph->sched_min_objs = prm->sched_min_objs;
+		graph->sched_budget = (rte_get_tsc_hz() *
+				       prm->sched_budget_us) / US_PER_S;
+		break;
+	case RTE_GRAPH_SCHED_DISPATCH:
+		graph->lcore_id = prm->lcore_id;
+		break;
+	default:
+		break;
+	}
+}
+
 rte_graph_t
 rte_graph_create(const char *name, struct rte_graph_param *prm)
 {
@@ -274,6 +330,9 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	if (name == NULL)
 		SET_ERR_JMP(EINVAL, fail, "Graph name should not be NULL");
 
+	if (graph_sched_param_check(prm))
+		goto fail;
+
 	/* Check for existence of duplicate graph */
 	STAILQ_FOREACH(graph, &graph_list, next)
 		if (strncmp(name, graph->name, RTE_GRAPH_NAMESIZE) == 0)
@@ -327,6 +386,7 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph->src_node_count = src_node_count;
 	graph->node_count = graph_nodes_count(graph);
 	graph->id = graph_id;
+	graph_sched_param_set(graph, prm);
 
 	/* Allocate the Graph fast path memory and populate the data */
 	if (graph_fp_mem_create(graph))
@@ -336,6 +396,10 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	if (graph_node_init(graph))
 		goto graph_mem_destroy;
 
+	/* Connect to the graphs of the other lcores in dispatch mode */
+	if (graph_dispatch_connect(graph))
+		goto node_fini;
+
 	/* All good, Lets add the graph to the list */
 	graph_id++;
 	STAILQ_INSERT_TAIL(&graph_list, graph, next);
@@ -343,6 +407,8 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	graph_spinlock_unlock();
 	return graph->id;
 
+node_fini:
+	graph_node_fini(graph);
 graph_mem_destroy:
 	graph_fp_mem_destroy(graph);
 graph_cleanup:
@@ -366,6 +432,8 @@ rte_graph_destroy(rte_graph_t id)
 	while (graph != NULL) {
 		tmp = STAILQ_NEXT(graph, next);
 		if (graph->id == id) {
+			/* Stop the handovers to and from the other lcores */
+			graph_dispatch_disconnect(graph);
 			/* Call fini() of the all the nodes in the graph */
 			graph_node_fini(graph);
 			/* Destroy graph fast path memory */
@@ -22,6 +22,10 @@ graph_dump(FILE *f, struct graph *g)
 	fprintf(f, "  mem_sz=%zu\n", g->mem_sz);
 	fprintf(f, "  node_count=%" PRIu32 "\n", g->node_count);
 	fprintf(f, "  src_node_count=%" PRIu32 "\n", g->src_node_count);
+	fprintf(f, "  sched_min_objs=%" PRIu16 "\n", g->sched_min_objs);
+	fprintf(f, "  sched_budget=%" PRIu64 "\n", g->sched_budget);
+	if (g->lcore_id != RTE_MAX_LCORE)
+		fprintf(f, "  lcore_id=%u\n", g->lcore_id);
 
 	STAILQ_FOREACH(graph_node, &g->node_list, next)
 		fprintf(f, "     node[%d] <%s>\n", i++, graph_node->node->name);
@@ -38,6 +42,8 @@ node_dump(FILE *f, struct node *n)
 	fprintf(f, "  addr=%p\n", n);
 	fprintf(f, "  process=%p\n", n->process);
 	fprintf(f, "  nb_edges=%d\n", n->nb_edges);
+	if (n->lcore_id != RTE_MAX_LCORE)
+		fprintf(f, "  lcore_id=%u\n", n->lcore_id);
 
 	for (i = 0; i < n->nb_edges; i++)
 		fprintf(f, "     edge[%d] <%s>\n", i, n->next_nodes[i]);
@@ -61,6 +67,10 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 	fprintf(f, "  fence=0x%" PRIx64 "\n", g->fence);
 	fprintf(f, "  nodes_start=0x%" PRIx32 "\n", g->nodes_start);
 	fprintf(f, "  cir_start=%p\n", g->cir_start);
+	fprintf(f, "  sched_min_objs=%" PRIu16 "\n", g->sched_min_objs);
+	fprintf(f, "  sched_budget=%" PRIu64 "\n", g->sched_budget);
+	fprintf(f, "  nb_dispatch_rx=%" PRIu32 "\n", g->nb_dispatch_rx);
+	fprintf(f, "  nb_dispatch_tx=%" PRIu32 "\n", g->nb_dispatch_tx);
 
 	rte_graph_foreach_node(count, off, g, n) {
 		if (!all && n->idx == 0)
@@ -77,6 +87,9 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 		fprintf(f, "       idx=%d\n", n->idx);
 		fprintf(f, "       total_objs=%" PRId64 "\n", n->total_objs);
 		fprintf(f, "       total_calls=%" PRId64 "\n", n->total_calls);
+		if (n->dispatch_peer != NULL)
+			fprintf(f, "       dispatch_peer=%p\n",
+				n->dispatch_peer);
 		for (i = 0; i < n->nb_edges; i++)
 			fprintf(f, "          edge[%d] <%s>\n", i,
 				n->nodes[i]->name);
@@ -0,0 +1,202 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_ring.h>
+
+#include "graph_private.h"
+
+/*
+ * Ring entries between two lcores, a stream takes its size plus two, and is
+ * split in chunks if larger than the ring
+ */
+#define GRAPH_DISPATCH_RING_SZ 4096
+
+static int
+dispatch_ring_owned(struct graph *graph, struct rte_ring *ring)
+{
+	struct graph_node *graph_node;
+	struct rte_node *node;
+
+	STAILQ_FOREACH(graph_node, &graph->node_list, next) {
+		node = graph_node_id_to_ptr(graph->graph,
+					    graph_node->node->id);
+		if (node != NULL && node->dispatch_ring == ring)
+			return 1;
+	}
+
+	return 0;
+}
+
+static void
+dispatch_rx_remove(struct rte_graph *graph, uint32_t idx)
+{
+	graph->nb_dispatch_rx--;
+	graph->dispatch_rx[idx] = graph->dispatch_rx[graph->nb_dispatch_rx];
+	graph->dispatch_rx[graph->nb_dispatch_rx] = NULL;
+}
+
+/* Hand the nodes of src owned by the lcore of dst over to dst */
+static int
+dispatch_link(struct graph *src, struct graph *dst)
+{
+	struct rte_graph *dst_fp = dst->graph;
+	struct graph_node *graph_node;
+	struct rte_ring *ring = NULL;
+	char name[RTE_RING_NAMESIZE];
+	struct rte_node *node, *peer;
+
+	STAILQ_FOREACH(graph_node, &src->node_list, next) {
+		if (graph_node->node->lcore_id != dst->lcore_id)
+			continue;
+
+		/* The node runs locally if dst does not have it */
+		peer = graph_node_id_to_ptr(dst_fp, graph_node->node->id);
+		if (peer == NULL)
+			continue;
+
+		if (ring == NULL) {
+			snprintf(name, sizeof(name), "GRAPH_DSP_%u_%u",
+				 src->lcore_id, dst->lcore_id);
+			ring = rte_ring_create(name, GRAPH_DISPATCH_RING_SZ,
+					       dst->socket,
+					       RING_F_SP_ENQ | RING_F_SC_DEQ);
+			if (ring == NULL)
+				SET_ERR_JMP(rte_errno, fail,
+					    "Failed to create ring %s", name);
+			dst_fp->dispatch_rx[dst_fp->nb_dispatch_rx++] = ring;
+		}
+
+		node = graph_node_id_to_ptr(src->graph, graph_node->node->id);
+		node->dispatch_ring = ring;
+		node->dispatch_peer = peer;
+		src->graph->nb_dispatch_tx++;
+	}
+
+	return 0;
+fail:
+	return -rte_errno;
+}
+
+/* Append the streams queued in ring to the streams of the nodes of graph */
+static void
+dispatch_ring_drain(struct rte_graph *graph, struct rte_ring *ring)
+{
+	uint32_t count = rte_ring_count(ring);
+	uint16_t nb_objs, idx;
+	struct rte_node *node;
+	uint64_t start = 0;
+	void *hdr[2];
+
+	while (count) {
+		if (rte_graph_has_stats_feature())
+			start = rte_rdtsc();
+
+		/* A stream is enqueued at once after its header */
+		RTE_VERIFY(rte_ring_sc_dequeue_bulk(ring, hdr, 2, NULL) == 2);
+		node = hdr[0];
+		nb_objs = (uint16_t)(uintptr_t)hdr[1];
+		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+
+		idx = node->idx;
+		if (unlikely(node->size < idx + nb_objs))
+			__rte_node_stream_alloc_size(graph, node,
+						     idx + nb_objs);
+		rte_ring_sc_dequeue_bulk(ring, &node->objs[idx], nb_objs,
+					 NULL);
+		if (idx == 0)
+			__rte_node_enqueue_tail_update(graph, node);
+		node->idx = idx + nb_objs;
+		count -= nb_objs + 2;
+
+		if (rte_graph_has_stats_feature())
+			node->dispatch_cycles += rte_rdtsc() - start;
+	}
+}
+
+/* Stop handing nodes of src over to dst, and free the ring between them */
+static void
+dispatch_unlink(struct graph *src, struct graph *dst)
+{
+	struct rte_graph *dst_fp = dst->graph;
+	struct graph_node *graph_node;
+	struct rte_ring *ring;
+	struct rte_node *node;
+	uint32_t i;
+
+	for (i = 0; i < dst_fp->nb_dispatch_rx; i++) {
+		ring = dst_fp->dispatch_rx[i];
+		if (!dispatch_ring_owned(src, ring))
+			continue;
+
+		STAILQ_FOREACH(graph_node, &src->node_list, next) {
+			node = graph_node_id_to_ptr(src->graph,
+						    graph_node->node->id);
+			if (node->dispatch_ring != ring)
+				continue;
+			node->dispatch_ring = NULL;
+			node->dispatch_peer = NULL;
+			src->graph->nb_dispatch_tx--;
+		}
+
+		/* Do not lose the streams not received by dst yet */
+		dispatch_ring_drain(dst_fp, ring);
+		dispatch_rx_remove(dst_fp, i);
+		rte_ring_free(ring);
+		return;
+	}
+}
+
+int
+graph_dispatch_connect(struct graph *graph)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *peer;
+
+	if (graph->lcore_id == RTE_MAX_LCORE)
+		return 0;
+
+	STAILQ_FOREACH(peer, graph_head, next) {
+		if (peer == graph || peer->lcore_id == RTE_MAX_LCORE)
+			continue;
+		if (dispatch_link(graph, peer) || dispatch_link(peer, graph))
+			goto fail;
+	}
+
+	return 0;
+fail:
+	graph_dispatch_disconnect(graph);
+	return -rte_errno;
+}
+
+void
+graph_dispatch_disconnect(struct graph *graph)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *peer;
+
+	if (graph->lcore_id == RTE_MAX_LCORE)
+		return;
+
+	STAILQ_FOREACH(peer, graph_head, next) {
+		if (peer == graph || peer->lcore_id == RTE_MAX_LCORE)
+			continue;
+		dispatch_unlink(graph, peer);
+		dispatch_unlink(peer, graph);
+	}
+}
+
+void __rte_noinline
+__rte_graph_dispatch_rx(struct rte_graph *graph)
+{
+	uint32_t i;
+
+	/* Only take the streams present, not to starve the graph */
+	for (i = 0; i < graph->nb_dispatch_rx; i++)
+		dispatch_ring_drain(graph, graph->dispatch_rx[i]);
+}
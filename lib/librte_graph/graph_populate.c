@@ -29,6 +29,15 @@ graph_fp_mem_calc_size(struct graph *graph)
 	graph->cir_start = sz;
 	graph->cir_mask = rte_align32pow2(graph->node_count) - 1;
 	sz += val;
+	/* Deferred streams list, at most all the nodes */
+	graph->defer_start = sz;
+	sz += sizeof(rte_graph_off_t) * graph->node_count;
+	/* Dispatch mode receive rings, at most one per other lcore */
+	if (graph->lcore_id != RTE_MAX_LCORE) {
+		sz = RTE_ALIGN(sz, sizeof(struct rte_ring *));
+		graph->dispatch_rx_start = sz;
+		sz += sizeof(struct rte_ring *) * RTE_MAX_LCORE;
+	}
 	/* Fence */
 	sz += sizeof(RTE_GRAPH_FENCE);
 	sz = RTE_ALIGN(sz, RTE_CACHE_LINE_SIZE);
@@ -56,6 +65,15 @@ graph_header_popluate(struct graph *_graph)
 	graph->nb_nodes = _graph->node_count;
 	graph->cir_start = RTE_PTR_ADD(graph, _graph->cir_start);
 	graph->nodes_start = _graph->nodes_start;
+	graph->sched_min_objs = _graph->sched_min_objs;
+	graph->sched_budget = _graph->sched_budget;
+	graph->defer_start = RTE_PTR_ADD(graph, _graph->defer_start);
+	graph->nb_dispatch_rx = 0;
+	graph->nb_dispatch_tx = 0;
+	if (_graph->lcore_id != RTE_MAX_LCORE)
+		graph->dispatch_rx = RTE_PTR_ADD(graph,
+						 _graph->dispatch_rx_start);
+	graph->lcore_id = _graph->lcore_id;
 	graph->socket = _graph->socket;
 	graph->id = _graph->id;
 	memcpy(graph->name, _graph->name, RTE_GRAPH_NAMESIZE);
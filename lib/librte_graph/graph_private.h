@@ -55,6 +55,7 @@ struct node {
 	rte_node_t id;		      /**< Allocated identifier for the node. */
 	rte_node_t parent_id;	      /**< Parent node identifier. */
 	rte_edge_t nb_edges;	      /**< Number of edges from this node. */
+	unsigned int lcore_id;	      /**< Owner lcore, RTE_MAX_LCORE if any. */
 	char next_nodes[][RTE_NODE_NAMESIZE]; /**< Names of next nodes. */
 };
 
@@ -94,6 +95,16 @@ struct graph {
 	/**< Circular buffer start offset in graph reel. */
 	uint32_t cir_mask;
 	/**< Circular buffer mask for wrap around. */
+	uint32_t defer_start;
+	/**< Deferred streams list start offset in graph reel. */
+	uint16_t sched_min_objs;
+	/**< Deferred scheduling fill level, 0 if disabled. */
+	uint64_t sched_budget;
+	/**< Deferred scheduling latency budget in cycles. */
+	unsigned int lcore_id;
+	/**< Dispatch scheduling lcore, RTE_MAX_LCORE if disabled. */
+	uint32_t dispatch_rx_start;
+	/**< Dispatch scheduling receive rings start offset in graph reel. */
 	rte_graph_t id;
 	/**< Graph identifier. */
 	size_t mem_sz;
@@ -286,6 +297,34 @@ int graph_fp_mem_create(struct graph *graph);
  */
 int graph_fp_mem_destroy(struct graph *graph);
 
+/* Dispatch scheduling functions */
+/**
+ * @internal
+ *
+ * Connect a graph of the dispatch scheduling mode to the graphs of the other
+ * lcores: create the rings between them, and point the nodes owned by an
+ * lcore to their counterpart in the graph of this lcore.
+ *
+ * @param graph
+ *   Pointer to the internal graph object, not yet in the graph list.
+ *
+ * @return
+ *   - 0: Success.
+ *   - <0: Ring creation error.
+ */
+int graph_dispatch_connect(struct graph *graph);
+
+/**
+ * @internal
+ *
+ * Disconnect a graph of the dispatch scheduling mode from the graphs of the
+ * other lcores, and free the rings between them.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ */
+void graph_dispatch_disconnect(struct graph *graph);
+
 /* Lookup functions */
 /**
  * @internal
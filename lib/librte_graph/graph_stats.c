@@ -8,6 +8,7 @@
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_telemetry.h>
 
 #include "graph_private.h"
 
@@ -42,15 +43,15 @@ struct rte_graph_cluster_stats {
 #define boarder()                                                              \
 	fprintf(f, "+-------------------------------+---------------+--------" \
 		   "-------+---------------+---------------+---------------+-" \
-		   "----------+\n")
+		   "----------+---------------+\n")
 
 static inline void
 print_banner(FILE *f)
 {
 	boarder();
-	fprintf(f, "%-32s%-16s%-16s%-16s%-16s%-16s%-16s\n", "|Node", "|calls",
-		"|objs", "|realloc_count", "|objs/call", "|objs/sec(10E6)",
-		"|cycles/call|");
+	fprintf(f, "%-32s%-16s%-16s%-16s%-16s%-16s%-12s%-17s\n", "|Node",
+		"|calls", "|objs", "|realloc_count", "|objs/call",
+		"|objs/sec(10E6)", "|cycles/call", "|xfer_cycles/obj|");
 	boarder();
 }
 
@@ -58,12 +59,13 @@ static inline void
 print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 {
 	double objs_per_call, objs_per_sec, cycles_per_call, ts_per_hz;
+	double dispatch_cycles_per_obj;
 	const uint64_t prev_calls = stat->prev_calls;
 	const uint64_t prev_objs = stat->prev_objs;
 	const uint64_t cycles = stat->cycles;
 	const uint64_t calls = stat->calls;
 	const uint64_t objs = stat->objs;
-	uint64_t call_delta;
+	uint64_t call_delta, dispatch_delta;
 
 	call_delta = calls - prev_calls;
 	objs_per_call =
@@ -74,12 +76,18 @@ print_node(FILE *f, const struct rte_graph_cluster_node_stats *stat)
 	ts_per_hz = (double)((stat->ts - stat->prev_ts) / stat->hz);
 	objs_per_sec = ts_per_hz ? (objs - prev_objs) / ts_per_hz : 0;
 	objs_per_sec /= 1000000;
+	dispatch_delta = stat->dispatch_objs - stat->prev_dispatch_objs;
+	dispatch_cycles_per_obj =
+		dispatch_delta ? (double)(stat->dispatch_cycles -
+					  stat->prev_dispatch_cycles) /
+				 dispatch_delta
+			       : 0;
 
 	fprintf(f,
 		"|%-31s|%-15" PRIu64 "|%-15" PRIu64 "|%-15" PRIu64
-		"|%-15.3f|%-15.6f|%-11.4f|\n",
+		"|%-15.3f|%-15.6f|%-11.4f|%-15.4f|\n",
 		stat->name, calls, objs, stat->realloc_count, objs_per_call,
-		objs_per_sec, cycles_per_call);
+		objs_per_sec, cycles_per_call, dispatch_cycles_per_obj);
 }
 
 static int
@@ -329,9 +337,14 @@ static inline void
 cluster_node_arregate_stats(struct cluster_node *cluster)
 {
 	uint64_t calls = 0, cycles = 0, objs = 0, realloc_count = 0;
+	uint64_t fill_hist[RTE_GRAPH_FILL_HIST_SZ] = {0};
+	uint64_t cycles_hist[RTE_GRAPH_CYCLES_HIST_SZ] = {0};
+	uint64_t dispatch_objs = 0, dispatch_cycles = 0;
+	uint64_t dispatch_stalls = 0;
 	struct rte_graph_cluster_node_stats *stat = &cluster->stat;
 	struct rte_node *node;
 	rte_node_t count;
+	unsigned int i;
 
 	for (count = 0; count < cluster->nb_nodes; count++) {
 		node = cluster->nodes[count];
@@ -340,6 +353,13 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 		objs += node->total_objs;
 		cycles += node->total_cycles;
 		realloc_count += node->realloc_count;
+		for (i = 0; i < RTE_GRAPH_FILL_HIST_SZ; i++)
+			fill_hist[i] += node->fill_hist[i];
+		for (i = 0; i < RTE_GRAPH_CYCLES_HIST_SZ; i++)
+			cycles_hist[i] += node->cycles_hist[i];
+		dispatch_objs += node->dispatch_objs;
+		dispatch_cycles += node->dispatch_cycles;
+		dispatch_stalls += node->dispatch_stalls;
 	}
 
 	stat->calls = calls;
@@ -347,6 +367,11 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	stat->cycles = cycles;
 	stat->ts = rte_get_timer_cycles();
 	stat->realloc_count = realloc_count;
+	memcpy(stat->fill_hist, fill_hist, sizeof(fill_hist));
+	memcpy(stat->cycles_hist, cycles_hist, sizeof(cycles_hist));
+	stat->dispatch_objs = dispatch_objs;
+	stat->dispatch_cycles = dispatch_cycles;
+	stat->dispatch_stalls = dispatch_stalls;
 }
 
 static inline void
@@ -358,6 +383,8 @@ cluster_node_store_prev_stats(struct cluster_node *cluster)
 	stat->prev_calls = stat->calls;
 	stat->prev_objs = stat->objs;
 	stat->prev_cycles = stat->cycles;
+	stat->prev_dispatch_objs = stat->dispatch_objs;
+	stat->prev_dispatch_cycles = stat->dispatch_cycles;
 }
 
 void
@@ -401,6 +428,200 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		memset(node->fill_hist, 0, sizeof(node->fill_hist));
+		memset(node->cycles_hist, 0, sizeof(node->cycles_hist));
+		node->dispatch_objs = 0;
+		node->dispatch_cycles = 0;
+		node->dispatch_stalls = 0;
+		node->prev_dispatch_objs = 0;
+		node->prev_dispatch_cycles = 0;
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
+
+/* Telemetry */
+
+struct graph_tel_stats {
+	struct rte_tel_data *names;
+	struct rte_tel_data *calls;
+	struct rte_tel_data *objs;
+	struct rte_tel_data *cycles;
+};
+
+struct graph_tel_node {
+	const char *name;
+	struct rte_tel_data *d;
+	bool found;
+};
+
+static struct rte_graph_cluster_stats *
+graph_tel_stats_create(const char *pattern, rte_graph_cluster_stats_cb_t fn,
+		       void *cookie)
+{
+	struct rte_graph_cluster_stats_param prm = {
+		.socket_id = SOCKET_ID_ANY,
+		.fn = fn,
+		.cookie = cookie,
+		.nb_graph_patterns = 1,
+		.graph_patterns = &pattern,
+	};
+
+	return rte_graph_cluster_stats_create(&prm);
+}
+
+static struct rte_tel_data *
+graph_tel_array(struct rte_tel_data *d, const char *name,
+		enum rte_tel_value_type type)
+{
+	struct rte_tel_data *a;
+
+	a = rte_tel_data_alloc();
+	if (a == NULL)
+		return NULL;
+	rte_tel_data_start_array(a, type);
+	rte_tel_data_add_dict_container(d, name, a, 0);
+	return a;
+}
+
+static int
+graph_tel_stats_cb(bool is_first, bool is_last, void *cookie,
+		   const struct rte_graph_cluster_node_stats *stat)
+{
+	struct graph_tel_stats *tel = cookie;
+
+	RTE_SET_USED(is_first);
+	RTE_SET_USED(is_last);
+
+	rte_tel_data_add_array_string(tel->names, stat->name);
+	rte_tel_data_add_array_u64(tel->calls, stat->calls);
+	rte_tel_data_add_array_u64(tel->objs, stat->objs);
+	rte_tel_data_add_array_u64(tel->cycles, stat->cycles);
+	return 0;
+}
+
+static void
+graph_tel_hist(struct rte_tel_data *d, const char *name, const uint64_t *hist,
+	       unsigned int sz)
+{
+	struct rte_tel_data *a;
+	unsigned int i;
+
+	a = graph_tel_array(d, name, RTE_TEL_U64_VAL);
+	if (a == NULL)
+		return;
+	for (i = 0; i < sz; i++)
+		rte_tel_data_add_array_u64(a, hist[i]);
+}
+
+static int
+graph_tel_node_cb(bool is_first, bool is_last, void *cookie,
+		  const struct rte_graph_cluster_node_stats *stat)
+{
+	struct graph_tel_node *tel = cookie;
+	struct rte_tel_data *d = tel->d;
+
+	RTE_SET_USED(is_first);
+	RTE_SET_USED(is_last);
+
+	if (strncmp(stat->name, tel->name, RTE_NODE_NAMESIZE) != 0)
+		return 0;
+
+	rte_tel_data_add_dict_string(d, "name", stat->name);
+	rte_tel_data_add_dict_u64(d, "calls", stat->calls);
+	rte_tel_data_add_dict_u64(d, "objs", stat->objs);
+	rte_tel_data_add_dict_u64(d, "cycles", stat->cycles);
+	rte_tel_data_add_dict_u64(d, "realloc_count", stat->realloc_count);
+	rte_tel_data_add_dict_u64(d, "dispatch_objs", stat->dispatch_objs);
+	rte_tel_data_add_dict_u64(d, "dispatch_cycles", stat->dispatch_cycles);
+	rte_tel_data_add_dict_u64(d, "dispatch_stalls",
+				  stat->dispatch_stalls);
+	graph_tel_hist(d, "fill_hist", stat->fill_hist,
+		       RTE_GRAPH_FILL_HIST_SZ);
+	graph_tel_hist(d, "cycles_hist", stat->cycles_hist,
+		       RTE_GRAPH_CYCLES_HIST_SZ);
+	tel->found = true;
+	/* Stop the walk over the nodes */
+	return 1;
+}
+
+static int
+graph_handle_list(const char *cmd __rte_unused,
+		  const char *params __rte_unused, struct rte_tel_data *d)
+{
+	struct graph_head *graph_head = graph_list_head_get();
+	struct graph *graph;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_head, next)
+		rte_tel_data_add_array_string(d, graph->name);
+	graph_spinlock_unlock();
+	return 0;
+}
+
+static int
+graph_handle_stats(const char *cmd __rte_unused, const char *params,
+		   struct rte_tel_data *d)
+{
+	struct rte_graph_cluster_stats *stats;
+	struct graph_tel_stats tel;
+	const char *pattern = "*";
+
+	if (params != NULL && strlen(params) != 0)
+		pattern = params;
+
+	rte_tel_data_start_dict(d);
+	tel.names = graph_tel_array(d, "nodes", RTE_TEL_STRING_VAL);
+	tel.calls = graph_tel_array(d, "calls", RTE_TEL_U64_VAL);
+	tel.objs = graph_tel_array(d, "objs", RTE_TEL_U64_VAL);
+	tel.cycles = graph_tel_array(d, "cycles", RTE_TEL_U64_VAL);
+	if (tel.names == NULL || tel.calls == NULL || tel.objs == NULL ||
+	    tel.cycles == NULL)
+		goto fail;
+
+	stats = graph_tel_stats_create(pattern, graph_tel_stats_cb, &tel);
+	if (stats == NULL)
+		goto fail;
+	rte_graph_cluster_stats_get(stats, false);
+	rte_graph_cluster_stats_destroy(stats);
+	return 0;
+fail:
+	rte_tel_data_free(tel.names);
+	rte_tel_data_free(tel.calls);
+	rte_tel_data_free(tel.objs);
+	rte_tel_data_free(tel.cycles);
+	return -1;
+}
+
+static int
+graph_handle_node(const char *cmd __rte_unused, const char *params,
+		  struct rte_tel_data *d)
+{
+	struct rte_graph_cluster_stats *stats;
+	struct graph_tel_node tel;
+
+	if (params == NULL || strlen(params) == 0)
+		return -1;
+
+	tel.name = params;
+	tel.d = d;
+	tel.found = false;
+	stats = graph_tel_stats_create("*", graph_tel_node_cb, &tel);
+	if (stats == NULL)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_graph_cluster_stats_get(stats, false);
+	rte_graph_cluster_stats_destroy(stats);
+	return tel.found ? 0 : -1;
+}
+
+RTE_INIT(graph_init_telemetry)
+{
+	rte_telemetry_register_cmd("/graph/list", graph_handle_list,
+		"Returns list of available graphs. Takes no parameters");
+	rte_telemetry_register_cmd("/graph/stats", graph_handle_stats,
+		"Returns node stats. Parameters: graph pattern, all if none");
+	rte_telemetry_register_cmd("/graph/node", graph_handle_node,
+		"Returns node stats and histograms. Parameters: node name");
+}
@@ -96,6 +96,7 @@ __rte_node_register(const struct rte_node_register *reg)
 	node->fini = reg->fini;
 	node->nb_edges = reg->nb_edges;
 	node->parent_id = reg->parent_id;
+	node->lcore_id = RTE_MAX_LCORE;
 	for (i = 0; i < reg->nb_edges; i++) {
 		if (rte_strscpy(node->next_nodes[i], reg->next_nodes[i],
 				RTE_NODE_NAMESIZE) < 0) {
@@ -201,6 +202,31 @@ rte_node_clone(rte_node_t id, const char *name)
 	return RTE_NODE_ID_INVALID;
 }
 
+int
+rte_node_lcore_affinity_set(rte_node_t id, unsigned int lcore_id)
+{
+	struct node *node;
+	int rc = -EINVAL;
+
+	NODE_ID_CHECK(id);
+	if (lcore_id > RTE_MAX_LCORE)
+		goto fail;
+
+	graph_spinlock_lock();
+
+	STAILQ_FOREACH(node, &node_list, next) {
+		if (node->id == id) {
+			node->lcore_id = lcore_id;
+			rc = 0;
+			break;
+		}
+	}
+
+	graph_spinlock_unlock();
+fail:
+	return rc;
+}
+
 rte_node_t
 rte_node_from_name(const char *name)
 {
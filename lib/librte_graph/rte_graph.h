@@ -69,6 +69,22 @@ typedef uint16_t rte_graph_t;      /**< Graph id type. */
 #error "Unsupported burst size"
 #endif
 
+/**
+ * Number of buckets of the node fill histograms.
+ *
+ * Bucket 0 counts the calls with no object, bucket n the calls with
+ * [2^(n-1), 2^n) objects, and the last bucket the calls with a burst or more.
+ */
+#define RTE_GRAPH_FILL_HIST_SZ (RTE_GRAPH_BURST_SIZE_LOG2 + 2)
+
+/**
+ * Number of buckets of the node cycles histograms.
+ *
+ * Bucket n counts the calls which took [2^(n-1), 2^n) cycles, and the last
+ * bucket the longer calls.
+ */
+#define RTE_GRAPH_CYCLES_HIST_SZ 32
+
 /* Forward declaration */
 struct rte_node;  /**< Node object */
 struct rte_graph; /**< Graph object */
@@ -154,6 +170,25 @@ typedef void (*rte_node_fini_t)(const struct rte_graph *graph,
 typedef int (*rte_graph_cluster_stats_cb_t)(bool is_first, bool is_last,
 	     void *cookie, const struct rte_graph_cluster_node_stats *stats);
 
+/**
+ * Graph node scheduling modes.
+ *
+ * @see struct rte_graph_param::sched_mode
+ */
+enum rte_graph_sched_mode {
+	RTE_GRAPH_SCHED_DEFAULT = 0,
+	/**< Run all the pending nodes on each graph walk. */
+	RTE_GRAPH_SCHED_DEFERRED,
+	/**< Defer a pending node to the next graph walks until it holds
+	 *   sched_min_objs objects or it is pending for sched_budget_us.
+	 */
+	RTE_GRAPH_SCHED_DISPATCH,
+	/**< Walk the graph on lcore_id, and hand the streams of the nodes
+	 *   owned by other lcores over to the graphs of these lcores.
+	 *   @see rte_node_lcore_affinity_set()
+	 */
+};
+
 /**
  * Structure to hold configuration parameters for creating the graph.
  *
@@ -164,6 +199,20 @@ struct rte_graph_param {
 	uint16_t nb_node_patterns;  /**< Number of node patterns. */
 	const char **node_patterns;
 	/**< Array of node patterns based on shell pattern. */
+	enum rte_graph_sched_mode sched_mode;
+	/**< Node scheduling mode, RTE_GRAPH_SCHED_DEFAULT when zeroed. */
+	uint16_t sched_min_objs;
+	/**< Deferred mode: number of objects a node waits for, from 1 to
+	 *   RTE_GRAPH_BURST_SIZE.
+	 */
+	uint32_t sched_budget_us;
+	/**< Deferred mode: latency budget in microseconds, after which a
+	 *   pending node runs whatever its number of objects.
+	 */
+	unsigned int lcore_id;
+	/**< Dispatch mode: lcore walking the graph, at most one graph per
+	 *   lcore.
+	 */
 };
 
 /**
@@ -205,6 +254,24 @@ struct rte_graph_cluster_node_stats {
 	uint64_t prev_cycles;	/**< Previous number of cycles. */
 
 	uint64_t realloc_count; /**< Realloc count. */
+	uint64_t fill_hist[RTE_GRAPH_FILL_HIST_SZ];
+	/**< Number of calls per number of objects, in power of 2 buckets.
+	 *   @see RTE_GRAPH_FILL_HIST_SZ
+	 */
+	uint64_t cycles_hist[RTE_GRAPH_CYCLES_HIST_SZ];
+	/**< Number of calls per number of cycles, in power of 2 buckets.
+	 *   @see RTE_GRAPH_CYCLES_HIST_SZ
+	 */
+	uint64_t dispatch_objs;
+	/**< Dispatch mode: objs handed over to the lcore owning the node. */
+	uint64_t dispatch_cycles;
+	/**< Dispatch mode: cycles spent handing objs over, on both lcores. */
+	uint64_t dispatch_stalls;
+	/**< Dispatch mode: walks leaving a stream pending, as the ring to the
+	 *   lcore owning the node was full.
+	 */
+	uint64_t prev_dispatch_objs;	/**< Previous number of handed objs. */
+	uint64_t prev_dispatch_cycles;	/**< Previous number of hand cycles. */
 
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
@@ -485,6 +552,26 @@ rte_node_t __rte_node_register(const struct rte_node_register *node);
 __rte_experimental
 rte_node_t rte_node_clone(rte_node_t id, const char *name);
 
+/**
+ * Set the lcore affinity of a node, for the graphs of the
+ * RTE_GRAPH_SCHED_DISPATCH mode created afterwards.
+ *
+ * The graph of the lcore owning the node processes its objs. The other
+ * graphs hand the streams of the node over to this graph, through a ring per
+ * pair of lcores, once per graph walk. A node without affinity is processed
+ * by the graph it is enqueued to.
+ *
+ * @param id
+ *   Node id.
+ * @param lcore_id
+ *   Lcore owning the node, or RTE_MAX_LCORE to clear the affinity.
+ *
+ * @return
+ *   0 on success, -EINVAL otherwise.
+ */
+__rte_experimental
+int rte_node_lcore_affinity_set(rte_node_t id, unsigned int lcore_id);
+
 /**
  * Get node id from node name.
  *
@@ -16,11 +16,14 @@
  * process, enqueue and move streams of objects to the next nodes.
  */
 
+#include <string.h>
+
 #include <rte_common.h>
 #include <rte_cycles.h>
 #include <rte_prefetch.h>
 #include <rte_memcpy.h>
 #include <rte_memory.h>
+#include <rte_ring.h>
 
 #include "rte_graph.h"
 
@@ -40,6 +43,13 @@ struct rte_graph {
 	rte_node_t nb_nodes;	     /**< Number of nodes in the graph. */
 	rte_graph_off_t *cir_start;  /**< Pointer to circular buffer. */
 	rte_graph_off_t nodes_start; /**< Offset at which node memory starts. */
+	uint16_t sched_min_objs;     /**< Deferred mode fill level, 0 if off. */
+	uint64_t sched_budget;	     /**< Deferred mode budget in cycles. */
+	rte_graph_off_t *defer_start; /**< Nodes deferred by a graph walk. */
+	uint32_t nb_dispatch_rx; /**< Number of rings to receive from. */
+	uint32_t nb_dispatch_tx; /**< Number of nodes owned by other lcores. */
+	struct rte_ring **dispatch_rx; /**< Rings from the other lcores. */
+	unsigned int lcore_id;	/**< Dispatch mode lcore. */
 	rte_graph_t id;	/**< Graph identifier. */
 	int socket;	/**< Socket ID where memory is allocated. */
 	char name[RTE_GRAPH_NAMESIZE];	/**< Name of the graph. */
@@ -62,6 +72,14 @@ struct rte_node {
 
 	char parent[RTE_NODE_NAMESIZE];	/**< Parent node name. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
+	uint64_t defer_ts;	/**< Timestamp of the first deferral. */
+	uint64_t fill_hist[RTE_GRAPH_FILL_HIST_SZ]; /**< Fill histogram. */
+	uint64_t cycles_hist[RTE_GRAPH_CYCLES_HIST_SZ]; /**< Cycles per call. */
+	struct rte_ring *dispatch_ring;	/**< Ring to the owner lcore. */
+	struct rte_node *dispatch_peer;	/**< Node in the owner lcore graph. */
+	uint64_t dispatch_objs;		/**< Objs handed over. */
+	uint64_t dispatch_cycles;	/**< Cycles spent handing objs over. */
+	uint64_t dispatch_stalls;	/**< Hand-overs left for a full ring. */
 
 	/* Fast path area  */
 #define RTE_NODE_CTX_SZ 16
@@ -118,10 +136,192 @@ __rte_experimental
 void __rte_node_stream_alloc_size(struct rte_graph *graph,
 				  struct rte_node *node, uint16_t req_size);
 
+/**
+ * @internal
+ *
+ * Check whether a pending node is deferred to the next graph walk, in the
+ * RTE_GRAPH_SCHED_DEFERRED scheduling mode.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the pending node object.
+ * @param now
+ *   Timestamp of the graph walk.
+ *
+ * @return
+ *   1 if the node is deferred, 0 if it must run.
+ */
+static __rte_always_inline int
+__rte_node_defer(const struct rte_graph *graph, struct rte_node *node,
+		 uint64_t now)
+{
+	if (node->idx < graph->sched_min_objs) {
+		if (node->defer_ts == 0) {
+			node->defer_ts = now;
+			return 1;
+		}
+		if (now - node->defer_ts < graph->sched_budget)
+			return 1;
+	}
+	node->defer_ts = 0;
+	return 0;
+}
+
+/**
+ * @internal
+ *
+ * Update the fill histogram of a node before it is run.
+ *
+ * @param node
+ *   Pointer to the node object.
+ */
+static __rte_always_inline void
+__rte_node_fill_hist_update(struct rte_node *node)
+{
+	const uint32_t bucket = rte_fls_u32(node->idx);
+
+	node->fill_hist[RTE_MIN(bucket, RTE_GRAPH_FILL_HIST_SZ - 1U)]++;
+}
+
+/**
+ * @internal
+ *
+ * Update the cycles histogram of a node after it is run.
+ *
+ * @param node
+ *   Pointer to the node object.
+ * @param cycles
+ *   Cycles spent in the process function of the node.
+ */
+static __rte_always_inline void
+__rte_node_cycles_hist_update(struct rte_node *node, uint64_t cycles)
+{
+	const uint32_t bucket = rte_fls_u64(cycles);
+
+	node->cycles_hist[RTE_MIN(bucket, RTE_GRAPH_CYCLES_HIST_SZ - 1U)]++;
+}
+
+/**
+ * @internal
+ *
+ * Copy objects to the space reserved on a ring, from a position.
+ *
+ * @param zcd
+ *   Space reserved on the ring.
+ * @param pos
+ *   Position of the first object in the reserved space.
+ * @param objs
+ *   Objects to copy.
+ * @param n
+ *   Number of objects to copy.
+ */
+static __rte_always_inline void
+__rte_node_dispatch_copy(const struct rte_ring_zc_data *zcd, unsigned int pos,
+			 void * const *objs, unsigned int n)
+{
+	void **ptr1 = zcd->ptr1;
+	void **ptr2 = zcd->ptr2;
+	unsigned int n1 = pos < zcd->n1 ? RTE_MIN(zcd->n1 - pos, n) : 0;
+
+	if (n1)
+		rte_memcpy(&ptr1[pos], objs, n1 * sizeof(void *));
+	if (n > n1)
+		rte_memcpy(&ptr2[pos + n1 - zcd->n1], &objs[n1],
+			   (n - n1) * sizeof(void *));
+}
+
+/**
+ * @internal
+ *
+ * Hand the stream of a node over to the graph of the lcore owning the node,
+ * in the RTE_GRAPH_SCHED_DISPATCH scheduling mode.
+ *
+ * The stream is put in the ring to the owner lcore in chunks taking at most
+ * the whole ring, each in one operation after the node of the owner graph and
+ * the number of objects. The objects not handed over, when the ring is full,
+ * are moved to the start of the stream.
+ *
+ * @param node
+ *   Pointer to the node object, owned by another lcore.
+ *
+ * @return
+ *   1 if the stream is handed over, 0 if objects are left in the stream.
+ */
+static __rte_always_inline int
+__rte_node_dispatch(struct rte_node *node)
+{
+	struct rte_ring *ring = node->dispatch_ring;
+	const uint16_t max_objs = rte_ring_get_capacity(ring) - 2;
+	uint16_t nb_objs = node->idx;
+	struct rte_ring_zc_data zcd;
+	uint16_t n, done = 0;
+	uint64_t start = 0;
+	void *hdr[2];
+
+	/* Source node, polled by its owner lcore */
+	if (nb_objs == 0)
+		return 1;
+
+	if (rte_graph_has_stats_feature())
+		start = rte_rdtsc();
+
+	while (nb_objs) {
+		n = RTE_MIN(nb_objs, max_objs);
+		if (rte_ring_enqueue_zc_bulk_start(ring, n + 2, &zcd,
+						   NULL) == 0)
+			break;
+		hdr[0] = node->dispatch_peer;
+		hdr[1] = (void *)(uintptr_t)n;
+		__rte_node_dispatch_copy(&zcd, 0, hdr, 2);
+		__rte_node_dispatch_copy(&zcd, 2, &node->objs[done], n);
+		rte_ring_enqueue_zc_finish(ring, n + 2);
+		done += n;
+		nb_objs -= n;
+	}
+
+	if (rte_graph_has_stats_feature()) {
+		node->dispatch_objs += done;
+		node->dispatch_cycles += rte_rdtsc() - start;
+		if (nb_objs)
+			node->dispatch_stalls++;
+	}
+	if (likely(nb_objs == 0))
+		return 1;
+
+	if (done)
+		memmove(node->objs, &node->objs[done],
+			nb_objs * sizeof(void *));
+	node->idx = nb_objs;
+	return 0;
+}
+
+/**
+ * @internal
+ *
+ * Receive the streams handed over by the other lcores, in the
+ * RTE_GRAPH_SCHED_DISPATCH scheduling mode, and make their nodes pending.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+__rte_experimental
+void __rte_graph_dispatch_rx(struct rte_graph *graph);
+
 /**
  * Perform graph walk on the circular buffer and invoke the process function
  * of the nodes and collect the stats.
  *
+ * In the RTE_GRAPH_SCHED_DEFERRED scheduling mode, the pending nodes holding
+ * less objects than the configured fill level are kept pending for the next
+ * walks, until they fill up or exceed the latency budget.
+ *
+ * In the RTE_GRAPH_SCHED_DISPATCH scheduling mode, the walk first receives
+ * the streams handed over by the other lcores, and hands the streams of the
+ * nodes owned by other lcores over instead of processing them. The nodes
+ * whose stream does not fit in the ring to their owner lcore are kept
+ * pending for the next walks.
+ *
  * @param graph
  *   Graph pointer returned from rte_graph_lookup function.
  *
@@ -134,8 +334,11 @@ rte_graph_walk(struct rte_graph *graph)
 	const rte_graph_off_t *cir_start = graph->cir_start;
 	const rte_node_t mask = graph->cir_mask;
 	uint32_t head = graph->head;
+	const uint16_t min_objs = graph->sched_min_objs;
+	const uint32_t dispatch = graph->nb_dispatch_tx;
+	uint32_t nb_deferred = 0;
 	struct rte_node *node;
-	uint64_t start;
+	uint64_t start, cycles, now = 0;
 	uint16_t rc;
 	void **objs;
 
@@ -153,17 +356,44 @@ rte_graph_walk(struct rte_graph *graph)
 	 *	| ... | <= pending streams
 	 *	|     |
 	 *	+-----+ <= cir_start + mask
+	 *
+	 * The deferred pending streams are set aside and become the first
+	 * pending streams of the next walk. The streams received from the
+	 * other lcores are appended to the pending streams.
 	 */
+	if (unlikely(min_objs))
+		now = rte_rdtsc();
+	if (unlikely(graph->nb_dispatch_rx))
+		__rte_graph_dispatch_rx(graph);
+
 	while (likely(head != graph->tail)) {
 		node = RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
 		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+		if (unlikely(min_objs) && (int32_t)head > 0 &&
+		    __rte_node_defer(graph, node, now)) {
+			graph->defer_start[nb_deferred++] = node->off;
+			head &= mask;
+			continue;
+		}
+		if (unlikely(dispatch) && node->dispatch_ring != NULL) {
+			/* Keep the node pending until the ring has room */
+			if (__rte_node_dispatch(node))
+				node->idx = 0;
+			else
+				graph->defer_start[nb_deferred++] = node->off;
+			head = likely((int32_t)head > 0) ? head & mask : head;
+			continue;
+		}
 		objs = node->objs;
 		rte_prefetch0(objs);
 
 		if (rte_graph_has_stats_feature()) {
+			__rte_node_fill_hist_update(node);
 			start = rte_rdtsc();
 			rc = node->process(graph, node, objs, node->idx);
-			node->total_cycles += rte_rdtsc() - start;
+			cycles = rte_rdtsc() - start;
+			node->total_cycles += cycles;
+			__rte_node_cycles_hist_update(node, cycles);
 			node->total_calls++;
 			node->total_objs += rc;
 		} else {
@@ -172,7 +402,11 @@ rte_graph_walk(struct rte_graph *graph)
 		node->idx = 0;
 		head = likely((int32_t)head > 0) ? head & mask : head;
 	}
-	graph->tail = 0;
+
+	if (unlikely(nb_deferred))
+		rte_memcpy(graph->cir_start, graph->defer_start,
+			   nb_deferred * sizeof(rte_graph_off_t));
+	graph->tail = nb_deferred;
 }
 
 /* Fast path helper functions */
@@ -224,7 +458,7 @@ __rte_node_enqueue_prologue(struct rte_graph *graph, struct rte_node *node,
 		__rte_node_enqueue_tail_update(graph, node);
 
 	if (unlikely(node->size < (idx + space)))
-		__rte_node_stream_alloc(graph, node);
+		__rte_node_stream_alloc_size(graph, node, idx + space);
 }
 
 /**
@@ -38,7 +38,8 @@
 				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY | \
 				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE |	\
 				   RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL | \
-				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF | \
+				   RTE_HASH_EXTRA_FLAGS_RESIZABLE)
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -57,6 +58,9 @@ struct __rte_hash_rcu_dq_entry {
 	uint32_t ext_bkt_idx;
 };
 
+static void
+__hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n);
+
 struct rte_hash *
 rte_hash_find_existing(const char *name)
 {
@@ -158,6 +162,8 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	uint32_t *tbl_chng_cnt = NULL;
 	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	struct rte_hash_rs *rs = NULL;
+	struct rte_hash_rs_tbl *rs_tbl = NULL;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -193,6 +199,18 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	/* Resizing relies on lock free readers and a single writer */
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) &&
+	    (!(params->extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) ||
+	     (params->extra_flag & (RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD |
+				    RTE_HASH_EXTRA_FLAGS_EXT_TABLE)))) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: resizable table requires "
+			"rw concurrency lock free, single writer and no ext "
+			"table\n");
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -401,6 +419,29 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		}
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) {
+		rs = rte_zmalloc_socket(NULL, sizeof(struct rte_hash_rs),
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		rs_tbl = rte_zmalloc_socket(NULL, sizeof(struct rte_hash_rs_tbl),
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		if (rs == NULL || rs_tbl == NULL) {
+			RTE_LOG(ERR, HASH, "resize state memory allocation failed\n");
+			goto err_unlock;
+		}
+		rs->key_hash = rte_zmalloc_socket(NULL,
+				sizeof(hash_sig_t) * num_key_slots,
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+		if (rs->key_hash == NULL) {
+			RTE_LOG(ERR, HASH, "resize state memory allocation failed\n");
+			goto err_unlock;
+		}
+		rs->socket_id = params->socket_id;
+		rs->min_buckets = num_buckets;
+		rs->key_slots = num_key_slots;
+		rs_tbl->buckets = buckets;
+		rs_tbl->bucket_bitmask = num_buckets - 1;
+	}
+
 	/* Default hash function */
 #if defined(RTE_ARCH_X86)
 	default_hash_func = (rte_hash_function)rte_hash_crc;
@@ -435,8 +476,15 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->resizable = (rs != NULL);
+	h->rs = rs;
+	h->rs_tbl = rs_tbl;
 
 #if defined(RTE_ARCH_X86)
+	/* Vector compare functions load the signatures from the start
+	 * of the buckets.
+	 */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_hash_bucket, sig_current) != 0);
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
@@ -447,6 +495,20 @@ rte_hash_create(const struct rte_hash_parameters *params)
 #endif
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SCALAR;
 
+#ifdef CC_HASH_AVX512_SUPPORT
+	/* Compare the signatures of several keys at once and the keys
+	 * which have no dedicated compare function with masked loads.
+	 */
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0 &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512) {
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+		if (h->cmp_jump_table_idx == KEY_OTHER_BYTES &&
+				params->key_len < 64)
+			h->cmp_jump_table_idx = KEY_MASKED_BYTES;
+	}
+#endif
+
 	/* Writer threads need to take the lock when:
 	 * 1) RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY is enabled OR
 	 * 2) RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD is enabled
@@ -482,9 +544,79 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_free(k);
 	rte_free(tbl_chng_cnt);
 	rte_free(ext_bkt_to_free);
+	if (rs != NULL)
+		rte_free(rs->key_hash);
+	rte_free(rs);
+	rte_free(rs_tbl);
 	return NULL;
 }
 
+/*
+ * Readers no longer see the key store used before the last grow,
+ * hand out the key slots that were added by the grow.
+ */
+static void
+__hash_rs_release_key_store(struct rte_hash *h)
+{
+	struct rte_hash_rs *rs = h->rs;
+	uint32_t i;
+
+	rte_free(rs->key_store_old);
+	rs->key_store_old = NULL;
+
+	for (i = rs->key_store_old_slots; i < rs->key_slots; i++)
+		rte_ring_sp_enqueue_elem(h->free_slots, &i, sizeof(uint32_t));
+	h->entries += rs->key_slots - rs->key_store_old_slots;
+}
+
+/*
+ * Free the memory of previous resizes that the readers no longer use.
+ * If wait is set, block until the readers have reported a quiescent
+ * state and free all of it.
+ */
+static void
+__hash_rs_reclaim(struct rte_hash *h, bool wait)
+{
+	struct rte_hash_rs *rs = h->rs;
+	struct rte_rcu_qsbr *v = h->hash_rcu_cfg->v;
+	uint32_t i;
+
+	/* Tokens are increasing, stop at the first one still pending */
+	for (i = 0; i < rs->nb_retire; i++) {
+		if (rte_rcu_qsbr_check(v, rs->retire[i].token, wait) == 0)
+			break;
+		rte_free(rs->retire[i].tbl);
+		rte_free(rs->retire[i].buckets);
+	}
+	rs->nb_retire -= i;
+	memmove(rs->retire, &rs->retire[i],
+		rs->nb_retire * sizeof(struct rte_hash_rs_retire));
+
+	if (rs->key_store_old != NULL &&
+			rte_rcu_qsbr_check(v, rs->key_store_token, wait) == 1)
+		__hash_rs_release_key_store(h);
+}
+
+/*
+ * Free the memory of previous resizes without waiting for the readers.
+ * Only safe when no reader is referencing the table.
+ */
+static void
+__hash_rs_drain(struct rte_hash *h)
+{
+	struct rte_hash_rs *rs = h->rs;
+	uint32_t i;
+
+	for (i = 0; i < rs->nb_retire; i++) {
+		rte_free(rs->retire[i].tbl);
+		rte_free(rs->retire[i].buckets);
+	}
+	rs->nb_retire = 0;
+
+	if (rs->key_store_old != NULL)
+		__hash_rs_release_key_store(h);
+}
+
 void
 rte_hash_free(struct rte_hash *h)
 {
@@ -516,6 +648,18 @@ rte_hash_free(struct rte_hash *h)
 	if (h->dq)
 		rte_rcu_qsbr_dq_delete(h->dq);
 
+	if (h->rs != NULL) {
+		__hash_rs_drain(h);
+		rte_free(h->rs->buckets_old);
+		rte_free(h->rs->key_hash);
+		rte_free(h->rs_tbl);
+		if (h->rs->free_slots_zmalloc) {
+			rte_free(h->free_slots);
+			h->free_slots = NULL;
+		}
+		rte_free(h->rs);
+	}
+
 	if (h->use_local_cache)
 		rte_free(h->local_free_slots);
 	if (h->writer_takes_lock)
@@ -632,6 +776,15 @@ rte_hash_reset(struct rte_hash *h)
 			RTE_LOG(ERR, HASH, "RCU reclaim all resources failed\n");
 	}
 
+	if (h->rs != NULL) {
+		/* No reader is referencing the table, drop any resize */
+		__hash_rs_drain(h);
+		rte_free(h->rs->buckets_old);
+		h->rs->buckets_old = NULL;
+		h->rs->migrate_idx = 0;
+		h->rs_tbl->buckets_old = NULL;
+	}
+
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
@@ -689,6 +842,26 @@ enqueue_slot_back(const struct rte_hash *h,
 						sizeof(uint32_t));
 }
 
+/*
+ * After a grow, readers may still use the previous key store until they
+ * report a quiescent state. Mirror the writes to a key slot into it.
+ */
+static inline void
+__hash_rs_key_store_sync(const struct rte_hash *h, uint32_t key_idx)
+{
+	struct rte_hash_rs *rs = h->rs;
+	struct rte_hash_key *k, *old_k;
+
+	if (rs == NULL || rs->key_store_old == NULL ||
+			key_idx >= rs->key_store_old_slots)
+		return;
+
+	k = RTE_PTR_ADD(h->key_store, key_idx * h->key_entry_size);
+	old_k = RTE_PTR_ADD(rs->key_store_old, key_idx * h->key_entry_size);
+	memcpy(old_k->key, k->key, h->key_len);
+	__atomic_store_n(&old_k->pdata, k->pdata, __ATOMIC_RELEASE);
+}
+
 /* Search a key from bucket and update its data.
  * Writer holds the lock before calling this.
  */
@@ -713,6 +886,7 @@ search_and_update(const struct rte_hash *h, void *data, const void *key,
 				__atomic_store_n(&k->pdata,
 					data,
 					__ATOMIC_RELEASE);
+				__hash_rs_key_store_sync(h, bkt->key_idx[i]);
 				/*
 				 * Return index where key is stored,
 				 * subtracting the first dummy index
@@ -1004,6 +1178,450 @@ alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
 	return slot_id;
 }
 
+/*
+ * Publish the current bucket arrays to the readers of a resizable table.
+ * The previous view, and 'free_bkts' if not NULL, are freed once the
+ * readers have reported a quiescent state.
+ */
+static int
+__hash_rs_publish(struct rte_hash *h, struct rte_hash_bucket *free_bkts)
+{
+	struct rte_hash_rs *rs = h->rs;
+	struct rte_hash_rs_tbl *tbl, *prev_tbl = h->rs_tbl;
+	struct rte_hash_rs_retire *r;
+
+	tbl = rte_zmalloc_socket(NULL, sizeof(struct rte_hash_rs_tbl),
+				RTE_CACHE_LINE_SIZE, rs->socket_id);
+	if (tbl == NULL)
+		return -ENOMEM;
+
+	tbl->buckets = h->buckets;
+	tbl->bucket_bitmask = h->bucket_bitmask;
+	tbl->buckets_old = rs->buckets_old;
+	tbl->old_bucket_bitmask = rs->old_bucket_bitmask;
+
+	/* Make room by waiting for the readers to leave older views */
+	if (rs->nb_retire == RTE_HASH_RESIZE_RETIRE_MAX)
+		__hash_rs_reclaim(h, true);
+
+	/* Release the new view to the readers. The bucket arrays are
+	 * initialized before they are published.
+	 */
+	__atomic_store_n(&h->rs_tbl, tbl, __ATOMIC_RELEASE);
+
+	r = &rs->retire[rs->nb_retire++];
+	r->tbl = prev_tbl;
+	r->buckets = free_bkts;
+	r->token = rte_rcu_qsbr_start(h->hash_rcu_cfg->v);
+
+	return 0;
+}
+
+/*
+ * Insert a key slot, moved from the old bucket array, into the current
+ * bucket array of a resizable table.
+ */
+static int
+__hash_rs_insert(struct rte_hash *h, uint32_t key_idx)
+{
+	hash_sig_t sig = h->rs->key_hash[key_idx];
+	uint16_t short_sig = get_short_sig(sig);
+	uint32_t prim_bucket_idx = get_prim_bucket_index(h, sig);
+	uint32_t sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+							short_sig);
+	struct rte_hash_bucket *prim_bkt = &h->buckets[prim_bucket_idx];
+	struct rte_hash_bucket *sec_bkt = &h->buckets[sec_bucket_idx];
+	struct rte_hash_key *k = RTE_PTR_ADD(h->key_store,
+					key_idx * h->key_entry_size);
+	struct rte_hash_bucket *bkt;
+	int32_t ret_val;
+	unsigned int i;
+
+	for (bkt = prim_bkt; ; bkt = sec_bkt) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (bkt->key_idx[i] == EMPTY_SLOT) {
+				bkt->sig_current[i] = short_sig;
+				__atomic_store_n(&bkt->key_idx[i], key_idx,
+						 __ATOMIC_RELEASE);
+				return 0;
+			}
+		}
+		if (bkt == sec_bkt)
+			break;
+	}
+
+	if (rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt,
+			(const void *)k->key, k->pdata, short_sig,
+			prim_bucket_idx, key_idx, &ret_val) == 0)
+		return 0;
+
+	if (rte_hash_cuckoo_make_space_mw(h, sec_bkt, prim_bkt,
+			(const void *)k->key, k->pdata, short_sig,
+			sec_bucket_idx, key_idx, &ret_val) == 0)
+		return 0;
+
+	return -ENOSPC;
+}
+
+/*
+ * Move up to n_buckets buckets of the old bucket array into the current
+ * one. Returns the number of buckets left to move, or a negative value
+ * if a key could not be moved.
+ */
+static int
+__hash_rs_migrate(struct rte_hash *h, uint32_t n_buckets)
+{
+	struct rte_hash_rs *rs = h->rs;
+	struct rte_hash_bucket *bkt, *old_bkts;
+	uint32_t key_idx;
+	unsigned int i;
+
+	if (rs->buckets_old == NULL)
+		return 0;
+
+	while (rs->migrate_idx < rs->old_num_buckets && n_buckets-- > 0) {
+		bkt = &rs->buckets_old[rs->migrate_idx];
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			key_idx = bkt->key_idx[i];
+			if (key_idx == EMPTY_SLOT)
+				continue;
+
+			if (__hash_rs_insert(h, key_idx) != 0)
+				return -ENOSPC;
+
+			/* The entry is now present in both bucket arrays.
+			 * Inform the readers before it leaves the old one.
+			 * Since there is one writer, load acquires on
+			 * tbl_chng_cnt are not required.
+			 */
+			__atomic_store_n(h->tbl_chng_cnt,
+					 *h->tbl_chng_cnt + 1,
+					 __ATOMIC_RELEASE);
+			/* The store to sig_current should not
+			 * move above the store to tbl_chng_cnt.
+			 */
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+			bkt->sig_current[i] = NULL_SIGNATURE;
+			__atomic_store_n(&bkt->key_idx[i], EMPTY_SLOT,
+					 __ATOMIC_RELEASE);
+		}
+		rs->migrate_idx++;
+	}
+
+	if (rs->migrate_idx < rs->old_num_buckets)
+		return rs->old_num_buckets - rs->migrate_idx;
+
+	/* All keys moved, stop publishing the old bucket array */
+	old_bkts = rs->buckets_old;
+	rs->buckets_old = NULL;
+	if (__hash_rs_publish(h, old_bkts) != 0) {
+		rs->buckets_old = old_bkts;
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+/* Replace the free slots ring of a resizable table with a larger one */
+static int
+__hash_rs_grow_free_slots(struct rte_hash *h, uint32_t key_slots)
+{
+	struct rte_hash_rs *rs = h->rs;
+	const uint32_t count = rte_align32pow2(key_slots);
+	struct rte_ring *r;
+	ssize_t ring_size;
+	uint32_t slot_id;
+
+	ring_size = rte_ring_get_memsize_elem(sizeof(uint32_t), count);
+	if (ring_size < 0)
+		return ring_size;
+
+	r = rte_zmalloc_socket(NULL, ring_size, RTE_CACHE_LINE_SIZE,
+				rs->socket_id);
+	if (r == NULL)
+		return -ENOMEM;
+
+	if (rte_ring_init(r, h->free_slots->name, count, 0) != 0) {
+		rte_free(r);
+		return -EINVAL;
+	}
+
+	while (rte_ring_sc_dequeue_elem(h->free_slots, &slot_id,
+					sizeof(uint32_t)) == 0)
+		rte_ring_sp_enqueue_elem(r, &slot_id, sizeof(uint32_t));
+
+	if (rs->free_slots_zmalloc)
+		rte_free(h->free_slots);
+	else
+		rte_ring_free(h->free_slots);
+	h->free_slots = r;
+	rs->free_slots_zmalloc = 1;
+
+	return 0;
+}
+
+/*
+ * Replace the defer queue of a resizable table with one that can hold
+ * all its key slots. Without it, deletes fall back to waiting for the
+ * readers once the defer queue is full.
+ */
+static int
+__hash_rs_grow_dq(struct rte_hash *h, uint32_t size)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	/* Empty the current defer queue */
+	rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v, RTE_QSBR_THRID_INVALID);
+	if (rte_rcu_qsbr_dq_delete(h->dq) != 0)
+		return -EAGAIN;
+	h->dq = NULL;
+
+	snprintf(rcu_dq_name, sizeof(rcu_dq_name), "HASH_RCU_%s", h->name);
+	params.name = rcu_dq_name;
+	params.size = size;
+	params.trigger_reclaim_limit = h->hash_rcu_cfg->trigger_reclaim_limit;
+	params.max_reclaim_size = h->hash_rcu_cfg->max_reclaim_size;
+	params.esize = sizeof(struct __rte_hash_rcu_dq_entry);
+	params.free_fn = __hash_rcu_qsbr_free_resource;
+	params.p = h;
+	params.v = h->hash_rcu_cfg->v;
+	h->dq = rte_rcu_qsbr_dq_create(&params);
+	if (h->dq == NULL) {
+		/* Deletes wait for the readers, as in sync mode */
+		RTE_LOG(ERR, HASH, "HASH defer queue creation failed\n");
+		return -ENOMEM;
+	}
+	h->hash_rcu_cfg->dq_size = size;
+
+	return 0;
+}
+
+/*
+ * Grow the key store of a resizable table. The keys are copied to a new
+ * store which is published to the readers. The new key slots are handed
+ * out once no reader can be using the previous store anymore.
+ */
+static int
+__hash_rs_grow_key_store(struct rte_hash *h, uint32_t entries)
+{
+	struct rte_hash_rs *rs = h->rs;
+	uint32_t key_slots;
+	hash_sig_t *key_hash;
+	void *k;
+	int ret;
+
+	/* Only one previous key store can be kept in sync */
+	if (rs->key_store_old != NULL)
+		__hash_rs_reclaim(h, true);
+
+	if (entries <= h->entries)
+		return 0;
+	key_slots = rs->key_slots + (entries - h->entries);
+
+	k = rte_zmalloc_socket(NULL, (uint64_t)h->key_entry_size * key_slots,
+				RTE_CACHE_LINE_SIZE, rs->socket_id);
+	if (k == NULL)
+		return -ENOMEM;
+
+	key_hash = rte_realloc_socket(rs->key_hash,
+				sizeof(hash_sig_t) * key_slots,
+				RTE_CACHE_LINE_SIZE, rs->socket_id);
+	if (key_hash == NULL) {
+		rte_free(k);
+		return -ENOMEM;
+	}
+	rs->key_hash = key_hash;
+
+	if (rte_ring_get_capacity(h->free_slots) < key_slots - 1) {
+		ret = __hash_rs_grow_free_slots(h, key_slots);
+		if (ret != 0) {
+			rte_free(k);
+			return ret;
+		}
+	}
+
+	if (h->dq != NULL && h->hash_rcu_cfg->dq_size < key_slots)
+		__hash_rs_grow_dq(h, key_slots);
+
+	memcpy(k, h->key_store, (uint64_t)h->key_entry_size * rs->key_slots);
+	rs->key_store_old = h->key_store;
+	rs->key_store_old_slots = rs->key_slots;
+	rs->key_slots = key_slots;
+
+	/* Release the copied keys to the readers */
+	__atomic_store_n(&h->key_store, k, __ATOMIC_RELEASE);
+	rs->key_store_token = rte_rcu_qsbr_start(h->hash_rcu_cfg->v);
+
+	return 0;
+}
+
+/*
+ * Start resizing a resizable table to num_buckets buckets and, if larger
+ * than the current key store, to 'entries' key slots.
+ */
+static int
+__hash_rs_start(struct rte_hash *h, uint32_t num_buckets, uint32_t entries)
+{
+	struct rte_hash_rs *rs = h->rs;
+	struct rte_hash_bucket *buckets;
+	int ret;
+
+	if (entries > h->entries) {
+		ret = __hash_rs_grow_key_store(h, entries);
+		if (ret != 0)
+			return ret;
+	}
+
+	if (num_buckets == h->num_buckets && rs->buckets_old == NULL)
+		return 0;
+
+	/* Complete the resize in progress first */
+	ret = __hash_rs_migrate(h, UINT32_MAX);
+	if (ret != 0)
+		return ret;
+
+	if (num_buckets == h->num_buckets)
+		return 0;
+
+	buckets = rte_zmalloc_socket(NULL,
+			num_buckets * sizeof(struct rte_hash_bucket),
+			RTE_CACHE_LINE_SIZE, rs->socket_id);
+	if (buckets == NULL)
+		return -ENOMEM;
+
+	rs->buckets_old = h->buckets;
+	rs->old_num_buckets = h->num_buckets;
+	rs->old_bucket_bitmask = h->bucket_bitmask;
+	rs->migrate_idx = 0;
+	h->buckets = buckets;
+	h->num_buckets = num_buckets;
+	h->bucket_bitmask = num_buckets - 1;
+
+	ret = __hash_rs_publish(h, NULL);
+	if (ret != 0) {
+		h->buckets = rs->buckets_old;
+		h->num_buckets = rs->old_num_buckets;
+		h->bucket_bitmask = rs->old_bucket_bitmask;
+		rs->buckets_old = NULL;
+		rte_free(buckets);
+	}
+
+	return ret;
+}
+
+/* Double the bucket array of a resizable table, to make room for a key */
+static int
+__hash_rs_grow_buckets(struct rte_hash *h)
+{
+	if (h->hash_rcu_cfg == NULL || h->num_buckets >=
+			RTE_HASH_ENTRIES_MAX / RTE_HASH_BUCKET_ENTRIES)
+		return -ENOSPC;
+
+	return __hash_rs_start(h, h->num_buckets << 1, 0);
+}
+
+/* Make more key slots available in a resizable table */
+static int
+__hash_rs_grow_key_slots(struct rte_hash *h)
+{
+	struct rte_hash_rs *rs = h->rs;
+	int ret;
+
+	if (h->hash_rcu_cfg == NULL)
+		return -ENOSPC;
+
+	if (rs->key_store_old == NULL) {
+		if (h->entries >= RTE_HASH_ENTRIES_MAX)
+			return -ENOSPC;
+		ret = __hash_rs_grow_key_store(h, RTE_MIN(
+			(uint64_t)h->entries << 1,
+			(uint64_t)RTE_HASH_ENTRIES_MAX));
+		if (ret != 0)
+			return ret;
+	}
+
+	/* The new slots are usable once the readers leave the old store */
+	__hash_rs_reclaim(h, true);
+
+	return 0;
+}
+
+/*
+ * Called by the writer before every add and delete on a resizable table.
+ * Frees what the readers no longer use, moves a few buckets of a resize
+ * in progress, or starts a new resize if the load requires it.
+ */
+static void
+__hash_rs_writer_step(struct rte_hash *h, int adding)
+{
+	struct rte_hash_rs *rs = h->rs;
+	uint32_t count, capacity, entries, num_buckets;
+
+	if (h->hash_rcu_cfg == NULL)
+		return;
+
+	if (rs->nb_retire != 0 || rs->key_store_old != NULL)
+		__hash_rs_reclaim(h, false);
+
+	if (rs->buckets_old != NULL) {
+		__hash_rs_migrate(h, RTE_HASH_RESIZE_STEP_BUCKETS);
+		return;
+	}
+
+	count = rte_hash_count(h);
+	capacity = h->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	entries = h->entries;
+	num_buckets = h->num_buckets;
+
+	if (!adding) {
+		/* Shrink the bucket array when it is mostly empty */
+		if (count < capacity / 8 && num_buckets > rs->min_buckets)
+			__hash_rs_start(h, num_buckets >> 1, 0);
+		return;
+	}
+
+	/* Grow before the key slots run out or the buckets get too full
+	 * for cuckoo displacement to keep succeeding.
+	 */
+	if (count >= entries - entries / 8 && entries < RTE_HASH_ENTRIES_MAX &&
+			rs->key_store_old == NULL)
+		entries = RTE_MIN((uint64_t)entries << 1,
+				(uint64_t)RTE_HASH_ENTRIES_MAX);
+	if (count >= capacity - capacity / 8 && num_buckets <
+			RTE_HASH_ENTRIES_MAX / RTE_HASH_BUCKET_ENTRIES)
+		num_buckets <<= 1;
+
+	if (entries != h->entries || num_buckets != h->num_buckets)
+		__hash_rs_start(h, num_buckets, entries);
+}
+
+/*
+ * Search the old bucket array of a resizable table, while a resize is in
+ * progress, and update the data of the key if found.
+ */
+static inline int32_t
+__hash_rs_search_and_update(const struct rte_hash *h, void *data,
+		const void *key, hash_sig_t sig)
+{
+	struct rte_hash_rs *rs = h->rs;
+	uint16_t short_sig = get_short_sig(sig);
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	int32_t ret;
+
+	prim_bucket_idx = sig & rs->old_bucket_bitmask;
+	sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+				rs->old_bucket_bitmask;
+
+	ret = search_and_update(h, data, key,
+			&rs->buckets_old[prim_bucket_idx], short_sig);
+	if (ret != -1)
+		return ret;
+
+	return search_and_update(h, data, key,
+			&rs->buckets_old[sec_bucket_idx], short_sig);
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
@@ -1011,7 +1629,7 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	uint16_t short_sig;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
-	struct rte_hash_key *new_k, *keys = h->key_store;
+	struct rte_hash_key *new_k, *keys;
 	uint32_t ext_bkt_id = 0;
 	uint32_t slot_id;
 	int ret;
@@ -1021,6 +1639,9 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	int32_t ret_val;
 	struct rte_hash_bucket *last;
 
+	if (h->rs != NULL)
+		__hash_rs_writer_step((struct rte_hash *)(uintptr_t)h, 1);
+
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
@@ -1046,6 +1667,15 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Check the bucket array being resized */
+	if (h->rs != NULL && h->rs->buckets_old != NULL) {
+		ret = __hash_rs_search_and_update(h, data, key, sig);
+		if (ret != -1) {
+			__hash_rw_writer_unlock(h);
+			return ret;
+		}
+	}
+
 	__hash_rw_writer_unlock(h);
 
 	/* Did not find a match, so get a new slot for storing the new key */
@@ -1064,10 +1694,16 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 			if (ret == 0)
 				slot_id = alloc_slot(h, cached_free_slots);
 		}
+		if (slot_id == EMPTY_SLOT && h->rs != NULL &&
+				__hash_rs_grow_key_slots(
+				(struct rte_hash *)(uintptr_t)h) == 0)
+			slot_id = alloc_slot(h, cached_free_slots);
 		if (slot_id == EMPTY_SLOT)
 			return -ENOSPC;
 	}
 
+	/* The key store of a resizable table may have been replaced */
+	keys = h->key_store;
 	new_k = RTE_PTR_ADD(keys, slot_id * h->key_entry_size);
 	/* The store to application data (by the application) at *data should
 	 * not leak after the store of pdata in the key store. i.e. pdata is
@@ -1078,7 +1714,12 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		__ATOMIC_RELEASE);
 	/* Copy key */
 	memcpy(new_k->key, key, h->key_len);
+	if (h->rs != NULL) {
+		h->rs->key_hash[slot_id] = sig;
+		__hash_rs_key_store_sync(h, slot_id);
+	}
 
+insert:
 	/* Find an empty slot and insert */
 	ret = rte_hash_cuckoo_insert_mw(h, prim_bkt, sec_bkt, key, data,
 					short_sig, slot_id, &ret_val);
@@ -1112,6 +1753,16 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* if ext table not enabled, we failed the insertion */
 	if (!h->ext_table_support) {
+		/* A resizable table grows its bucket array instead */
+		if (h->rs != NULL && __hash_rs_grow_buckets(
+				(struct rte_hash *)(uintptr_t)h) == 0) {
+			prim_bucket_idx = get_prim_bucket_index(h, sig);
+			sec_bucket_idx = get_alt_bucket_index(h,
+					prim_bucket_idx, short_sig);
+			prim_bkt = &h->buckets[prim_bucket_idx];
+			sec_bkt = &h->buckets[sec_bucket_idx];
+			goto insert;
+		}
 		enqueue_slot_back(h, cached_free_slots, slot_id);
 		return ret;
 	}
@@ -1409,11 +2060,77 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 	return -ENOENT;
 }
 
+/* Search the bucket arrays of a resizable table, lock free */
+static inline int32_t
+__rte_hash_lookup_with_hash_rs(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	const struct rte_hash_rs_tbl *tbl;
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	uint32_t cnt_b, cnt_a;
+	int ret;
+	uint16_t short_sig;
+
+	short_sig = get_short_sig(sig);
+
+	do {
+		/* Load the table change counter before the lookup
+		 * starts. Acquire semantics will make sure that
+		 * loads in search_one_bucket are not hoisted.
+		 */
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
+				__ATOMIC_ACQUIRE);
+		tbl = __atomic_load_n(&h->rs_tbl, __ATOMIC_ACQUIRE);
+
+		prim_bucket_idx = sig & tbl->bucket_bitmask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+					tbl->bucket_bitmask;
+		ret = search_one_bucket_lf(h, key, short_sig, data,
+					&tbl->buckets[prim_bucket_idx]);
+		if (ret != -1)
+			return ret;
+		ret = search_one_bucket_lf(h, key, short_sig, data,
+					&tbl->buckets[sec_bucket_idx]);
+		if (ret != -1)
+			return ret;
+
+		/* Keys not moved yet are in the old bucket array */
+		if (tbl->buckets_old != NULL) {
+			prim_bucket_idx = sig & tbl->old_bucket_bitmask;
+			sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+						tbl->old_bucket_bitmask;
+			ret = search_one_bucket_lf(h, key, short_sig, data,
+					&tbl->buckets_old[prim_bucket_idx]);
+			if (ret != -1)
+				return ret;
+			ret = search_one_bucket_lf(h, key, short_sig, data,
+					&tbl->buckets_old[sec_bucket_idx]);
+			if (ret != -1)
+				return ret;
+		}
+
+		/* The loads of sig_current in search_one_bucket
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		/* Re-read the table change counter to check if keys
+		 * were moved, between or within the bucket arrays,
+		 * during the search. If yes, re-do the search.
+		 */
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt,
+					__ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a);
+
+	return -ENOENT;
+}
+
 static inline int32_t
 __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resizable)
+		return __rte_hash_lookup_with_hash_rs(h, key, sig, data);
+	else if (h->readwrite_concur_lf_support)
 		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
 	else
 		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
@@ -1689,6 +2406,9 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	uint32_t index = EMPTY_SLOT;
 	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
 
+	if (h->rs != NULL)
+		__hash_rs_writer_step((struct rte_hash *)(uintptr_t)h, 0);
+
 	short_sig = get_short_sig(sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
@@ -1717,6 +2437,24 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
+	/* Look for the key in the bucket array being resized */
+	if (h->rs != NULL && h->rs->buckets_old != NULL) {
+		prim_bucket_idx = sig & h->rs->old_bucket_bitmask;
+		sec_bucket_idx = (prim_bucket_idx ^ short_sig) &
+					h->rs->old_bucket_bitmask;
+		ret = search_and_remove(h, key,
+				&h->rs->buckets_old[prim_bucket_idx],
+				short_sig, &pos);
+		if (ret == -1)
+			ret = search_and_remove(h, key,
+				&h->rs->buckets_old[sec_bucket_idx],
+				short_sig, &pos);
+		if (ret != -1) {
+			last_bkt = NULL;
+			goto return_bkt;
+		}
+	}
+
 	__hash_rw_writer_unlock(h);
 	return -ENOENT;
 
@@ -1774,8 +2512,22 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 						      &rcu_dq_entry, 1);
 		} else if (h->dq)
 			/* Push into QSBR FIFO if using RTE_HASH_QSBR_MODE_DQ */
-			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
-				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
+			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0) {
+				if (h->rs == NULL) {
+					RTE_LOG(ERR, HASH,
+						"Failed to push QSBR FIFO\n");
+				} else {
+					/* A resizable table must not leak
+					 * key slots, wait for the readers.
+					 */
+					rte_rcu_qsbr_synchronize(
+						h->hash_rcu_cfg->v,
+						RTE_QSBR_THRID_INVALID);
+					__hash_rcu_qsbr_free_resource(
+						(void *)((uintptr_t)h),
+						&rcu_dq_entry, 1);
+				}
+			}
 	}
 	__hash_rw_writer_unlock(h);
 	return ret;
@@ -1916,11 +2668,18 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 
 	__hash_rw_reader_lock(h);
 
+#ifdef CC_HASH_AVX512_SUPPORT
+	if (h->sig_cmp_fn == RTE_HASH_COMPARE_AVX512)
+		rte_hash_compare_signatures_avx512(prim_hitmask, sec_hitmask,
+			primary_bkt, secondary_bkt, sig, num_keys);
+#endif
+
 	/* Compare signatures and prefetch key slot of first hit */
 	for (i = 0; i < num_keys; i++) {
-		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-			primary_bkt[i], secondary_bkt[i],
-			sig[i], h->sig_cmp_fn);
+		if (h->sig_cmp_fn != RTE_HASH_COMPARE_AVX512)
+			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
+				primary_bkt[i], secondary_bkt[i],
+				sig[i], h->sig_cmp_fn);
 
 		if (prim_hitmask[i]) {
 			uint32_t first_hit =
@@ -2073,11 +2832,20 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
 					__ATOMIC_ACQUIRE);
 
+#ifdef CC_HASH_AVX512_SUPPORT
+		if (h->sig_cmp_fn == RTE_HASH_COMPARE_AVX512)
+			rte_hash_compare_signatures_avx512(prim_hitmask,
+				sec_hitmask, primary_bkt, secondary_bkt, sig,
+				num_keys);
+#endif
+
 		/* Compare signatures and prefetch key slot of first hit */
 		for (i = 0; i < num_keys; i++) {
-			compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				sig[i], h->sig_cmp_fn);
+			if (h->sig_cmp_fn != RTE_HASH_COMPARE_AVX512)
+				compare_signatures(&prim_hitmask[i],
+					&sec_hitmask[i], primary_bkt[i],
+					secondary_bkt[i], sig[i],
+					h->sig_cmp_fn);
 
 			if (prim_hitmask[i]) {
 				uint32_t first_hit =
@@ -2279,6 +3047,106 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 	}
 }
 
+static inline void
+__rte_hash_lookup_with_hash_bulk_rs(const struct rte_hash *h,
+			const void **keys, hash_sig_t *prim_hash,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[])
+{
+	int32_t i, ret;
+	uint32_t prim_index, sec_index;
+	uint64_t hits;
+	uint32_t cnt_b, cnt_a;
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	const struct rte_hash_rs_tbl *tbl;
+
+	for (i = 0; i < num_keys; i++) {
+		rte_prefetch0(keys[i]);
+		sig[i] = get_short_sig(prim_hash[i]);
+	}
+
+	do {
+		/* Load the table change counter before the lookup
+		 * starts, keys may move from the old bucket array to
+		 * the current one.
+		 */
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt,
+					__ATOMIC_ACQUIRE);
+		tbl = __atomic_load_n(&h->rs_tbl, __ATOMIC_ACQUIRE);
+
+		for (i = 0; i < num_keys; i++) {
+			prim_index = prim_hash[i] & tbl->bucket_bitmask;
+			sec_index = (prim_index ^ sig[i]) &
+					tbl->bucket_bitmask;
+
+			primary_bkt[i] = &tbl->buckets[prim_index];
+			secondary_bkt[i] = &tbl->buckets[sec_index];
+
+			rte_prefetch0(primary_bkt[i]);
+			rte_prefetch0(secondary_bkt[i]);
+		}
+
+		__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig,
+			num_keys, positions, &hits, data);
+
+		/* Keys not moved yet are in the old bucket array */
+		if (tbl->buckets_old != NULL) {
+			for (i = 0; i < num_keys; i++) {
+				if (hits & (1ULL << i))
+					continue;
+				prim_index = prim_hash[i] &
+						tbl->old_bucket_bitmask;
+				sec_index = (prim_index ^ sig[i]) &
+						tbl->old_bucket_bitmask;
+				ret = search_one_bucket_lf(h, keys[i], sig[i],
+					data != NULL ? &data[i] : NULL,
+					&tbl->buckets_old[prim_index]);
+				if (ret == -1)
+					ret = search_one_bucket_lf(h, keys[i],
+						sig[i],
+						data != NULL ? &data[i] : NULL,
+						&tbl->buckets_old[sec_index]);
+				if (ret != -1) {
+					positions[i] = ret;
+					hits |= 1ULL << i;
+				}
+			}
+		}
+
+		/* The loads of sig_current should not move below the
+		 * load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt,
+					__ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a);
+
+	if (hit_mask != NULL)
+		*hit_mask = hits;
+}
+
+static inline void
+__rte_hash_lookup_bulk_rs(const struct rte_hash *h, const void **keys,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[])
+{
+	hash_sig_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t i;
+
+	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
+		rte_prefetch0(keys[i]);
+
+	for (i = 0; i < num_keys; i++) {
+		if (i + PREFETCH_OFFSET < num_keys)
+			rte_prefetch0(keys[i + PREFETCH_OFFSET]);
+		prim_hash[i] = rte_hash_hash(h, keys[i]);
+	}
+
+	__rte_hash_lookup_with_hash_bulk_rs(h, keys, prim_hash, num_keys,
+			positions, hit_mask, data);
+}
 
 static inline void
 __rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
@@ -2317,7 +3185,10 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resizable)
+		__rte_hash_lookup_bulk_rs(h, keys, num_keys, positions,
+					  hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
@@ -2429,7 +3300,10 @@ __rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
 			hash_sig_t *prim_hash, int32_t num_keys,
 			int32_t *positions, uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (h->resizable)
+		__rte_hash_lookup_with_hash_bulk_rs(h, keys, prim_hash,
+				num_keys, positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_with_hash_bulk_lf(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
 	else
@@ -2470,6 +3344,257 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 	return __builtin_popcountl(*hit_mask);
 }
 
+int
+rte_hash_lookup_staged_prefetch(const struct rte_hash *h,
+		const hash_sig_t *sig, uint32_t num_keys,
+		struct rte_hash_lookup_staged *state)
+{
+	const struct rte_hash_bucket *buckets;
+	uint32_t bucket_bitmask;
+	uint32_t prim_index, sec_index;
+	uint32_t i;
+
+	RETURN_IF_TRUE(((h == NULL) || (sig == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(state == NULL)), -EINVAL);
+
+	buckets = h->buckets;
+	bucket_bitmask = h->bucket_bitmask;
+	state->recheck_misses = 0;
+	if (h->resizable) {
+		const struct rte_hash_rs_tbl *tbl = __atomic_load_n(&h->rs_tbl,
+							__ATOMIC_ACQUIRE);
+
+		buckets = tbl->buckets;
+		bucket_bitmask = tbl->bucket_bitmask;
+		/* Keys not moved yet are found by the full lookup */
+		state->recheck_misses = (tbl->buckets_old != NULL);
+	} else if (h->readwrite_concur_support &&
+			!h->readwrite_concur_lf_support) {
+		/* Writers may move keys before the reader lock is taken */
+		state->recheck_misses = 1;
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		state->hash[i] = sig[i];
+		state->sig[i] = get_short_sig(sig[i]);
+		prim_index = sig[i] & bucket_bitmask;
+		sec_index = (prim_index ^ state->sig[i]) & bucket_bitmask;
+
+		state->prim_bkt[i] = &buckets[prim_index];
+		state->sec_bkt[i] = &buckets[sec_index];
+
+		rte_prefetch0(state->prim_bkt[i]);
+		rte_prefetch0(state->sec_bkt[i]);
+	}
+	state->num_keys = num_keys;
+
+	return 0;
+}
+
+int
+rte_hash_lookup_staged_match(const struct rte_hash *h,
+		struct rte_hash_lookup_staged *state)
+{
+	const struct rte_hash_bucket *bkt;
+	uint32_t i, hitmask, key_idx;
+
+	RETURN_IF_TRUE(((h == NULL) || (state == NULL)), -EINVAL);
+
+	/* Load the table change counter before the signatures, it is
+	 * checked again once the keys are compared.
+	 */
+	if (h->readwrite_concur_lf_support)
+		state->tbl_chng_cnt = __atomic_load_n(h->tbl_chng_cnt,
+					__ATOMIC_ACQUIRE);
+
+#ifdef CC_HASH_AVX512_SUPPORT
+	if (h->sig_cmp_fn == RTE_HASH_COMPARE_AVX512)
+		rte_hash_compare_signatures_avx512(state->prim_hitmask,
+			state->sec_hitmask, state->prim_bkt, state->sec_bkt,
+			state->sig, state->num_keys);
+#endif
+
+	/* Compare signatures and prefetch key slot of first hit */
+	for (i = 0; i < state->num_keys; i++) {
+		if (h->sig_cmp_fn != RTE_HASH_COMPARE_AVX512) {
+			state->prim_hitmask[i] = 0;
+			state->sec_hitmask[i] = 0;
+			compare_signatures(&state->prim_hitmask[i],
+				&state->sec_hitmask[i], state->prim_bkt[i],
+				state->sec_bkt[i], state->sig[i],
+				h->sig_cmp_fn);
+		}
+
+		if (state->prim_hitmask[i]) {
+			hitmask = state->prim_hitmask[i];
+			bkt = state->prim_bkt[i];
+		} else if (state->sec_hitmask[i]) {
+			hitmask = state->sec_hitmask[i];
+			bkt = state->sec_bkt[i];
+		} else
+			continue;
+
+		key_idx = bkt->key_idx[__builtin_ctzl(hitmask) >> 1];
+		rte_prefetch0((const char *)h->key_store +
+				key_idx * h->key_entry_size);
+	}
+
+	return 0;
+}
+
+/* Compare a key with the keys of a bucket whose signature matched */
+static inline int32_t
+__staged_compare_bkt(const struct rte_hash *h, const void *key,
+		const struct rte_hash_bucket *bkt, uint32_t hitmask,
+		void **data)
+{
+	const struct rte_hash_key *key_slot;
+	uint32_t hit_index, key_idx;
+
+	while (hitmask) {
+		hit_index = __builtin_ctzl(hitmask) >> 1;
+		key_idx = __atomic_load_n(&bkt->key_idx[hit_index],
+					  __ATOMIC_ACQUIRE);
+		key_slot = (const struct rte_hash_key *)(
+				(const char *)h->key_store +
+				key_idx * h->key_entry_size);
+
+		/*
+		 * If key index is 0, do not compare key,
+		 * as it is checking the dummy slot
+		 */
+		if (!!key_idx & !rte_hash_cmp_eq(key_slot->key, key, h)) {
+			if (data != NULL)
+				*data = __atomic_load_n(&key_slot->pdata,
+						__ATOMIC_ACQUIRE);
+			/*
+			 * Return index where key is stored,
+			 * subtracting the first dummy index
+			 */
+			return key_idx - 1;
+		}
+		hitmask &= ~(3ULL << (hit_index << 1));
+	}
+
+	return -1;
+}
+
+int
+rte_hash_lookup_staged_compare(const struct rte_hash *h, const void **keys,
+		struct rte_hash_lookup_staged *state, int32_t *positions,
+		uint64_t *hit_mask, void *data[])
+{
+	uint64_t hits = 0;
+	uint8_t recheck_misses;
+	uint32_t i;
+	int32_t ret;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (state == NULL) ||
+			(hit_mask == NULL)), -EINVAL);
+
+	__hash_rw_reader_lock(h);
+
+	for (i = 0; i < state->num_keys; i++) {
+		ret = __staged_compare_bkt(h, keys[i], state->prim_bkt[i],
+				state->prim_hitmask[i],
+				data != NULL ? &data[i] : NULL);
+		if (ret == -1)
+			ret = __staged_compare_bkt(h, keys[i],
+				state->sec_bkt[i], state->sec_hitmask[i],
+				data != NULL ? &data[i] : NULL);
+		if (ret != -1)
+			hits |= 1ULL << i;
+		if (positions != NULL)
+			positions[i] = (ret != -1) ? ret : -ENOENT;
+	}
+
+	__hash_rw_reader_unlock(h);
+
+	recheck_misses = state->recheck_misses;
+	if (h->readwrite_concur_lf_support) {
+		/* The loads of sig_current and key_idx should not move
+		 * below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		/* Keys moved between the stages may have been missed */
+		if (__atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE) !=
+				state->tbl_chng_cnt)
+			recheck_misses = 1;
+	}
+
+	/* Look up again the keys which may be somewhere else */
+	for (i = 0; i < state->num_keys; i++) {
+		if (hits & (1ULL << i))
+			continue;
+		if (!recheck_misses && !(h->ext_table_support &&
+				state->sec_bkt[i]->next != NULL))
+			continue;
+
+		ret = __rte_hash_lookup_with_hash(h, keys[i], state->hash[i],
+				data != NULL ? &data[i] : NULL);
+		if (ret >= 0) {
+			hits |= 1ULL << i;
+			if (positions != NULL)
+				positions[i] = ret;
+		}
+	}
+
+	*hit_mask = hits;
+
+	/* Return number of hits */
+	return __builtin_popcountl(hits);
+}
+
+/*
+ * Iterate over the current bucket array of a resizable table, then over
+ * the old one while a resize is in progress.
+ */
+static int32_t
+__rte_hash_iterate_rs(const struct rte_hash *h, const void **key, void **data,
+		uint32_t *next)
+{
+	const struct rte_hash_rs_tbl *tbl = h->rs_tbl;
+	const uint32_t total_entries_main = (tbl->bucket_bitmask + 1) *
+							RTE_HASH_BUCKET_ENTRIES;
+	uint32_t total_entries = total_entries_main;
+	const struct rte_hash_bucket *bkts;
+	uint32_t pos, position;
+	struct rte_hash_key *next_key;
+
+	if (tbl->buckets_old != NULL)
+		total_entries += (tbl->old_bucket_bitmask + 1) *
+						RTE_HASH_BUCKET_ENTRIES;
+
+	for (; *next < total_entries; (*next)++) {
+		if (*next < total_entries_main) {
+			bkts = tbl->buckets;
+			pos = *next;
+		} else {
+			bkts = tbl->buckets_old;
+			pos = *next - total_entries_main;
+		}
+		position = __atomic_load_n(
+			&bkts[pos / RTE_HASH_BUCKET_ENTRIES].key_idx[
+				pos % RTE_HASH_BUCKET_ENTRIES],
+			__ATOMIC_ACQUIRE);
+		if (position == EMPTY_SLOT)
+			continue;
+
+		next_key = (struct rte_hash_key *) ((char *)h->key_store +
+					position * h->key_entry_size);
+		/* Return key and data */
+		*key = next_key->key;
+		*data = next_key->pdata;
+
+		/* Increment iterator */
+		(*next)++;
+		return position - 1;
+	}
+
+	return -ENOENT;
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
@@ -2478,6 +3603,9 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
+	if (h->resizable)
+		return __rte_hash_iterate_rs(h, key, data, next);
+
 	const uint32_t total_entries_main = h->num_buckets *
 							RTE_HASH_BUCKET_ENTRIES;
 	const uint32_t total_entries = total_entries_main << 1;
@@ -2545,3 +3673,36 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	(*next)++;
 	return position - 1;
 }
+
+int
+rte_hash_resize(struct rte_hash *h, uint32_t entries)
+{
+	uint32_t num_buckets;
+
+	if (h == NULL || h->rs == NULL || h->hash_rcu_cfg == NULL ||
+			entries < RTE_HASH_BUCKET_ENTRIES ||
+			entries > RTE_HASH_ENTRIES_MAX)
+		return -EINVAL;
+
+	if ((uint32_t)rte_hash_count(h) > entries)
+		return -ENOSPC;
+
+	__hash_rs_reclaim(h, false);
+
+	num_buckets = rte_align32pow2(entries) / RTE_HASH_BUCKET_ENTRIES;
+	/* Do not shrink automatically below the requested size */
+	h->rs->min_buckets = num_buckets;
+
+	return __hash_rs_start(h, num_buckets, entries);
+}
+
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t n_buckets)
+{
+	if (h == NULL || h->rs == NULL || h->hash_rcu_cfg == NULL)
+		return -EINVAL;
+
+	__hash_rs_reclaim(h, false);
+
+	return __hash_rs_migrate(h, n_buckets);
+}
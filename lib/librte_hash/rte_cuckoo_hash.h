@@ -43,6 +43,10 @@
 #include <rte_hash_crc.h>
 #include <rte_jhash.h>
 
+#ifdef CC_HASH_AVX512_SUPPORT
+#include "rte_cuckoo_hash_avx512.h"
+#endif
+
 #if defined(RTE_ARCH_X86) || defined(RTE_ARCH_ARM64)
 /*
  * All different options to select a key compare function,
@@ -58,6 +62,7 @@ enum cmp_jump_table_case {
 	KEY_96_BYTES,
 	KEY_112_BYTES,
 	KEY_128_BYTES,
+	KEY_MASKED_BYTES,
 	KEY_OTHER_BYTES,
 	NUM_KEY_CMP_CASES,
 };
@@ -76,6 +81,11 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	rte_hash_k96_cmp_eq,
 	rte_hash_k112_cmp_eq,
 	rte_hash_k128_cmp_eq,
+#ifdef CC_HASH_AVX512_SUPPORT
+	rte_hash_k_masked_cmp_eq_avx512,
+#else
+	memcmp,
+#endif
 	memcmp
 };
 #else
@@ -122,6 +132,12 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/* Buckets migrated by each add/delete while a resize is in progress */
+#define RTE_HASH_RESIZE_STEP_BUCKETS	4
+
+/* Resized tables waiting for the readers to become quiescent */
+#define RTE_HASH_RESIZE_RETIRE_MAX	4
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -142,6 +158,7 @@ enum rte_hash_sig_compare_function {
 	RTE_HASH_COMPARE_SCALAR = 0,
 	RTE_HASH_COMPARE_SSE,
 	RTE_HASH_COMPARE_NEON,
+	RTE_HASH_COMPARE_AVX512,
 	RTE_HASH_COMPARE_NUM
 };
 
@@ -196,6 +213,10 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t resizable;
+	/**< If the bucket table can be resized online */
+	struct rte_hash_rs_tbl *rs_tbl;
+	/**< Bucket tables of a resizable hash, as seen by the readers */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
@@ -225,8 +246,50 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+	struct rte_hash_rs *rs;
+	/**< Writer side resize state, NULL if the table is not resizable */
 } __rte_cache_aligned;
 
+/** Bucket tables of a resizable hash, as seen by lock free readers.
+ * A new copy is published every time the set of bucket arrays changes,
+ * so that readers always use an array together with its own bitmask.
+ */
+struct rte_hash_rs_tbl {
+	struct rte_hash_bucket *buckets; /**< Current bucket array */
+	struct rte_hash_bucket *buckets_old;
+	/**< Bucket array being migrated into buckets, NULL if none */
+	uint32_t bucket_bitmask;         /**< Bitmask of buckets */
+	uint32_t old_bucket_bitmask;     /**< Bitmask of buckets_old */
+};
+
+/** Memory unpublished by a resize, freed once the readers are quiescent */
+struct rte_hash_rs_retire {
+	uint64_t token;                  /**< RCU QSBR token */
+	struct rte_hash_rs_tbl *tbl;     /**< Reader view to free */
+	struct rte_hash_bucket *buckets; /**< Bucket array to free, or NULL */
+};
+
+/** Writer side state of a resizable hash */
+struct rte_hash_rs {
+	int socket_id;                /**< NUMA socket of the tables */
+	uint32_t min_buckets;         /**< Buckets never shrink below this */
+	uint32_t old_num_buckets;     /**< Number of buckets in buckets_old */
+	uint32_t old_bucket_bitmask;  /**< Bitmask of buckets_old */
+	struct rte_hash_bucket *buckets_old;
+	/**< Bucket array being migrated, NULL if no resize in progress */
+	uint32_t migrate_idx;         /**< Next bucket of buckets_old to move */
+	uint32_t key_slots;           /**< Key slots in the key store */
+	hash_sig_t *key_hash;         /**< Full hash value of each key slot */
+	void *key_store_old;
+	/**< Key store still visible to readers after a grow, or NULL */
+	uint32_t key_store_old_slots; /**< Key slots in key_store_old */
+	uint64_t key_store_token;     /**< RCU QSBR token of key_store_old */
+	uint8_t free_slots_zmalloc;
+	/**< If free_slots was allocated by a grow, not by rte_ring_create */
+	uint32_t nb_retire;           /**< Number of valid entries in retire */
+	struct rte_hash_rs_retire retire[RTE_HASH_RESIZE_RETIRE_MAX];
+};
+
 struct queue_node {
 	struct rte_hash_bucket *bkt; /* Current bucket on the bfs search */
 	uint32_t cur_bkt_idx;
@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <rte_common.h>
+#include <rte_vect.h>
+
+#include "rte_cuckoo_hash_avx512.h"
+
+/* Spread the 8 bits of a bucket match mask to one bit every two bits */
+static __rte_always_inline uint32_t
+expand_match_mask(uint32_t m)
+{
+	m &= 0xff;
+	m = (m | (m << 4)) & 0x0f0f;
+	m = (m | (m << 2)) & 0x3333;
+	m = (m | (m << 1)) & 0x5555;
+
+	return m;
+}
+
+/*
+ * The signatures are the first 16 bytes of a bucket. A zmm register holds
+ * the primary and secondary buckets of two keys, compared in one go.
+ */
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+	uint32_t *sec_hash_matches,
+	const struct rte_hash_bucket **primary_bkt,
+	const struct rte_hash_bucket **secondary_bkt,
+	const uint16_t *sig, int32_t num_keys)
+{
+	__m512i bkt_sigs, key_sigs;
+	__mmask32 msk;
+	int32_t i;
+
+	for (i = 0; i + 1 < num_keys; i += 2) {
+		bkt_sigs = _mm512_castsi128_si512(
+			_mm_load_si128((const __m128i *)primary_bkt[i]));
+		bkt_sigs = _mm512_inserti32x4(bkt_sigs,
+			_mm_load_si128((const __m128i *)secondary_bkt[i]), 1);
+		bkt_sigs = _mm512_inserti32x4(bkt_sigs,
+			_mm_load_si128((const __m128i *)primary_bkt[i + 1]), 2);
+		bkt_sigs = _mm512_inserti32x4(bkt_sigs,
+			_mm_load_si128((const __m128i *)secondary_bkt[i + 1]),
+			3);
+		key_sigs = _mm512_mask_set1_epi16(_mm512_set1_epi16(sig[i]),
+			0xffff0000, sig[i + 1]);
+
+		msk = _mm512_cmpeq_epi16_mask(bkt_sigs, key_sigs);
+
+		prim_hash_matches[i] = expand_match_mask(msk);
+		sec_hash_matches[i] = expand_match_mask(msk >> 8);
+		prim_hash_matches[i + 1] = expand_match_mask(msk >> 16);
+		sec_hash_matches[i + 1] = expand_match_mask(msk >> 24);
+	}
+
+	/* Odd number of keys, the upper half of the register is unused */
+	if (i < num_keys) {
+		bkt_sigs = _mm512_castsi128_si512(
+			_mm_load_si128((const __m128i *)primary_bkt[i]));
+		bkt_sigs = _mm512_inserti32x4(bkt_sigs,
+			_mm_load_si128((const __m128i *)secondary_bkt[i]), 1);
+
+		msk = _mm512_cmpeq_epi16_mask(bkt_sigs,
+			_mm512_set1_epi16(sig[i]));
+
+		prim_hash_matches[i] = expand_match_mask(msk);
+		sec_hash_matches[i] = expand_match_mask(msk >> 8);
+	}
+}
+
+int
+rte_hash_k_masked_cmp_eq_avx512(const void *key1, const void *key2,
+	size_t key_len)
+{
+	/* Bytes past the key are neither loaded nor compared */
+	const __mmask64 msk = (key_len < 64) ?
+		(1ULL << key_len) - 1 : UINT64_MAX;
+	const __m512i k1 = _mm512_maskz_loadu_epi8(msk, key1);
+	const __m512i k2 = _mm512_maskz_loadu_epi8(msk, key2);
+
+	return _mm512_mask_cmpneq_epi8_mask(msk, k1, k2) != 0;
+}
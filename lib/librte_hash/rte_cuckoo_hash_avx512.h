@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_CUCKOO_HASH_AVX512_H_
+#define _RTE_CUCKOO_HASH_AVX512_H_
+
+struct rte_hash_bucket;
+
+/*
+ * Compare the signature of each key with the signatures of its primary
+ * and secondary buckets. The match masks have the same layout as the
+ * ones of compare_signatures(): the first bit of every two bits
+ * indicates a match.
+ */
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hash_matches,
+	uint32_t *sec_hash_matches,
+	const struct rte_hash_bucket **primary_bkt,
+	const struct rte_hash_bucket **secondary_bkt,
+	const uint16_t *sig, int32_t num_keys);
+
+/* Compare two keys of up to 64 bytes with masked loads */
+int
+rte_hash_k_masked_cmp_eq_avx512(const void *key1, const void *key2,
+	size_t key_len);
+
+#endif /* _RTE_CUCKOO_HASH_AVX512_H_ */
@@ -56,6 +56,13 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to let the table grow and shrink online, see rte_hash_resize().
+ * Requires RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF and an RCU QSBR variable
+ * attached with rte_hash_rcu_qsbr_add(). It cannot be combined with
+ * RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD or RTE_HASH_EXTRA_FLAGS_EXT_TABLE.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZABLE 0x40
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -76,6 +83,31 @@ typedef int (*rte_hash_cmp_eq_t)(const void *key1, const void *key2, size_t key_
  */
 typedef void (*rte_hash_free_key_data)(void *p, void *key_data);
 
+struct rte_hash_bucket;
+
+/**
+ * State of a staged bulk lookup, allocated by the caller and carried from
+ * one stage to the next, see rte_hash_lookup_staged_prefetch().
+ * Its content is private to the library.
+ */
+struct rte_hash_lookup_staged {
+	uint32_t num_keys;		/**< Number of keys of the batch. */
+	uint32_t tbl_chng_cnt;		/**< Table change counter at match. */
+	uint8_t recheck_misses;		/**< Misses need a full lookup. */
+	/** Precomputed hash values of the keys. */
+	hash_sig_t hash[RTE_HASH_LOOKUP_BULK_MAX];
+	/** Short signatures of the keys. */
+	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	/** Signature matches in the primary buckets. */
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	/** Signature matches in the secondary buckets. */
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	/** Primary buckets of the keys. */
+	const struct rte_hash_bucket *prim_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+	/** Secondary buckets of the keys. */
+	const struct rte_hash_bucket *sec_bkt[RTE_HASH_LOOKUP_BULK_MAX];
+};
+
 /**
  * Parameters used when creating the hash table.
  */
@@ -624,6 +656,94 @@ rte_hash_lookup_with_hash_bulk_data(const struct rte_hash *h,
 		const void **keys, hash_sig_t *sig,
 		uint32_t num_keys, uint64_t *hit_mask, void *data[]);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * First stage of a staged bulk lookup with precomputed hash values.
+ *
+ * A staged lookup splits rte_hash_lookup_with_hash_bulk_data() in three
+ * stages, so that the caller can do other work, such as the stages of
+ * other batches, while the memory accessed by the next stage is fetched:
+ *  - rte_hash_lookup_staged_prefetch() locates and prefetches the buckets,
+ *  - rte_hash_lookup_staged_match() compares the signatures and prefetches
+ *    the keys which match,
+ *  - rte_hash_lookup_staged_compare() compares the keys.
+ *
+ * The hash values must be computed the same way as the ones of the keys
+ * in the table, e.g. both come from the RSS hash of the packets.
+ * The three stages of a batch must be called by the same thread, in order,
+ * on a table not modified by this thread in between. With RCU, the thread
+ * must not report a quiescent state in between either.
+ *
+ * @param h
+ *   Hash table to look in.
+ * @param sig
+ *   A pointer to a list of precomputed hash values for keys.
+ * @param num_keys
+ *   How many keys are in the batch (less than or equal to
+ *   RTE_HASH_LOOKUP_BULK_MAX).
+ * @param state
+ *   State of the batch, provided by the caller.
+ * @return
+ *   -EINVAL if there's an error, otherwise 0.
+ */
+__rte_experimental
+int
+rte_hash_lookup_staged_prefetch(const struct rte_hash *h,
+		const hash_sig_t *sig, uint32_t num_keys,
+		struct rte_hash_lookup_staged *state);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Second stage of a staged bulk lookup: compare the signatures of the keys
+ * with the ones of their buckets, and prefetch the keys which match.
+ *
+ * @param h
+ *   Hash table to look in.
+ * @param state
+ *   State of the batch, filled by rte_hash_lookup_staged_prefetch().
+ * @return
+ *   -EINVAL if there's an error, otherwise 0.
+ */
+__rte_experimental
+int
+rte_hash_lookup_staged_match(const struct rte_hash *h,
+		struct rte_hash_lookup_staged *state);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Last stage of a staged bulk lookup: compare the keys whose signature
+ * matched. Keys which may have been missed because of concurrent writes
+ * are looked up again.
+ *
+ * @param h
+ *   Hash table to look in.
+ * @param keys
+ *   A pointer to the list of keys of the batch.
+ * @param state
+ *   State of the batch, filled by rte_hash_lookup_staged_match().
+ * @param positions
+ *   Output containing the positions of the keys, -ENOENT for the keys not
+ *   found. Can be NULL.
+ * @param hit_mask
+ *   Output containing a bitmask with all successful lookups.
+ * @param data
+ *   Output containing array of data returned from all the successful
+ *   lookups. Can be NULL.
+ * @return
+ *   -EINVAL if there's an error, otherwise number of successful lookups.
+ */
+__rte_experimental
+int
+rte_hash_lookup_staged_compare(const struct rte_hash *h, const void **keys,
+		struct rte_hash_lookup_staged *state, int32_t *positions,
+		uint64_t *hit_mask, void *data[]);
+
 /**
  * Find multiple keys in the hash table.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -694,6 +814,68 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 __rte_experimental
 int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start resizing a hash table created with RTE_HASH_EXTRA_FLAGS_RESIZABLE.
+ *
+ * A new bucket array sized for 'entries' keys is allocated and published
+ * to the readers. Keys are then moved to it a few buckets at a time, by
+ * every subsequent add and delete and by rte_hash_resize_step(), while
+ * lock free readers keep finding them in either array. Old arrays are
+ * freed once all the readers registered with the RCU QSBR variable have
+ * reported a quiescent state.
+ *
+ * Growing the table also grows the key store. Key positions are stable:
+ * the key store never shrinks, only the bucket array does.
+ *
+ * A resizable table also grows automatically when it runs out of key
+ * slots or fails to place a key, and its bucket array shrinks back,
+ * down to its initial size, when it is mostly empty.
+ *
+ * This operation is not multi-thread safe with regard to the writer
+ * and must be called from the writer thread.
+ *
+ * @param h
+ *   Hash table to resize.
+ * @param entries
+ *   New number of entries.
+ * @return
+ *   - 0 if the resize was started, or the table already has that size.
+ *   - -EINVAL if the parameters are invalid, the table is not resizable
+ *     or no RCU QSBR variable is attached.
+ *   - -ENOSPC if the table holds more keys than 'entries', or a pending
+ *     resize could not be completed.
+ *   - -ENOMEM if memory allocation failed.
+ */
+__rte_experimental
+int
+rte_hash_resize(struct rte_hash *h, uint32_t entries);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Make progress on a resize started by rte_hash_resize() or by the table
+ * itself, and free the memory of previous resizes the readers no longer
+ * use. Applications can call it from the writer thread when idle, to
+ * complete a resize without waiting for further adds and deletes.
+ *
+ * @param h
+ *   Hash table being resized.
+ * @param n_buckets
+ *   Maximum number of buckets to migrate.
+ * @return
+ *   - Number of buckets still to migrate, 0 if no resize is in progress.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOSPC if a key could not be placed in the new bucket array.
+ *     It stays in the old array, where lookups keep finding it.
+ */
+__rte_experimental
+int
+rte_hash_resize_step(struct rte_hash *h, uint32_t n_buckets);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,8 +25,14 @@
 #include <assert.h>
 #include <rte_jhash.h>
 #include <rte_tailq.h>
+#include <rte_prefetch.h>
+#include <rte_cpuflags.h>
+#include <rte_vect.h>
 
 #include "rte_lpm6.h"
+#ifdef CC_LPM6_AVX512_SUPPORT
+#include "rte_lpm6_avx512.h"
+#endif
 
 #define RTE_LPM6_TBL24_NUM_ENTRIES        (1 << 24)
 #define RTE_LPM6_TBL8_GROUP_NUM_ENTRIES         256
@@ -41,6 +47,8 @@
 #define BYTE_SIZE                                 8
 #define BYTES2_SIZE                              16
 
+#define LOOKUP_BULK_INTERLEAVE                    8
+
 #define RULE_HASH_TABLE_EXTRA_SPACE              64
 #define TBL24_IND                        UINT32_MAX
 
@@ -101,6 +109,7 @@ struct rte_lpm6 {
 	uint32_t max_rules;              /**< Max number of rules. */
 	uint32_t used_rules;             /**< Used rules so far. */
 	uint32_t number_tbl8s;           /**< Number of tbl8s to allocate. */
+	uint8_t vector_lookup;           /**< Use AVX512 bulk lookup. */
 
 	/* LPM Tables. */
 	struct rte_hash *rules_tbl; /**< LPM rules. */
@@ -357,6 +366,11 @@ rte_lpm6_create(const char *name, int socket_id,
 	lpm->rules_tbl = rules_tbl;
 	lpm->tbl8_pool = tbl8_pool;
 	lpm->tbl8_hdrs = tbl8_hdrs;
+#ifdef CC_LPM6_AVX512_SUPPORT
+	lpm->vector_lookup =
+		(rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0) &&
+		(rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512);
+#endif
 
 	/* init the stack */
 	tbl8_pool_init(lpm);
@@ -972,46 +986,76 @@ rte_lpm6_lookup(const struct rte_lpm6 *lpm, const uint8_t *ip,
 }
 
 /*
- * Looks up a group of IP addresses
+ * Looks up a group of up to LOOKUP_BULK_INTERLEAVE IP addresses.
+ * All the addresses of the group walk the same tbl8 level together, the
+ * entry of the next level is prefetched for every address still in flight
+ * before any of them is read.
  */
-int
-rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
+static inline void
+lookup_bulk_interleaved(const struct rte_lpm6 *lpm,
 		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
 		int32_t *next_hops, unsigned int n)
 {
+	const struct rte_lpm6_tbl_entry *tbl[LOOKUP_BULK_INTERLEAVE];
+	uint32_t tbl24_index, next_hop, pending;
 	unsigned int i;
-	const struct rte_lpm6_tbl_entry *tbl;
-	const struct rte_lpm6_tbl_entry *tbl_next = NULL;
-	uint32_t tbl24_index, next_hop;
 	uint8_t first_byte;
 	int status;
 
-	/* DEBUG: Check user input arguments. */
-	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
-		return -EINVAL;
-
+	pending = 0;
 	for (i = 0; i < n; i++) {
-		first_byte = LOOKUP_FIRST_BYTE;
 		tbl24_index = (ips[i][0] << BYTES2_SIZE) |
 				(ips[i][1] << BYTE_SIZE) | ips[i][2];
+		tbl[i] = &lpm->tbl24[tbl24_index];
+		rte_prefetch0(tbl[i]);
+		pending |= 1 << i;
+	}
 
-		/* Calculate pointer to the first entry to be inspected */
-		tbl = &lpm->tbl24[tbl24_index];
+	first_byte = LOOKUP_FIRST_BYTE;
+	while (pending != 0) {
+		for (i = 0; i < n; i++) {
+			if ((pending & (1 << i)) == 0)
+				continue;
+
+			status = lookup_step(lpm, tbl[i], &tbl[i], ips[i],
+					first_byte, &next_hop);
+			if (status == 1) {
+				rte_prefetch0(tbl[i]);
+				continue;
+			}
 
-		do {
-			/* Continue inspecting following levels
-			 * until success or failure
-			 */
-			status = lookup_step(lpm, tbl, &tbl_next, ips[i],
-					first_byte++, &next_hop);
-			tbl = tbl_next;
-		} while (status == 1);
-
-		if (status < 0)
-			next_hops[i] = -1;
-		else
-			next_hops[i] = (int32_t)next_hop;
+			next_hops[i] = (status < 0) ? -1 : (int32_t)next_hop;
+			pending &= ~(1 << i);
+		}
+		first_byte++;
 	}
+}
+
+/*
+ * Looks up a group of IP addresses
+ */
+int
+rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
+		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+		int32_t *next_hops, unsigned int n)
+{
+	unsigned int i = 0;
+
+	/* DEBUG: Check user input arguments. */
+	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
+		return -EINVAL;
+
+#ifdef CC_LPM6_AVX512_SUPPORT
+	if (lpm->vector_lookup)
+		i = rte_lpm6_vec_lookup_bulk(
+				(const uint32_t *)lpm->tbl24,
+				(const uint32_t *)lpm->tbl8,
+				ips, next_hops, n);
+#endif
+
+	for (; i < n; i += LOOKUP_BULK_INTERLEAVE)
+		lookup_bulk_interleaved(lpm, &ips[i], &next_hops[i],
+				RTE_MIN(n - i, (unsigned int)LOOKUP_BULK_INTERLEAVE));
 
 	return 0;
 }
@@ -0,0 +1,118 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_vect.h>
+#include <rte_lpm6.h>
+
+#include "rte_lpm6_avx512.h"
+
+/* Entry bits, same as in rte_lpm6.c */
+#define LPM6_VALID_EXT_ENTRY_BITMASK	0xA0000000
+#define LPM6_LOOKUP_SUCCESS		0x20000000
+#define LPM6_TBL8_BITMASK		0x001FFFFF
+
+/* tbl8 levels after tbl24 consume ip bytes 3 to 15 */
+#define LPM6_FIRST_TBL8_BYTE		3
+
+static __rte_always_inline void
+transpose_x16(uint8_t ips[16][RTE_LPM6_IPV6_ADDR_SIZE], __m512i chunks[4])
+{
+	__m512i tmp1, tmp2, tmp3, tmp4;
+	__m512i tmp5, tmp6, tmp7, tmp8;
+	const __rte_x86_zmm_t perm_idxes = {
+		.u32 = { 0, 4, 8, 12, 2, 6, 10, 14,
+			1, 5, 9, 13, 3, 7, 11, 15
+		},
+	};
+
+	/* load all ip addresses */
+	tmp1 = _mm512_loadu_si512(&ips[0][0]);
+	tmp2 = _mm512_loadu_si512(&ips[4][0]);
+	tmp3 = _mm512_loadu_si512(&ips[8][0]);
+	tmp4 = _mm512_loadu_si512(&ips[12][0]);
+
+	/* transpose 4 byte chunks of 16 ips */
+	tmp5 = _mm512_unpacklo_epi32(tmp1, tmp2);
+	tmp7 = _mm512_unpackhi_epi32(tmp1, tmp2);
+	tmp6 = _mm512_unpacklo_epi32(tmp3, tmp4);
+	tmp8 = _mm512_unpackhi_epi32(tmp3, tmp4);
+
+	tmp1 = _mm512_unpacklo_epi32(tmp5, tmp6);
+	tmp3 = _mm512_unpackhi_epi32(tmp5, tmp6);
+	tmp2 = _mm512_unpacklo_epi32(tmp7, tmp8);
+	tmp4 = _mm512_unpackhi_epi32(tmp7, tmp8);
+
+	chunks[0] = _mm512_permutexvar_epi32(perm_idxes.z, tmp1);
+	chunks[1] = _mm512_permutexvar_epi32(perm_idxes.z, tmp3);
+	chunks[2] = _mm512_permutexvar_epi32(perm_idxes.z, tmp2);
+	chunks[3] = _mm512_permutexvar_epi32(perm_idxes.z, tmp4);
+}
+
+static __rte_always_inline void
+lpm6_vec_lookup_x16(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[16][RTE_LPM6_IPV6_ADDR_SIZE], int32_t *next_hops)
+{
+	const __m512i lsbyte = _mm512_set1_epi32(UINT8_MAX);
+	const __m512i valid_ext = _mm512_set1_epi32(
+		LPM6_VALID_EXT_ENTRY_BITMASK);
+	const __m512i nh_mask = _mm512_set1_epi32(LPM6_TBL8_BITMASK);
+	const __m512i miss = _mm512_set1_epi32(-1);
+	__m512i chunks[4];
+	__m512i idxes, res, bytes;
+	__mmask16 msk_ext, msk_hit;
+	unsigned int i, shift;
+
+	transpose_x16(ips, chunks);
+
+	/*
+	 * first chunk holds ip bytes 0-3 in host (little endian) order,
+	 * tbl24 index is (ip[0] << 16) | (ip[1] << 8) | ip[2]
+	 */
+	idxes = _mm512_or_epi32(
+		_mm512_slli_epi32(_mm512_and_epi32(chunks[0], lsbyte), 16),
+		_mm512_and_epi32(chunks[0], _mm512_set1_epi32(0xFF00)));
+	idxes = _mm512_or_epi32(idxes, _mm512_and_epi32(
+		_mm512_srli_epi32(chunks[0], 16), lsbyte));
+	res = _mm512_i32gather_epi32(idxes, (const int *)tbl24, 4);
+
+	/* walk tbl8 levels while any of the entries is extended */
+	for (i = LPM6_FIRST_TBL8_BYTE; i < RTE_LPM6_IPV6_ADDR_SIZE; i++) {
+		msk_ext = _mm512_cmpeq_epi32_mask(
+			_mm512_and_epi32(res, valid_ext), valid_ext);
+		if (msk_ext == 0)
+			break;
+
+		shift = (i % sizeof(uint32_t)) * 8;
+		bytes = _mm512_and_epi32(_mm512_srli_epi32(
+			chunks[i / sizeof(uint32_t)], shift), lsbyte);
+		idxes = _mm512_add_epi32(_mm512_slli_epi32(
+			_mm512_and_epi32(res, nh_mask), 8), bytes);
+		res = _mm512_mask_i32gather_epi32(res, msk_ext, idxes,
+			(const int *)tbl8, 4);
+	}
+
+	msk_hit = _mm512_test_epi32_mask(res,
+		_mm512_set1_epi32(LPM6_LOOKUP_SUCCESS));
+	res = _mm512_mask_and_epi32(miss, msk_hit, res, nh_mask);
+	_mm512_storeu_si512(next_hops, res);
+}
+
+/*
+ * Looks up groups of 16 ips, returns the number of ips looked up,
+ * the remainder is left for the scalar path.
+ */
+unsigned int
+rte_lpm6_vec_lookup_bulk(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops, const unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n / 16; i++)
+		lpm6_vec_lookup_x16(tbl24, tbl8,
+			(uint8_t (*)[RTE_LPM6_IPV6_ADDR_SIZE])&ips[i * 16],
+			next_hops + i * 16);
+
+	return i * 16;
+}
@@ -0,0 +1,13 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_LPM6_AVX512_H_
+#define _RTE_LPM6_AVX512_H_
+
+unsigned int
+rte_lpm6_vec_lookup_bulk(const uint32_t *tbl24, const uint32_t *tbl8,
+	uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+	int32_t *next_hops, const unsigned int n);
+
+#endif /* _RTE_LPM6_AVX512_H_ */
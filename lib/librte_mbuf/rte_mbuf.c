@@ -449,8 +449,51 @@ int rte_mbuf_check(const struct rte_mbuf *m, int is_header,
 
 /**
  * @internal helper function for freeing a bulk of packet mbuf segments
- * via an array holding the packet mbuf segments from the same mempool
- * pending to be freed.
+ * that may belong to several mempools.
+ *
+ * The segments are grouped by mempool in place, so that each mempool
+ * receives a single rte_mempool_put_bulk() call per group, no matter how
+ * the segments of different mempools are interleaved in the array.
+ *
+ * @param pending
+ *  Array of packet mbuf segments, already processed by
+ *  rte_pktmbuf_prefree_seg(). The array order is not preserved.
+ * @param nb_pending
+ *  Number of elements held in the array.
+ */
+static void
+__rte_pktmbuf_free_pending(struct rte_mbuf **pending,
+	unsigned int nb_pending)
+{
+	struct rte_mempool *mp;
+	struct rte_mbuf *m;
+	unsigned int i, n;
+
+	while (nb_pending > 0) {
+		/* move all segments from the first segment's pool up front */
+		mp = pending[0]->pool;
+		for (i = 1, n = 1; i < nb_pending; i++) {
+			m = pending[i];
+			if (m->pool != mp)
+				continue;
+			if (i != n) {
+				pending[i] = pending[n];
+				pending[n] = m;
+			}
+			n++;
+		}
+
+		rte_mempool_put_bulk(mp, (void **)pending, n);
+		pending += n;
+		nb_pending -= n;
+	}
+}
+
+/**
+ * @internal helper function for freeing a bulk of packet mbuf segments
+ * via an array holding the packet mbuf segments pending to be freed.
+ * The segments may come from different mempools; they are grouped by
+ * mempool when the array is flushed.
  *
  * @param m
  *  The packet mbuf segment to be freed.
@@ -470,10 +513,8 @@ __rte_pktmbuf_free_seg_via_array(struct rte_mbuf *m,
 {
 	m = rte_pktmbuf_prefree_seg(m);
 	if (likely(m != NULL)) {
-		if (*nb_pending == pending_sz ||
-		    (*nb_pending > 0 && m->pool != pending[0]->pool)) {
-			rte_mempool_put_bulk(pending[0]->pool,
-					(void **)pending, *nb_pending);
+		if (*nb_pending == pending_sz) {
+			__rte_pktmbuf_free_pending(pending, *nb_pending);
 			*nb_pending = 0;
 		}
 
@@ -482,8 +523,7 @@ __rte_pktmbuf_free_seg_via_array(struct rte_mbuf *m,
 }
 
 /**
- * Size of the array holding mbufs from the same mempool pending to be freed
- * in bulk.
+ * Size of the array holding mbufs pending to be freed in bulk.
  */
 #define RTE_PKTMBUF_FREE_PENDING_SZ 64
 
@@ -510,7 +550,7 @@ void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count)
 	}
 
 	if (nb_pending > 0)
-		rte_mempool_put_bulk(pending[0]->pool, (void **)pending, nb_pending);
+		__rte_pktmbuf_free_pending(pending, nb_pending);
 }
 
 /* Creates a shallow copy of mbuf */
@@ -795,6 +795,118 @@ rte_pktmbuf_pool_create_extbuf(const char *name, unsigned int n,
 	const struct rte_pktmbuf_extmem *ext_mem,
 	unsigned int ext_num);
 
+/**
+ * Shareable memory file holding the data buffers of a mbuf pool created
+ * by rte_pktmbuf_pool_create_memfd().
+ *
+ * The file descriptor may be passed to another process, e.g. with
+ * SCM_RIGHTS over a UNIX socket. That process, which does not need to be
+ * a DPDK process, maps the whole file with mmap() and reads the packet
+ * data in place, at the offsets given by rte_pktmbuf_memfd_offset().
+ *
+ * The data buffers are laid out page by page: each page of *page_sz*
+ * bytes holds *page_sz / elt_size* buffers of *elt_size* bytes, starting
+ * at the beginning of the page.
+ */
+struct rte_pktmbuf_memfd {
+	int fd;			/**< Sealed memfd file descriptor. */
+	void *addr;		/**< Local mapping of the memfd. */
+	size_t len;		/**< Length of the memfd in bytes. */
+	size_t page_sz;		/**< Page size backing the memfd. */
+	uint16_t elt_size;	/**< Size of each data buffer in bytes. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: This API may change without prior notice.
+ *
+ * Create a mbuf pool with pinned external data buffers in a memfd.
+ *
+ * This function creates an anonymous memory file with memfd_create(),
+ * backed by hugepages unless *page_sz* is the system page size, sizes it
+ * for *n* data buffers and seals it against resizing. The file is mapped,
+ * registered with rte_extmem_register(), and used as external memory for
+ * rte_pktmbuf_pool_create_extbuf().
+ *
+ * This function is only supported on Linux.
+ *
+ * @param name
+ *   The name of the mbuf pool.
+ * @param n
+ *   The number of elements in the mbuf pool.
+ * @param cache_size
+ *   Size of the per-core object cache. See rte_mempool_create() for
+ *   details.
+ * @param priv_size
+ *   Size of application private are between the rte_mbuf structure
+ *   and the data buffer. This value must be aligned to RTE_MBUF_PRIV_ALIGN.
+ * @param data_room_size
+ *   Size of data buffer in each mbuf, including RTE_PKTMBUF_HEADROOM.
+ *   It must not be larger than *page_sz*.
+ * @param socket_id
+ *   The socket identifier where the mbuf headers should be allocated.
+ * @param page_sz
+ *   Size of the pages backing the memfd: either the system page size,
+ *   or a hugepage size supported by the kernel.
+ * @param mfd
+ *   Structure filled with the description of the memfd on success.
+ * @return
+ *   The pointer to the new allocated mempool, on success. NULL on error
+ *   with rte_errno set appropriately. Possible rte_errno values include
+ *   the ones of rte_pktmbuf_pool_create_extbuf(), and:
+ *    - ENOTSUP - memfd is not supported on this platform, or the physical
+ *      addresses of its pages are not available in IOVA as PA mode
+ *    - EINVAL - invalid page size, or data_room_size larger than a page
+ */
+__rte_experimental
+struct rte_mempool *
+rte_pktmbuf_pool_create_memfd(const char *name, unsigned int n,
+	unsigned int cache_size, uint16_t priv_size,
+	uint16_t data_room_size, int socket_id, size_t page_sz,
+	struct rte_pktmbuf_memfd *mfd);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: This API may change without prior notice.
+ *
+ * Free a mbuf pool created by rte_pktmbuf_pool_create_memfd().
+ *
+ * The mempool is freed, the memfd is unregistered, unmapped and its file
+ * descriptor closed. The memory stays valid for the other processes
+ * which still map it.
+ *
+ * @param mp
+ *   The mbuf pool.
+ * @param mfd
+ *   The memfd description filled by rte_pktmbuf_pool_create_memfd().
+ */
+__rte_experimental
+void
+rte_pktmbuf_pool_free_memfd(struct rte_mempool *mp,
+	struct rte_pktmbuf_memfd *mfd);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: This API may change without prior notice.
+ *
+ * Get the offset of the data of a mbuf segment in the memfd.
+ *
+ * @param mfd
+ *   The memfd description of the mbuf pool.
+ * @param m
+ *   A mbuf segment allocated from the pool created along with *mfd*.
+ * @return
+ *   The offset of the segment data from the beginning of the memfd.
+ */
+__rte_experimental
+static inline size_t
+rte_pktmbuf_memfd_offset(const struct rte_pktmbuf_memfd *mfd,
+	const struct rte_mbuf *m)
+{
+	RTE_ASSERT(RTE_PTR_DIFF(m->buf_addr, mfd->addr) < mfd->len);
+	return RTE_PTR_DIFF(rte_pktmbuf_mtod(m, void *), mfd->addr);
+}
+
 /**
  * Get the data room size of mbufs stored in a pktmbuf_pool
  *
@@ -1412,7 +1524,10 @@ static inline void rte_pktmbuf_free(struct rte_mbuf *m)
  * Free a bulk of packet mbufs back into their original mempools.
  *
  * Free a bulk of mbufs, and all their segments in case of chained buffers.
- * Each segment is added back into its original mempool.
+ * Each segment is added back into its original mempool. Segments are
+ * grouped by mempool, so that mbufs from different mempools may be freely
+ * interleaved in the array without breaking the bulk returns to the
+ * mempools. This is the preferred way for a PMD to free transmitted mbufs.
  *
  *  @param mbufs
  *    Array of pointers to packet mbufs.
@@ -0,0 +1,217 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_errno.h>
+#include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_mempool.h>
+#include <rte_mbuf.h>
+
+#ifdef RTE_EXEC_ENV_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#ifdef F_ADD_SEALS /* if file sealing is supported, so is memfd */
+#include <linux/memfd.h>
+#define MEMFD_SUPPORTED
+#endif
+#endif
+
+#ifdef MEMFD_SUPPORTED
+
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 4U
+#endif
+#ifndef MFD_HUGE_SHIFT
+#define MFD_HUGE_SHIFT 26
+#endif
+
+#define MEMFD_SEALS (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)
+
+/* Create, size, seal and map the memfd described by mfd. */
+static int
+memfd_region_create(const char *name, struct rte_pktmbuf_memfd *mfd)
+{
+	unsigned int flags = MFD_ALLOW_SEALING | MFD_CLOEXEC;
+	size_t sys_page_sz = (size_t)sysconf(_SC_PAGESIZE);
+	void *addr;
+	int ret;
+
+	if (mfd->page_sz != sys_page_sz)
+		flags |= MFD_HUGETLB |
+			(rte_log2_u64(mfd->page_sz) << MFD_HUGE_SHIFT);
+
+	mfd->fd = memfd_create(name, flags);
+	if (mfd->fd < 0) {
+		ret = -errno;
+		RTE_LOG(ERR, MBUF, "cannot create memfd: %s\n",
+			strerror(-ret));
+		return ret;
+	}
+	if (ftruncate(mfd->fd, mfd->len) < 0) {
+		ret = -errno;
+		RTE_LOG(ERR, MBUF, "cannot size memfd: %s\n", strerror(-ret));
+		goto error;
+	}
+	if (fcntl(mfd->fd, F_ADD_SEALS, MEMFD_SEALS) < 0) {
+		ret = -errno;
+		RTE_LOG(ERR, MBUF, "cannot seal memfd: %s\n", strerror(-ret));
+		goto error;
+	}
+	/* populate the mapping so that the pages have an IOVA */
+	addr = mmap(NULL, mfd->len, PROT_READ | PROT_WRITE,
+		    MAP_SHARED | MAP_POPULATE, mfd->fd, 0);
+	if (addr == MAP_FAILED) {
+		ret = -errno;
+		RTE_LOG(ERR, MBUF, "cannot map memfd: %s\n", strerror(-ret));
+		goto error;
+	}
+	mfd->addr = addr;
+
+	return 0;
+
+error:
+	close(mfd->fd);
+	mfd->fd = -1;
+	return ret;
+}
+
+/* Helper to create a mbuf pool with pinned external buffers in a memfd. */
+struct rte_mempool *
+rte_pktmbuf_pool_create_memfd(const char *name, unsigned int n,
+	unsigned int cache_size, uint16_t priv_size,
+	uint16_t data_room_size, int socket_id, size_t page_sz,
+	struct rte_pktmbuf_memfd *mfd)
+{
+	struct rte_pktmbuf_extmem *ext_mem = NULL;
+	struct rte_mempool *mp = NULL;
+	rte_iova_t *iovas = NULL;
+	unsigned int i, n_pages, elt_per_page;
+	uint16_t elt_size;
+	int ret;
+
+	if (mfd == NULL || n == 0 || !rte_is_power_of_2(page_sz) ||
+	    page_sz < (size_t)sysconf(_SC_PAGESIZE)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	elt_size = RTE_ALIGN_CEIL(data_room_size, RTE_CACHE_LINE_SIZE);
+	if (elt_size == 0 || elt_size > page_sz) {
+		RTE_LOG(ERR, MBUF, "data room does not fit in a %zu page\n",
+			page_sz);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	elt_per_page = page_sz / elt_size;
+	n_pages = (n + elt_per_page - 1) / elt_per_page;
+
+	memset(mfd, 0, sizeof(*mfd));
+	mfd->page_sz = page_sz;
+	mfd->elt_size = elt_size;
+	mfd->len = (size_t)n_pages * page_sz;
+	ret = memfd_region_create(name, mfd);
+	if (ret < 0) {
+		rte_errno = -ret;
+		return NULL;
+	}
+
+	ext_mem = rte_malloc(NULL, n_pages * sizeof(*ext_mem), 0);
+	iovas = rte_malloc(NULL, n_pages * sizeof(*iovas), 0);
+	if (ext_mem == NULL || iovas == NULL) {
+		rte_errno = ENOMEM;
+		goto error;
+	}
+	/* one descriptor per page, as pages may not be IOVA-contiguous */
+	for (i = 0; i < n_pages; i++) {
+		void *va = RTE_PTR_ADD(mfd->addr, (size_t)i * page_sz);
+
+		iovas[i] = rte_eal_iova_mode() == RTE_IOVA_VA ?
+			(rte_iova_t)(uintptr_t)va : rte_mem_virt2phy(va);
+		if (iovas[i] == RTE_BAD_IOVA) {
+			RTE_LOG(ERR, MBUF, "cannot get the IOVA of memfd page %u\n",
+				i);
+			rte_errno = ENOTSUP;
+			goto error;
+		}
+		ext_mem[i].buf_ptr = va;
+		ext_mem[i].buf_iova = iovas[i];
+		ext_mem[i].buf_len = page_sz;
+		ext_mem[i].elt_size = elt_size;
+	}
+
+	if (rte_extmem_register(mfd->addr, mfd->len, iovas, n_pages,
+			page_sz) < 0) {
+		RTE_LOG(ERR, MBUF, "cannot register memfd: %s\n",
+			rte_strerror(rte_errno));
+		goto error;
+	}
+
+	mp = rte_pktmbuf_pool_create_extbuf(name, n, cache_size, priv_size,
+			data_room_size, socket_id, ext_mem, n_pages);
+	if (mp == NULL) {
+		ret = rte_errno;
+		rte_extmem_unregister(mfd->addr, mfd->len);
+		rte_errno = ret;
+		goto error;
+	}
+
+	rte_free(iovas);
+	rte_free(ext_mem);
+	return mp;
+
+error:
+	ret = rte_errno;
+	rte_free(iovas);
+	rte_free(ext_mem);
+	munmap(mfd->addr, mfd->len);
+	close(mfd->fd);
+	mfd->fd = -1;
+	mfd->addr = NULL;
+	rte_errno = ret;
+	return NULL;
+}
+
+/* Free a mbuf pool created by rte_pktmbuf_pool_create_memfd(). */
+void
+rte_pktmbuf_pool_free_memfd(struct rte_mempool *mp,
+	struct rte_pktmbuf_memfd *mfd)
+{
+	rte_mempool_free(mp);
+	if (mfd == NULL || mfd->addr == NULL)
+		return;
+
+	rte_extmem_unregister(mfd->addr, mfd->len);
+	munmap(mfd->addr, mfd->len);
+	close(mfd->fd);
+	mfd->fd = -1;
+	mfd->addr = NULL;
+}
+
+#else /* !MEMFD_SUPPORTED */
+
+struct rte_mempool *
+rte_pktmbuf_pool_create_memfd(__rte_unused const char *name,
+	__rte_unused unsigned int n, __rte_unused unsigned int cache_size,
+	__rte_unused uint16_t priv_size, __rte_unused uint16_t data_room_size,
+	__rte_unused int socket_id, __rte_unused size_t page_sz,
+	__rte_unused struct rte_pktmbuf_memfd *mfd)
+{
+	rte_errno = ENOTSUP;
+	return NULL;
+}
+
+void
+rte_pktmbuf_pool_free_memfd(struct rte_mempool *mp,
+	__rte_unused struct rte_pktmbuf_memfd *mfd)
+{
+	rte_mempool_free(mp);
+}
+
+#endif /* MEMFD_SUPPORTED */
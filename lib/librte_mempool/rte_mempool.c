@@ -31,6 +31,7 @@
 #include <rte_spinlock.h>
 #include <rte_tailq.h>
 #include <rte_eal_paging.h>
+#include <rte_telemetry.h>
 
 #include "rte_mempool.h"
 #include "rte_mempool_trace.h"
@@ -42,10 +43,6 @@ static struct rte_tailq_elem rte_mempool_tailq = {
 };
 EAL_REGISTER_TAILQ(rte_mempool_tailq)
 
-#define CACHE_FLUSHTHRESH_MULTIPLIER 1.5
-#define CALC_CACHE_FLUSHTHRESH(c)	\
-	((typeof(c))((c) * CACHE_FLUSHTHRESH_MULTIPLIER))
-
 #if defined(RTE_ARCH_X86)
 /*
  * return the greatest common divisor between a and b (fast algorithm)
@@ -732,7 +729,7 @@ static void
 mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
 {
 	cache->size = size;
-	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
+	cache->flushthresh = RTE_MEMPOOL_CACHE_FLUSHTHRESH(size);
 	cache->len = 0;
 }
 
@@ -777,6 +774,37 @@ rte_mempool_cache_free(struct rte_mempool_cache *cache)
 	rte_free(cache);
 }
 
+int
+rte_mempool_cache_set_adaptive(struct rte_mempool *mp, uint32_t min_size,
+	uint32_t max_size)
+{
+	struct rte_mempool_cache *cache;
+	unsigned int lcore_id;
+
+	if (mp == NULL || mp->cache_size == 0)
+		return -EINVAL;
+
+	if (max_size != 0 && (min_size == 0 || min_size > mp->cache_size ||
+			max_size < mp->cache_size ||
+			max_size > RTE_MEMPOOL_CACHE_MAX_SIZE ||
+			RTE_MEMPOOL_CACHE_FLUSHTHRESH(max_size) > mp->size))
+		return -EINVAL;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		cache = &mp->local_cache[lcore_id];
+		if (max_size == 0) {
+			cache->size = mp->cache_size;
+			cache->flushthresh =
+				RTE_MEMPOOL_CACHE_FLUSHTHRESH(cache->size);
+		}
+		cache->min_size = min_size;
+		cache->max_size = max_size;
+		cache->calls = 0;
+		cache->bulk = 0;
+	}
+	return 0;
+}
+
 /* create an empty mempool */
 struct rte_mempool *
 rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
@@ -816,7 +844,7 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	/* asked cache too big */
 	if (cache_size > RTE_MEMPOOL_CACHE_MAX_SIZE ||
-	    CALC_CACHE_FLUSHTHRESH(cache_size) > n) {
+	    RTE_MEMPOOL_CACHE_FLUSHTHRESH(cache_size) > n) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
@@ -1003,6 +1031,7 @@ rte_mempool_in_use_count(const struct rte_mempool *mp)
 static unsigned
 rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 {
+	const struct rte_mempool_cache *cache;
 	unsigned lcore_id;
 	unsigned count = 0;
 	unsigned cache_count;
@@ -1014,9 +1043,15 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 		return count;
 
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
-		cache_count = mp->local_cache[lcore_id].len;
+		cache = &mp->local_cache[lcore_id];
+		cache_count = cache->len;
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
+		if (cache->max_size != 0)
+			fprintf(f, "    cache_adaptive[%u]=size:%"PRIu32
+				" grow:%"PRIu32" shrink:%"PRIu32"\n",
+				lcore_id, cache->size, cache->nb_grow,
+				cache->nb_shrink);
 		count += cache_count;
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
@@ -1335,3 +1370,108 @@ void rte_mempool_walk(void (*func)(struct rte_mempool *, void *),
 
 	rte_mcfg_mempool_read_unlock();
 }
+
+static void
+mempool_list_cb(struct rte_mempool *mp, void *arg)
+{
+	struct rte_tel_data *d = arg;
+
+	rte_tel_data_add_array_string(d, mp->name);
+}
+
+static int
+mempool_handle_list(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	rte_mempool_walk(mempool_list_cb, d);
+	return 0;
+}
+
+/* add one array of values of the enabled lcores to the dictionary */
+static void
+mempool_add_lcore_array(struct rte_tel_data *d, const char *name,
+		const struct rte_mempool *mp, size_t offset)
+{
+	struct rte_tel_data *a;
+	unsigned int lcore_id;
+	const uint32_t *val;
+
+	a = rte_tel_data_alloc();
+	if (a == NULL)
+		return;
+
+	rte_tel_data_start_array(a, RTE_TEL_U64_VAL);
+	RTE_LCORE_FOREACH(lcore_id) {
+		val = RTE_PTR_ADD(&mp->local_cache[lcore_id], offset);
+		rte_tel_data_add_array_u64(a, *val);
+	}
+	rte_tel_data_add_dict_container(d, name, a, 0);
+}
+
+static int
+mempool_handle_info(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	const struct rte_mempool_cache *cache;
+	struct rte_mempool *mp;
+	struct rte_tel_data *a;
+	unsigned int lcore_id;
+
+	if (params == NULL || strlen(params) == 0)
+		return -1;
+
+	mp = rte_mempool_lookup(params);
+	if (mp == NULL)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", mp->name);
+	rte_tel_data_add_dict_string(d, "ops_name",
+		rte_mempool_get_ops(mp->ops_index)->name);
+	rte_tel_data_add_dict_int(d, "socket_id", mp->socket_id);
+	rte_tel_data_add_dict_u64(d, "flags", mp->flags);
+	rte_tel_data_add_dict_u64(d, "size", mp->size);
+	rte_tel_data_add_dict_u64(d, "populated_size", mp->populated_size);
+	rte_tel_data_add_dict_u64(d, "elt_size", mp->elt_size);
+	rte_tel_data_add_dict_u64(d, "avail_count",
+		rte_mempool_avail_count(mp));
+	rte_tel_data_add_dict_u64(d, "in_use_count",
+		rte_mempool_in_use_count(mp));
+	rte_tel_data_add_dict_u64(d, "cache_size", mp->cache_size);
+
+	if (mp->cache_size == 0)
+		return 0;
+
+	/* the adaptive mode uses the same bounds for all the caches */
+	cache = &mp->local_cache[0];
+	rte_tel_data_add_dict_u64(d, "cache_min_size", cache->min_size);
+	rte_tel_data_add_dict_u64(d, "cache_max_size", cache->max_size);
+
+	a = rte_tel_data_alloc();
+	if (a == NULL)
+		return 0;
+	rte_tel_data_start_array(a, RTE_TEL_INT_VAL);
+	RTE_LCORE_FOREACH(lcore_id)
+		rte_tel_data_add_array_int(a, lcore_id);
+	rte_tel_data_add_dict_container(d, "lcores", a, 0);
+
+	mempool_add_lcore_array(d, "lcore_cache_count", mp,
+		offsetof(struct rte_mempool_cache, len));
+	mempool_add_lcore_array(d, "lcore_cache_size", mp,
+		offsetof(struct rte_mempool_cache, size));
+	mempool_add_lcore_array(d, "lcore_cache_grow", mp,
+		offsetof(struct rte_mempool_cache, nb_grow));
+	mempool_add_lcore_array(d, "lcore_cache_shrink", mp,
+		offsetof(struct rte_mempool_cache, nb_shrink));
+	return 0;
+}
+
+RTE_INIT(mempool_init_telemetry)
+{
+	rte_telemetry_register_cmd("/mempool/list", mempool_handle_list,
+		"Returns list of available mempools. Takes no parameters");
+	rte_telemetry_register_cmd("/mempool/info", mempool_handle_info,
+		"Returns mempool info and per-lcore cache sizes. "
+		"Parameters: pool name");
+}
@@ -91,8 +91,42 @@ struct rte_mempool_cache {
 	 * cases to avoid needless emptying of cache.
 	 */
 	void *objs[RTE_MEMPOOL_CACHE_MAX_SIZE * 3]; /**< Cache objects */
+	/*
+	 * Adaptive mode state. It is kept after the objects, in the padding
+	 * of the structure, so that the layout of the fields above is not
+	 * changed.
+	 */
+	uint32_t calls;	      /**< Get and put calls since the last resize */
+	uint32_t bulk;	      /**< Pool operations since the last resize */
+	uint32_t min_size;    /**< Adaptive mode lower bound of size */
+	uint32_t max_size;    /**< Adaptive mode upper bound of size, 0 if off */
+	uint32_t nb_grow;     /**< Number of times the size was increased */
+	uint32_t nb_shrink;   /**< Number of times the size was decreased */
 } __rte_cache_aligned;
 
+/**
+ * Flush threshold of a cache of the given size.
+ */
+#define RTE_MEMPOOL_CACHE_FLUSHTHRESH(size)	((size) + (size) / 2)
+
+/**
+ * Number of pool operations of a cache in adaptive mode
+ * between two decisions on its size.
+ */
+#define RTE_MEMPOOL_CACHE_ADAPT_WINDOW	16
+
+/**
+ * A cache in adaptive mode grows when it serves less than this number
+ * of get and put calls per pool operation.
+ */
+#define RTE_MEMPOOL_CACHE_ADAPT_GROW	16
+
+/**
+ * A cache in adaptive mode shrinks when it serves more than this number
+ * of get and put calls per pool operation.
+ */
+#define RTE_MEMPOOL_CACHE_ADAPT_SHRINK	256
+
 /**
  * A structure that stores the size of mempool elements.
  */
@@ -1197,6 +1231,41 @@ uint32_t rte_mempool_mem_iter(struct rte_mempool *mp,
  */
 void rte_mempool_dump(FILE *f, struct rte_mempool *mp);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable or disable the adaptive mode of the per-lcore default caches.
+ *
+ * In adaptive mode, each cache resizes itself between the given bounds
+ * from the get and put calls of its lcore: when they are unbalanced, the
+ * cache keeps running empty or full and often accesses the pool, so it
+ * grows to access the pool with larger bulks. When they are balanced,
+ * the cache rarely accesses the pool and shrinks back to keep less
+ * objects out of the pool.
+ *
+ * This function is not thread-safe with the get and put operations on
+ * the mempool.
+ *
+ * @param mp
+ *   A pointer to the mempool structure, created with a cache.
+ * @param min_size
+ *   Lower bound of the cache size, not greater than the cache size given
+ *   at creation.
+ * @param max_size
+ *   Upper bound of the cache size, not less than the cache size given at
+ *   creation and not greater than RTE_MEMPOOL_CACHE_MAX_SIZE.
+ *   Zero disables the adaptive mode and restores the cache size given
+ *   at creation.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool has no cache or the bounds are invalid.
+ */
+__rte_experimental
+int
+rte_mempool_cache_set_adaptive(struct rte_mempool *mp, uint32_t min_size,
+	uint32_t max_size);
+
 /**
  * Create a user-owned mempool cache.
  *
@@ -1269,6 +1338,40 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @internal Account a pool operation of a cache. In adaptive mode, resize
+ * the cache every few operations: grow it when it serves few get and put
+ * calls per pool operation, shrink it when it serves many.
+ * @param cache
+ *   A pointer to a mempool cache structure.
+ */
+static __rte_always_inline void
+__mempool_cache_adapt(struct rte_mempool_cache *cache)
+{
+	uint32_t size;
+
+	if (cache->max_size == 0 ||
+			++cache->bulk < RTE_MEMPOOL_CACHE_ADAPT_WINDOW)
+		return;
+
+	size = cache->size;
+	if (cache->calls < cache->bulk * RTE_MEMPOOL_CACHE_ADAPT_GROW &&
+			size < cache->max_size) {
+		size = RTE_MIN(size * 2, cache->max_size);
+		cache->nb_grow++;
+	} else if (cache->calls >
+			cache->bulk * RTE_MEMPOOL_CACHE_ADAPT_SHRINK &&
+			size > cache->min_size) {
+		size = RTE_MAX(size / 2, cache->min_size);
+		cache->nb_shrink++;
+	}
+
+	cache->size = size;
+	cache->flushthresh = RTE_MEMPOOL_CACHE_FLUSHTHRESH(size);
+	cache->calls = 0;
+	cache->bulk = 0;
+}
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1294,6 +1397,8 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	if (unlikely(cache == NULL || n > RTE_MEMPOOL_CACHE_MAX_SIZE))
 		goto ring_enqueue;
 
+	if (cache->max_size != 0)
+		cache->calls++;
 	cache_objs = &cache->objs[cache->len];
 
 	/*
@@ -1312,12 +1417,19 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
 		cache->len = cache->size;
+		__mempool_cache_adapt(cache);
 	}
 
 	return;
 
 ring_enqueue:
 
+	/* a put bypassing the cache is a pool operation of its own */
+	if (cache != NULL && cache->max_size != 0) {
+		cache->calls++;
+		__mempool_cache_adapt(cache);
+	}
+
 	/* push remaining objects in ring */
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
 	if (rte_mempool_ops_enqueue_bulk(mp, obj_table, n) < 0)
@@ -1415,8 +1527,10 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 
 	/* No cache provided or cannot be satisfied from cache */
 	if (unlikely(cache == NULL || n >= cache->size))
-		goto ring_dequeue;
+		goto ring_bypass;
 
+	if (cache->max_size != 0)
+		cache->calls++;
 	cache_objs = cache->objs;
 
 	/* Can this be satisfied from the cache? */
@@ -1438,6 +1552,7 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		}
 
 		cache->len += req;
+		__mempool_cache_adapt(cache);
 	}
 
 	/* Now fill in the response ... */
@@ -1450,6 +1565,17 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 
 	return 0;
 
+ring_bypass:
+
+	/*
+	 * A get bypassing the cache is a pool operation of its own, so
+	 * that a cache which became smaller than the requests can grow.
+	 */
+	if (cache != NULL && cache->max_size != 0) {
+		cache->calls++;
+		__mempool_cache_adapt(cache);
+	}
+
 ring_dequeue:
 
 	/* get remaining objects from ring */
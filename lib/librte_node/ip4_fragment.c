@@ -0,0 +1,222 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_debug.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+#include "ip4_fragment_priv.h"
+#include "node_private.h"
+
+#define IP4_FRAGMENT_POOL_SZ 8191
+#define IP4_FRAGMENT_POOL_CACHE_SZ 256
+
+/* Most fragments out of a packet, the others are dropped */
+#define IP4_FRAGMENT_MAX_FRAGS 16
+
+struct ip4_fragment_node_ctx {
+	/* Socket's mbufs of the fragment headers */
+	struct rte_mempool *direct_pool;
+	/* Socket's mbufs of the fragment payloads */
+	struct rte_mempool *indirect_pool;
+};
+
+static struct ip4_fragment_node_main *ip4_fragment_nm;
+
+#define IP4_FRAGMENT_NODE_DIRECT_POOL(ctx) \
+	(((struct ip4_fragment_node_ctx *)ctx)->direct_pool)
+
+#define IP4_FRAGMENT_NODE_INDIRECT_POOL(ctx) \
+	(((struct ip4_fragment_node_ctx *)ctx)->indirect_pool)
+
+static uint16_t
+ip4_fragment_node_process(struct rte_graph *graph, struct rte_node *node,
+			  void **objs, uint16_t nb_objs)
+{
+	struct rte_mempool *direct = IP4_FRAGMENT_NODE_DIRECT_POOL(node->ctx);
+	struct rte_mempool *indirect;
+	struct rte_mbuf *frags[IP4_FRAGMENT_MAX_FRAGS];
+	const int dyn = node_mbuf_priv1_dynfield_offset;
+	struct ip4_fragment_nh *nh = ip4_fragment_nm->nh;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct ip4_fragment_nh *nh0;
+	struct rte_mbuf *mbuf;
+	int32_t nb_frags, j;
+	uint8_t *l2, *d;
+	uint16_t i;
+
+	indirect = IP4_FRAGMENT_NODE_INDIRECT_POOL(node->ctx);
+	for (i = 0; i < nb_objs; i++) {
+		mbuf = (struct rte_mbuf *)objs[i];
+		nh0 = &nh[node_mbuf_priv1(mbuf, dyn)->nh];
+
+		/* The rewritten L2 header is put back on each fragment */
+		l2 = rte_pktmbuf_mtod(mbuf, uint8_t *);
+		rte_pktmbuf_adj(mbuf, nh0->l2_len);
+		nb_frags = rte_ipv4_fragment_packet(mbuf, frags,
+						    IP4_FRAGMENT_MAX_FRAGS,
+						    nh0->mtu, direct, indirect);
+		if (unlikely(nb_frags < 0)) {
+			rte_node_enqueue_x1(graph, node, 0, mbuf);
+			continue;
+		}
+
+		for (j = 0; j < nb_frags; j++) {
+			ipv4_hdr = rte_pktmbuf_mtod(frags[j],
+						    struct rte_ipv4_hdr *);
+			ipv4_hdr->hdr_checksum = rte_ipv4_cksum(ipv4_hdr);
+			d = (uint8_t *)rte_pktmbuf_prepend(frags[j],
+							   nh0->l2_len);
+			rte_memcpy(d, l2, nh0->l2_len);
+			frags[j]->l2_len = nh0->l2_len;
+		}
+		/* The fragments hold their own references to the payload */
+		rte_pktmbuf_free(mbuf);
+
+		rte_node_enqueue(graph, node, nh0->tx_node, (void **)frags,
+				 nb_frags);
+	}
+
+	return nb_objs;
+}
+
+static struct ip4_fragment_node_main *
+ip4_fragment_nm_get(void)
+{
+	if (ip4_fragment_nm == NULL)
+		ip4_fragment_nm = rte_zmalloc(
+			"ip4_fragment", sizeof(struct ip4_fragment_node_main),
+			RTE_CACHE_LINE_SIZE);
+
+	return ip4_fragment_nm;
+}
+
+int
+ip4_fragment_set_next(uint16_t port_id, uint16_t next_index)
+{
+	struct ip4_fragment_node_main *nm = ip4_fragment_nm_get();
+
+	if (nm == NULL)
+		return -ENOMEM;
+	nm->next_index[port_id] = next_index;
+
+	return 0;
+}
+
+int
+ip4_fragment_nh_set(uint16_t next_hop, uint16_t dst_port, uint16_t l2_len,
+		    uint16_t mtu)
+{
+	struct ip4_fragment_node_main *nm = ip4_fragment_nm_get();
+
+	if (nm == NULL)
+		return -ENOMEM;
+
+	/* Check if dst port doesn't exist as edge */
+	if (!nm->next_index[dst_port])
+		return -EINVAL;
+
+	nm->nh[next_hop].tx_node = nm->next_index[dst_port];
+	nm->nh[next_hop].l2_len = l2_len;
+	nm->nh[next_hop].mtu = mtu;
+
+	return 0;
+}
+
+static int
+setup_pools(struct ip4_fragment_node_main *nm, int socket)
+{
+	char s[RTE_MEMPOOL_NAMESIZE];
+
+	/* One pair of pools per socket */
+	if (nm->direct_pool[socket])
+		return 0;
+
+	/* Direct mbufs hold the L2 and IPv4 headers of a fragment */
+	snprintf(s, sizeof(s), "IP4_FRAG_DIRECT_%d", socket);
+	nm->direct_pool[socket] = rte_pktmbuf_pool_create(s,
+		IP4_FRAGMENT_POOL_SZ, IP4_FRAGMENT_POOL_CACHE_SZ, 0,
+		RTE_PKTMBUF_HEADROOM + sizeof(struct rte_ipv4_hdr), socket);
+	if (nm->direct_pool[socket] == NULL)
+		return -rte_errno;
+
+	/* Indirect mbufs are attached to the payload of the packet */
+	snprintf(s, sizeof(s), "IP4_FRAG_INDIRECT_%d", socket);
+	nm->indirect_pool[socket] = rte_pktmbuf_pool_create(s,
+		IP4_FRAGMENT_POOL_SZ, IP4_FRAGMENT_POOL_CACHE_SZ, 0, 0,
+		socket);
+	if (nm->indirect_pool[socket] == NULL) {
+		rte_mempool_free(nm->direct_pool[socket]);
+		nm->direct_pool[socket] = NULL;
+		return -rte_errno;
+	}
+
+	return 0;
+}
+
+static int
+ip4_fragment_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ip4_fragment_node_main *nm;
+	static bool init_once;
+	int socket, rc;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ip4_fragment_node_ctx) >
+			 RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+		init_once = true;
+	}
+
+	nm = ip4_fragment_nm_get();
+	if (nm == NULL)
+		return -ENOMEM;
+
+	/* A graph on any socket takes the pools of the first one */
+	socket = graph->socket == SOCKET_ID_ANY ? 0 : graph->socket;
+	rc = setup_pools(nm, socket);
+	if (rc) {
+		node_err("ip4_fragment",
+			 "Failed to setup fragment pools for sock %d, rc=%d",
+			 socket, rc);
+		return rc;
+	}
+
+	/* Update socket's pools in node ctx */
+	IP4_FRAGMENT_NODE_DIRECT_POOL(node->ctx) = nm->direct_pool[socket];
+	IP4_FRAGMENT_NODE_INDIRECT_POOL(node->ctx) = nm->indirect_pool[socket];
+
+	node_dbg("ip4_fragment", "Initialized ip4_fragment node");
+
+	return 0;
+}
+
+static struct rte_node_register ip4_fragment_node = {
+	.process = ip4_fragment_node_process,
+	.name = "ip4_fragment",
+	/* Default edge i.e '0' is pkt drop */
+	.nb_edges = 1,
+	.next_nodes = {
+		[0] = "pkt_drop",
+	},
+	.init = ip4_fragment_node_init,
+};
+
+struct rte_node_register *
+ip4_fragment_node_get(void)
+{
+	return &ip4_fragment_node;
+}
+
+RTE_NODE_REGISTER(ip4_fragment_node);
@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#ifndef __INCLUDE_IP4_FRAGMENT_PRIV_H__
+#define __INCLUDE_IP4_FRAGMENT_PRIV_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_common.h>
+
+#include "ip4_rewrite_priv.h"
+
+/**
+ * @internal
+ *
+ * Ipv4 fragment next hop data structure. Used to send the fragments of a
+ * rewritten packet out of its port.
+ */
+struct ip4_fragment_nh {
+	uint16_t tx_node; /**< Tx node next index identifier. */
+	uint16_t l2_len;  /**< Length of the rewritten L2 header. */
+	uint16_t mtu;     /**< IPv4 MTU of the port. */
+};
+
+/**
+ * @internal
+ *
+ * Ipv4 fragment node main data structure.
+ */
+struct ip4_fragment_node_main {
+	struct ip4_fragment_nh nh[RTE_GRAPH_IP4_REWRITE_MAX_NH];
+	/**< Array of next hop data, indexed as the rewrite ones */
+	uint16_t next_index[RTE_MAX_ETHPORTS];
+	/**< Next index of each configured port. */
+	struct rte_mempool *direct_pool[RTE_MAX_NUMA_NODES];
+	/**< Mbufs of the fragment headers of each socket. */
+	struct rte_mempool *indirect_pool[RTE_MAX_NUMA_NODES];
+	/**< Mbufs of the fragment payloads of each socket. */
+};
+
+/**
+ * @internal
+ *
+ * Get the ipv4 fragment node.
+ *
+ * @return
+ *   Pointer to the ipv4 fragment node.
+ */
+struct rte_node_register *ip4_fragment_node_get(void);
+
+/**
+ * @internal
+ *
+ * Set the Edge index of a given port_id.
+ *
+ * @param port_id
+ *   Ethernet port identifier.
+ * @param next_index
+ *   Edge index of the Given Tx node.
+ */
+int ip4_fragment_set_next(uint16_t port_id, uint16_t next_index);
+
+/**
+ * @internal
+ *
+ * Set the output of the fragments of a next hop.
+ *
+ * @param next_hop
+ *   Next hop id, as given to the rewrite node.
+ * @param dst_port
+ *   Destination port of the next hop.
+ * @param l2_len
+ *   Length of the L2 header written by the rewrite node.
+ * @param mtu
+ *   IPv4 MTU of the destination port.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+int ip4_fragment_nh_set(uint16_t next_hop, uint16_t dst_port, uint16_t l2_len,
+			uint16_t mtu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_IP4_FRAGMENT_PRIV_H__ */
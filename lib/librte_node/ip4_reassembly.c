@@ -0,0 +1,185 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_cycles.h>
+#include <rte_debug.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_ip4_api.h"
+
+#include "node_private.h"
+
+#define IP4_REASSEMBLY_MAX_FLOWS 1024
+#define IP4_REASSEMBLY_FLOW_TTL_MS 1000
+#define IP4_REASSEMBLY_BUCKET_ENTRIES 16
+
+/* Death row entries prefetched while freeing them */
+#define IP4_REASSEMBLY_DR_PREFETCH 3
+
+/* IP4 reassembly global data struct */
+struct ip4_reassembly_node_main {
+	uint32_t max_flows;
+	uint32_t flow_ttl_ms;
+};
+
+struct ip4_reassembly_node_ctx {
+	/* Graph's fragment table */
+	struct rte_ip_frag_tbl *tbl;
+	/* Graph's mbufs to free */
+	struct rte_ip_frag_death_row *dr;
+};
+
+static struct ip4_reassembly_node_main ip4_reassembly_nm = {
+	.max_flows = IP4_REASSEMBLY_MAX_FLOWS,
+	.flow_ttl_ms = IP4_REASSEMBLY_FLOW_TTL_MS,
+};
+
+#define IP4_REASSEMBLY_NODE_TBL(ctx) \
+	(((struct ip4_reassembly_node_ctx *)ctx)->tbl)
+
+#define IP4_REASSEMBLY_NODE_DR(ctx) \
+	(((struct ip4_reassembly_node_ctx *)ctx)->dr)
+
+static uint16_t
+ip4_reassembly_node_process(struct rte_graph *graph, struct rte_node *node,
+			    void **objs, uint16_t nb_objs)
+{
+	struct rte_ip_frag_tbl *tbl = IP4_REASSEMBLY_NODE_TBL(node->ctx);
+	struct rte_ip_frag_death_row *dr = IP4_REASSEMBLY_NODE_DR(node->ctx);
+	const uint64_t tms = rte_rdtsc();
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_mbuf *mbuf;
+	uint16_t held = 0;
+	void **to_next;
+	uint16_t i;
+
+	for (i = 0; i < 4 && i < nb_objs; i++)
+		rte_prefetch0(rte_pktmbuf_mtod_offset(
+			(struct rte_mbuf *)objs[i], void *,
+			sizeof(struct rte_ether_hdr)));
+
+	/* Reassembled packets are never more than the fragments */
+	to_next = rte_node_next_stream_get(graph, node, 0, nb_objs);
+	for (i = 0; i < nb_objs; i++) {
+		if (likely(i + 4 < nb_objs))
+			rte_prefetch0(rte_pktmbuf_mtod_offset(
+				(struct rte_mbuf *)objs[i + 4], void *,
+				sizeof(struct rte_ether_hdr)));
+
+		mbuf = (struct rte_mbuf *)objs[i];
+		ipv4_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv4_hdr *,
+				sizeof(struct rte_ether_hdr));
+		if (unlikely(!rte_ipv4_frag_pkt_is_fragmented(ipv4_hdr))) {
+			to_next[held++] = mbuf;
+			continue;
+		}
+
+		mbuf->l2_len = sizeof(struct rte_ether_hdr);
+		mbuf->l3_len = rte_ipv4_hdr_len(ipv4_hdr);
+		mbuf = rte_ipv4_frag_reassemble_packet(tbl, dr, mbuf, tms,
+						       ipv4_hdr);
+		/* The death row is sized for so many fragments at once */
+		if (unlikely((i + 1) % IP_FRAG_DEATH_ROW_LEN == 0))
+			rte_ip_frag_free_death_row(dr,
+						   IP4_REASSEMBLY_DR_PREFETCH);
+		if (mbuf == NULL)
+			continue;
+
+		/* Checksum is left to be computed on the reassembled hdr */
+		ipv4_hdr = rte_pktmbuf_mtod_offset(mbuf, struct rte_ipv4_hdr *,
+						   mbuf->l2_len);
+		ipv4_hdr->hdr_checksum = rte_ipv4_cksum(ipv4_hdr);
+		to_next[held++] = mbuf;
+	}
+
+	rte_node_next_stream_put(graph, node, 0, held);
+	rte_ip_frag_free_death_row(dr, IP4_REASSEMBLY_DR_PREFETCH);
+
+	return nb_objs;
+}
+
+int
+rte_node_ip4_reassembly_configure(uint32_t max_flows, uint32_t flow_ttl_ms)
+{
+	if (max_flows == 0 || flow_ttl_ms == 0)
+		return -EINVAL;
+
+	ip4_reassembly_nm.max_flows = max_flows;
+	ip4_reassembly_nm.flow_ttl_ms = flow_ttl_ms;
+
+	return 0;
+}
+
+static int
+ip4_reassembly_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ip4_reassembly_node_main *nm = &ip4_reassembly_nm;
+	struct rte_ip_frag_death_row *dr;
+	struct rte_ip_frag_tbl *tbl;
+	uint64_t max_cycles;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ip4_reassembly_node_ctx) >
+			 RTE_NODE_CTX_SZ);
+
+	/* One fragment table per graph, not to share it between lcores */
+	max_cycles = (rte_get_tsc_hz() + MS_PER_S - 1) / MS_PER_S *
+		     nm->flow_ttl_ms;
+	tbl = rte_ip_frag_table_create(nm->max_flows,
+				       IP4_REASSEMBLY_BUCKET_ENTRIES,
+				       nm->max_flows, max_cycles,
+				       graph->socket);
+	if (tbl == NULL) {
+		node_err("ip4_reassembly",
+			 "Failed to create fragment table for graph %s",
+			 graph->name);
+		return -ENOMEM;
+	}
+
+	dr = rte_zmalloc_socket("ip4_reassembly", sizeof(*dr),
+				RTE_CACHE_LINE_SIZE, graph->socket);
+	if (dr == NULL) {
+		rte_ip_frag_table_destroy(tbl);
+		return -ENOMEM;
+	}
+
+	IP4_REASSEMBLY_NODE_TBL(node->ctx) = tbl;
+	IP4_REASSEMBLY_NODE_DR(node->ctx) = dr;
+
+	node_dbg("ip4_reassembly", "Initialized ip4_reassembly node");
+
+	return 0;
+}
+
+static void
+ip4_reassembly_node_fini(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct rte_ip_frag_death_row *dr = IP4_REASSEMBLY_NODE_DR(node->ctx);
+
+	RTE_SET_USED(graph);
+
+	rte_ip_frag_table_destroy(IP4_REASSEMBLY_NODE_TBL(node->ctx));
+	rte_ip_frag_free_death_row(dr, 0);
+	rte_free(dr);
+}
+
+static struct rte_node_register ip4_reassembly_node = {
+	.process = ip4_reassembly_node_process,
+	.name = "ip4_reassembly",
+
+	.init = ip4_reassembly_node_init,
+	.fini = ip4_reassembly_node_fini,
+
+	.nb_edges = 1,
+	.next_nodes = {
+		[0] = "ip4_lookup",
+	},
+};
+
+RTE_NODE_REGISTER(ip4_reassembly_node);
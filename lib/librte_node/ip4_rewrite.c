@@ -16,6 +16,7 @@
 
 #include "rte_node_ip4_api.h"
 
+#include "ip4_fragment_priv.h"
 #include "ip4_rewrite_priv.h"
 #include "node_private.h"
 
@@ -103,6 +104,9 @@ ip4_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 					      sizeof(struct rte_ether_hdr));
 		ip0->time_to_live = priv01.u16[1] - 1;
 		ip0->hdr_checksum = priv01.u16[2] + priv01.u16[3];
+		if (unlikely(rte_be_to_cpu_16(ip0->total_length) >
+			     nh[priv01.u16[0]].mtu))
+			next0 = IP4_REWRITE_NEXT_FRAGMENT;
 
 		/* Update ttl,cksum rewrite ethernet hdr on mbuf1 */
 		d1 = rte_pktmbuf_mtod(mbuf1, void *);
@@ -114,6 +118,9 @@ ip4_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 					      sizeof(struct rte_ether_hdr));
 		ip1->time_to_live = priv01.u16[5] - 1;
 		ip1->hdr_checksum = priv01.u16[6] + priv01.u16[7];
+		if (unlikely(rte_be_to_cpu_16(ip1->total_length) >
+			     nh[priv01.u16[4]].mtu))
+			next1 = IP4_REWRITE_NEXT_FRAGMENT;
 
 		/* Update ttl,cksum rewrite ethernet hdr on mbuf2 */
 		d2 = rte_pktmbuf_mtod(mbuf2, void *);
@@ -124,6 +131,9 @@ ip4_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 					      sizeof(struct rte_ether_hdr));
 		ip2->time_to_live = priv23.u16[1] - 1;
 		ip2->hdr_checksum = priv23.u16[2] + priv23.u16[3];
+		if (unlikely(rte_be_to_cpu_16(ip2->total_length) >
+			     nh[priv23.u16[0]].mtu))
+			next2 = IP4_REWRITE_NEXT_FRAGMENT;
 
 		/* Update ttl,cksum rewrite ethernet hdr on mbuf3 */
 		d3 = rte_pktmbuf_mtod(mbuf3, void *);
@@ -135,6 +145,9 @@ ip4_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 					      sizeof(struct rte_ether_hdr));
 		ip3->time_to_live = priv23.u16[5] - 1;
 		ip3->hdr_checksum = priv23.u16[6] + priv23.u16[7];
+		if (unlikely(rte_be_to_cpu_16(ip3->total_length) >
+			     nh[priv23.u16[4]].mtu))
+			next3 = IP4_REWRITE_NEXT_FRAGMENT;
 
 		/* Enqueue four to next node */
 		rte_edge_t fix_spec =
@@ -228,6 +241,9 @@ ip4_rewrite_node_process(struct rte_graph *graph, struct rte_node *node,
 		chksum += chksum >= 0xffff;
 		ip0->hdr_checksum = chksum;
 		ip0->time_to_live = node_mbuf_priv1(mbuf0, dyn)->ttl - 1;
+		if (unlikely(rte_be_to_cpu_16(ip0->total_length) >
+			     nh[node_mbuf_priv1(mbuf0, dyn)->nh].mtu))
+			next0 = IP4_REWRITE_NEXT_FRAGMENT;
 
 		if (unlikely(next_index ^ next0)) {
 			/* Copy things successfully speculated till now */
@@ -301,6 +317,8 @@ rte_node_ip4_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 			 uint8_t rewrite_len, uint16_t dst_port)
 {
 	struct ip4_rewrite_nh_header *nh;
+	uint16_t mtu;
+	int rc;
 
 	if (next_hop >= RTE_GRAPH_IP4_REWRITE_MAX_NH)
 		return -EINVAL;
@@ -320,12 +338,20 @@ rte_node_ip4_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 	if (!ip4_rewrite_nm->next_index[dst_port])
 		return -EINVAL;
 
+	/* Packets over the MTU of the port are fragmented */
+	if (rte_eth_dev_get_mtu(dst_port, &mtu))
+		mtu = RTE_ETHER_MTU;
+	rc = ip4_fragment_nh_set(next_hop, dst_port, rewrite_len, mtu);
+	if (rc < 0)
+		return rc;
+
 	/* Update next hop */
 	nh = &ip4_rewrite_nm->nh[next_hop];
 
 	memcpy(nh->rewrite_data, rewrite_data, rewrite_len);
 	nh->tx_node = ip4_rewrite_nm->next_index[dst_port];
 	nh->rewrite_len = rewrite_len;
+	nh->mtu = mtu;
 	nh->enabled = true;
 
 	return 0;
@@ -335,9 +361,10 @@ static struct rte_node_register ip4_rewrite_node = {
 	.process = ip4_rewrite_node_process,
 	.name = "ip4_rewrite",
 	/* Default edge i.e '0' is pkt drop */
-	.nb_edges = 1,
+	.nb_edges = 2,
 	.next_nodes = {
-		[0] = "pkt_drop",
+		[IP4_REWRITE_NEXT_PKT_DROP] = "pkt_drop",
+		[IP4_REWRITE_NEXT_FRAGMENT] = "ip4_fragment",
 	},
 	.init = ip4_rewrite_node_init,
 };
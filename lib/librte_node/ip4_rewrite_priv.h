@@ -13,6 +13,10 @@ extern "C" {
 #define RTE_GRAPH_IP4_REWRITE_MAX_NH 64
 #define RTE_GRAPH_IP4_REWRITE_MAX_LEN 56
 
+/* Static edges of the rewrite node, tx nodes are added after them */
+#define IP4_REWRITE_NEXT_PKT_DROP 0
+#define IP4_REWRITE_NEXT_FRAGMENT 1
+
 /**
  * @internal
  *
@@ -23,7 +27,7 @@ struct ip4_rewrite_nh_header {
 	uint16_t rewrite_len; /**< Header rewrite length. */
 	uint16_t tx_node;     /**< Tx node next index identifier. */
 	uint16_t enabled;     /**< NH enable flag */
-	uint16_t rsvd;
+	uint16_t mtu;         /**< IPv4 MTU of the port. */
 	union {
 		struct {
 			struct rte_ether_addr dst;
@@ -0,0 +1,248 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#include <rte_debug.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_fib6.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_ip6_api.h"
+
+#include "node_private.h"
+
+#define IPV6_L3FWD_FIB_MAX_RULES 1024
+#define IPV6_L3FWD_FIB_NUMBER_TBL8S (1 << 12)
+
+/* Number of packets looked up at once, bounds the stack usage */
+#define IP6_LOOKUP_NODE_BULK 64
+
+/* IP6 Lookup global data struct */
+struct ip6_lookup_node_main {
+	struct rte_fib6 *fib_tbl[RTE_MAX_NUMA_NODES];
+};
+
+struct ip6_lookup_node_ctx {
+	/* Socket's FIB table */
+	struct rte_fib6 *fib;
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+static struct ip6_lookup_node_main ip6_lookup_nm;
+
+#define IP6_LOOKUP_NODE_FIB(ctx) \
+	(((struct ip6_lookup_node_ctx *)ctx)->fib)
+
+#define IP6_LOOKUP_NODE_PRIV1_OFF(ctx) \
+	(((struct ip6_lookup_node_ctx *)ctx)->mbuf_priv1_off)
+
+static uint16_t
+ip6_lookup_node_process(struct rte_graph *graph, struct rte_node *node,
+			void **objs, uint16_t nb_objs)
+{
+	uint8_t ips[IP6_LOOKUP_NODE_BULK][RTE_FIB6_IPV6_ADDR_SIZE];
+	struct rte_fib6 *fib = IP6_LOOKUP_NODE_FIB(node->ctx);
+	const int dyn = IP6_LOOKUP_NODE_PRIV1_OFF(node->ctx);
+	uint64_t next_hops[IP6_LOOKUP_NODE_BULK];
+	uint8_t hop_limits[IP6_LOOKUP_NODE_BULK];
+	struct rte_ipv6_hdr *ipv6_hdr;
+	void **to_next, **from;
+	uint16_t last_spec = 0;
+	struct rte_mbuf *mbuf;
+	rte_edge_t next_index;
+	uint16_t held = 0;
+	uint16_t i, j, n;
+
+	/* Speculative next */
+	next_index = RTE_NODE_IP6_LOOKUP_NEXT_REWRITE;
+	from = objs;
+
+	for (i = 0; i < 4 && i < nb_objs; i++)
+		rte_prefetch0(rte_pktmbuf_mtod_offset(
+			(struct rte_mbuf *)objs[i], void *,
+			sizeof(struct rte_ether_hdr)));
+
+	/* Get stream for the speculated next node */
+	to_next = rte_node_next_stream_get(graph, node, next_index, nb_objs);
+	for (i = 0; i < nb_objs; i += n) {
+		n = RTE_MIN(nb_objs - i, IP6_LOOKUP_NODE_BULK);
+
+		/* Gather the DIPs of the bulk for a single FIB lookup */
+		for (j = 0; j < n; j++) {
+			if (likely(i + j + 4 < nb_objs))
+				rte_prefetch0(rte_pktmbuf_mtod_offset(
+					(struct rte_mbuf *)objs[i + j + 4],
+					void *, sizeof(struct rte_ether_hdr)));
+
+			mbuf = (struct rte_mbuf *)objs[i + j];
+			ipv6_hdr = rte_pktmbuf_mtod_offset(mbuf,
+					struct rte_ipv6_hdr *,
+					sizeof(struct rte_ether_hdr));
+			rte_memcpy(ips[j], ipv6_hdr->dst_addr,
+				   RTE_FIB6_IPV6_ADDR_SIZE);
+			/* Extract hop limit as ipv6 hdr is in cache */
+			hop_limits[j] = ipv6_hdr->hop_limits;
+		}
+
+		rte_fib6_lookup_bulk(fib, ips, next_hops, n);
+
+		for (j = 0; j < n; j++) {
+			uint16_t next;
+
+			mbuf = (struct rte_mbuf *)objs[i + j];
+			node_mbuf_priv1(mbuf, dyn)->nh = (uint16_t)next_hops[j];
+			node_mbuf_priv1(mbuf, dyn)->ttl = hop_limits[j];
+			next = (uint16_t)(next_hops[j] >> 16);
+			/* Hop limit would expire on the way out */
+			if (unlikely(hop_limits[j] <= 1))
+				next = RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP;
+
+			if (unlikely(next_index != next)) {
+				/* Copy things speculated till now */
+				rte_memcpy(to_next, from,
+					   last_spec * sizeof(from[0]));
+				from += last_spec;
+				to_next += last_spec;
+				held += last_spec;
+				last_spec = 0;
+
+				rte_node_enqueue_x1(graph, node, next, from[0]);
+				from += 1;
+			} else {
+				last_spec += 1;
+			}
+		}
+	}
+
+	/* !!! Home run !!! */
+	if (likely(last_spec == nb_objs)) {
+		rte_node_next_stream_move(graph, node, next_index);
+		return nb_objs;
+	}
+	held += last_spec;
+	rte_memcpy(to_next, from, last_spec * sizeof(from[0]));
+	rte_node_next_stream_put(graph, node, next_index, held);
+
+	return nb_objs;
+}
+
+int
+rte_node_ip6_route_add(const uint8_t *ip, uint8_t depth, uint16_t next_hop,
+		       enum rte_node_ip6_lookup_next next_node)
+{
+	char abuf[INET6_ADDRSTRLEN];
+	uint8_t socket;
+	uint32_t val;
+	int ret;
+
+	inet_ntop(AF_INET6, ip, abuf, sizeof(abuf));
+	/* Embedded next node id into 24 bit next hop */
+	val = ((next_node << 16) | next_hop) & ((1ull << 24) - 1);
+	node_dbg("ip6_lookup", "FIB: Adding route %s / %d nh (0x%x)", abuf,
+		 depth, val);
+
+	for (socket = 0; socket < RTE_MAX_NUMA_NODES; socket++) {
+		if (!ip6_lookup_nm.fib_tbl[socket])
+			continue;
+
+		ret = rte_fib6_add(ip6_lookup_nm.fib_tbl[socket], ip, depth,
+				   val);
+		if (ret < 0) {
+			node_err("ip6_lookup",
+				 "Unable to add entry %s / %d nh (%x) to FIB table on sock %d, rc=%d\n",
+				 abuf, depth, val, socket, ret);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int
+setup_fib(struct ip6_lookup_node_main *nm, int socket)
+{
+	struct rte_fib6_conf config_ipv6;
+	char s[RTE_MEMZONE_NAMESIZE];
+
+	/* One FIB table per socket */
+	if (nm->fib_tbl[socket])
+		return 0;
+
+	/* create the FIB table, unknown destinations go to pkt drop */
+	memset(&config_ipv6, 0, sizeof(config_ipv6));
+	config_ipv6.type = RTE_FIB6_TRIE;
+	config_ipv6.default_nh =
+		((uint64_t)RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP) << 16;
+	config_ipv6.max_routes = IPV6_L3FWD_FIB_MAX_RULES;
+	config_ipv6.trie.nh_sz = RTE_FIB6_TRIE_4B;
+	config_ipv6.trie.num_tbl8 = IPV6_L3FWD_FIB_NUMBER_TBL8S;
+	snprintf(s, sizeof(s), "IPV6_L3FWD_FIB_%d", socket);
+	nm->fib_tbl[socket] = rte_fib6_create(s, socket, &config_ipv6);
+	if (nm->fib_tbl[socket] == NULL)
+		return -rte_errno;
+
+	return 0;
+}
+
+static int
+ip6_lookup_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	uint16_t socket, lcore_id;
+	static uint8_t init_once;
+	int rc;
+
+	RTE_SET_USED(graph);
+	RTE_BUILD_BUG_ON(sizeof(struct ip6_lookup_node_ctx) > RTE_NODE_CTX_SZ);
+
+	if (!init_once) {
+		node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+				&node_mbuf_priv1_dynfield_desc);
+		if (node_mbuf_priv1_dynfield_offset < 0)
+			return -rte_errno;
+
+		/* Setup FIB tables for all sockets */
+		RTE_LCORE_FOREACH(lcore_id)
+		{
+			socket = rte_lcore_to_socket_id(lcore_id);
+			rc = setup_fib(&ip6_lookup_nm, socket);
+			if (rc) {
+				node_err("ip6_lookup",
+					 "Failed to setup fib tbl for sock %u, rc=%d",
+					 socket, rc);
+				return rc;
+			}
+		}
+		init_once = 1;
+	}
+
+	/* Update socket's FIB and mbuf dyn priv1 offset in node ctx */
+	IP6_LOOKUP_NODE_FIB(node->ctx) = ip6_lookup_nm.fib_tbl[graph->socket];
+	IP6_LOOKUP_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+
+	node_dbg("ip6_lookup", "Initialized ip6_lookup node");
+
+	return 0;
+}
+
+static struct rte_node_register ip6_lookup_node = {
+	.process = ip6_lookup_node_process,
+	.name = "ip6_lookup",
+
+	.init = ip6_lookup_node_init,
+
+	.nb_edges = RTE_NODE_IP6_LOOKUP_NEXT_MAX,
+	.next_nodes = {
+		[RTE_NODE_IP6_LOOKUP_NEXT_REWRITE] = "ip6_rewrite",
+		[RTE_NODE_IP6_LOOKUP_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+RTE_NODE_REGISTER(ip6_lookup_node);
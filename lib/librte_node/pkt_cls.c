@@ -13,7 +13,7 @@
 #include "node_private.h"
 
 /* Next node for each ptype, default is '0' is "pkt_drop" */
-static const uint8_t p_nxt[256] __rte_cache_aligned = {
+static const uint8_t p_nxt[512] __rte_cache_aligned = {
 	[RTE_PTYPE_L3_IPV4] = PKT_CLS_NEXT_IP4_LOOKUP,
 
 	[RTE_PTYPE_L3_IPV4_EXT] = PKT_CLS_NEXT_IP4_LOOKUP,
@@ -28,14 +28,72 @@ static const uint8_t p_nxt[256] __rte_cache_aligned = {
 
 	[RTE_PTYPE_L3_IPV4_EXT_UNKNOWN | RTE_PTYPE_L2_ETHER] =
 		PKT_CLS_NEXT_IP4_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6] = PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6_EXT] = PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6_EXT_UNKNOWN] = PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6 | RTE_PTYPE_L2_ETHER] =
+		PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6_EXT | RTE_PTYPE_L2_ETHER] =
+		PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6_EXT_UNKNOWN | RTE_PTYPE_L2_ETHER] =
+		PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV4 | PKT_CLS_FRAG] = PKT_CLS_NEXT_IP4_REASSEMBLY,
+
+	[RTE_PTYPE_L3_IPV4_EXT | PKT_CLS_FRAG] = PKT_CLS_NEXT_IP4_REASSEMBLY,
+
+	[RTE_PTYPE_L3_IPV4_EXT_UNKNOWN | PKT_CLS_FRAG] =
+		PKT_CLS_NEXT_IP4_REASSEMBLY,
+
+	[RTE_PTYPE_L3_IPV4 | RTE_PTYPE_L2_ETHER | PKT_CLS_FRAG] =
+		PKT_CLS_NEXT_IP4_REASSEMBLY,
+
+	[RTE_PTYPE_L3_IPV4_EXT | RTE_PTYPE_L2_ETHER | PKT_CLS_FRAG] =
+		PKT_CLS_NEXT_IP4_REASSEMBLY,
+
+	[RTE_PTYPE_L3_IPV4_EXT_UNKNOWN | RTE_PTYPE_L2_ETHER | PKT_CLS_FRAG] =
+		PKT_CLS_NEXT_IP4_REASSEMBLY,
+
+	/* IPv6 fragments are forwarded as is */
+	[RTE_PTYPE_L3_IPV6 | PKT_CLS_FRAG] = PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6_EXT | PKT_CLS_FRAG] = PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6_EXT_UNKNOWN | PKT_CLS_FRAG] =
+		PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6 | RTE_PTYPE_L2_ETHER | PKT_CLS_FRAG] =
+		PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6_EXT | RTE_PTYPE_L2_ETHER | PKT_CLS_FRAG] =
+		PKT_CLS_NEXT_IP6_LOOKUP,
+
+	[RTE_PTYPE_L3_IPV6_EXT_UNKNOWN | RTE_PTYPE_L2_ETHER | PKT_CLS_FRAG] =
+		PKT_CLS_NEXT_IP6_LOOKUP,
 };
 
+/* l2l3 type of the packet, with PKT_CLS_FRAG set for a fragment */
+static __rte_always_inline uint16_t
+pkt_cls_type(const struct rte_mbuf *m)
+{
+	uint32_t ptype = m->packet_type;
+
+	return (ptype & (RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK)) |
+	       (((ptype & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_FRAG) << 8);
+}
+
 static uint16_t
 pkt_cls_node_process(struct rte_graph *graph, struct rte_node *node,
 		     void **objs, uint16_t nb_objs)
 {
 	struct rte_mbuf *mbuf0, *mbuf1, *mbuf2, *mbuf3, **pkts;
-	uint8_t l0, l1, l2, l3, last_type;
+	uint16_t l0, l1, l2, l3, last_type;
 	uint16_t next_index, n_left_from;
 	uint16_t held = 0, last_spec = 0;
 	struct pkt_cls_node_ctx *ctx;
@@ -78,19 +136,15 @@ pkt_cls_node_process(struct rte_graph *graph, struct rte_node *node,
 		pkts += 4;
 		n_left_from -= 4;
 
-		l0 = mbuf0->packet_type &
-			(RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK);
-		l1 = mbuf1->packet_type &
-			(RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK);
-		l2 = mbuf2->packet_type &
-			(RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK);
-		l3 = mbuf3->packet_type &
-			(RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK);
+		l0 = pkt_cls_type(mbuf0);
+		l1 = pkt_cls_type(mbuf1);
+		l2 = pkt_cls_type(mbuf2);
+		l3 = pkt_cls_type(mbuf3);
 
 		/* Check if they are destined to same
 		 * next node based on l2l3 packet type.
 		 */
-		uint8_t fix_spec = (last_type ^ l0) | (last_type ^ l1) |
+		uint16_t fix_spec = (last_type ^ l0) | (last_type ^ l1) |
 			(last_type ^ l2) | (last_type ^ l3);
 
 		if (unlikely(fix_spec)) {
@@ -175,8 +229,7 @@ pkt_cls_node_process(struct rte_graph *graph, struct rte_node *node,
 		pkts += 1;
 		n_left_from -= 1;
 
-		l0 = mbuf0->packet_type &
-			(RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK);
+		l0 = pkt_cls_type(mbuf0);
 		if (unlikely((l0 != last_type) &&
 			     (p_nxt[l0] != next_index))) {
 			/* Copy things successfully speculated till now */
@@ -220,6 +273,8 @@ struct rte_node_register pkt_cls_node = {
 		/* Pkt drop node starts at '0' */
 		[PKT_CLS_NEXT_PKT_DROP] = "pkt_drop",
 		[PKT_CLS_NEXT_IP4_LOOKUP] = "ip4_lookup",
+		[PKT_CLS_NEXT_IP6_LOOKUP] = "ip6_lookup",
+		[PKT_CLS_NEXT_IP4_REASSEMBLY] = "ip4_reassembly",
 	},
 };
 RTE_NODE_REGISTER(pkt_cls_node);
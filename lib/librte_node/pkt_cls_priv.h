@@ -10,6 +10,9 @@ extern "C" {
 
 #include <rte_common.h>
 
+/* Set above the l2l3 type of the fragments, see pkt_cls_type() */
+#define PKT_CLS_FRAG (1 << 8)
+
 struct pkt_cls_node_ctx {
 	uint16_t l2l3_type;
 };
@@ -17,6 +20,8 @@ struct pkt_cls_node_ctx {
 enum pkt_cls_next_nodes {
 	PKT_CLS_NEXT_PKT_DROP,
 	PKT_CLS_NEXT_IP4_LOOKUP,
+	PKT_CLS_NEXT_IP6_LOOKUP,
+	PKT_CLS_NEXT_IP4_REASSEMBLY,
 	PKT_CLS_NEXT_MAX,
 };
 
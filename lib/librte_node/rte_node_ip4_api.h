@@ -13,7 +13,7 @@
  * All functions in this file may be changed or removed without prior notice.
  *
  * This API allows to do control path functions of ip4_* nodes
- * like ip4_lookup, ip4_rewrite.
+ * like ip4_lookup, ip4_rewrite, ip4_reassembly.
  *
  */
 #ifdef __cplusplus
@@ -73,6 +73,24 @@ __rte_experimental
 int rte_node_ip4_rewrite_add(uint16_t next_hop, uint8_t *rewrite_data,
 			     uint8_t rewrite_len, uint16_t dst_port);
 
+/**
+ * Configure the fragment tables of the ip4_reassembly nodes.
+ *
+ * Each graph gets its own table when created, so that a change only
+ * applies to the graphs created after it.
+ *
+ * @param max_flows
+ *   Maximum number of packets being reassembled at once.
+ * @param flow_ttl_ms
+ *   Time in milliseconds to wait for all the fragments of a packet.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ip4_reassembly_configure(uint32_t max_flows,
+				      uint32_t flow_ttl_ms);
+
 #ifdef __cplusplus
 }
 #endif
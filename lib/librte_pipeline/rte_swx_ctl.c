@@ -326,6 +326,9 @@ table_entry_duplicate(struct rte_swx_ctl_pipeline *ctl,
 		/* key_signature. */
 		new_entry->key_signature = entry->key_signature;
 
+		/* key_priority. */
+		new_entry->key_priority = entry->key_priority;
+
 		/* key_mask. */
 		if (table->params.match_type != RTE_SWX_TABLE_MATCH_EXACT) {
 			if (!entry->key_mask)
@@ -393,23 +396,29 @@ entry_keycmp_em(struct rte_swx_table_entry *e0,
 }
 
 static int
-entry_keycmp_wm(struct rte_swx_table_entry *e0 __rte_unused,
-		struct rte_swx_table_entry *e1 __rte_unused,
-		uint32_t key_size __rte_unused)
+entry_keycmp_wm(struct rte_swx_table_entry *e0,
+		struct rte_swx_table_entry *e1,
+		uint32_t key_size)
 {
-	/* TBD */
+	uint32_t i;
+
+	if (memcmp(e0->key_mask, e1->key_mask, key_size))
+		return 1; /* Not equal. */
+
+	for (i = 0; i < key_size; i++)
+		if ((e0->key[i] ^ e1->key[i]) & e0->key_mask[i])
+			return 1; /* Not equal. */
 
-	return 1; /* Not equal */
+	return 0; /* Equal */
 }
 
 static int
-entry_keycmp_lpm(struct rte_swx_table_entry *e0 __rte_unused,
-		 struct rte_swx_table_entry *e1 __rte_unused,
-		 uint32_t key_size __rte_unused)
+entry_keycmp_lpm(struct rte_swx_table_entry *e0,
+		 struct rte_swx_table_entry *e1,
+		 uint32_t key_size)
 {
-	/* TBD */
-
-	return 1; /* Not equal */
+	/* The prefix is the key mask. */
+	return entry_keycmp_wm(e0, e1, key_size);
 }
 
 static int
@@ -1341,7 +1350,7 @@ rte_swx_ctl_pipeline_table_entry_read(struct rte_swx_ctl_pipeline *ctl,
 	struct action *action;
 	struct rte_swx_table_entry *entry = NULL;
 	char *s0 = NULL, *s;
-	uint32_t n_tokens = 0, arg_offset = 0, i;
+	uint32_t n_tokens = 0, arg_offset = 0, action_pos, i;
 
 	/* Check input arguments. */
 	if (!ctl)
@@ -1382,16 +1391,33 @@ rte_swx_ctl_pipeline_table_entry_read(struct rte_swx_ctl_pipeline *ctl,
 	}
 
 	if ((n_tokens < 3 + table->info.n_match_fields) ||
-	    strcmp(tokens[0], "match") ||
-	    strcmp(tokens[1 + table->info.n_match_fields], "action"))
+	    strcmp(tokens[0], "match"))
+		goto error;
+
+	/* The priority is only accepted by the wildcard match tables. */
+	action_pos = 1 + table->info.n_match_fields;
+	if (!strcmp(tokens[action_pos], "priority")) {
+		char *priority = tokens[action_pos + 1];
+
+		if (table->params.match_type != RTE_SWX_TABLE_MATCH_WILDCARD)
+			goto error;
+
+		entry->key_priority = strtoul(priority, &priority, 0);
+		if (priority[0])
+			goto error;
+
+		action_pos += 2;
+	}
+
+	if ((n_tokens < action_pos + 2) ||
+	    strcmp(tokens[action_pos], "action"))
 		goto error;
 
-	action = action_find(ctl, tokens[2 + table->info.n_match_fields]);
+	action = action_find(ctl, tokens[action_pos + 1]);
 	if (!action)
 		goto error;
 
-	if (n_tokens != 3 + table->info.n_match_fields +
-	    action->info.n_args * 2)
+	if (n_tokens != action_pos + 2 + action->info.n_args * 2)
 		goto error;
 
 	/*
@@ -1399,23 +1425,45 @@ rte_swx_ctl_pipeline_table_entry_read(struct rte_swx_ctl_pipeline *ctl,
 	 */
 	for (i = 0; i < table->info.n_match_fields; i++) {
 		struct rte_swx_ctl_table_match_field_info *mf = &table->mf[i];
-		char *mf_val = tokens[1 + i];
-		uint64_t val;
+		uint32_t offset = (mf->offset - table->mf[0].offset) / 8;
+		char *mf_val = tokens[1 + i], *mf_mask;
+		uint64_t val, mask = UINT64_MAX;
+
+		/* The optional "/MASK" suffix, with all the field bits part of
+		 * the key when not present.
+		 */
+		mf_mask = strchr(mf_val, '/');
+		if (mf_mask) {
+			*mf_mask = 0;
+			mf_mask++;
+
+			if (!entry->key_mask)
+				goto error;
+
+			mask = strtoull(mf_mask, &mf_mask, 0);
+			if (mf_mask[0])
+				goto error;
+		}
 
 		val = strtoull(mf_val, &mf_val, 0);
 		if (mf_val[0])
 			goto error;
 
 		/* Endianness conversion. */
-		if (mf->is_header)
+		if (mf->is_header) {
 			val = field_hton(val, mf->n_bits);
+			mask = field_hton(mask, mf->n_bits);
+		}
 
 		/* Copy key and key_mask to entry. */
-		memcpy(&entry->key[(mf->offset - table->mf[0].offset) / 8],
+		memcpy(&entry->key[offset],
 		       (uint8_t *)&val,
 		       mf->n_bits / 8);
 
-		/* TBD Set entry->key_mask for wildcard and LPM tables. */
+		if (entry->key_mask)
+			memcpy(&entry->key_mask[offset],
+			       (uint8_t *)&mask,
+			       mf->n_bits / 8);
 	}
 
 	/*
@@ -1431,8 +1479,8 @@ rte_swx_ctl_pipeline_table_entry_read(struct rte_swx_ctl_pipeline *ctl,
 		uint64_t val;
 		int is_nbo = 0;
 
-		arg_name = tokens[3 + table->info.n_match_fields + i * 2];
-		arg_val = tokens[3 + table->info.n_match_fields + i * 2 + 1];
+		arg_name = tokens[action_pos + 2 + i * 2];
+		arg_val = tokens[action_pos + 2 + i * 2 + 1];
 
 		if (strcmp(arg_name, arg->name) ||
 		    (strlen(arg_val) < 4) ||
@@ -1472,6 +1520,35 @@ rte_swx_ctl_pipeline_table_entry_read(struct rte_swx_ctl_pipeline *ctl,
 	return NULL;
 }
 
+static void
+table_entry_fprintf(FILE *f,
+		    struct rte_swx_ctl_pipeline *ctl,
+		    struct table *table,
+		    struct rte_swx_table_entry *entry)
+{
+	struct action *action = &ctl->actions[entry->action_id];
+	uint32_t i;
+
+	fprintf(f, "match ");
+	for (i = 0; i < table->params.key_size; i++)
+		fprintf(f, "%02x", entry->key[i]);
+
+	if (entry->key_mask) {
+		fprintf(f, "/");
+		for (i = 0; i < table->params.key_size; i++)
+			fprintf(f, "%02x", entry->key_mask[i]);
+	}
+
+	if (table->params.match_type == RTE_SWX_TABLE_MATCH_WILDCARD)
+		fprintf(f, " priority %u", entry->key_priority);
+
+	fprintf(f, " action %s ", action->info.name);
+	for (i = 0; i < action->data_size; i++)
+		fprintf(f, "%02x", entry->action_data[i]);
+
+	fprintf(f, "\n");
+}
+
 int
 rte_swx_ctl_pipeline_table_fprintf(FILE *f,
 				   struct rte_swx_ctl_pipeline *ctl,
@@ -1502,47 +1579,17 @@ rte_swx_ctl_pipeline_table_fprintf(FILE *f,
 
 	/* Table entries. */
 	TAILQ_FOREACH(entry, &table->entries, node) {
-		struct action *action = &ctl->actions[entry->action_id];
-
-		fprintf(f, "match ");
-		for (i = 0; i < table->params.key_size; i++)
-			fprintf(f, "%02x", entry->key[i]);
-
-		fprintf(f, " action %s ", action->info.name);
-		for (i = 0; i < action->data_size; i++)
-			fprintf(f, "%02x", entry->action_data[i]);
-
-		fprintf(f, "\n");
+		table_entry_fprintf(f, ctl, table, entry);
 		n_entries++;
 	}
 
 	TAILQ_FOREACH(entry, &table->pending_modify0, node) {
-		struct action *action = &ctl->actions[entry->action_id];
-
-		fprintf(f, "match ");
-		for (i = 0; i < table->params.key_size; i++)
-			fprintf(f, "%02x", entry->key[i]);
-
-		fprintf(f, " action %s ", action->info.name);
-		for (i = 0; i < action->data_size; i++)
-			fprintf(f, "%02x", entry->action_data[i]);
-
-		fprintf(f, "\n");
+		table_entry_fprintf(f, ctl, table, entry);
 		n_entries++;
 	}
 
 	TAILQ_FOREACH(entry, &table->pending_delete, node) {
-		struct action *action = &ctl->actions[entry->action_id];
-
-		fprintf(f, "match ");
-		for (i = 0; i < table->params.key_size; i++)
-			fprintf(f, "%02x", entry->key[i]);
-
-		fprintf(f, " action %s ", action->info.name);
-		for (i = 0; i < action->data_size; i++)
-			fprintf(f, "%02x", entry->action_data[i]);
-
-		fprintf(f, "\n");
+		table_entry_fprintf(f, ctl, table, entry);
 		n_entries++;
 	}
 
@@ -515,6 +515,13 @@ rte_swx_ctl_pipeline_abort(struct rte_swx_ctl_pipeline *ctl);
  *
  * Read table entry from string.
  *
+ * The string format is: "match VAL[/MASK] ... [priority PRIO] action NAME
+ * ARG_NAME H(ARG_VAL)|N(ARG_VAL) ...", with one VAL[/MASK] per table match
+ * field. The field MASK is only allowed for the wildcard match and LPM tables,
+ * with all the field bits being part of the key when it is not present. The
+ * entry priority is only allowed for the wildcard match tables and defaults
+ * to 0, i.e. the highest priority.
+ *
  * @param[in] ctl
  *   Pipeline control handle.
  * @param[in] table_name
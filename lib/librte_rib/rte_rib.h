@@ -22,6 +22,7 @@
 #include <stdint.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,6 +53,33 @@ struct rte_rib_conf {
 	int	max_nodes;
 };
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_RIB_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_rib_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_RIB_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_RIB_QSBR_MODE_SYNC
+};
+
+/** RIB RCU QSBR configuration structure. */
+struct rte_rib_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_RIB_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_rib_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: max_nodes.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_RIB_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Get an IPv4 mask from prefix length
  * It is caller responsibility to make sure depth is not bigger than 32
@@ -289,6 +317,34 @@ __rte_experimental
 void
 rte_rib_free(struct rte_rib *rib);
 
+/**
+ * Associate RCU QSBR variable with a RIB object.
+ *
+ * Once associated, the nodes unlinked by rte_rib_remove() are only given
+ * back to the node pool after the readers registered with the QSBR
+ * variable went through a quiescent state. rte_rib_lookup(),
+ * rte_rib_get_nxt() and the other functions not modifying the tree can
+ * then run without locking concurrently with a single writer calling
+ * rte_rib_insert() and rte_rib_remove(). A node returned to a reader stays
+ * readable until the reader reports a quiescent state. Routes inserted
+ * or removed during a rte_rib_get_nxt() walk may be missed or returned
+ * more than once.
+ *
+ * @param rib
+ *   the RIB object to add RCU QSBR
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -1 on failure with rte_errno indicating reason for failure.
+ *   - EINVAL - invalid pointer
+ *   - EEXIST - already added QSBR
+ *   - ENOMEM - memory allocation failure
+ */
+__rte_experimental
+int
+rte_rib_rcu_qsbr_add(struct rte_rib *rib, struct rte_rib_rcu_config *cfg);
+
 #ifdef __cplusplus
 }
 #endif
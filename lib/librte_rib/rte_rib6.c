@@ -45,19 +45,17 @@ struct rte_rib6 {
 	struct rte_mempool	*node_pool;
 	uint32_t		cur_nodes;
 	uint32_t		cur_routes;
+	struct rte_rcu_qsbr	*v;	/* RCU QSBR variable */
+	enum rte_rib6_qsbr_mode	rcu_mode; /* Blocking, defer queue */
+	struct rte_rcu_qsbr_dq	*dq;	/* RCU QSBR defer queue */
 	int			max_nodes;
 };
 
 static inline bool
 is_valid_node(struct rte_rib6_node *node)
 {
-	return (node->flag & RTE_RIB_VALID_NODE) == RTE_RIB_VALID_NODE;
-}
-
-static inline bool
-is_right_node(struct rte_rib6_node *node)
-{
-	return node->parent->right == node;
+	return (__atomic_load_n(&node->flag, __ATOMIC_RELAXED) &
+		RTE_RIB_VALID_NODE) == RTE_RIB_VALID_NODE;
 }
 
 /*
@@ -93,7 +91,8 @@ static inline struct rte_rib6_node *
 get_nxt_node(struct rte_rib6_node *node,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
 {
-	return (get_dir(ip, node->depth)) ? node->right : node->left;
+	return __atomic_load_n((get_dir(ip, node->depth)) ?
+		&node->right : &node->left, __ATOMIC_ACQUIRE);
 }
 
 static struct rte_rib6_node *
@@ -103,6 +102,12 @@ node_alloc(struct rte_rib6 *rib)
 	int ret;
 
 	ret = rte_mempool_get(rib->node_pool, (void *)&ent);
+	if (unlikely(ret != 0) && (rib->dq != NULL)) {
+		/* reuse the nodes readers are done with */
+		rte_rcu_qsbr_dq_reclaim(rib->dq, rib->max_nodes,
+			NULL, NULL, NULL);
+		ret = rte_mempool_get(rib->node_pool, (void *)&ent);
+	}
 	if (unlikely(ret != 0))
 		return NULL;
 	++rib->cur_nodes;
@@ -116,6 +121,92 @@ node_free(struct rte_rib6 *rib, struct rte_rib6_node *ent)
 	rte_mempool_put(rib->node_pool, ent);
 }
 
+static void
+__rib_rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct rte_rib6 *rib = p;
+
+	RTE_SET_USED(n);
+	rte_mempool_put(rib->node_pool, *(struct rte_rib6_node **)data);
+}
+
+/*
+ * Free nodes unlinked from the tree. With RCU, concurrent readers may
+ * still hold them, so they go back to the pool after a grace period.
+ */
+static void
+nodes_retire(struct rte_rib6 *rib, struct rte_rib6_node **ent,
+	unsigned int n)
+{
+	unsigned int i;
+
+	rib->cur_nodes -= n;
+	if ((rib->v != NULL) && (rib->rcu_mode == RTE_RIB6_QSBR_MODE_DQ)) {
+		for (i = 0; i < n; i++) {
+			if (rte_rcu_qsbr_dq_enqueue(rib->dq, &ent[i]) != 0)
+				break;
+		}
+		ent += i;
+		n -= i;
+		if (n == 0)
+			return;
+		/* defer queue is full, wait for the readers instead */
+	}
+	if (rib->v != NULL)
+		rte_rcu_qsbr_synchronize(rib->v, RTE_QSBR_THRID_INVALID);
+	rte_mempool_put_bulk(rib->node_pool, (void **)ent, n);
+}
+
+int
+rte_rib6_rcu_qsbr_add(struct rte_rib6 *rib, struct rte_rib6_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if ((rib == NULL) || (cfg == NULL) || (cfg->v == NULL)) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	if (rib->v != NULL) {
+		rte_errno = EEXIST;
+		return -1;
+	}
+
+	if (cfg->mode == RTE_RIB6_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_RIB6_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"RIB6_RCU_%s", rib->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = rib->max_nodes;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_RIB6_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(struct rte_rib6_node *);
+		params.free_fn = __rib_rcu_qsbr_free_resource;
+		params.p = rib;
+		params.v = cfg->v;
+		rib->dq = rte_rcu_qsbr_dq_create(&params);
+		if (rib->dq == NULL) {
+			RTE_LOG(ERR, LPM, "RIB6 defer queue creation failed\n");
+			rte_errno = ENOMEM;
+			return -1;
+		}
+	} else {
+		rte_errno = EINVAL;
+		return -1;
+	}
+	rib->rcu_mode = cfg->mode;
+	rib->v = cfg->v;
+
+	return 0;
+}
+
 struct rte_rib6_node *
 rte_rib6_lookup(struct rte_rib6 *rib,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
@@ -127,7 +218,7 @@ rte_rib6_lookup(struct rte_rib6 *rib,
 		rte_errno = EINVAL;
 		return NULL;
 	}
-	cur = rib->tree;
+	cur = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 
 	while ((cur != NULL) && is_covered(ip, cur->ip, cur->depth)) {
 		if (is_valid_node(cur))
@@ -145,9 +236,9 @@ rte_rib6_lookup_parent(struct rte_rib6_node *ent)
 	if (ent == NULL)
 		return NULL;
 
-	tmp = ent->parent;
+	tmp = __atomic_load_n(&ent->parent, __ATOMIC_ACQUIRE);
 	while ((tmp != NULL) && (!is_valid_node(tmp)))
-		tmp = tmp->parent;
+		tmp = __atomic_load_n(&tmp->parent, __ATOMIC_ACQUIRE);
 
 	return tmp;
 }
@@ -164,7 +255,7 @@ rte_rib6_lookup_exact(struct rte_rib6 *rib,
 		rte_errno = EINVAL;
 		return NULL;
 	}
-	cur = rib->tree;
+	cur = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 
 	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
 		tmp_ip[i] = ip[i] & get_msk_part(depth, i);
@@ -196,6 +287,7 @@ rte_rib6_get_nxt(struct rte_rib6 *rib,
 	uint8_t depth, struct rte_rib6_node *last, int flag)
 {
 	struct rte_rib6_node *tmp, *prev = NULL;
+	struct rte_rib6_node *parent, *right = NULL, *left;
 	uint8_t tmp_ip[RTE_RIB6_IPV6_ADDR_SIZE];
 	int i;
 
@@ -208,20 +300,28 @@ rte_rib6_get_nxt(struct rte_rib6 *rib,
 		tmp_ip[i] = ip[i] & get_msk_part(depth, i);
 
 	if (last == NULL) {
-		tmp = rib->tree;
+		tmp = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 		while ((tmp) && (tmp->depth < depth))
 			tmp = get_nxt_node(tmp, tmp_ip);
 	} else {
 		tmp = last;
-		while ((tmp->parent != NULL) && (is_right_node(tmp) ||
-				(tmp->parent->right == NULL))) {
-			tmp = tmp->parent;
+		/*
+		 * Links are read once, as a concurrent writer may
+		 * change them under RCU protection
+		 */
+		while ((parent = __atomic_load_n(&tmp->parent,
+				__ATOMIC_ACQUIRE)) != NULL) {
+			right = __atomic_load_n(&parent->right,
+				__ATOMIC_ACQUIRE);
+			if ((right != tmp) && (right != NULL))
+				break;
+			tmp = parent;
 			if (is_valid_node(tmp) &&
 					(is_covered(tmp->ip, tmp_ip, depth) &&
 					(tmp->depth > depth)))
 				return tmp;
 		}
-		tmp = (tmp->parent != NULL) ? tmp->parent->right : NULL;
+		tmp = (parent != NULL) ? right : NULL;
 	}
 	while (tmp) {
 		if (is_valid_node(tmp) &&
@@ -231,7 +331,9 @@ rte_rib6_get_nxt(struct rte_rib6 *rib,
 			if (flag == RTE_RIB6_GET_NXT_COVER)
 				return prev;
 		}
-		tmp = (tmp->left != NULL) ? tmp->left : tmp->right;
+		left = __atomic_load_n(&tmp->left, __ATOMIC_ACQUIRE);
+		tmp = (left != NULL) ? left :
+			__atomic_load_n(&tmp->right, __ATOMIC_ACQUIRE);
 	}
 	return prev;
 }
@@ -240,33 +342,43 @@ void
 rte_rib6_remove(struct rte_rib6 *rib,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth)
 {
-	struct rte_rib6_node *cur, *prev, *child;
+	struct rte_rib6_node *cur, *child;
+	struct rte_rib6_node *unlinked[RIB6_MAXDEPTH + 1];
+	unsigned int n = 0;
 
 	cur = rte_rib6_lookup_exact(rib, ip, depth);
 	if (cur == NULL)
 		return;
 
 	--rib->cur_routes;
-	cur->flag &= ~RTE_RIB_VALID_NODE;
+	__atomic_store_n(&cur->flag, cur->flag & ~RTE_RIB_VALID_NODE,
+		__ATOMIC_RELAXED);
+	/*
+	 * Unlinked nodes keep their links, so that concurrent readers
+	 * standing on them can go on walking the tree
+	 */
 	while (!is_valid_node(cur)) {
 		if ((cur->left != NULL) && (cur->right != NULL))
-			return;
+			break;
 		child = (cur->left == NULL) ? cur->right : cur->left;
 		if (child != NULL)
-			child->parent = cur->parent;
+			__atomic_store_n(&child->parent, cur->parent,
+				__ATOMIC_RELEASE);
+		unlinked[n++] = cur;
 		if (cur->parent == NULL) {
-			rib->tree = child;
-			node_free(rib, cur);
-			return;
+			__atomic_store_n(&rib->tree, child, __ATOMIC_RELEASE);
+			break;
 		}
 		if (cur->parent->left == cur)
-			cur->parent->left = child;
+			__atomic_store_n(&cur->parent->left, child,
+				__ATOMIC_RELEASE);
 		else
-			cur->parent->right = child;
-		prev = cur;
+			__atomic_store_n(&cur->parent->right, child,
+				__ATOMIC_RELEASE);
 		cur = cur->parent;
-		node_free(rib, prev);
 	}
+	if (n != 0)
+		nodes_retire(rib, unlinked, n);
 }
 
 struct rte_rib6_node *
@@ -310,13 +422,14 @@ rte_rib6_insert(struct rte_rib6 *rib,
 	rte_rib6_copy_addr(new_node->ip, tmp_ip);
 	new_node->depth = depth;
 	new_node->flag = RTE_RIB_VALID_NODE;
+	new_node->nh = 0;
 
 	/* traverse down the tree to find matching node or closest matching */
 	while (1) {
 		/* insert as the last node in the branch */
 		if (*tmp == NULL) {
-			*tmp = new_node;
 			new_node->parent = prev;
+			__atomic_store_n(tmp, new_node, __ATOMIC_RELEASE);
 			++rib->cur_routes;
 			return *tmp;
 		}
@@ -329,7 +442,9 @@ rte_rib6_insert(struct rte_rib6 *rib,
 		if (rte_rib6_is_equal(tmp_ip, (*tmp)->ip) &&
 				(depth == (*tmp)->depth)) {
 			node_free(rib, new_node);
-			(*tmp)->flag |= RTE_RIB_VALID_NODE;
+			__atomic_store_n(&(*tmp)->flag,
+				(*tmp)->flag | RTE_RIB_VALID_NODE,
+				__ATOMIC_RELAXED);
 			++rib->cur_routes;
 			return *tmp;
 		}
@@ -369,8 +484,8 @@ rte_rib6_insert(struct rte_rib6 *rib,
 		else
 			new_node->left = *tmp;
 		new_node->parent = (*tmp)->parent;
-		(*tmp)->parent = new_node;
-		*tmp = new_node;
+		__atomic_store_n(&(*tmp)->parent, new_node, __ATOMIC_RELEASE);
+		__atomic_store_n(tmp, new_node, __ATOMIC_RELEASE);
 	} else {
 		/* create intermediate node */
 		common_node = node_alloc(rib);
@@ -384,7 +499,6 @@ rte_rib6_insert(struct rte_rib6 *rib,
 		common_node->flag = 0;
 		common_node->parent = (*tmp)->parent;
 		new_node->parent = common_node;
-		(*tmp)->parent = common_node;
 		if (get_dir((*tmp)->ip, common_depth) == 1) {
 			common_node->left = new_node;
 			common_node->right = *tmp;
@@ -392,7 +506,9 @@ rte_rib6_insert(struct rte_rib6 *rib,
 			common_node->left = *tmp;
 			common_node->right = new_node;
 		}
-		*tmp = common_node;
+		__atomic_store_n(&(*tmp)->parent, common_node,
+			__ATOMIC_RELEASE);
+		__atomic_store_n(tmp, common_node, __ATOMIC_RELEASE);
 	}
 	++rib->cur_routes;
 	return new_node;
@@ -434,7 +550,7 @@ rte_rib6_get_nh(const struct rte_rib6_node *node, uint64_t *nh)
 		rte_errno = EINVAL;
 		return -1;
 	}
-	*nh = node->nh;
+	*nh = __atomic_load_n(&node->nh, __ATOMIC_RELAXED);
 	return 0;
 }
 
@@ -445,7 +561,7 @@ rte_rib6_set_nh(struct rte_rib6_node *node, uint64_t nh)
 		rte_errno = EINVAL;
 		return -1;
 	}
-	node->nh = nh;
+	__atomic_store_n(&node->nh, nh, __ATOMIC_RELAXED);
 	return 0;
 }
 
@@ -592,6 +708,8 @@ rte_rib6_free(struct rte_rib6 *rib)
 			RTE_RIB6_GET_NXT_ALL)) != NULL)
 		rte_rib6_remove(rib, tmp->ip, tmp->depth);
 
+	if (rib->dq != NULL)
+		rte_rcu_qsbr_dq_delete(rib->dq);
 	rte_mempool_free(rib->node_pool);
 
 	rte_free(rib);
@@ -45,7 +45,8 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 /* mask of all valid flag values to ring_create() */
 #define RING_F_MASK (RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ | \
 		     RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ |	       \
-		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ)
+		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ |	       \
+		     RING_F_MPSC_FAA)
 
 /* true if x is a power of 2 */
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
@@ -87,6 +88,20 @@ rte_ring_get_memsize(unsigned int count)
 	return rte_ring_get_memsize_elem(sizeof(void *), count);
 }
 
+/*
+ * internal helper function to reset the slot sequences of a MPSC FAA ring:
+ * each slot is free for the producer at its own position.
+ */
+static void
+reset_faa_seq(struct rte_ring *r)
+{
+	uint32_t i, *seq;
+
+	seq = __rte_ring_faa_seq(r);
+	for (i = 0; i != r->size; i++)
+		seq[i] = i;
+}
+
 /*
  * internal helper function to reset prod/cons head-tail values.
  */
@@ -104,6 +119,7 @@ reset_headtail(void *p)
 	switch (ht->sync_type) {
 	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_ST:
+	case RTE_RING_SYNC_MPSC_FAA:
 		ht->head = 0;
 		ht->tail = 0;
 		break;
@@ -125,6 +141,8 @@ rte_ring_reset(struct rte_ring *r)
 {
 	reset_headtail(&r->prod);
 	reset_headtail(&r->cons);
+	if (r->prod.sync_type == RTE_RING_SYNC_MPSC_FAA)
+		reset_faa_seq(r);
 }
 
 /*
@@ -141,6 +159,15 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	static const uint32_t cons_st_flags =
 		(RING_F_SC_DEQ | RING_F_MC_RTS_DEQ | RING_F_MC_HTS_DEQ);
 
+	/* MPSC FAA sets both the producer and the consumer modes */
+	if (flags & RING_F_MPSC_FAA) {
+		if (flags & (prod_st_flags | cons_st_flags))
+			return -EINVAL;
+		*prod_st = RTE_RING_SYNC_MPSC_FAA;
+		*cons_st = RTE_RING_SYNC_MPSC_FAA;
+		return 0;
+	}
+
 	switch (flags & prod_st_flags) {
 	case 0:
 		*prod_st = RTE_RING_SYNC_MT;
@@ -178,8 +205,8 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	return 0;
 }
 
-int
-rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
+static int
+ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	unsigned int flags)
 {
 	int ret;
@@ -202,6 +229,11 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
 		offsetof(struct rte_ring_rts_headtail, tail.val.pos));
 
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, sync_type) !=
+		offsetof(struct rte_ring_faa_headtail, sync_type));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
+		offsetof(struct rte_ring_faa_headtail, tail));
+
 	/* future proof flags, only allow supported values */
 	if (flags & ~RING_F_MASK) {
 		RTE_LOG(ERR, RING,
@@ -244,6 +276,20 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	return 0;
 }
 
+int
+rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
+	unsigned int flags)
+{
+	/* the slot sequences are not part of rte_ring_get_memsize() */
+	if (flags & RING_F_MPSC_FAA) {
+		RTE_LOG(ERR, RING,
+			"MPSC FAA ring must be created with rte_ring_create()\n");
+		return -EINVAL;
+	}
+
+	return ring_init(r, name, count, flags);
+}
+
 /* create the ring for a given element size */
 struct rte_ring *
 rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
@@ -271,6 +317,11 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 		return NULL;
 	}
 
+	/* MPSC FAA ring keeps a sequence number per slot after the elements */
+	if (flags & RING_F_MPSC_FAA)
+		ring_size += RTE_ALIGN(count * sizeof(uint32_t),
+			RTE_CACHE_LINE_SIZE);
+
 	ret = snprintf(mz_name, sizeof(mz_name), "%s%s",
 		RTE_RING_MZ_PREFIX, name);
 	if (ret < 0 || ret >= (int)sizeof(mz_name)) {
@@ -296,7 +347,12 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 		r = mz->addr;
 		/* no need to check return value here, we already checked the
 		 * arguments above */
-		rte_ring_init(r, name, requested_count, flags);
+		ring_init(r, name, requested_count, flags);
+		if (flags & RING_F_MPSC_FAA) {
+			r->faa_prod.esize = esize;
+			r->faa_cons.esize = esize;
+			reset_faa_seq(r);
+		}
 
 		te->data = (void *) r;
 		r->memzone = mz;
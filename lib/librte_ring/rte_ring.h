@@ -107,6 +107,8 @@ ssize_t rte_ring_get_memsize(unsigned int count);
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   RING_F_MPSC_FAA is not supported, as the ring of that mode needs more
+ *   memory than rte_ring_get_memsize(): use rte_ring_create() instead.
  * @return
  *   0 on success, or a negative value on error.
  */
@@ -160,6 +162,10 @@ int rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   - RING_F_MPSC_FAA: If this flag is set, the default behavior when
+ *     using ``rte_ring_enqueue()`` or ``rte_ring_dequeue()`` is
+ *     "multi-producer fetch-and-add, single-consumer" (MPSC FAA mode).
+ *     It cannot be combined with the producer and consumer flags above.
  * @return
  *   On success, the pointer to the new allocated ring. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
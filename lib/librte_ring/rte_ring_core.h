@@ -60,6 +60,7 @@ enum rte_ring_sync_type {
 #ifdef ALLOW_EXPERIMENTAL_API
 	RTE_RING_SYNC_MT_RTS, /**< multi-thread relaxed tail sync */
 	RTE_RING_SYNC_MT_HTS, /**< multi-thread head/tail sync */
+	RTE_RING_SYNC_MPSC_FAA, /**< MP fetch-and-add, single consumer */
 #endif
 };
 
@@ -110,6 +111,13 @@ struct rte_ring_hts_headtail {
 	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
 };
 
+struct rte_ring_faa_headtail {
+	volatile uint32_t head;      /**< prod/consumer head. */
+	volatile uint32_t tail;      /**< completed enqueues/dequeues. */
+	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
+	uint32_t esize;     /**< element size, to locate the slot sequences */
+};
+
 /**
  * An RTE ring structure.
  *
@@ -143,6 +151,7 @@ struct rte_ring {
 		struct rte_ring_headtail prod;
 		struct rte_ring_hts_headtail hts_prod;
 		struct rte_ring_rts_headtail rts_prod;
+		struct rte_ring_faa_headtail faa_prod;
 	}  __rte_cache_aligned;
 
 	char pad1 __rte_cache_aligned; /**< empty cache line */
@@ -153,6 +162,7 @@ struct rte_ring {
 		struct rte_ring_headtail cons;
 		struct rte_ring_hts_headtail hts_cons;
 		struct rte_ring_rts_headtail rts_cons;
+		struct rte_ring_faa_headtail faa_cons;
 	}  __rte_cache_aligned;
 
 	char pad2 __rte_cache_aligned; /**< empty cache line */
@@ -177,6 +187,13 @@ struct rte_ring {
 #define RING_F_MP_HTS_ENQ 0x0020 /**< The default enqueue is "MP HTS". */
 #define RING_F_MC_HTS_DEQ 0x0040 /**< The default dequeue is "MC HTS". */
 
+/**
+ * The ring is multi-producer fetch-and-add, single-consumer ("MPSC FAA").
+ * It sets both the enqueue and the dequeue behavior, and cannot be combined
+ * with the other producer/consumer flags.
+ */
+#define RING_F_MPSC_FAA 0x0080
+
 #ifdef __cplusplus
 }
 #endif
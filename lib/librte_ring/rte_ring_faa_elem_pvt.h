@@ -0,0 +1,188 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_RING_FAA_ELEM_PVT_H_
+#define _RTE_RING_FAA_ELEM_PVT_H_
+
+/**
+ * @file rte_ring_faa_elem_pvt.h
+ * It is not recommended to include this file directly,
+ * include <rte_ring.h> instead.
+ * Contains internal helper functions for MPSC fetch-and-add (FAA) ring mode.
+ * For more information please refer to <rte_ring_faa.h>.
+ */
+
+/**
+ * @internal returns the slot sequence array, stored after the elements.
+ */
+static __rte_always_inline uint32_t *
+__rte_ring_faa_seq(struct rte_ring *r)
+{
+	return (uint32_t *)((uintptr_t)&r[1] +
+		(size_t)r->size * r->faa_prod.esize);
+}
+
+/**
+ * @internal This function reserves the producer slots for enqueue.
+ * The free space is checked before the fetch-and-add, so the head can
+ * only overshoot the free space when several producers race for the last
+ * slots: the extra producers then wait for the consumer in
+ * __rte_ring_faa_slot_wait().
+ */
+static __rte_always_inline unsigned int
+__rte_ring_faa_move_prod_head(struct rte_ring *r, unsigned int num,
+	enum rte_ring_queue_behavior behavior, uint32_t *old_head,
+	uint32_t *free_entries)
+{
+	uint32_t n, head;
+	int32_t free;
+
+	head = __atomic_load_n(&r->faa_prod.head, __ATOMIC_RELAXED);
+	free = (int32_t)(r->capacity + __atomic_load_n(&r->faa_cons.tail,
+			__ATOMIC_ACQUIRE) - head);
+	*free_entries = (free > 0) ? (uint32_t)free : 0;
+
+	n = num;
+	if (unlikely(n > *free_entries))
+		n = (behavior == RTE_RING_QUEUE_FIXED) ? 0 : *free_entries;
+
+	if (n != 0)
+		*old_head = __atomic_fetch_add(&r->faa_prod.head, n,
+				__ATOMIC_RELAXED);
+	return n;
+}
+
+/**
+ * @internal waits till the slot for position *pos* is released by the
+ * consumer. It is only spinning when the producer head went past the
+ * free space.
+ */
+static __rte_always_inline void
+__rte_ring_faa_slot_wait(const uint32_t *seq, uint32_t pos)
+{
+	while (__atomic_load_n(seq, __ATOMIC_ACQUIRE) != pos)
+		rte_pause();
+}
+
+/**
+ * @internal Enqueue several objects on the MPSC FAA ring.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Enqueue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Enqueue as many items as possible from ring
+ * @param free_space
+ *   returns the amount of space after the enqueue operation has finished
+ * @return
+ *   Actual number of objects enqueued.
+ *   If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_faa_enqueue_elem(struct rte_ring *r, const void *obj_table,
+	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
+	uint32_t *free_space)
+{
+	uint32_t free, head, i, *seq;
+
+	n = __rte_ring_faa_move_prod_head(r, n, behavior, &head, &free);
+
+	if (n != 0) {
+		seq = __rte_ring_faa_seq(r);
+		for (i = 0; i != n; i++)
+			__rte_ring_faa_slot_wait(&seq[(head + i) & r->mask],
+				head + i);
+
+		__rte_ring_enqueue_elems(r, head, obj_table, esize, n);
+
+		/*
+		 * count the objects before publishing them, so that the
+		 * consumer never sees more objects than the count.
+		 */
+		__atomic_fetch_add(&r->faa_prod.tail, n, __ATOMIC_RELAXED);
+
+		/* publish the slots, the consumer waits for pos + 1 */
+		for (i = 0; i != n; i++)
+			__atomic_store_n(&seq[(head + i) & r->mask],
+				head + i + 1, __ATOMIC_RELEASE);
+	}
+
+	if (free_space != NULL)
+		*free_space = (free > n) ? free - n : 0;
+	return n;
+}
+
+/**
+ * @internal Dequeue several objects from the MPSC FAA ring.
+ * The objects are taken up to the first slot not yet published, as the
+ * producers may complete out of order.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring. Otherwise
+ *   the results are undefined.
+ * @param n
+ *   The number of objects to pull from the ring.
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Dequeue a fixed number of items from a ring
+ *   RTE_RING_QUEUE_VARIABLE: Dequeue as many items as possible from ring
+ * @param available
+ *   returns the number of remaining ring entries after the dequeue has finished
+ * @return
+ *   - Actual number of objects dequeued.
+ *     If behavior == RTE_RING_QUEUE_FIXED, this will be 0 or n only.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_faa_dequeue_elem(struct rte_ring *r, void *obj_table,
+	uint32_t esize, uint32_t n, enum rte_ring_queue_behavior behavior,
+	uint32_t *available)
+{
+	uint32_t entries, head, i, *seq;
+
+	head = r->faa_cons.head;
+	entries = __atomic_load_n(&r->faa_prod.tail, __ATOMIC_RELAXED) - head;
+	if (n > entries)
+		n = (behavior == RTE_RING_QUEUE_FIXED) ? 0 : entries;
+
+	/* stop at the first slot not published yet */
+	seq = __rte_ring_faa_seq(r);
+	for (i = 0; i != n; i++) {
+		if (__atomic_load_n(&seq[(head + i) & r->mask],
+				__ATOMIC_ACQUIRE) != head + i + 1)
+			break;
+	}
+	if (i != n && behavior == RTE_RING_QUEUE_FIXED)
+		i = 0;
+	n = i;
+
+	if (n != 0) {
+		__rte_ring_dequeue_elems(r, head, obj_table, esize, n);
+
+		/* release the slots for the next lap of the producers */
+		for (i = 0; i != n; i++)
+			__atomic_store_n(&seq[(head + i) & r->mask],
+				head + i + r->size, __ATOMIC_RELEASE);
+
+		r->faa_cons.head = head + n;
+		__atomic_store_n(&r->faa_cons.tail, head + n, __ATOMIC_RELEASE);
+	}
+
+	if (available != NULL)
+		*available = entries - n;
+	return n;
+}
+
+#endif /* _RTE_RING_FAA_ELEM_PVT_H_ */
@@ -26,9 +26,10 @@
  * to avoid copying of the data to temporary area (for ex: array of mbufs
  * on the stack).
  *
- * Note that currently these APIs are available only for two sync modes:
+ * Note that currently these APIs are available only for three sync modes:
  * 1) Single Producer/Single Consumer (RTE_RING_SYNC_ST)
  * 2) Serialized Producer/Serialized Consumer (RTE_RING_SYNC_MT_HTS).
+ * 3) Relaxed Tail Sync Producer/Consumer (RTE_RING_SYNC_MT_RTS).
  * It is user's responsibility to create/init ring with appropriate sync
  * modes selected.
  *
@@ -64,8 +65,16 @@
  *	rte_ring_enqueue_zc_finish(r, nb_rx);
  * }
  *
- * Note that between _start_ and _finish_ none other thread can proceed
- * with enqueue/dequeue operation till _finish_ completes.
+ * Note that in RTE_RING_SYNC_ST and RTE_RING_SYNC_MT_HTS modes, between
+ * _start_ and _finish_ none other thread can proceed with enqueue/dequeue
+ * operation till _finish_ completes.
+ *
+ * In RTE_RING_SYNC_MT_RTS mode, other threads can start and finish their
+ * own enqueue/dequeue operations while the space returned by _start_ is
+ * being filled or read, as long as the head/tail distance of the ring
+ * stays within its limit (see rte_ring_set_prod_htd_max()). As the head
+ * was already moved by _start_, _finish_ has to be called with exactly
+ * the number of objects returned by _start_.
  */
 
 #ifdef __cplusplus
@@ -136,8 +145,10 @@ __rte_ring_do_enqueue_zc_elem_start(struct rte_ring *r, unsigned int esize,
 	case RTE_RING_SYNC_MT_HTS:
 		n = __rte_ring_hts_move_prod_head(r, n, behavior, &head, &free);
 		break;
-	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+		n = __rte_ring_rts_move_prod_head(r, n, behavior, &head, &free);
+		break;
+	case RTE_RING_SYNC_MT:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -284,6 +295,7 @@ rte_ring_enqueue_zc_burst_start(struct rte_ring *r, unsigned int n,
  * Complete enqueuing several objects on the ring.
  * Note that number of objects to enqueue should not exceed previous
  * enqueue_start return value.
+ * In RTE_RING_SYNC_MT_RTS mode, it must be equal to that value.
  *
  * @param r
  *   A pointer to the ring structure.
@@ -305,8 +317,12 @@ rte_ring_enqueue_zc_elem_finish(struct rte_ring *r, unsigned int n)
 		n = __rte_ring_hts_get_tail(&r->hts_prod, &tail, n);
 		__rte_ring_hts_set_head_tail(&r->hts_prod, tail, n, 1);
 		break;
-	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+		/* head was not moved if start returned zero */
+		if (n != 0)
+			__rte_ring_rts_update_tail(&r->rts_prod);
+		break;
+	case RTE_RING_SYNC_MT:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -317,6 +333,7 @@ rte_ring_enqueue_zc_elem_finish(struct rte_ring *r, unsigned int n)
  * Complete enqueuing several pointers to objects on the ring.
  * Note that number of objects to enqueue should not exceed previous
  * enqueue_start return value.
+ * In RTE_RING_SYNC_MT_RTS mode, it must be equal to that value.
  *
  * @param r
  *   A pointer to the ring structure.
@@ -350,8 +367,11 @@ __rte_ring_do_dequeue_zc_elem_start(struct rte_ring *r,
 		n = __rte_ring_hts_move_cons_head(r, n, behavior,
 			&head, &avail);
 		break;
-	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+		n = __rte_ring_rts_move_cons_head(r, n, behavior,
+			&head, &avail);
+		break;
+	case RTE_RING_SYNC_MT:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -496,6 +516,7 @@ rte_ring_dequeue_zc_burst_start(struct rte_ring *r, unsigned int n,
  * Complete dequeuing several objects from the ring.
  * Note that number of objects to dequeued should not exceed previous
  * dequeue_start return value.
+ * In RTE_RING_SYNC_MT_RTS mode, it must be equal to that value.
  *
  * @param r
  *   A pointer to the ring structure.
@@ -517,8 +538,12 @@ rte_ring_dequeue_zc_elem_finish(struct rte_ring *r, unsigned int n)
 		n = __rte_ring_hts_get_tail(&r->hts_cons, &tail, n);
 		__rte_ring_hts_set_head_tail(&r->hts_cons, tail, n, 0);
 		break;
-	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+		/* head was not moved if start returned zero */
+		if (n != 0)
+			__rte_ring_rts_update_tail(&r->rts_cons);
+		break;
+	case RTE_RING_SYNC_MT:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -529,6 +554,7 @@ rte_ring_dequeue_zc_elem_finish(struct rte_ring *r, unsigned int n)
  * Complete dequeuing several objects from the ring.
  * Note that number of objects to dequeued should not exceed previous
  * dequeue_start return value.
+ * In RTE_RING_SYNC_MT_RTS mode, it must be equal to that value.
  *
  * @param r
  *   A pointer to the ring structure.
@@ -539,7 +565,7 @@ __rte_experimental
 static __rte_always_inline void
 rte_ring_dequeue_zc_finish(struct rte_ring *r, unsigned int n)
 {
-	rte_ring_dequeue_elem_finish(r, n);
+	rte_ring_dequeue_zc_elem_finish(r, n);
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,199 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_string_fns.h>
+
+#include "rte_ring.h"
+#include "rte_ring_set.h"
+
+/* create a ring set */
+struct rte_ring_set *
+rte_ring_set_create(const char *name, unsigned int max_rings, int socket_id)
+{
+	struct rte_ring_set *s;
+	uint32_t nb_slabs;
+	size_t sz;
+
+	if (name == NULL || max_rings == 0 ||
+			max_rings > RTE_RING_SET_MAX_RINGS) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	nb_slabs = RTE_ALIGN_CEIL(max_rings, RTE_RING_SET_SLAB_BITS) /
+		RTE_RING_SET_SLAB_BITS;
+	sz = sizeof(*s) + nb_slabs * sizeof(s->bmp[0]);
+
+	s = rte_zmalloc_socket(name, sz, RTE_CACHE_LINE_SIZE, socket_id);
+	if (s == NULL) {
+		RTE_LOG(ERR, RING, "Cannot reserve memory for ring set %s\n",
+			name);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	/* keep the members away from the bitmap written by the producers */
+	s->members = rte_zmalloc_socket(name,
+			max_rings * sizeof(s->members[0]),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (s->members == NULL) {
+		RTE_LOG(ERR, RING, "Cannot reserve memory for ring set %s\n",
+			name);
+		rte_free(s);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	strlcpy(s->name, name, sizeof(s->name));
+	s->max_rings = max_rings;
+	s->nb_slabs = nb_slabs;
+	s->next = 0;
+
+	return s;
+}
+
+/* free a ring set */
+void
+rte_ring_set_free(struct rte_ring_set *s)
+{
+	if (s == NULL)
+		return;
+
+	rte_free(s->members);
+	rte_free(s);
+}
+
+static inline void
+ring_set_clear(struct rte_ring_set *s, uint32_t idx)
+{
+	__atomic_fetch_and(&s->bmp[idx / RTE_RING_SET_SLAB_BITS],
+		~(1ULL << (idx % RTE_RING_SET_SLAB_BITS)), __ATOMIC_RELAXED);
+}
+
+/* add a ring to a ring set */
+int
+rte_ring_set_add(struct rte_ring_set *s, struct rte_ring *r,
+	unsigned int weight)
+{
+	uint32_t idx;
+
+	if (s == NULL || r == NULL || weight == 0)
+		return -EINVAL;
+
+	/* the bitmap protocol relies on a single consumer per ring */
+	if (r->cons.sync_type != RTE_RING_SYNC_ST) {
+		RTE_LOG(ERR, RING, "Ring %s is not single consumer\n",
+			r->name);
+		return -EINVAL;
+	}
+
+	for (idx = 0; idx != s->max_rings; idx++) {
+		if (s->members[idx].r == NULL)
+			break;
+	}
+	if (idx == s->max_rings)
+		return -ENOSPC;
+
+	s->members[idx].r = r;
+	s->members[idx].weight = weight;
+
+	/* the ring may already hold objects */
+	if (rte_ring_count(r) != 0)
+		rte_ring_set_signal(s, idx);
+
+	return idx;
+}
+
+/* remove a ring from a ring set */
+int
+rte_ring_set_del(struct rte_ring_set *s, unsigned int idx)
+{
+	if (s == NULL || idx >= s->max_rings || s->members[idx].r == NULL)
+		return -EINVAL;
+
+	ring_set_clear(s, idx);
+	s->members[idx].r = NULL;
+	s->members[idx].weight = 0;
+
+	return 0;
+}
+
+/*
+ * The ring was found empty: clear its bit, then check it again, in case
+ * a producer enqueued after the dequeue but read the bit before it was
+ * cleared. The barrier pairs with the one in rte_ring_set_signal().
+ */
+static inline void
+ring_set_drained(struct rte_ring_set *s, uint32_t idx, struct rte_ring *r)
+{
+	ring_set_clear(s, idx);
+
+	rte_smp_mb();
+
+	if (rte_ring_count(r) != 0)
+		__atomic_fetch_or(&s->bmp[idx / RTE_RING_SET_SLAB_BITS],
+			1ULL << (idx % RTE_RING_SET_SLAB_BITS),
+			__ATOMIC_RELAXED);
+}
+
+/* dequeue objects from the signalled rings of a ring set */
+unsigned int
+rte_ring_set_dequeue_burst_elem(struct rte_ring_set *s, void *obj_table,
+	unsigned int esize, unsigned int n)
+{
+	const struct rte_ring_set_member *m;
+	uint32_t i, w, b, idx, start, nb, avail, got;
+	uint64_t slab;
+
+	start = s->next;
+	got = 0;
+
+	/*
+	 * one pass over the bitmap: the slab holding the start position
+	 * is visited twice, first from the start bit to its end, then from
+	 * its beginning to the start bit.
+	 */
+	for (i = 0; i <= s->nb_slabs && got != n; i++) {
+		w = (start / RTE_RING_SET_SLAB_BITS + i) % s->nb_slabs;
+		slab = __atomic_load_n(&s->bmp[w], __ATOMIC_ACQUIRE);
+
+		b = start % RTE_RING_SET_SLAB_BITS;
+		if (i == 0)
+			slab &= ~0ULL << b;
+		else if (i == s->nb_slabs)
+			slab &= (1ULL << b) - 1;
+
+		while (slab != 0 && got != n) {
+			b = __builtin_ctzll(slab);
+			slab &= slab - 1;
+
+			idx = w * RTE_RING_SET_SLAB_BITS + b;
+			m = &s->members[idx];
+			if (unlikely(m->r == NULL)) {
+				ring_set_clear(s, idx);
+				continue;
+			}
+
+			nb = RTE_MIN(m->weight, n - got);
+			nb = rte_ring_dequeue_burst_elem(m->r,
+				RTE_PTR_ADD(obj_table, (size_t)got * esize),
+				esize, nb, &avail);
+			got += nb;
+
+			if (avail == 0)
+				ring_set_drained(s, idx, m->r);
+
+			s->next = (idx + 1) % s->max_rings;
+		}
+	}
+
+	return got;
+}
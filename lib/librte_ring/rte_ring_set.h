@@ -0,0 +1,312 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_RING_SET_H_
+#define _RTE_RING_SET_H_
+
+/**
+ * @file
+ * RTE Ring Set
+ *
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * A ring set groups several rings drained by a single consumer.
+ * Along with the rings, the set keeps a bitmap with one bit per ring,
+ * which is set when the ring becomes non-empty. The consumer only
+ * visits the rings signalled in the bitmap, instead of polling all of
+ * them, and takes at most *weight* objects from each visited ring before
+ * moving to the next one (weighted round robin).
+ *
+ * The producers have to signal the set after enqueuing to a ring of the
+ * set, either by using the rte_ring_set_enqueue_*() wrappers, or by
+ * calling rte_ring_set_signal() after their own enqueue operation.
+ * Signalling a ring already signalled only reads the bitmap, so that
+ * the bitmap cache lines are written only on the empty to non-empty
+ * transitions of the rings.
+ *
+ * The rings of a set can have any producer sync mode, but must have a
+ * single consumer: the one which dequeues from the set.
+ */
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_common.h>
+#include <rte_atomic.h>
+#include <rte_ring.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of rings in a ring set. */
+#define RTE_RING_SET_MAX_RINGS 4096
+
+/** Number of rings per bitmap slab. */
+#define RTE_RING_SET_SLAB_BITS 64
+
+/** @internal A ring member of a ring set. */
+struct rte_ring_set_member {
+	struct rte_ring *r;	/**< Ring, NULL if the slot is free. */
+	uint32_t weight;	/**< Max objects dequeued per visit. */
+};
+
+/**
+ * A ring set. The members and the consumer state are written only by
+ * the control path and the consumer, the bitmap slabs by the producers.
+ */
+struct rte_ring_set {
+	char name[RTE_RING_NAMESIZE];	/**< Name of the ring set. */
+	uint32_t max_rings;	/**< Max number of rings in the set. */
+	uint32_t nb_slabs;	/**< Number of bitmap slabs. */
+	uint32_t next;		/**< Next ring to visit by the consumer. */
+	struct rte_ring_set_member *members; /**< Ring members. */
+	/** Non-empty bitmap, one bit per ring. */
+	uint64_t bmp[] __rte_cache_aligned;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a ring set.
+ *
+ * @param name
+ *   The name of the ring set.
+ * @param max_rings
+ *   The maximum number of rings in the set, at most RTE_RING_SET_MAX_RINGS.
+ * @param socket_id
+ *   The *socket_id* argument is the socket identifier in case of NUMA.
+ *   The value can be *SOCKET_ID_ANY* if there is no NUMA constraint.
+ * @return
+ *   The ring set on success, NULL on error with rte_errno set:
+ *    - EINVAL - invalid parameter
+ *    - ENOMEM - the memory could not be allocated
+ */
+__rte_experimental
+struct rte_ring_set *
+rte_ring_set_create(const char *name, unsigned int max_rings, int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a ring set. The rings of the set are not freed.
+ *
+ * @param s
+ *   The ring set to free.
+ */
+__rte_experimental
+void
+rte_ring_set_free(struct rte_ring_set *s);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a ring to a ring set.
+ *
+ * This function is not multi-thread safe, and must not be called while
+ * the consumer is dequeuing from the set.
+ *
+ * @param s
+ *   The ring set.
+ * @param r
+ *   The ring to add. It must have a single consumer.
+ * @param weight
+ *   The maximum number of objects dequeued from the ring each time the
+ *   consumer visits it, at least 1.
+ * @return
+ *   The index of the ring in the set, to be given to the producers, on
+ *   success. A negative errno value on error:
+ *    - -EINVAL - invalid parameter, or the ring has multiple consumers
+ *    - -ENOSPC - the set is full
+ */
+__rte_experimental
+int
+rte_ring_set_add(struct rte_ring_set *s, struct rte_ring *r,
+	unsigned int weight);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Remove a ring from a ring set. The objects left in the ring are not
+ * dequeued.
+ *
+ * This function is not multi-thread safe, and must not be called while
+ * the consumer is dequeuing from the set or a producer is signalling
+ * the ring.
+ *
+ * @param s
+ *   The ring set.
+ * @param idx
+ *   The index of the ring, as returned by rte_ring_set_add().
+ * @return
+ *   0 on success, -EINVAL if there is no ring at this index.
+ */
+__rte_experimental
+int
+rte_ring_set_del(struct rte_ring_set *s, unsigned int idx);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Signal the consumer of a ring set that a ring may be non-empty.
+ *
+ * Must be called by a producer after each successful enqueue operation
+ * on a ring of the set, unless it uses the rte_ring_set_enqueue_*()
+ * wrappers.
+ *
+ * @param s
+ *   The ring set.
+ * @param idx
+ *   The index of the ring in the set.
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_ring_set_signal(struct rte_ring_set *s, unsigned int idx)
+{
+	uint64_t *slab = &s->bmp[idx / RTE_RING_SET_SLAB_BITS];
+	uint64_t mask = 1ULL << (idx % RTE_RING_SET_SLAB_BITS);
+
+	/*
+	 * order the ring tail update before the bitmap read, it pairs
+	 * with the barrier between the bit clear and the ring re-check
+	 * in the consumer.
+	 */
+	rte_smp_mb();
+
+	if ((__atomic_load_n(slab, __ATOMIC_RELAXED) & mask) == 0)
+		__atomic_fetch_or(slab, mask, __ATOMIC_RELEASE);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue several objects on a ring of a ring set, and signal the set.
+ *
+ * @param s
+ *   The ring set.
+ * @param idx
+ *   The index of the ring in the set.
+ * @param obj_table
+ *   A pointer to a table of objects.
+ * @param esize
+ *   The size of ring element, in bytes. It must be a multiple of 4.
+ *   This must be the same value used while creating the ring.
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued, between 0 and n.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_enqueue_burst_elem(struct rte_ring_set *s, unsigned int idx,
+	const void *obj_table, unsigned int esize, unsigned int n,
+	unsigned int *free_space)
+{
+	n = rte_ring_enqueue_burst_elem(s->members[idx].r, obj_table, esize,
+			n, free_space);
+	if (n != 0)
+		rte_ring_set_signal(s, idx);
+	return n;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue several pointers to objects on a ring of a ring set, and
+ * signal the set.
+ *
+ * @param s
+ *   The ring set.
+ * @param idx
+ *   The index of the ring in the set.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to add in the ring from the obj_table.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   enqueue operation has finished.
+ * @return
+ *   The number of objects enqueued, between 0 and n.
+ */
+__rte_experimental
+static __rte_always_inline unsigned int
+rte_ring_set_enqueue_burst(struct rte_ring_set *s, unsigned int idx,
+	void * const *obj_table, unsigned int n, unsigned int *free_space)
+{
+	return rte_ring_set_enqueue_burst_elem(s, idx, obj_table,
+			sizeof(void *), n, free_space);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dequeue objects from the signalled rings of a ring set.
+ *
+ * The signalled rings are visited in a round robin order, starting after
+ * the last ring visited by the previous call, and at most *weight*
+ * objects are dequeued from each of them. The bit of a ring is cleared
+ * when the ring is found empty.
+ *
+ * This function must be called by a single consumer.
+ *
+ * @param s
+ *   The ring set.
+ * @param obj_table
+ *   A pointer to a table of objects that will be filled.
+ * @param esize
+ *   The size of the ring elements, in bytes. It must be a multiple of 4,
+ *   and the same for all the rings of the set.
+ * @param n
+ *   The maximum number of objects to dequeue.
+ * @return
+ *   The number of objects dequeued, between 0 and n.
+ */
+__rte_experimental
+unsigned int
+rte_ring_set_dequeue_burst_elem(struct rte_ring_set *s, void *obj_table,
+	unsigned int esize, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Dequeue pointers to objects from the signalled rings of a ring set.
+ *
+ * See rte_ring_set_dequeue_burst_elem().
+ *
+ * @param s
+ *   The ring set.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects) that will be filled.
+ * @param n
+ *   The maximum number of objects to dequeue.
+ * @return
+ *   The number of objects dequeued, between 0 and n.
+ */
+__rte_experimental
+static inline unsigned int
+rte_ring_set_dequeue_burst(struct rte_ring_set *s, void **obj_table,
+	unsigned int n)
+{
+	return rte_ring_set_dequeue_burst_elem(s, obj_table, sizeof(void *),
+			n);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RING_SET_H_ */
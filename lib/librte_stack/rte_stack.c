@@ -62,13 +62,10 @@ rte_stack_create(const char *name, unsigned int count, int socket_id,
 		return NULL;
 	}
 
-#ifdef RTE_ARCH_64
-	RTE_BUILD_BUG_ON(sizeof(struct rte_stack_lf_head) != 16);
+#ifdef RTE_STACK_LF_IDX
+	RTE_BUILD_BUG_ON(sizeof(union rte_stack_lf_idx_head) != 8);
 #else
-	if (flags & RTE_STACK_F_LF) {
-		STACK_LOG_ERR("Lock-free stack is not supported on your platform\n");
-		return NULL;
-	}
+	RTE_BUILD_BUG_ON(sizeof(struct rte_stack_lf_head) != 16);
 #endif
 
 	sz = rte_stack_get_memsize(count, flags);
@@ -34,7 +34,11 @@ extern "C" {
 
 struct rte_stack_lf_elem {
 	void *data;			/**< Data pointer */
-	struct rte_stack_lf_elem *next;	/**< Next pointer */
+	RTE_STD_C11
+	union {
+		struct rte_stack_lf_elem *next;	/**< Next pointer */
+		uint32_t next_idx;	/**< Next index (tagged index mode) */
+	};
 };
 
 struct rte_stack_lf_head {
@@ -42,9 +46,28 @@ struct rte_stack_lf_head {
 	uint64_t cnt; /**< Modification counter for avoiding ABA problem */
 };
 
+/* List head of the tagged index mode, updated with a 64-bit CAS. */
+union rte_stack_lf_idx_head {
+	uint64_t raw; /**< Raw value, for atomic operations */
+	RTE_STD_C11
+	struct {
+		uint32_t top; /**< Stack top index, 0 if empty */
+		uint32_t cnt; /**< Modification counter against ABA problem */
+	};
+};
+
 struct rte_stack_lf_list {
-	/** List head */
-	struct rte_stack_lf_head head __rte_aligned(16);
+	RTE_STD_C11
+	union {
+		/** List head */
+		struct rte_stack_lf_head head __rte_aligned(16);
+		struct {
+			/** List head (tagged index mode) */
+			union rte_stack_lf_idx_head idx_head;
+			/** Elements indexed from 1 (tagged index mode) */
+			struct rte_stack_lf_elem *idx_elems;
+		};
+	};
 	/** List len */
 	uint64_t len;
 };
@@ -88,8 +111,12 @@ struct rte_stack {
 } __rte_cache_aligned;
 
 /**
- * The stack uses lock-free push and pop functions. This flag is only
- * supported on x86_64 platforms, currently.
+ * The stack uses lock-free push and pop functions. On platforms with a
+ * 128-bit compare-and-swap (x86_64 and arm64), the list heads hold an
+ * element pointer and a 64-bit modification counter. On other platforms,
+ * or if DPDK is built with the stack_lf_idx option, they hold a 32-bit
+ * element index and a 32-bit modification counter, updated with a 64-bit
+ * compare-and-swap.
  */
 #define RTE_STACK_F_LF 0x0001
 
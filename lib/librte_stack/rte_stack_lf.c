@@ -10,6 +10,11 @@ rte_stack_lf_init(struct rte_stack *s, unsigned int count)
 	struct rte_stack_lf_elem *elems = s->stack_lf.elems;
 	unsigned int i;
 
+#ifdef RTE_STACK_LF_IDX
+	s->stack_lf.used.idx_elems = elems;
+	s->stack_lf.free.idx_elems = elems;
+#endif
+
 	for (i = 0; i < count; i++)
 		__rte_stack_lf_push_elems(&s->stack_lf.free,
 					  &elems[i], &elems[i], 1);
@@ -5,8 +5,9 @@
 #ifndef _RTE_STACK_LF_H_
 #define _RTE_STACK_LF_H_
 
-#if !(defined(RTE_ARCH_X86_64) || defined(RTE_ARCH_ARM64))
-#include "rte_stack_lf_stubs.h"
+/* The list mode is set at build time, see RTE_STACK_LF_IDX in rte_config */
+#ifdef RTE_STACK_LF_IDX
+#include "rte_stack_lf_idx.h"
 #else
 #ifdef RTE_USE_C11_MEM_MODEL
 #include "rte_stack_lf_c11.h"
@@ -15,6 +16,30 @@
 #endif
 #endif
 
+/**
+ * @internal Return the next element of a list of popped elements.
+ *
+ * @param list
+ *   A pointer to the list the elements were popped from.
+ * @param elem
+ *   A pointer to the element.
+ * @return
+ *   The next element, NULL at the end of the list.
+ */
+static __rte_always_inline struct rte_stack_lf_elem *
+__rte_stack_lf_elem_next(const struct rte_stack_lf_list *list,
+			 const struct rte_stack_lf_elem *elem)
+{
+#ifdef RTE_STACK_LF_IDX
+	if (elem->next_idx == 0)
+		return NULL;
+	return __rte_stack_lf_idx_elem(list, elem->next_idx);
+#else
+	RTE_SET_USED(list);
+	return elem->next;
+#endif
+}
+
 /**
  * @internal Push several objects on the lock-free stack (MT-safe).
  *
@@ -44,7 +69,8 @@ __rte_stack_lf_push(struct rte_stack *s,
 		return 0;
 
 	/* Construct the list elements */
-	for (tmp = first, i = 0; i < n; i++, tmp = tmp->next)
+	for (tmp = first, i = 0; i < n; i++,
+	     tmp = __rte_stack_lf_elem_next(&s->stack_lf.free, tmp))
 		tmp->data = obj_table[n - i - 1];
 
 	/* Push them to the used list */
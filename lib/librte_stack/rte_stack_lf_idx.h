@@ -0,0 +1,151 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_STACK_LF_IDX_H_
+#define _RTE_STACK_LF_IDX_H_
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+
+/*
+ * Lock-free LIFO lists for platforms without a 128-bit compare-and-swap.
+ *
+ * The list head holds a 32-bit element index and a 32-bit modification
+ * counter, so that it is updated with a 64-bit compare-and-swap. The
+ * counter is incremented on each update, so that a head which was popped
+ * and pushed back between the read and the update of another thread does
+ * not match anymore (ABA problem). It could only match again after 2^32
+ * updates of the list in the meantime.
+ *
+ * The elements are indexed from 1 in the element array of the stack,
+ * shared by its two lists, and the index 0 is used as the end of list
+ * marker.
+ */
+
+static __rte_always_inline uint32_t
+__rte_stack_lf_elem_idx(const struct rte_stack_lf_list *list,
+			const struct rte_stack_lf_elem *elem)
+{
+	return elem - list->idx_elems + 1;
+}
+
+static __rte_always_inline struct rte_stack_lf_elem *
+__rte_stack_lf_idx_elem(const struct rte_stack_lf_list *list, uint32_t idx)
+{
+	return &list->idx_elems[idx - 1];
+}
+
+static __rte_always_inline unsigned int
+__rte_stack_lf_count(struct rte_stack *s)
+{
+	/* As for the 128-bit CAS lists, the length is updated after the
+	 * push and before the pop, so the list may appear shorter than it
+	 * is, but never longer.
+	 */
+	return (unsigned int)__atomic_load_n(&s->stack_lf.used.len,
+					     __ATOMIC_RELAXED);
+}
+
+static __rte_always_inline void
+__rte_stack_lf_push_elems(struct rte_stack_lf_list *list,
+			  struct rte_stack_lf_elem *first,
+			  struct rte_stack_lf_elem *last,
+			  unsigned int num)
+{
+	union rte_stack_lf_idx_head old_head, new_head;
+
+	new_head.top = __rte_stack_lf_elem_idx(list, first);
+	old_head.raw = __atomic_load_n(&list->idx_head.raw, __ATOMIC_RELAXED);
+
+	do {
+		/* Swing the top index to the first element in the list and
+		 * make the last element point to the old top.
+		 */
+		new_head.cnt = old_head.cnt + 1;
+		last->next_idx = old_head.top;
+
+		/* Use the release memmodel to ensure the writes to the LF LIFO
+		 * elements are visible before the head update.
+		 */
+	} while (__atomic_compare_exchange_n(&list->idx_head.raw,
+			&old_head.raw, new_head.raw, 1, __ATOMIC_RELEASE,
+			__ATOMIC_RELAXED) == 0);
+
+	/* Ensure the stack modifications are not reordered with respect
+	 * to the LIFO len update.
+	 */
+	__atomic_add_fetch(&list->len, num, __ATOMIC_RELEASE);
+}
+
+static __rte_always_inline struct rte_stack_lf_elem *
+__rte_stack_lf_pop_elems(struct rte_stack_lf_list *list,
+			 unsigned int num,
+			 void **obj_table,
+			 struct rte_stack_lf_elem **last)
+{
+	union rte_stack_lf_idx_head old_head, new_head;
+	struct rte_stack_lf_elem *tmp;
+	uint64_t len;
+	uint32_t idx;
+	unsigned int i;
+
+	len = __atomic_load_n(&list->len, __ATOMIC_ACQUIRE);
+
+	/* Reserve num elements, if available */
+	do {
+		/* Does the list contain enough elements? */
+		if (unlikely(len < num))
+			return NULL;
+
+		/* len is updated on failure */
+	} while (__atomic_compare_exchange_n(&list->len, &len, len - num,
+			1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE) == 0);
+
+	old_head.raw = __atomic_load_n(&list->idx_head.raw, __ATOMIC_ACQUIRE);
+
+	/* Pop num elements */
+	do {
+		idx = old_head.top;
+
+		/* Traverse the list to find the new head. A next index will
+		 * either point to another element or be 0; if a thread
+		 * encounters an element that has already been popped, the CAS
+		 * will fail.
+		 */
+		for (i = 0; i < num && idx != 0; i++) {
+			tmp = __rte_stack_lf_idx_elem(list, idx);
+			if (obj_table)
+				obj_table[i] = tmp->data;
+			if (last)
+				*last = tmp;
+			idx = __atomic_load_n(&tmp->next_idx,
+					      __ATOMIC_RELAXED);
+		}
+
+		/* If the end of list was encountered, the list was modified
+		 * while traversing it. Retry.
+		 */
+		if (i != num) {
+			old_head.raw = __atomic_load_n(&list->idx_head.raw,
+						       __ATOMIC_ACQUIRE);
+			continue;
+		}
+
+		new_head.top = idx;
+		new_head.cnt = old_head.cnt + 1;
+
+		/* old_head is updated on failure. Use the acquire memmodel
+		 * to ensure the element reads of the next attempt are not
+		 * reordered before this head read.
+		 */
+		if (__atomic_compare_exchange_n(&list->idx_head.raw,
+				&old_head.raw, new_head.raw, 1,
+				__ATOMIC_RELEASE, __ATOMIC_ACQUIRE) != 0)
+			break;
+	} while (1);
+
+	return __rte_stack_lf_idx_elem(list, old_head.top);
+}
+
+#endif /* _RTE_STACK_LF_IDX_H_ */
@@ -89,6 +89,13 @@ struct rte_swx_table_entry {
 	 */
 	uint64_t key_signature;
 
+	/** Key priority for the current entry. Used by the wildcard match
+	 * tables to pick one entry out of several entries that match the same
+	 * lookup key: the lower the value, the higher the priority, with 0
+	 * being the highest priority. Ignored by the other table types.
+	 */
+	uint32_t key_priority;
+
 	/** Action ID for the current entry. */
 	uint64_t action_id;
 
@@ -0,0 +1,367 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_byteorder.h>
+#include <rte_malloc.h>
+#include <rte_memzone.h>
+#include <rte_fib.h>
+#include <rte_rib.h>
+
+#include "rte_swx_table_lpm.h"
+
+#define CHECK(condition, err_code)                                             \
+do {                                                                           \
+	if (!(condition))                                                      \
+		return -(err_code);                                            \
+} while (0)
+
+/* Largest number of rules the 2-byte FIB next hops can point to. */
+#define LPM_NH_2B_MAX ((1U << 15) - 1)
+
+/* Largest number of tbl8 groups, i.e. of /24 prefixes with longer routes. */
+#define LPM_TBL8_MAX (1U << 15)
+
+#define LPM_TBL24_SIZE (1 << 24)
+#define LPM_TBL8_SIZE 256
+
+struct table {
+	/* Input parameters */
+	struct rte_swx_table_params params;
+
+	/* Internal. */
+	struct rte_fib *fib;
+	struct rte_rib *rib;
+	uint32_t data_size;
+	uint32_t rule_stack_tos;
+	uint64_t total_size;
+
+	/* Memory arrays. */
+	uint32_t *rule_stack;
+	uint8_t *data;
+};
+
+static inline uint64_t *
+rule_data(struct table *t, uint32_t rule_id)
+{
+	return (uint64_t *)&t->data[(uint64_t)rule_id * t->data_size];
+}
+
+/* The FIB next hop of each rule is its ID, with the table size for miss. */
+static void
+fib_conf_get(struct rte_swx_table_params *params, struct rte_fib_conf *conf)
+{
+	memset(conf, 0, sizeof(*conf));
+	conf->type = RTE_FIB_DIR24_8;
+	conf->default_nh = params->n_keys_max;
+	conf->max_routes = params->n_keys_max;
+	conf->dir24_8.nh_sz = (params->n_keys_max <= LPM_NH_2B_MAX) ?
+		RTE_FIB_DIR24_8_2B : RTE_FIB_DIR24_8_4B;
+	conf->dir24_8.num_tbl8 = RTE_MIN(params->n_keys_max, LPM_TBL8_MAX);
+}
+
+/* Return 0 and the prefix depth when the entry mask is a prefix. */
+static int
+entry_read(struct table *t,
+	   struct rte_swx_table_entry *entry,
+	   uint32_t *ip,
+	   uint8_t *depth)
+{
+	uint32_t key, mask = UINT32_MAX, mask0;
+
+	memcpy(&key, entry->key, sizeof(key));
+	memcpy(&mask0, t->params.key_mask0, sizeof(mask0));
+	if (entry->key_mask)
+		memcpy(&mask, entry->key_mask, sizeof(mask));
+
+	mask = rte_be_to_cpu_32(mask & mask0);
+	*depth = __builtin_popcount(mask);
+	CHECK(!*depth || (mask == (UINT32_MAX << (32 - *depth))), EINVAL);
+
+	*ip = rte_be_to_cpu_32(key) & mask;
+	return 0;
+}
+
+static void
+rule_data_update(struct table *t,
+		 uint32_t rule_id,
+		 struct rte_swx_table_entry *entry)
+{
+	uint64_t *data = rule_data(t, rule_id);
+
+	data[0] = entry->action_id;
+	if (t->params.action_data_size)
+		memcpy(&data[1],
+		       entry->action_data,
+		       t->params.action_data_size);
+}
+
+#define CL RTE_CACHE_LINE_ROUNDUP
+
+static int
+__table_create(struct table **table,
+	       uint64_t *memory_footprint,
+	       struct rte_swx_table_params *params,
+	       const char *args __rte_unused,
+	       int numa_node)
+{
+	static uint32_t fib_id;
+	char name[RTE_MEMZONE_NAMESIZE];
+	struct rte_fib_conf conf;
+	struct table *t;
+	uint8_t *memory;
+	size_t table_meta_sz, key_mask_sz, rule_stack_sz, data_sz, fib_sz,
+		total_size;
+	size_t key_mask_offset, rule_stack_offset, data_offset;
+	uint32_t key_data_size, i;
+
+	/* Check input arguments. */
+	CHECK(params, EINVAL);
+	CHECK(params->match_type == RTE_SWX_TABLE_MATCH_LPM, EINVAL);
+	CHECK(params->key_size == sizeof(uint32_t), EINVAL);
+	CHECK(params->n_keys_max, EINVAL);
+	CHECK(params->n_keys_max < INT32_MAX, EINVAL);
+
+	/* Memory allocation. */
+	fib_conf_get(params, &conf);
+	key_data_size = RTE_ALIGN_CEIL(params->action_data_size + 8,
+				       sizeof(uint64_t));
+
+	table_meta_sz = CL(sizeof(struct table));
+	key_mask_sz = CL(params->key_size);
+	rule_stack_sz = CL(params->n_keys_max * sizeof(uint32_t));
+	data_sz = CL(params->n_keys_max * key_data_size);
+	total_size = table_meta_sz + key_mask_sz + rule_stack_sz + data_sz;
+
+	key_mask_offset = table_meta_sz;
+	rule_stack_offset = key_mask_offset + key_mask_sz;
+	data_offset = rule_stack_offset + rule_stack_sz;
+
+	if (!table) {
+		/* The FIB is allocated separately. */
+		fib_sz = ((size_t)LPM_TBL24_SIZE +
+			  (size_t)conf.dir24_8.num_tbl8 * LPM_TBL8_SIZE) <<
+			 conf.dir24_8.nh_sz;
+
+		if (memory_footprint)
+			*memory_footprint = total_size + fib_sz;
+		return 0;
+	}
+
+	memory = rte_zmalloc_socket(NULL, total_size, RTE_CACHE_LINE_SIZE,
+				    numa_node);
+	CHECK(memory, ENOMEM);
+
+	/* Initialization. */
+	t = (struct table *)memory;
+	memcpy(&t->params, params, sizeof(*params));
+
+	t->data_size = key_data_size;
+	t->total_size = total_size;
+
+	t->params.key_mask0 = &memory[key_mask_offset];
+	t->rule_stack = (uint32_t *)&memory[rule_stack_offset];
+	t->data = &memory[data_offset];
+
+	if (!params->key_mask0)
+		memset(t->params.key_mask0, 0xFF, params->key_size);
+	else
+		memcpy(t->params.key_mask0, params->key_mask0,
+		       params->key_size);
+
+	for (i = 0; i < t->params.n_keys_max; i++)
+		t->rule_stack[i] = t->params.n_keys_max - 1 - i;
+	t->rule_stack_tos = t->params.n_keys_max;
+
+	/* The control path keeps two instances of each table. */
+	snprintf(name, sizeof(name), "SWX_LPM_%u",
+		 __atomic_fetch_add(&fib_id, 1, __ATOMIC_RELAXED));
+	t->fib = rte_fib_create(name, numa_node, &conf);
+	if (!t->fib) {
+		rte_free(memory);
+		CHECK(0, ENOMEM);
+	}
+
+	t->rib = rte_fib_get_rib(t->fib);
+
+	*table = t;
+	return 0;
+}
+
+static void
+table_free(void *table)
+{
+	struct table *t = table;
+
+	if (!t)
+		return;
+
+	rte_fib_free(t->fib);
+	rte_free(t);
+}
+
+static int
+table_add(void *table, struct rte_swx_table_entry *entry)
+{
+	struct table *t = table;
+	struct rte_rib_node *node;
+	uint64_t nh;
+	uint32_t ip, rule_id;
+	uint8_t depth;
+	int status;
+
+	CHECK(t, EINVAL);
+	CHECK(entry, EINVAL);
+	CHECK(entry->key, EINVAL);
+	CHECK((!t->params.action_data_size && !entry->action_data) ||
+	      (t->params.action_data_size && entry->action_data), EINVAL);
+
+	status = entry_read(t, entry, &ip, &depth);
+	if (status)
+		return status;
+
+	/* Prefix is present in the table. */
+	node = rte_rib_lookup_exact(t->rib, ip, depth);
+	if (node) {
+		rte_rib_get_nh(node, &nh);
+		rule_data_update(t, (uint32_t)nh, entry);
+		return 0;
+	}
+
+	/* Prefix is not present in the table. */
+	CHECK(t->rule_stack_tos, ENOSPC);
+	rule_id = t->rule_stack[t->rule_stack_tos - 1];
+	rule_data_update(t, rule_id, entry);
+
+	status = rte_fib_add(t->fib, ip, depth, rule_id);
+	CHECK(!status, ENOSPC);
+
+	t->rule_stack_tos--;
+	return 0;
+}
+
+static int
+table_del(void *table, struct rte_swx_table_entry *entry)
+{
+	struct table *t = table;
+	struct rte_rib_node *node;
+	uint64_t nh;
+	uint32_t ip;
+	uint8_t depth;
+	int status;
+
+	CHECK(t, EINVAL);
+	CHECK(entry, EINVAL);
+	CHECK(entry->key, EINVAL);
+
+	status = entry_read(t, entry, &ip, &depth);
+	if (status)
+		return status;
+
+	node = rte_rib_lookup_exact(t->rib, ip, depth);
+	if (!node)
+		return 0;
+
+	rte_rib_get_nh(node, &nh);
+
+	status = rte_fib_delete(t->fib, ip, depth);
+	CHECK(!status, EINVAL);
+
+	t->rule_stack[t->rule_stack_tos++] = (uint32_t)nh;
+	return 0;
+}
+
+static uint64_t
+table_mailbox_size_get(void)
+{
+	return 0;
+}
+
+static int
+table_lookup(void *table,
+	     void *mailbox __rte_unused,
+	     uint8_t **key,
+	     uint64_t *action_id,
+	     uint8_t **action_data,
+	     int *hit)
+{
+	struct table *t = table;
+	uint32_t ip;
+	uint64_t nh;
+
+	memcpy(&ip, &(*key)[t->params.key_offset], sizeof(ip));
+	ip = rte_be_to_cpu_32(ip);
+
+	rte_fib_lookup_bulk(t->fib, &ip, &nh, 1);
+	if (nh == t->params.n_keys_max) {
+		*hit = 0;
+		return 1;
+	}
+
+	*action_id = rule_data(t, nh)[0];
+	*action_data = (uint8_t *)&rule_data(t, nh)[1];
+	*hit = 1;
+	return 1;
+}
+
+static void *
+table_create(struct rte_swx_table_params *params,
+	     struct rte_swx_table_entry_list *entries,
+	     const char *args,
+	     int numa_node)
+{
+	struct table *t;
+	struct rte_swx_table_entry *entry;
+	int status;
+
+	/* Table create. */
+	status = __table_create(&t, NULL, params, args, numa_node);
+	if (status)
+		return NULL;
+
+	/* Table add entries. */
+	if (!entries)
+		return t;
+
+	TAILQ_FOREACH(entry, entries, node) {
+		int status;
+
+		status = table_add(t, entry);
+		if (status) {
+			table_free(t);
+			return NULL;
+		}
+	}
+
+	return t;
+}
+
+static uint64_t
+table_footprint(struct rte_swx_table_params *params,
+		struct rte_swx_table_entry_list *entries __rte_unused,
+		const char *args)
+{
+	uint64_t memory_footprint;
+	int status;
+
+	status = __table_create(NULL, &memory_footprint, params, args, 0);
+	if (status)
+		return 0;
+
+	return memory_footprint;
+}
+
+struct rte_swx_table_ops rte_swx_table_lpm_ops = {
+	.footprint_get = table_footprint,
+	.mailbox_size_get = table_mailbox_size_get,
+	.create = table_create,
+	.add = table_add,
+	.del = table_del,
+	.lkp = table_lookup,
+	.free = table_free,
+};
@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#ifndef __INCLUDE_RTE_SWX_TABLE_LPM_H__
+#define __INCLUDE_RTE_SWX_TABLE_LPM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE SWX Longest Prefix Match Table
+ *
+ * IPv4 routing table built on top of the FIB library. The key is a 4-byte
+ * IPv4 address in network byte order, e.g. a header field, and the key mask of
+ * each entry must be a contiguous prefix.
+ */
+
+#include <stdint.h>
+
+#include <rte_swx_table.h>
+
+/** Longest prefix match table operations. */
+extern struct rte_swx_table_ops rte_swx_table_lpm_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,668 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_hash_crc.h>
+
+#include "rte_swx_table_wm.h"
+
+#define CHECK(condition, err_code)                                             \
+do {                                                                           \
+	if (!(condition))                                                      \
+		return -(err_code);                                            \
+} while (0)
+
+#ifndef RTE_SWX_TABLE_WM_USE_HUGE_PAGES
+#define RTE_SWX_TABLE_WM_USE_HUGE_PAGES 1
+#endif
+
+#if RTE_SWX_TABLE_WM_USE_HUGE_PAGES
+
+#include <rte_malloc.h>
+
+static void *
+env_malloc(size_t size, size_t alignment, int numa_node)
+{
+	return rte_zmalloc_socket(NULL, size, alignment, numa_node);
+}
+
+static void
+env_free(void *start, size_t size __rte_unused)
+{
+	rte_free(start);
+}
+
+#else
+
+#include <numa.h>
+
+static void *
+env_malloc(size_t size, size_t alignment __rte_unused, int numa_node)
+{
+	return numa_alloc_onnode(size, numa_node);
+}
+
+static void
+env_free(void *start, size_t size)
+{
+	numa_free(start, size);
+}
+
+#endif
+
+#define KEY_SIZE_MAX 64
+
+/* Invalid tuple ID, used to flag the free rules. */
+#define TUPLE_INVALID UINT32_MAX
+
+/* n_bytes needs to be a multiple of 8 bytes. */
+static inline void
+keycpy(void *dst, void *src, void *src_mask, uint32_t n_bytes)
+{
+	uint64_t *dst64 = dst, *src64 = src, *src_mask64 = src_mask;
+	uint32_t i;
+
+	for (i = 0; i < n_bytes / sizeof(uint64_t); i++)
+		dst64[i] = src64[i] & src_mask64[i];
+}
+
+/*
+ * Return: 0 = Keys are NOT equal; 1 = Keys are equal.
+ */
+static inline uint32_t
+keycmp(void *a, void *b, uint32_t n_bytes)
+{
+	uint64_t *a64 = a, *b64 = b;
+	uint64_t or = 0;
+	uint32_t i;
+
+	for (i = 0; i < n_bytes / sizeof(uint64_t); i++)
+		or |= a64[i] ^ b64[i];
+
+	return or ? 0 : 1;
+}
+
+struct tuple {
+	/* Number of rules using the mask of this tuple. */
+	uint32_t n_rules;
+
+	/* Best (i.e. lowest) priority of the rules of this tuple. */
+	uint32_t priority;
+};
+
+struct rule {
+	/* Next rule in the same bucket, as rule ID + 1, or 0 when none. */
+	uint32_t next;
+
+	/* Tuple of this rule, or TUPLE_INVALID when the rule is free. */
+	uint32_t tuple_id;
+
+	/* Hash of the masked key, seeded with the tuple ID. */
+	uint32_t sig;
+
+	uint32_t priority;
+};
+
+struct table {
+	/* Input parameters */
+	struct rte_swx_table_params params;
+
+	/* Internal. */
+	uint32_t key_size;
+	uint32_t data_size;
+	uint32_t n_buckets;
+	uint32_t n_tuples;
+	uint32_t tuple_stack_tos;
+	uint32_t rule_stack_tos;
+	uint64_t total_size;
+
+	/* Memory arrays. */
+	uint8_t *key_mask;
+	struct tuple *tuples;
+	uint8_t *tuple_masks;
+	uint32_t *tuple_order;
+	uint32_t *tuple_stack;
+	uint32_t *buckets;
+	struct rule *rules;
+	uint8_t *rule_keys;
+	uint32_t *rule_stack;
+	uint8_t *data;
+};
+
+static inline uint8_t *
+tuple_mask(struct table *t, uint32_t tuple_id)
+{
+	return &t->tuple_masks[(uint64_t)tuple_id * t->key_size];
+}
+
+static inline uint8_t *
+rule_key(struct table *t, uint32_t rule_id)
+{
+	return &t->rule_keys[(uint64_t)rule_id * t->key_size];
+}
+
+static inline uint64_t *
+rule_data(struct table *t, uint32_t rule_id)
+{
+	return (uint64_t *)&t->data[(uint64_t)rule_id * t->data_size];
+}
+
+static inline uint32_t
+hash(void *key, uint32_t key_size, uint32_t tuple_id)
+{
+	return rte_hash_crc(key, key_size, tuple_id);
+}
+
+/* Keep the tuples sorted by their best rule priority, so that the lookup can
+ * stop on the first tuple that cannot beat the current match.
+ */
+static void
+tuple_order_sort(struct table *t)
+{
+	uint32_t i;
+
+	for (i = 1; i < t->n_tuples; i++) {
+		uint32_t tuple_id = t->tuple_order[i];
+		uint32_t priority = t->tuples[tuple_id].priority;
+		uint32_t j;
+
+		for (j = i; j; j--) {
+			uint32_t prev_id = t->tuple_order[j - 1];
+
+			if (t->tuples[prev_id].priority <= priority)
+				break;
+
+			t->tuple_order[j] = prev_id;
+		}
+
+		t->tuple_order[j] = tuple_id;
+	}
+}
+
+static void
+tuple_priority_update(struct table *t, uint32_t tuple_id)
+{
+	struct tuple *tp = &t->tuples[tuple_id];
+	uint32_t i;
+
+	tp->priority = UINT32_MAX;
+	for (i = 0; i < t->params.n_keys_max; i++) {
+		struct rule *r = &t->rules[i];
+
+		if ((r->tuple_id == tuple_id) && (r->priority < tp->priority))
+			tp->priority = r->priority;
+	}
+}
+
+static int
+tuple_find(struct table *t, uint8_t *mask)
+{
+	uint32_t i;
+
+	for (i = 0; i < t->n_tuples; i++) {
+		uint32_t tuple_id = t->tuple_order[i];
+
+		if (keycmp(tuple_mask(t, tuple_id), mask, t->key_size))
+			return tuple_id;
+	}
+
+	return -1;
+}
+
+/* Return the rule ID, or -1 when not found. */
+static int
+rule_find(struct table *t,
+	  uint32_t tuple_id,
+	  uint8_t *key,
+	  uint32_t sig,
+	  uint32_t *prev_id)
+{
+	uint32_t bkt_id = sig & (t->n_buckets - 1);
+	uint32_t rule_id, prev = 0;
+
+	for (rule_id = t->buckets[bkt_id]; rule_id; ) {
+		struct rule *r = &t->rules[rule_id - 1];
+
+		if ((r->tuple_id == tuple_id) &&
+		    (r->sig == sig) &&
+		    keycmp(rule_key(t, rule_id - 1), key, t->key_size)) {
+			if (prev_id)
+				*prev_id = prev;
+			return rule_id - 1;
+		}
+
+		prev = rule_id;
+		rule_id = r->next;
+	}
+
+	return -1;
+}
+
+static void
+rule_data_update(struct table *t,
+		 uint32_t rule_id,
+		 struct rte_swx_table_entry *entry)
+{
+	uint64_t *data = rule_data(t, rule_id);
+
+	data[0] = entry->action_id;
+	if (t->params.action_data_size)
+		memcpy(&data[1],
+		       entry->action_data,
+		       t->params.action_data_size);
+}
+
+/* Compute the effective mask, the masked key and the priority of an entry. */
+static void
+entry_read(struct table *t,
+	   struct rte_swx_table_entry *entry,
+	   uint8_t *mask,
+	   uint8_t *key,
+	   uint32_t *priority)
+{
+	uint32_t n_bits = 0, i;
+
+	memset(mask, 0, t->key_size);
+	memset(key, 0, t->key_size);
+
+	for (i = 0; i < t->params.key_size; i++) {
+		mask[i] = t->key_mask[i];
+		if (entry->key_mask)
+			mask[i] &= entry->key_mask[i];
+
+		key[i] = entry->key[i] & mask[i];
+		n_bits += __builtin_popcount(mask[i]);
+	}
+
+	/* Longest prefix first. */
+	if (t->params.match_type == RTE_SWX_TABLE_MATCH_LPM)
+		*priority = t->params.key_size * 8 - n_bits;
+	else
+		*priority = entry->key_priority;
+}
+
+#define CL RTE_CACHE_LINE_ROUNDUP
+
+static int
+__table_create(struct table **table,
+	       uint64_t *memory_footprint,
+	       struct rte_swx_table_params *params,
+	       const char *args __rte_unused,
+	       int numa_node)
+{
+	struct table *t;
+	uint8_t *memory;
+	size_t table_meta_sz, key_mask_sz, tuple_sz, tuple_mask_sz,
+		tuple_order_sz, tuple_stack_sz, bucket_sz, rule_sz, rule_key_sz,
+		rule_stack_sz, data_sz, total_size;
+	size_t key_mask_offset, tuple_offset, tuple_mask_offset,
+		tuple_order_offset, tuple_stack_offset, bucket_offset,
+		rule_offset, rule_key_offset, rule_stack_offset, data_offset;
+	uint32_t key_size, key_data_size, n_buckets, i;
+
+	/* Check input arguments. */
+	CHECK(params, EINVAL);
+	CHECK((params->match_type == RTE_SWX_TABLE_MATCH_WILDCARD) ||
+	      (params->match_type == RTE_SWX_TABLE_MATCH_LPM), EINVAL);
+	CHECK(params->key_size, EINVAL);
+	CHECK(params->key_size <= KEY_SIZE_MAX, EINVAL);
+	CHECK(params->n_keys_max, EINVAL);
+
+	/* Memory allocation. */
+	key_size = RTE_ALIGN_CEIL(params->key_size, sizeof(uint64_t));
+	key_data_size = RTE_ALIGN_CEIL(params->action_data_size + 8,
+				       sizeof(uint64_t));
+	n_buckets = rte_align32pow2(params->n_keys_max);
+
+	table_meta_sz = CL(sizeof(struct table));
+	key_mask_sz = CL(key_size);
+	tuple_sz = CL(params->n_keys_max * sizeof(struct tuple));
+	tuple_mask_sz = CL(params->n_keys_max * key_size);
+	tuple_order_sz = CL(params->n_keys_max * sizeof(uint32_t));
+	tuple_stack_sz = CL(params->n_keys_max * sizeof(uint32_t));
+	bucket_sz = CL(n_buckets * sizeof(uint32_t));
+	rule_sz = CL(params->n_keys_max * sizeof(struct rule));
+	rule_key_sz = CL(params->n_keys_max * key_size);
+	rule_stack_sz = CL(params->n_keys_max * sizeof(uint32_t));
+	data_sz = CL(params->n_keys_max * key_data_size);
+	total_size = table_meta_sz + key_mask_sz + tuple_sz + tuple_mask_sz +
+		     tuple_order_sz + tuple_stack_sz + bucket_sz + rule_sz +
+		     rule_key_sz + rule_stack_sz + data_sz;
+
+	key_mask_offset = table_meta_sz;
+	tuple_offset = key_mask_offset + key_mask_sz;
+	tuple_mask_offset = tuple_offset + tuple_sz;
+	tuple_order_offset = tuple_mask_offset + tuple_mask_sz;
+	tuple_stack_offset = tuple_order_offset + tuple_order_sz;
+	bucket_offset = tuple_stack_offset + tuple_stack_sz;
+	rule_offset = bucket_offset + bucket_sz;
+	rule_key_offset = rule_offset + rule_sz;
+	rule_stack_offset = rule_key_offset + rule_key_sz;
+	data_offset = rule_stack_offset + rule_stack_sz;
+
+	if (!table) {
+		if (memory_footprint)
+			*memory_footprint = total_size;
+		return 0;
+	}
+
+	memory = env_malloc(total_size, RTE_CACHE_LINE_SIZE, numa_node);
+	CHECK(memory,  ENOMEM);
+	memset(memory, 0, total_size);
+
+	/* Initialization. */
+	t = (struct table *)memory;
+	memcpy(&t->params, params, sizeof(*params));
+
+	t->key_size = key_size;
+	t->data_size = key_data_size;
+	t->n_buckets = n_buckets;
+	t->total_size = total_size;
+
+	t->key_mask = &memory[key_mask_offset];
+	t->tuples = (struct tuple *)&memory[tuple_offset];
+	t->tuple_masks = &memory[tuple_mask_offset];
+	t->tuple_order = (uint32_t *)&memory[tuple_order_offset];
+	t->tuple_stack = (uint32_t *)&memory[tuple_stack_offset];
+	t->buckets = (uint32_t *)&memory[bucket_offset];
+	t->rules = (struct rule *)&memory[rule_offset];
+	t->rule_keys = &memory[rule_key_offset];
+	t->rule_stack = (uint32_t *)&memory[rule_stack_offset];
+	t->data = &memory[data_offset];
+
+	t->params.key_mask0 = t->key_mask;
+
+	if (!params->key_mask0)
+		memset(t->key_mask, 0xFF, params->key_size);
+	else
+		memcpy(t->key_mask, params->key_mask0, params->key_size);
+
+	for (i = 0; i < t->params.n_keys_max; i++) {
+		t->rules[i].tuple_id = TUPLE_INVALID;
+		t->rule_stack[i] = t->params.n_keys_max - 1 - i;
+		t->tuple_stack[i] = t->params.n_keys_max - 1 - i;
+	}
+	t->rule_stack_tos = t->params.n_keys_max;
+	t->tuple_stack_tos = t->params.n_keys_max;
+
+	*table = t;
+	return 0;
+}
+
+static void
+table_free(void *table)
+{
+	struct table *t = table;
+
+	if (!t)
+		return;
+
+	env_free(t, t->total_size);
+}
+
+static int
+table_add(void *table, struct rte_swx_table_entry *entry)
+{
+	struct table *t = table;
+	uint64_t mask[KEY_SIZE_MAX / sizeof(uint64_t)];
+	uint64_t key[KEY_SIZE_MAX / sizeof(uint64_t)];
+	struct tuple *tp;
+	struct rule *r;
+	uint32_t priority, sig, bkt_id;
+	int tuple_id, rule_id;
+
+	CHECK(t, EINVAL);
+	CHECK(entry, EINVAL);
+	CHECK(entry->key, EINVAL);
+	CHECK((!t->params.action_data_size && !entry->action_data) ||
+	      (t->params.action_data_size && entry->action_data), EINVAL);
+
+	entry_read(t, entry, (uint8_t *)mask, (uint8_t *)key, &priority);
+
+	/* Key is present in the table: update its data and priority. */
+	tuple_id = tuple_find(t, (uint8_t *)mask);
+	if (tuple_id >= 0) {
+		sig = hash(key, t->key_size, tuple_id);
+		rule_id = rule_find(t, tuple_id, (uint8_t *)key, sig, NULL);
+		if (rule_id >= 0) {
+			r = &t->rules[rule_id];
+
+			rule_data_update(t, rule_id, entry);
+			if (r->priority != priority) {
+				r->priority = priority;
+				tuple_priority_update(t, tuple_id);
+				tuple_order_sort(t);
+			}
+
+			return 0;
+		}
+	}
+
+	/* Key is not present in the table. A free tuple is always available
+	 * when a free rule is, as each tuple has at least one rule.
+	 */
+	CHECK(t->rule_stack_tos, ENOSPC);
+
+	if (tuple_id < 0) {
+		tuple_id = t->tuple_stack[--t->tuple_stack_tos];
+		tp = &t->tuples[tuple_id];
+		tp->n_rules = 0;
+		tp->priority = UINT32_MAX;
+		memcpy(tuple_mask(t, tuple_id), mask, t->key_size);
+		t->tuple_order[t->n_tuples++] = tuple_id;
+	}
+
+	sig = hash(key, t->key_size, tuple_id);
+
+	/* Allocate new rule & install. */
+	rule_id = t->rule_stack[--t->rule_stack_tos];
+	r = &t->rules[rule_id];
+	r->tuple_id = tuple_id;
+	r->sig = sig;
+	r->priority = priority;
+	memcpy(rule_key(t, rule_id), key, t->key_size);
+	rule_data_update(t, rule_id, entry);
+
+	bkt_id = sig & (t->n_buckets - 1);
+	r->next = t->buckets[bkt_id];
+	t->buckets[bkt_id] = rule_id + 1;
+
+	tp = &t->tuples[tuple_id];
+	tp->n_rules++;
+	if (priority < tp->priority) {
+		tp->priority = priority;
+		tuple_order_sort(t);
+	}
+
+	return 0;
+}
+
+static int
+table_del(void *table, struct rte_swx_table_entry *entry)
+{
+	struct table *t = table;
+	uint64_t mask[KEY_SIZE_MAX / sizeof(uint64_t)];
+	uint64_t key[KEY_SIZE_MAX / sizeof(uint64_t)];
+	struct tuple *tp;
+	struct rule *r;
+	uint32_t priority, sig, prev_id, i;
+	int tuple_id, rule_id;
+
+	CHECK(t, EINVAL);
+	CHECK(entry, EINVAL);
+	CHECK(entry->key, EINVAL);
+
+	entry_read(t, entry, (uint8_t *)mask, (uint8_t *)key, &priority);
+
+	tuple_id = tuple_find(t, (uint8_t *)mask);
+	if (tuple_id < 0)
+		return 0;
+
+	sig = hash(key, t->key_size, tuple_id);
+	rule_id = rule_find(t, tuple_id, (uint8_t *)key, sig, &prev_id);
+	if (rule_id < 0)
+		return 0;
+
+	/* Rule free. */
+	r = &t->rules[rule_id];
+	if (prev_id)
+		t->rules[prev_id - 1].next = r->next;
+	else
+		t->buckets[sig & (t->n_buckets - 1)] = r->next;
+
+	r->next = 0;
+	r->tuple_id = TUPLE_INVALID;
+	t->rule_stack[t->rule_stack_tos++] = rule_id;
+
+	/* Tuple free if empty, otherwise its best priority is recomputed when
+	 * the rule was the one providing it.
+	 */
+	tp = &t->tuples[tuple_id];
+	tp->n_rules--;
+	if (!tp->n_rules) {
+		for (i = 0; i < t->n_tuples; i++)
+			if (t->tuple_order[i] == (uint32_t)tuple_id)
+				break;
+
+		memmove(&t->tuple_order[i],
+			&t->tuple_order[i + 1],
+			(t->n_tuples - i - 1) * sizeof(uint32_t));
+		t->n_tuples--;
+		t->tuple_stack[t->tuple_stack_tos++] = tuple_id;
+		return 0;
+	}
+
+	if (r->priority == tp->priority) {
+		tuple_priority_update(t, tuple_id);
+		tuple_order_sort(t);
+	}
+
+	return 0;
+}
+
+static uint64_t
+table_mailbox_size_get(void)
+{
+	return 0;
+}
+
+static int
+table_lookup(void *table,
+	     void *mailbox __rte_unused,
+	     uint8_t **key,
+	     uint64_t *action_id,
+	     uint8_t **action_data,
+	     int *hit)
+{
+	struct table *t = table;
+	uint64_t masked_key[KEY_SIZE_MAX / sizeof(uint64_t)];
+	uint8_t *input_key = &(*key)[t->params.key_offset];
+	uint32_t best_priority = 0, best_rule_id = 0, best_hit = 0, i;
+
+	for (i = 0; i < t->n_tuples; i++) {
+		uint32_t tuple_id = t->tuple_order[i];
+		struct tuple *tp = &t->tuples[tuple_id];
+		uint32_t sig, bkt_id, rule_id;
+
+		/* None of the remaining tuples can provide a better match. */
+		if (best_hit && (tp->priority >= best_priority))
+			break;
+
+		keycpy(masked_key, input_key, tuple_mask(t, tuple_id),
+		       t->key_size);
+		sig = hash(masked_key, t->key_size, tuple_id);
+		bkt_id = sig & (t->n_buckets - 1);
+
+		for (rule_id = t->buckets[bkt_id]; rule_id; ) {
+			struct rule *r = &t->rules[rule_id - 1];
+
+			if ((r->sig != sig) ||
+			    (r->tuple_id != tuple_id) ||
+			    !keycmp(rule_key(t, rule_id - 1), masked_key,
+				    t->key_size)) {
+				rule_id = r->next;
+				continue;
+			}
+
+			/* At most one rule per tuple matches the key. */
+			if (!best_hit || (r->priority < best_priority)) {
+				best_priority = r->priority;
+				best_rule_id = rule_id - 1;
+				best_hit = 1;
+			}
+			break;
+		}
+	}
+
+	if (best_hit) {
+		uint64_t *data = rule_data(t, best_rule_id);
+
+		*action_id = data[0];
+		*action_data = (uint8_t *)&data[1];
+	}
+
+	*hit = best_hit;
+	return 1;
+}
+
+static void *
+table_create(struct rte_swx_table_params *params,
+	     struct rte_swx_table_entry_list *entries,
+	     const char *args,
+	     int numa_node)
+{
+	struct table *t;
+	struct rte_swx_table_entry *entry;
+	int status;
+
+	/* Table create. */
+	status = __table_create(&t, NULL, params, args, numa_node);
+	if (status)
+		return NULL;
+
+	/* Table add entries. */
+	if (!entries)
+		return t;
+
+	TAILQ_FOREACH(entry, entries, node) {
+		int status;
+
+		status = table_add(t, entry);
+		if (status) {
+			table_free(t);
+			return NULL;
+		}
+	}
+
+	return t;
+}
+
+static uint64_t
+table_footprint(struct rte_swx_table_params *params,
+		struct rte_swx_table_entry_list *entries __rte_unused,
+		const char *args)
+{
+	uint64_t memory_footprint;
+	int status;
+
+	status = __table_create(NULL, &memory_footprint, params, args, 0);
+	if (status)
+		return 0;
+
+	return memory_footprint;
+}
+
+struct rte_swx_table_ops rte_swx_table_wildcard_match_ops = {
+	.footprint_get = table_footprint,
+	.mailbox_size_get = table_mailbox_size_get,
+	.create = table_create,
+	.add = table_add,
+	.del = table_del,
+	.lkp = table_lookup,
+	.free = table_free,
+};
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#ifndef __INCLUDE_RTE_SWX_TABLE_WM_H__
+#define __INCLUDE_RTE_SWX_TABLE_WM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE SWX Wildcard Match Table
+ *
+ * Tuple space search table: the entries sharing the same key mask are stored
+ * in the same hash tuple and the lookup probes the tuples in the order of
+ * their best entry priority, stopping as soon as none of the remaining tuples
+ * can provide a better match. The entry with the lowest *key_priority* value
+ * wins among the matching entries. When used for Longest Prefix Match (LPM),
+ * the entry priority is derived from the entry key mask, with the longest
+ * prefix winning.
+ */
+
+#include <stdint.h>
+
+#include <rte_swx_table.h>
+
+/** Wildcard match table operations. */
+extern struct rte_swx_table_ops rte_swx_table_wildcard_match_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
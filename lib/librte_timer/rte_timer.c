@@ -28,6 +28,34 @@
 
 #include "rte_timer.h"
 
+/* timer wheel geometry: 4 levels of 256 slots, i.e. 2^32 ticks */
+#define WHEEL_LEVELS		4
+#define WHEEL_SLOT_BITS		8
+#define WHEEL_SLOTS		(1 << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK		(WHEEL_SLOTS - 1)
+#define WHEEL_BMP_WORDS		(WHEEL_SLOTS / 64)
+/* timers further away are put at the end of the wheel, and cascaded again */
+#define WHEEL_MAX_DELTA	((1ULL << (WHEEL_LEVELS * WHEEL_SLOT_BITS)) - 1)
+
+/**
+ * Per-lcore hierarchical timer wheel.
+ *
+ * A timer is put in the level with a slot granularity fitting its distance
+ * to the current tick. The timers of a level 0 slot expire when the slot
+ * is reached, the timers of a higher level slot are cascaded to the lower
+ * levels when the slot is reached.
+ */
+struct timer_wheel {
+	uint64_t cur_tick;	/**< next tick to process */
+	uint64_t next_tick;	/**< no timer expires before this tick */
+	uint32_t shift;		/**< log2 of timer cycles per tick */
+	uint32_t nb_timers;	/**< number of timers in the wheel */
+	/** bitmap of the non-empty slots, per level */
+	uint64_t bmp[WHEEL_LEVELS][WHEEL_BMP_WORDS];
+	/** doubly linked lists of timers, per slot */
+	struct rte_timer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+} __rte_cache_aligned;
+
 /**
  * Per-lcore info for timers.
  */
@@ -47,6 +75,9 @@ struct priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** timer wheel, NULL if the timers are kept in the skiplist */
+	struct timer_wheel *wheel;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -56,10 +87,14 @@ struct priv_timer {
 #define FL_ALLOCATED	(1 << 0)
 struct rte_timer_data {
 	struct priv_timer priv_timer[RTE_MAX_LCORE];
+	/** memory of the per-lcore timer wheels, NULL for skiplists */
+	const struct rte_memzone *wheel_mz;
 	uint8_t internal_flags;
 };
 
 #define RTE_MAX_DATA_ELS 64
+/* max number of timers configured at once by the bulk functions */
+#define TIMER_BULK_SZ 64
 static const struct rte_memzone *rte_timer_data_mz;
 static int *volatile rte_timer_mz_refcnt;
 static struct rte_timer_data *rte_timer_data_arr;
@@ -115,12 +150,75 @@ rte_timer_data_alloc(uint32_t *id_ptr)
 	return -ENOSPC;
 }
 
+int
+rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t resolution)
+{
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	struct rte_timer_data *data;
+	struct timer_wheel *wheel;
+	uint64_t cur_tick;
+	uint32_t id, shift;
+	unsigned int lcore_id;
+	int ret;
+
+	if (resolution == 0)
+		return -EINVAL;
+
+	ret = rte_timer_data_alloc(&id);
+	if (ret < 0)
+		return ret;
+
+	snprintf(mz_name, sizeof(mz_name), "rte_timer_wheel_%u", id);
+	mz = rte_memzone_reserve_aligned(mz_name,
+			RTE_MAX_LCORE * sizeof(*wheel), SOCKET_ID_ANY, 0,
+			RTE_CACHE_LINE_SIZE);
+	if (mz == NULL) {
+		rte_timer_data_dealloc(id);
+		return -ENOMEM;
+	}
+	memset(mz->addr, 0, mz->len);
+
+	shift = rte_log2_u64(resolution);
+	cur_tick = rte_get_timer_cycles() >> shift;
+
+	data = &rte_timer_data_arr[id];
+	data->wheel_mz = mz;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheel = (struct timer_wheel *)mz->addr + lcore_id;
+		wheel->cur_tick = cur_tick;
+		wheel->next_tick = UINT64_MAX;
+		wheel->shift = shift;
+		data->priv_timer[lcore_id].wheel = wheel;
+	}
+
+	if (id_ptr)
+		*id_ptr = id;
+
+	return 0;
+}
+
+static void
+timer_data_free_wheel(struct rte_timer_data *timer_data)
+{
+	unsigned int lcore_id;
+
+	if (timer_data->wheel_mz == NULL)
+		return;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		timer_data->priv_timer[lcore_id].wheel = NULL;
+	rte_memzone_free(timer_data->wheel_mz);
+	timer_data->wheel_mz = NULL;
+}
+
 int
 rte_timer_data_dealloc(uint32_t id)
 {
 	struct rte_timer_data *timer_data;
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	timer_data_free_wheel(timer_data);
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
@@ -194,6 +292,8 @@ rte_timer_subsystem_init(void)
 void
 rte_timer_subsystem_finalize(void)
 {
+	int i;
+
 	rte_mcfg_timer_lock();
 
 	if (!rte_timer_subsystem_initialized) {
@@ -201,8 +301,11 @@ rte_timer_subsystem_finalize(void)
 		return;
 	}
 
-	if (--(*rte_timer_mz_refcnt) == 0)
+	if (--(*rte_timer_mz_refcnt) == 0) {
+		for (i = 0; i < RTE_MAX_DATA_ELS; i++)
+			timer_data_free_wheel(&rte_timer_data_arr[i]);
 		rte_memzone_free(rte_timer_data_mz);
+	}
 
 	rte_timer_subsystem_initialized = 0;
 
@@ -389,6 +492,233 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+/*
+ * The timers of a wheel slot are linked in a doubly linked list with the
+ * skiplist pointers: sl_next[0] is the next timer, sl_next[1] the previous
+ * one, and sl_next[2] stores the slot position + 1, or 0 when the timer is
+ * not in the wheel.
+ */
+#define WHEEL_NEXT(tim)	((tim)->sl_next[0])
+#define WHEEL_PREV(tim)	((tim)->sl_next[1])
+
+static inline uint32_t
+timer_wheel_get_pos(const struct rte_timer *tim)
+{
+	return (uint32_t)(uintptr_t)tim->sl_next[2];
+}
+
+static inline void
+timer_wheel_set_pos(struct rte_timer *tim, uint32_t pos)
+{
+	tim->sl_next[2] = (struct rte_timer *)(uintptr_t)pos;
+}
+
+/* tick of a timer, rounded up so that it never expires early */
+static inline uint64_t
+timer_wheel_tick(const struct timer_wheel *wheel, uint64_t expire)
+{
+	return (expire >> wheel->shift) +
+		((expire & ((1ULL << wheel->shift) - 1)) != 0);
+}
+
+/* link a timer in the slot of the wheel matching the tick */
+static void
+timer_wheel_link(struct timer_wheel *wheel, struct rte_timer *tim,
+		 uint64_t tick)
+{
+	uint64_t delta = tick - wheel->cur_tick;
+	struct rte_timer **head;
+	uint32_t lvl, slot;
+
+	if (delta > WHEEL_MAX_DELTA) {
+		delta = WHEEL_MAX_DELTA;
+		tick = wheel->cur_tick + delta;
+	}
+
+	lvl = (delta < WHEEL_SLOTS) ? 0 :
+		(rte_fls_u64(delta) - 1) / WHEEL_SLOT_BITS;
+	slot = (tick >> (lvl * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+
+	head = &wheel->slots[lvl][slot];
+	WHEEL_NEXT(tim) = *head;
+	WHEEL_PREV(tim) = NULL;
+	if (*head != NULL)
+		WHEEL_PREV(*head) = tim;
+	*head = tim;
+	timer_wheel_set_pos(tim, lvl * WHEEL_SLOTS + slot + 1);
+	wheel->bmp[lvl][slot / 64] |= 1ULL << (slot % 64);
+}
+
+/* unlink a timer from its wheel slot */
+static void
+timer_wheel_unlink(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	uint32_t pos = timer_wheel_get_pos(tim) - 1;
+	uint32_t lvl = pos / WHEEL_SLOTS;
+	uint32_t slot = pos % WHEEL_SLOTS;
+
+	if (WHEEL_PREV(tim) != NULL)
+		WHEEL_NEXT(WHEEL_PREV(tim)) = WHEEL_NEXT(tim);
+	else
+		wheel->slots[lvl][slot] = WHEEL_NEXT(tim);
+	if (WHEEL_NEXT(tim) != NULL)
+		WHEEL_PREV(WHEEL_NEXT(tim)) = WHEEL_PREV(tim);
+	if (wheel->slots[lvl][slot] == NULL)
+		wheel->bmp[lvl][slot / 64] &= ~(1ULL << (slot % 64));
+	timer_wheel_set_pos(tim, 0);
+}
+
+/* detach the list of timers of a wheel slot */
+static struct rte_timer *
+timer_wheel_take_slot(struct timer_wheel *wheel, uint32_t lvl, uint32_t slot)
+{
+	struct rte_timer *tim = wheel->slots[lvl][slot];
+
+	wheel->slots[lvl][slot] = NULL;
+	wheel->bmp[lvl][slot / 64] &= ~(1ULL << (slot % 64));
+	return tim;
+}
+
+/* add a timer in the wheel, with lock held as necessary */
+static void
+timer_wheel_add(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	uint64_t tick = timer_wheel_tick(wheel, tim->expire);
+
+	/* an expired timer runs on the next tick processed */
+	if (tick < wheel->cur_tick)
+		tick = wheel->cur_tick;
+	/* NOTE: this is not atomic on 32-bit */
+	if (tick < wheel->next_tick)
+		wheel->next_tick = tick;
+
+	timer_wheel_link(wheel, tim, tick);
+	wheel->nb_timers++;
+}
+
+/* remove a timer from the wheel, with lock held as necessary */
+static void
+timer_wheel_del(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	/* the timer may have been taken off the wheel by the manage
+	 * function, but failed to switch to running state
+	 */
+	if (timer_wheel_get_pos(tim) == 0)
+		return;
+
+	timer_wheel_unlink(wheel, tim);
+	wheel->nb_timers--;
+}
+
+/* first non-empty slot of a level from slot idx, wrapping, or -1 */
+static int
+timer_wheel_next_slot(const uint64_t *bmp, uint32_t idx)
+{
+	uint32_t i, word = idx / 64;
+	uint64_t bits = bmp[word] & (UINT64_MAX << (idx % 64));
+
+	for (i = 0; i <= WHEEL_BMP_WORDS; i++) {
+		if (bits != 0)
+			return word * 64 + rte_bsf64(bits);
+		word = (word + 1) % WHEEL_BMP_WORDS;
+		bits = bmp[word];
+	}
+	return -1;
+}
+
+/*
+ * First tick from tick *from* on which a slot of the wheel is reached,
+ * either to expire its timers or to cascade them, or UINT64_MAX.
+ */
+static uint64_t
+timer_wheel_next_event(const struct timer_wheel *wheel, uint64_t from)
+{
+	uint64_t tick, next = UINT64_MAX;
+	uint32_t lvl, shift, idx;
+	int slot;
+
+	for (lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		shift = lvl * WHEEL_SLOT_BITS;
+		/* first tick of the level granularity from *from* */
+		tick = (from >> shift) + ((from & ((1ULL << shift) - 1)) != 0);
+		idx = tick & WHEEL_SLOT_MASK;
+		slot = timer_wheel_next_slot(wheel->bmp[lvl], idx);
+		if (slot < 0)
+			continue;
+
+		tick = tick - idx + slot;
+		if ((uint32_t)slot < idx)
+			tick += WHEEL_SLOTS;
+		tick <<= shift;
+		if (tick < next)
+			next = tick;
+	}
+	return next;
+}
+
+/*
+ * Process the wheel up to the given tick, and return the expired timers in
+ * a list linked with sl_next[0], in running state. The slots are processed
+ * in order, skipping the empty ones, so that a whole slot of timers expires
+ * at once. Call with lock held.
+ */
+static struct rte_timer *
+timer_wheel_expire(struct timer_wheel *wheel, uint64_t now_tick)
+{
+	struct rte_timer *tim, *next_tim, *run_first_tim, **pprev;
+	uint64_t tick;
+	uint32_t lvl, shift;
+
+	run_first_tim = NULL;
+	pprev = &run_first_tim;
+
+	tick = timer_wheel_next_event(wheel, wheel->cur_tick);
+	while (tick <= now_tick) {
+		wheel->cur_tick = tick;
+
+		/* cascade the higher level slots reached on this tick */
+		for (lvl = 1; lvl < WHEEL_LEVELS; lvl++) {
+			shift = lvl * WHEEL_SLOT_BITS;
+			if ((tick & ((1ULL << shift) - 1)) != 0)
+				break;
+			tim = timer_wheel_take_slot(wheel, lvl,
+					(tick >> shift) & WHEEL_SLOT_MASK);
+			for ( ; tim != NULL; tim = next_tim) {
+				next_tim = WHEEL_NEXT(tim);
+				timer_wheel_link(wheel, tim,
+					timer_wheel_tick(wheel, tim->expire));
+			}
+		}
+
+		/* transition the level 0 slot from PENDING to RUNNING */
+		tim = timer_wheel_take_slot(wheel, 0, tick & WHEEL_SLOT_MASK);
+		for ( ; tim != NULL; tim = next_tim) {
+			next_tim = WHEEL_NEXT(tim);
+			timer_wheel_set_pos(tim, 0);
+			wheel->nb_timers--;
+
+			/* another core may be trying to re-config this one,
+			 * leave it out of the run list
+			 */
+			if (likely(timer_set_running_state(tim) == 0)) {
+				*pprev = tim;
+				pprev = &tim->sl_next[0];
+			}
+		}
+
+		tick = timer_wheel_next_event(wheel, tick + 1);
+	}
+	*pprev = NULL;
+
+	/* timers added from now on are relative to the next tick */
+	if (wheel->cur_tick <= now_tick)
+		wheel->cur_tick = now_tick + 1;
+	/* NOTE: this is not atomic on 32-bit */
+	wheel->next_tick = tick;
+
+	return run_first_tim;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -401,6 +731,11 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
+	if (priv_timer[tim_lcore].wheel != NULL) {
+		timer_wheel_add(priv_timer[tim_lcore].wheel, tim);
+		return;
+	}
+
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev, priv_timer);
@@ -427,24 +762,21 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 }
 
 /*
- * del from list, lock if needed
+ * del from list of lcore prev_owner, with its lock held
  * timer must be in config state
  * timer must be in a list
  */
 static void
-timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
-	  int local_is_locked, struct priv_timer *priv_timer)
+timer_del_locked(struct rte_timer *tim, unsigned int prev_owner,
+		 struct priv_timer *priv_timer)
 {
-	unsigned lcore_id = rte_lcore_id();
-	unsigned prev_owner = prev_status.owner;
 	int i;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
-	/* if timer needs is pending another core, we need to lock the
-	 * list; if it is on local core, we need to lock if we are not
-	 * called from rte_timer_manage() */
-	if (prev_owner != lcore_id || !local_is_locked)
-		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+	if (priv_timer[prev_owner].wheel != NULL) {
+		timer_wheel_del(priv_timer[prev_owner].wheel, tim);
+		return;
+	}
 
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
@@ -465,11 +797,85 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 			priv_timer[prev_owner].curr_skiplist_depth --;
 		else
 			break;
+}
+
+/*
+ * del from list, lock if needed
+ * timer must be in config state
+ * timer must be in a list
+ */
+static void
+timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
+	  int local_is_locked, struct priv_timer *priv_timer)
+{
+	unsigned lcore_id = rte_lcore_id();
+	unsigned prev_owner = prev_status.owner;
+
+	/* if timer needs is pending another core, we need to lock the
+	 * list; if it is on local core, we need to lock if we are not
+	 * called from rte_timer_manage() */
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+
+	timer_del_locked(tim, prev_owner, priv_timer);
 
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
 
+/*
+ * del the pending timers of a bulk from their lists, taking the lock of
+ * each owner lcore once
+ * timers must be in config state
+ */
+static void
+timer_del_bulk(struct rte_timer **tims, union rte_timer_status *prev_status,
+	       unsigned int nb_tims, struct priv_timer *priv_timer)
+{
+	unsigned int i, j, prev_owner;
+
+	for (i = 0; i < nb_tims; i++) {
+		if (prev_status[i].state != RTE_TIMER_PENDING)
+			continue;
+
+		prev_owner = prev_status[i].owner;
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+		for (j = i; j < nb_tims; j++) {
+			if (prev_status[j].state != RTE_TIMER_PENDING ||
+			    (unsigned int)prev_status[j].owner != prev_owner)
+				continue;
+			timer_del_locked(tims[j], prev_owner, priv_timer);
+			__TIMER_STAT_ADD(priv_timer, pending, -1);
+			/* mark the timer as removed */
+			prev_status[j].state = RTE_TIMER_CONFIG;
+		}
+		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
+	}
+}
+
+/* pick the lcore of a timer, round robin for LCORE_ID_ANY */
+static unsigned int
+timer_get_target_lcore(unsigned int tim_lcore, struct priv_timer *priv_timer)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (tim_lcore != (unsigned int)LCORE_ID_ANY)
+		return tim_lcore;
+
+	if (lcore_id < RTE_MAX_LCORE) {
+		/* EAL thread with valid lcore_id */
+		tim_lcore = rte_get_next_lcore(
+			priv_timer[lcore_id].prev_lcore,
+			0, 1);
+		priv_timer[lcore_id].prev_lcore = tim_lcore;
+	} else
+		/* non-EAL thread do not run rte_timer_manage(),
+		 * so schedule the timer on the first enabled lcore. */
+		tim_lcore = rte_get_next_lcore(LCORE_ID_ANY, 0, 1);
+
+	return tim_lcore;
+}
+
 /* Reset and start the timer associated with the timer handle (private func) */
 static int
 __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
@@ -484,18 +890,7 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 	struct priv_timer *priv_timer = timer_data->priv_timer;
 
 	/* round robin for tim_lcore */
-	if (tim_lcore == (unsigned)LCORE_ID_ANY) {
-		if (lcore_id < RTE_MAX_LCORE) {
-			/* EAL thread with valid lcore_id */
-			tim_lcore = rte_get_next_lcore(
-				priv_timer[lcore_id].prev_lcore,
-				0, 1);
-			priv_timer[lcore_id].prev_lcore = tim_lcore;
-		} else
-			/* non-EAL thread do not run rte_timer_manage(),
-			 * so schedule the timer on the first enabled lcore. */
-			tim_lcore = rte_get_next_lcore(LCORE_ID_ANY, 0, 1);
-	}
+	tim_lcore = timer_get_target_lcore(tim_lcore, priv_timer);
 
 	/* wait that the timer is in correct status before update,
 	 * and mark it as being configured */
@@ -586,6 +981,127 @@ rte_timer_reset_sync(struct rte_timer *tim, uint64_t ticks,
 		rte_pause();
 }
 
+/*
+ * mark up to nb_tims timers as configured, stopping at the first one
+ * running or being configured on another core, and return their number
+ */
+static unsigned int
+timer_set_config_state_bulk(struct rte_timer **tims,
+			    union rte_timer_status *prev_status,
+			    unsigned int nb_tims, struct priv_timer *priv_timer)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	unsigned int i;
+
+	for (i = 0; i < nb_tims; i++) {
+		if (timer_set_config_state(tims[i], &prev_status[i],
+					   priv_timer) < 0)
+			break;
+
+		if (prev_status[i].state == RTE_TIMER_RUNNING &&
+		    lcore_id < RTE_MAX_LCORE)
+			priv_timer[lcore_id].updated = 1;
+	}
+
+	return i;
+}
+
+/* Reset and start a bulk of at most TIMER_BULK_SZ timers (private func) */
+static unsigned int
+__rte_timer_reset_bulk(struct rte_timer **tims, unsigned int nb_tims,
+		       uint64_t expire, uint64_t period,
+		       unsigned int tim_lcore, rte_timer_cb_t fct,
+		       void * const *args, struct rte_timer_data *timer_data)
+{
+	union rte_timer_status prev_status[TIMER_BULK_SZ], status;
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+	struct rte_timer *tim;
+	unsigned int i;
+
+	nb_tims = timer_set_config_state_bulk(tims, prev_status, nb_tims,
+					      priv_timer);
+	if (nb_tims == 0)
+		return 0;
+
+	__TIMER_STAT_ADD(priv_timer, reset, nb_tims);
+
+	/* remove them from their lists */
+	timer_del_bulk(tims, prev_status, nb_tims, priv_timer);
+
+	/* add them to the list of the target lcore at once */
+	status.state = RTE_TIMER_PENDING;
+	status.owner = (int16_t)tim_lcore;
+
+	rte_spinlock_lock(&priv_timer[tim_lcore].list_lock);
+
+	for (i = 0; i < nb_tims; i++) {
+		tim = tims[i];
+		tim->period = period;
+		tim->expire = expire;
+		tim->f = fct;
+		tim->arg = (args == NULL) ? NULL : args[i];
+
+		timer_add(tim, tim_lcore, priv_timer);
+
+		/* The "RELEASE" ordering guarantees the memory operations
+		 * above the status update are observed before the update by
+		 * all threads
+		 */
+		__atomic_store_n(&tim->status.u32, status.u32,
+				 __ATOMIC_RELEASE);
+	}
+	__TIMER_STAT_ADD(priv_timer, pending, nb_tims);
+
+	rte_spinlock_unlock(&priv_timer[tim_lcore].list_lock);
+
+	return nb_tims;
+}
+
+/* Reset and start several timers */
+int
+rte_timer_reset_bulk(struct rte_timer **tims, unsigned int nb_tims,
+		     uint64_t ticks, enum rte_timer_type type,
+		     unsigned int tim_lcore, rte_timer_cb_t fct,
+		     void * const *args)
+{
+	return rte_timer_alt_reset_bulk(default_data_id, tims, nb_tims, ticks,
+					type, tim_lcore, fct, args);
+}
+
+int
+rte_timer_alt_reset_bulk(uint32_t timer_data_id, struct rte_timer **tims,
+			 unsigned int nb_tims, uint64_t ticks,
+			 enum rte_timer_type type, unsigned int tim_lcore,
+			 rte_timer_cb_t fct, void * const *args)
+{
+	uint64_t cur_time = rte_get_timer_cycles();
+	uint64_t period;
+	unsigned int i, n, ret;
+	struct rte_timer_data *timer_data;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+
+	if (type == PERIODICAL)
+		period = ticks;
+	else
+		period = 0;
+
+	/* all the timers go to the same lcore */
+	tim_lcore = timer_get_target_lcore(tim_lcore, timer_data->priv_timer);
+
+	for (i = 0; i < nb_tims; i += n) {
+		n = RTE_MIN(nb_tims - i, (unsigned int)TIMER_BULK_SZ);
+		ret = __rte_timer_reset_bulk(&tims[i], n, cur_time + ticks,
+					     period, tim_lcore, fct,
+					     (args == NULL) ? NULL : &args[i],
+					     timer_data);
+		if (ret != n)
+			return i + ret;
+	}
+
+	return nb_tims;
+}
+
 static int
 __rte_timer_stop(struct rte_timer *tim, int local_is_locked,
 		 struct rte_timer_data *timer_data)
@@ -641,6 +1157,65 @@ rte_timer_alt_stop(uint32_t timer_data_id, struct rte_timer *tim)
 	return __rte_timer_stop(tim, 0, timer_data);
 }
 
+/* Stop a bulk of at most TIMER_BULK_SZ timers (private func) */
+static unsigned int
+__rte_timer_stop_bulk(struct rte_timer **tims, unsigned int nb_tims,
+		      struct rte_timer_data *timer_data)
+{
+	union rte_timer_status prev_status[TIMER_BULK_SZ], status;
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+	unsigned int i;
+
+	nb_tims = timer_set_config_state_bulk(tims, prev_status, nb_tims,
+					      priv_timer);
+	if (nb_tims == 0)
+		return 0;
+
+	__TIMER_STAT_ADD(priv_timer, stop, nb_tims);
+
+	/* remove them from their lists */
+	timer_del_bulk(tims, prev_status, nb_tims, priv_timer);
+
+	/* mark timers as stopped */
+	status.state = RTE_TIMER_STOP;
+	status.owner = RTE_TIMER_NO_OWNER;
+	for (i = 0; i < nb_tims; i++)
+		/* The "RELEASE" ordering guarantees the memory operations
+		 * above the status update are observed before the update by
+		 * all threads
+		 */
+		__atomic_store_n(&tims[i]->status.u32, status.u32,
+				 __ATOMIC_RELEASE);
+
+	return nb_tims;
+}
+
+/* Stop several timers */
+int
+rte_timer_stop_bulk(struct rte_timer **tims, unsigned int nb_tims)
+{
+	return rte_timer_alt_stop_bulk(default_data_id, tims, nb_tims);
+}
+
+int
+rte_timer_alt_stop_bulk(uint32_t timer_data_id, struct rte_timer **tims,
+			unsigned int nb_tims)
+{
+	unsigned int i, n, ret;
+	struct rte_timer_data *timer_data;
+
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+
+	for (i = 0; i < nb_tims; i += n) {
+		n = RTE_MIN(nb_tims - i, (unsigned int)TIMER_BULK_SZ);
+		ret = __rte_timer_stop_bulk(&tims[i], n, timer_data);
+		if (ret != n)
+			return i + ret;
+	}
+
+	return nb_tims;
+}
+
 /* loop until rte_timer_stop() succeed */
 void
 rte_timer_stop_sync(struct rte_timer *tim)
@@ -657,59 +1232,76 @@ rte_timer_pending(struct rte_timer *tim)
 				__ATOMIC_RELAXED) == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-static void
-__rte_timer_manage(struct rte_timer_data *timer_data)
+/*
+ * Take the expired timers off the pending timers of an lcore, and return
+ * them in a run list linked with sl_next[0], in RUNNING state.
+ */
+static struct rte_timer *
+timer_get_run_list(unsigned int lcore_id, struct priv_timer *priv_timer)
 {
-	union rte_timer_status status;
+	struct priv_timer *privp = &priv_timer[lcore_id];
 	struct rte_timer *tim, *next_tim;
 	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
+	uint64_t cur_time, cur_tick;
 	int i, ret;
-	struct priv_timer *priv_timer = timer_data->priv_timer;
 
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
+	if (privp->wheel != NULL) {
+		/* optimize for the case where the wheel is empty */
+		if (privp->wheel->nb_timers == 0)
+			return NULL;
+		cur_tick = rte_get_timer_cycles() >> privp->wheel->shift;
+
+#ifdef RTE_ARCH_64
+		/* as for the skiplist, the next tick can be checked outside
+		 * the lock on 64-bit
+		 */
+		if (likely(privp->wheel->next_tick > cur_tick))
+			return NULL;
+#endif
+
+		rte_spinlock_lock(&privp->list_lock);
+		run_first_tim = timer_wheel_expire(privp->wheel, cur_tick);
+		rte_spinlock_unlock(&privp->list_lock);
+
+		return run_first_tim;
+	}
 
-	__TIMER_STAT_ADD(priv_timer, manage, 1);
 	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
+	if (privp->pending_head.sl_next[0] == NULL)
+		return NULL;
 	cur_time = rte_get_timer_cycles();
 
 #ifdef RTE_ARCH_64
 	/* on 64-bit the value cached in the pending_head.expired will be
 	 * updated atomically, so we can consult that for a quick check here
 	 * outside the lock */
-	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
+	if (likely(privp->pending_head.expire > cur_time))
+		return NULL;
 #endif
 
 	/* browse ordered list, add expired timers in 'expired' list */
-	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
+	rte_spinlock_lock(&privp->list_lock);
 
 	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
-		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
+	if (privp->pending_head.sl_next[0] == NULL ||
+	    privp->pending_head.sl_next[0]->expire > cur_time) {
+		rte_spinlock_unlock(&privp->list_lock);
+		return NULL;
 	}
 
 	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
+	tim = privp->pending_head.sl_next[0];
 
 	/* break the existing list at current time point */
 	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
+	for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+		if (prev[i] == &privp->pending_head)
 			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
+		privp->pending_head.sl_next[i] = prev[i]->sl_next[i];
 		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
+			privp->curr_skiplist_depth--;
+		prev[i]->sl_next[i] = NULL;
 	}
 
 	/* transition run-list from PENDING to RUNNING */
@@ -731,11 +1323,32 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 	}
 
 	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
+	privp->pending_head.expire =
+	    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+		privp->pending_head.sl_next[0]->expire;
 
-	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+	rte_spinlock_unlock(&privp->list_lock);
+
+	return run_first_tim;
+}
+
+/* must be called periodically, run all timer that expired */
+static void
+__rte_timer_manage(struct rte_timer_data *timer_data)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = timer_data->priv_timer;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+	run_first_tim = timer_get_run_list(lcore_id, priv_timer);
+	if (run_first_tim == NULL)
+		return;
 
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
@@ -804,15 +1417,12 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 {
 	unsigned int default_poll_lcores[] = {rte_lcore_id()};
 	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim, **pprev;
+	struct rte_timer *tim;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
-	uint64_t cur_time;
-	int i, j, ret;
+	int i;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
-	struct priv_timer *privp;
 	uint32_t poll_lcore;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, data, -EINVAL);
@@ -829,74 +1439,10 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 
 	for (i = 0; i < nb_poll_lcores; i++) {
 		poll_lcore = poll_lcores[i];
-		privp = &data->priv_timer[poll_lcore];
 
-		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
-			continue;
-		cur_time = rte_get_timer_cycles();
-
-#ifdef RTE_ARCH_64
-		/* on 64-bit the value cached in the pending_head.expired will
-		 * be updated atomically, so we can consult that for a quick
-		 * check here outside the lock
-		 */
-		if (likely(privp->pending_head.expire > cur_time))
-			continue;
-#endif
-
-		/* browse ordered list, add expired timers in 'expired' list */
-		rte_spinlock_lock(&privp->list_lock);
-
-		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
-			rte_spinlock_unlock(&privp->list_lock);
-			continue;
-		}
-
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
-		/* transition run-list from PENDING to RUNNING */
-		run_first_tims[nb_runlists] = tim;
-		pprev = &run_first_tims[nb_runlists];
-		nb_runlists++;
-
-		for ( ; tim != NULL; tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			ret = timer_set_running_state(tim);
-			if (likely(ret == 0)) {
-				pprev = &tim->sl_next[0];
-			} else {
-				/* another core is trying to re-config this one,
-				 * remove it from local expired list
-				 */
-				*pprev = next_tim;
-			}
-		}
-
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
-		rte_spinlock_unlock(&privp->list_lock);
+		tim = timer_get_run_list(poll_lcore, data->priv_timer);
+		if (tim != NULL)
+			run_first_tims[nb_runlists++] = tim;
 	}
 
 	/* Now process the run lists */
@@ -976,6 +1522,31 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* stop all the timers of a wheel, with lock held */
+static void
+timer_wheel_stop_all(struct timer_wheel *wheel,
+		     struct rte_timer_data *timer_data,
+		     rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct rte_timer *tim, *next_tim;
+	uint32_t lvl, slot;
+
+	for (lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		for (slot = 0; slot < WHEEL_SLOTS; slot++) {
+			for (tim = wheel->slots[lvl][slot]; tim != NULL;
+			     tim = next_tim) {
+				next_tim = WHEEL_NEXT(tim);
+
+				/* Call timer_stop with lock held */
+				__rte_timer_stop(tim, 1, timer_data);
+
+				if (f)
+					f(tim, f_arg);
+			}
+		}
+	}
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -996,6 +1567,13 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 
 		rte_spinlock_lock(&priv_timer->list_lock);
 
+		if (priv_timer->wheel != NULL) {
+			timer_wheel_stop_all(priv_timer->wheel, timer_data,
+					     f, f_arg);
+			rte_spinlock_unlock(&priv_timer->list_lock);
+			continue;
+		}
+
 		for (tim = priv_timer->pending_head.sl_next[0];
 		     tim != NULL;
 		     tim = next_tim) {
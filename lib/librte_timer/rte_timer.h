@@ -146,6 +146,38 @@ struct rte_timer
  */
 int rte_timer_data_alloc(uint32_t *id_ptr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance in shared memory, tracking its pending
+ * timers in per-lcore hierarchical timer wheels instead of skiplists.
+ *
+ * Starting and stopping a timer of this instance is done in constant time,
+ * whatever the number of pending timers. In exchange, the expiry time of
+ * the timers is rounded up to the wheel resolution: a timer never expires
+ * early, but may expire up to one resolution late, and the timers expiring
+ * within the same resolution period are not ordered.
+ *
+ * The timer data instance is used with the rte_timer_alt_*() functions,
+ * like the instances returned by rte_timer_data_alloc().
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param resolution
+ *   Resolution of the timer wheel, in timer cycles. It is rounded up to a
+ *   power of 2.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid resolution
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ *   - -ENOMEM: the timer wheels could not be allocated
+ */
+__rte_experimental
+int rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t resolution);
+
 /**
  * Deallocate a timer data instance.
  *
@@ -274,6 +306,54 @@ rte_timer_reset_sync(struct rte_timer *tim, uint64_t ticks,
 		     enum rte_timer_type type, unsigned tim_lcore,
 		     rte_timer_cb_t fct, void *arg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset and start several timers.
+ *
+ * The timers are reset with the same parameters as with rte_timer_reset(),
+ * except for the argument of the callback function. The lock of the timer
+ * list of each lcore involved is taken once for the whole bulk, instead of
+ * once per timer.
+ *
+ * The timers are reset in order, up to the first one in the RUNNING or
+ * CONFIG state: this one and the following ones are left unchanged.
+ * A timer must not appear twice in the array.
+ *
+ * @param tims
+ *   An array of timer handles.
+ * @param nb_tims
+ *   The number of timers in the array.
+ * @param ticks
+ *   The number of cycles (see rte_get_hpet_hz()) before the callback
+ *   function is called.
+ * @param type
+ *   The type can be either:
+ *   - PERIODICAL: The timers are automatically reloaded after execution
+ *     (returns to the PENDING state)
+ *   - SINGLE: The timers are one-shot, that is, the timers go to a
+ *     STOPPED state after execution.
+ * @param tim_lcore
+ *   The ID of the lcore where the timer callback functions have to be
+ *   executed. If tim_lcore is LCORE_ID_ANY, the timer library will
+ *   launch all the timers of the bulk on a different core for each call
+ *   (round-robin).
+ * @param fct
+ *   The callback function of the timers.
+ * @param args
+ *   An array of *nb_tims* user arguments of the callback function, one per
+ *   timer, or NULL to use a NULL argument for all the timers.
+ * @return
+ *   - The number of timers scheduled, from the start of the array.
+ */
+__rte_experimental
+int
+rte_timer_reset_bulk(struct rte_timer **tims, unsigned int nb_tims,
+		     uint64_t ticks, enum rte_timer_type type,
+		     unsigned int tim_lcore, rte_timer_cb_t fct,
+		     void * const *args);
+
 /**
  * Stop a timer.
  *
@@ -316,6 +396,32 @@ int rte_timer_stop(struct rte_timer *tim);
  */
 void rte_timer_stop_sync(struct rte_timer *tim);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Stop several timers.
+ *
+ * The lock of the timer list of each lcore involved is taken once for the
+ * whole bulk, instead of once per timer.
+ *
+ * The timers are stopped in order, up to the first one in the RUNNING or
+ * CONFIG state: this one and the following ones are left unchanged.
+ * A timer must not appear twice in the array.
+ *
+ * @see rte_timer_stop()
+ *
+ * @param tims
+ *   An array of timer handles.
+ * @param nb_tims
+ *   The number of timers in the array.
+ * @return
+ *   - The number of timers stopped, from the start of the array.
+ */
+__rte_experimental
+int
+rte_timer_stop_bulk(struct rte_timer **tims, unsigned int nb_tims);
+
 /**
  * Test if a timer is pending.
  *
@@ -435,6 +541,80 @@ rte_timer_alt_reset(uint32_t timer_data_id, struct rte_timer *tim,
 int
 rte_timer_alt_stop(uint32_t timer_data_id, struct rte_timer *tim);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * This function is the same as rte_timer_reset_bulk(), except that it allows
+ * a caller to specify the rte_timer_data instance containing the list to
+ * which the timers should be added.
+ *
+ * @see rte_timer_reset_bulk()
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used for
+ *   this operation.
+ * @param tims
+ *   An array of timer handles.
+ * @param nb_tims
+ *   The number of timers in the array.
+ * @param ticks
+ *   The number of cycles (see rte_get_hpet_hz()) before the callback
+ *   function is called.
+ * @param type
+ *   The type can be either:
+ *   - PERIODICAL: The timers are automatically reloaded after execution
+ *     (returns to the PENDING state)
+ *   - SINGLE: The timers are one-shot, that is, the timers go to a
+ *     STOPPED state after execution.
+ * @param tim_lcore
+ *   The ID of the lcore where the timer callback functions have to be
+ *   executed. If tim_lcore is LCORE_ID_ANY, the timer library will
+ *   launch all the timers of the bulk on a different core for each call
+ *   (round-robin).
+ * @param fct
+ *   The callback function of the timers. This parameter can be NULL if (and
+ *   only if) rte_timer_alt_manage() will be used to manage these timers.
+ * @param args
+ *   An array of *nb_tims* user arguments of the callback function, one per
+ *   timer, or NULL to use a NULL argument for all the timers.
+ * @return
+ *   - The number of timers scheduled, from the start of the array.
+ *   - -EINVAL: invalid timer_data_id
+ */
+__rte_experimental
+int
+rte_timer_alt_reset_bulk(uint32_t timer_data_id, struct rte_timer **tims,
+			 unsigned int nb_tims, uint64_t ticks,
+			 enum rte_timer_type type, unsigned int tim_lcore,
+			 rte_timer_cb_t fct, void * const *args);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * This function is the same as rte_timer_stop_bulk(), except that it allows
+ * a caller to specify the rte_timer_data instance containing the lists from
+ * which the timers should be removed.
+ *
+ * @see rte_timer_stop_bulk()
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used for
+ *   this operation.
+ * @param tims
+ *   An array of timer handles.
+ * @param nb_tims
+ *   The number of timers in the array.
+ * @return
+ *   - The number of timers stopped, from the start of the array.
+ *   - -EINVAL: invalid timer_data_id
+ */
+__rte_experimental
+int
+rte_timer_alt_stop_bulk(uint32_t timer_data_id, struct rte_timer **tims,
+			unsigned int nb_tims);
+
 /**
  * Callback function type for rte_timer_alt_manage().
  */
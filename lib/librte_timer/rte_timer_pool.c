@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_log.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_string_fns.h>
+#include <rte_ring_elem.h>
+
+#include "rte_timer.h"
+#include "rte_timer_pool.h"
+
+/* create a timer pool */
+struct rte_timer_pool *
+rte_timer_pool_create(const char *name, uint32_t nb_timers, int socket_id)
+{
+	char ring_name[RTE_RING_NAMESIZE];
+	struct rte_timer_pool *pool;
+	struct rte_ring *r;
+	rte_timer_handle_t handle;
+	int ret;
+
+	if (name == NULL || nb_timers == 0 ||
+			nb_timers >= RTE_TIMER_HANDLE_INVALID ||
+			nb_timers > RTE_RING_SZ_MASK) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	ret = snprintf(ring_name, sizeof(ring_name), "%s%s",
+			RTE_TIMER_POOL_RING_PREFIX, name);
+	if (ret < 0 || ret >= (int)sizeof(ring_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	r = rte_ring_create_elem(ring_name, sizeof(rte_timer_handle_t),
+			nb_timers, socket_id, RING_F_EXACT_SZ);
+	if (r == NULL)
+		return NULL;
+
+	pool = rte_zmalloc_socket(name, sizeof(*pool) +
+			(size_t)nb_timers * sizeof(pool->timers[0]),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (pool == NULL) {
+		RTE_LOG(ERR, TIMER, "Cannot reserve memory for timer pool %s\n",
+			name);
+		rte_ring_free(r);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	strlcpy(pool->name, name, sizeof(pool->name));
+	pool->nb_timers = nb_timers;
+	pool->free_handles = r;
+
+	for (handle = 0; handle < nb_timers; handle++) {
+		rte_timer_init(&pool->timers[handle]);
+		rte_ring_enqueue_elem(r, &handle, sizeof(handle));
+	}
+
+	return pool;
+}
+
+/* free a timer pool */
+void
+rte_timer_pool_free(struct rte_timer_pool *pool)
+{
+	if (pool == NULL)
+		return;
+
+	rte_ring_free(pool->free_handles);
+	rte_free(pool);
+}
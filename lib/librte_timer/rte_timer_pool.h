@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_TIMER_POOL_H_
+#define _RTE_TIMER_POOL_H_
+
+/**
+ * @file
+ * RTE Timer Pool
+ *
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * A timer pool allocates timers from a contiguous array, and identifies
+ * them with 32-bit handles. Objects with a timer, such as flow table
+ * entries, can store a handle instead of embedding a struct rte_timer,
+ * keeping the objects small and the timers packed together.
+ *
+ * The timers of a pool are regular timers, used with the rte_timer_*()
+ * functions after converting their handles with rte_timer_pool_get_timer().
+ * For instance, the timers of a burst of flows can be armed at once with
+ * rte_timer_alt_reset_bulk().
+ *
+ * The free handles are kept in a ring, so the timers can be allocated and
+ * freed by several threads.
+ */
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <rte_compat.h>
+#include <rte_common.h>
+#include <rte_ring_elem.h>
+
+#include "rte_timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Prefix of the name of the ring of free handles of a timer pool. */
+#define RTE_TIMER_POOL_RING_PREFIX "TP_"
+/** Maximum length of a timer pool name. */
+#define RTE_TIMER_POOL_NAMESIZE (RTE_RING_NAMESIZE - \
+				 sizeof(RTE_TIMER_POOL_RING_PREFIX) + 1)
+
+/** Handle of a timer of a timer pool. */
+typedef uint32_t rte_timer_handle_t;
+
+/** Invalid timer handle, never returned by rte_timer_pool_alloc_bulk(). */
+#define RTE_TIMER_HANDLE_INVALID UINT32_MAX
+
+/**
+ * A timer pool.
+ */
+struct rte_timer_pool {
+	char name[RTE_TIMER_POOL_NAMESIZE]; /**< Name of the timer pool. */
+	uint32_t nb_timers;		/**< Number of timers in the pool. */
+	struct rte_ring *free_handles;	/**< Handles of free timers. */
+	/** Timers of the pool, indexed by their handle. */
+	struct rte_timer timers[] __rte_cache_aligned;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a timer pool.
+ *
+ * @param name
+ *   The name of the timer pool.
+ * @param nb_timers
+ *   The number of timers of the pool.
+ * @param socket_id
+ *   The *socket_id* argument is the socket identifier in case of NUMA.
+ *   The value can be *SOCKET_ID_ANY* if there is no NUMA constraint.
+ * @return
+ *   The timer pool on success, NULL on error with rte_errno set:
+ *    - EINVAL - invalid parameter
+ *    - ENAMETOOLONG - the name is too long
+ *    - ENOMEM - the memory could not be allocated
+ *    - EEXIST - a timer pool with the same name already exists
+ */
+__rte_experimental
+struct rte_timer_pool *
+rte_timer_pool_create(const char *name, uint32_t nb_timers, int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a timer pool. The timers of the pool must be stopped.
+ *
+ * @param pool
+ *   The timer pool to free.
+ */
+__rte_experimental
+void
+rte_timer_pool_free(struct rte_timer_pool *pool);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate several timers from a timer pool. The timers are stopped.
+ *
+ * @param pool
+ *   The timer pool.
+ * @param handles
+ *   An array of *n* handles, filled with the handles of the timers.
+ * @param n
+ *   The number of timers to allocate.
+ * @return
+ *   - 0: Success, the handles are filled.
+ *   - -ENOENT: not enough free timers, no timer is allocated.
+ */
+__rte_experimental
+static inline int
+rte_timer_pool_alloc_bulk(struct rte_timer_pool *pool,
+			  rte_timer_handle_t *handles, unsigned int n)
+{
+	if (rte_ring_dequeue_bulk_elem(pool->free_handles, handles,
+			sizeof(rte_timer_handle_t), n, NULL) != n)
+		return -ENOENT;
+	return 0;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free several timers to their timer pool. The timers must be stopped.
+ *
+ * @param pool
+ *   The timer pool.
+ * @param handles
+ *   An array of *n* handles of timers allocated from the pool.
+ * @param n
+ *   The number of timers to free.
+ */
+__rte_experimental
+static inline void
+rte_timer_pool_free_bulk(struct rte_timer_pool *pool,
+			 const rte_timer_handle_t *handles, unsigned int n)
+{
+	/* the ring can hold all the handles, so this cannot fail */
+	rte_ring_enqueue_bulk_elem(pool->free_handles, handles,
+			sizeof(rte_timer_handle_t), n, NULL);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the timer of a handle.
+ *
+ * @param pool
+ *   The timer pool.
+ * @param handle
+ *   The handle of a timer of the pool.
+ * @return
+ *   The timer.
+ */
+__rte_experimental
+static inline struct rte_timer *
+rte_timer_pool_get_timer(struct rte_timer_pool *pool,
+			 rte_timer_handle_t handle)
+{
+	return &pool->timers[handle];
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the handle of a timer, for instance from its callback function.
+ *
+ * @param pool
+ *   The timer pool.
+ * @param tim
+ *   A timer of the pool.
+ * @return
+ *   The handle of the timer.
+ */
+__rte_experimental
+static inline rte_timer_handle_t
+rte_timer_pool_get_handle(const struct rte_timer_pool *pool,
+			  const struct rte_timer *tim)
+{
+	return (rte_timer_handle_t)(tim - pool->timers);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_TIMER_POOL_H_ */